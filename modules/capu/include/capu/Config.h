@@ -24,6 +24,20 @@
 #define _WINSOCKAPI_
 #endif
 
+/**
+ * storage class for variables with one instance per thread (plain old data only)
+ */
+#ifdef OS_WINDOWS
+#define CAPU_THREAD_LOCAL __declspec(thread)
+#else
+#define CAPU_THREAD_LOCAL __thread
+#endif
+
+/**
+ * size of a cache line in bytes, used to align data against false sharing
+ */
+#define CAPU_CACHE_LINE_SIZE 64
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
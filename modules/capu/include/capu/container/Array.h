@@ -20,16 +20,49 @@
 #include "capu/Config.h"
 #include "capu/Error.h"
 #include "capu/os/Memory.h"
-#include "capu/util/ScopedPointer.h"
+#include "capu/os/NumericLimits.h"
 #include "capu/util/Swap.h"
+#include <new>
 
 namespace capu
 {
+    /**
+     * Storage of an Array which creates the elements with new[]
+     */
+    template<typename T>
+    struct DefaultArrayStorage
+    {
+        static T* Allocate(const uint_t size);
+        static void Free(T* data, const uint_t size);
+    };
 
     /**
-     * Array of objects
+     * Storage of an Array which places the first element at a multiple of ALIGNMENT,
+     * e.g. for SIMD access or to keep arrays of different threads on different cache lines
+     */
+    template<typename T, uint_t ALIGNMENT = CAPU_CACHE_LINE_SIZE>
+    struct AlignedArrayStorage
+    {
+        static T* Allocate(const uint_t size);
+        static void Free(T* data, const uint_t size);
+    };
+
+    /**
+     * Storage of an Array which allocates directly from the operating system
+     * and uses huge pages where possible. Only worth it for arrays of several megabytes.
      */
     template<typename T>
+    struct HugePageArrayStorage
+    {
+        static T* Allocate(const uint_t size);
+        static void Free(T* data, const uint_t size);
+    };
+
+    /**
+     * Array of objects
+     * @param STORAGE defines how the memory for the elements is allocated
+     */
+    template<typename T, typename STORAGE = DefaultArrayStorage<T> >
     class Array
     {
     public:
@@ -37,39 +70,39 @@ namespace capu
         /**
          * Default constructor
          */
-        Array<T>();
+        Array();
 
         /**
          * Constructor
-         * @param size Fix size of the array
+         * @param size Fix size of the array. The array is empty if the memory cannot be allocated.
          */
-        Array<T>(const uint_t size);
+        Array(const uint_t size);
 
         /**
          * Constructor
-         * @param size Fix size of the array
+         * @param size Fix size of the array. The array is empty if the memory cannot be allocated.
          * @param value Value to initialize the elements of the array
          */
-        Array<T>(const uint_t size, const T& value);
+        Array(const uint_t size, const T& value);
 
         /**
          * Constructor that copies a certain number of elements from a native array
          * @param other array to copy from
          * @param size number of elements to copy
          */
-        Array<T>(const T other[], const uint_t size);
+        Array(const T other[], const uint_t size);
 
         /**
          * Copy constructor
          * @param other The array to copy from
          */
-        Array<T>(const Array<T>& other);
+        Array(const Array<T, STORAGE>& other);
 
         /**
          * Assignment operator
          * @param other The array to assign from
          */
-        Array<T>& operator=(const Array<T>& other);
+        Array<T, STORAGE>& operator=(const Array<T, STORAGE>& other);
 
         /**
          * Destructor
@@ -120,7 +153,7 @@ namespace capu
         /**
          * Swaps the contents with another array
          */
-        void swap(Array<T>& other);
+        void swap(Array<T, STORAGE>& other);
 
         /**
          * Allows access of an array element
@@ -155,12 +188,10 @@ namespace capu
         T* getRawData();
 
     private:
-        typedef ScopedArray<T> InternalArray;
-
         status_t setData(const T& value, const uint_t start, const uint_t count);
 
         uint_t mSize;
-        InternalArray mInternalArray;
+        T* mData;
     };
 
 
@@ -168,143 +199,247 @@ namespace capu
      * Implementation specialized swap for array
      */
 
-    template<typename T>
-    void swap(Array<T>& first, Array<T>& second)
+    template<typename T, typename STORAGE>
+    void swap(Array<T, STORAGE>& first, Array<T, STORAGE>& second)
     {
         first.swap(second);
     }
 
 
     /*
-     * Implementation Array
+     * Implementation array storages
      */
 
     template<typename T>
-    Array<T>::Array()
-        : mSize(0)
-        , mInternalArray(0)
+    inline T* DefaultArrayStorage<T>::Allocate(const uint_t size)
     {
+        return size > 0 ? new T[size] : 0;
     }
 
     template<typename T>
-    Array<T>::Array(const uint_t size)
-        : mSize(size)
-        , mInternalArray(size)
+    inline void DefaultArrayStorage<T>::Free(T* data, const uint_t)
+    {
+        delete[] data;
+    }
+
+    template<typename T>
+    struct ArrayElements
+    {
+        /**
+         * Checks whether the bytes of size elements can be expressed in uint_t
+         */
+        static bool_t FitsIntoMemory(const uint_t size)
+        {
+            return size <= NumericLimits::Max<uint_t>() / sizeof(T);
+        }
+
+        static T* Construct(T* data, const uint_t size)
+        {
+            if (data)
+            {
+                for (uint_t i = 0; i < size; ++i)
+                {
+                    new (&data[i]) T;
+                }
+            }
+            return data;
+        }
+
+        static void Destruct(T* data, const uint_t size)
+        {
+            if (data)
+            {
+                for (uint_t i = 0; i < size; ++i)
+                {
+                    data[i].~T();
+                }
+            }
+        }
+    };
+
+    template<typename T, uint_t ALIGNMENT>
+    inline T* AlignedArrayStorage<T, ALIGNMENT>::Allocate(const uint_t size)
+    {
+        if (!ArrayElements<T>::FitsIntoMemory(size))
+        {
+            return 0;
+        }
+        return ArrayElements<T>::Construct(static_cast<T*>(Memory::AllocateAligned(size * sizeof(T), ALIGNMENT)), size);
+    }
+
+    template<typename T, uint_t ALIGNMENT>
+    inline void AlignedArrayStorage<T, ALIGNMENT>::Free(T* data, const uint_t size)
     {
+        ArrayElements<T>::Destruct(data, size);
+        Memory::FreeAligned(data);
     }
 
     template<typename T>
-    Array<T>::Array(const uint_t size, const T& value)
+    inline T* HugePageArrayStorage<T>::Allocate(const uint_t size)
+    {
+        if (!ArrayElements<T>::FitsIntoMemory(size))
+        {
+            return 0;
+        }
+        return ArrayElements<T>::Construct(static_cast<T*>(Memory::AllocateLarge(size * sizeof(T))), size);
+    }
+
+    template<typename T>
+    inline void HugePageArrayStorage<T>::Free(T* data, const uint_t size)
+    {
+        ArrayElements<T>::Destruct(data, size);
+        Memory::FreeLarge(data, size * sizeof(T));
+    }
+
+
+    /*
+     * Implementation Array
+     */
+
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::Array()
+        : mSize(0)
+        , mData(0)
+    {
+    }
+
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::Array(const uint_t size)
+        : mSize(size)
+        , mData(STORAGE::Allocate(size))
+    {
+        if (mData == 0)
+        {
+            mSize = 0;
+        }
+    }
+
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::Array(const uint_t size, const T& value)
         : mSize(size)
-        , mInternalArray(size)
+        , mData(STORAGE::Allocate(size))
     {
+        if (mData == 0)
+        {
+            mSize = 0;
+        }
         set(value);
     }
 
-    template<typename T>
-    Array<T>::Array(const T other[], uint_t size)
-        : mSize(size), mInternalArray(size)
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::Array(const T other[], uint_t size)
+        : mSize(size)
+        , mData(STORAGE::Allocate(size))
     {
-        Memory::CopyObject(mInternalArray, other, size);
+        if (mData == 0)
+        {
+            mSize = 0;
+        }
+        Memory::CopyObject(mData, other, mSize);
     }
 
 
-    template<typename T>
-    Array<T>::Array(const Array<T>& other)
-        : mSize(other.mSize), mInternalArray(other.mSize)
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::Array(const Array<T, STORAGE>& other)
+        : mSize(other.mSize)
+        , mData(STORAGE::Allocate(other.mSize))
     {
-        Memory::CopyObject(mInternalArray.getRawData(), other.getRawData(), other.size());
+        if (mData == 0)
+        {
+            mSize = 0;
+        }
+        Memory::CopyObject(mData, other.getRawData(), mSize);
     }
 
 
-    template<typename T>
-    void Array<T>::swap(Array<T>& other)
+    template<typename T, typename STORAGE>
+    void Array<T, STORAGE>::swap(Array<T, STORAGE>& other)
     {
         capu::swap(mSize, other.mSize);
-        capu::swap(mInternalArray, other.mInternalArray);
+        capu::swap(mData, other.mData);
     }
 
-    template<typename T>
-    Array<T>&  Array<T>::operator=(const Array<T>& other)
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>&  Array<T, STORAGE>::operator=(const Array<T, STORAGE>& other)
     {
         if (mSize != other.mSize)
         {
-            mSize = other.mSize;
-
             // create temporary array with the correct size and then swap
             // this ensures automatic release of the old memory block
-            InternalArray tmpArray(mSize);
-            mInternalArray.swap(tmpArray);
+            Array<T, STORAGE> tmpArray(other.mSize);
+            swap(tmpArray);
         }
 
-        Memory::CopyObject(getRawData(), other.getRawData(), other.size());
+        // an array which could not be allocated stays empty
+        Memory::CopyObject(getRawData(), other.getRawData(), mSize);
         return *this;
     }
 
 
-    template<typename T>
-    Array<T>::~Array(void)
+    template<typename T, typename STORAGE>
+    Array<T, STORAGE>::~Array(void)
     {
+        STORAGE::Free(mData, mSize);
     }
 
-    template<typename T>
-    void Array<T>::set(const T& value)
+    template<typename T, typename STORAGE>
+    void Array<T, STORAGE>::set(const T& value)
     {
         setData(value, 0, mSize);
     }
 
-    template<typename T>
-    status_t Array<T>::set(const T& value, const uint_t index, const uint_t count)
+    template<typename T, typename STORAGE>
+    status_t Array<T, STORAGE>::set(const T& value, const uint_t index, const uint_t count)
     {
         return setData(value, index, count);
     }
 
-    template<typename T>
-    status_t Array<T>::move(const uint_t start, const uint_t count, const uint_t dst)
+    template<typename T, typename STORAGE>
+    status_t Array<T, STORAGE>::move(const uint_t start, const uint_t count, const uint_t dst)
     {
         if ((start >= mSize) || ((count + start) > mSize) || ((dst + count) > mSize))
         {
             return CAPU_ERANGE;
         }
-        Memory::MoveObject(mInternalArray.getRawData() + dst, mInternalArray.getRawData() + start, count);
+        Memory::MoveObject(mData + dst, mData + start, count);
 
         return CAPU_OK;
     }
 
-    template<typename T>
-    status_t Array<T>::copy(const T other[], const uint_t size)
+    template<typename T, typename STORAGE>
+    status_t Array<T, STORAGE>::copy(const T other[], const uint_t size)
     {
         if (size != mSize)
         {
             return CAPU_ERANGE;
         }
 
-        Memory::CopyObject(mInternalArray.getRawData(), other, size);
+        Memory::CopyObject(mData, other, size);
 
         return CAPU_OK;
     }
 
-    template<typename T>
-    T& Array<T>::operator[](const uint_t index) const
+    template<typename T, typename STORAGE>
+    T& Array<T, STORAGE>::operator[](const uint_t index) const
     {
-        return mInternalArray[index];
+        return mData[index];
     }
 
-    template<typename T>
-    uint_t Array<T>::size() const
+    template<typename T, typename STORAGE>
+    uint_t Array<T, STORAGE>::size() const
     {
         return mSize;
     }
 
-    template<typename T>
-    status_t Array<T>::setData(const T& value, const uint_t index, const uint_t count)
+    template<typename T, typename STORAGE>
+    status_t Array<T, STORAGE>::setData(const T& value, const uint_t index, const uint_t count)
     {
 
         if ((index >= mSize) || ((count + index) > mSize))
         {
             return CAPU_ERANGE;
         }
-        T* start = &mInternalArray[mSize - (mSize - count) + index];
+        T* start = &mData[mSize - (mSize - count) + index];
 
         switch (count)
         {
@@ -360,30 +495,29 @@ namespace capu
         return CAPU_OK;
     }
 
-    template<typename T>
-    void Array<T>::setRawData(const int32_t value)
+    template<typename T, typename STORAGE>
+    void Array<T, STORAGE>::setRawData(const int32_t value)
     {
-        Memory::Set(mInternalArray.getRawData(), value, sizeof(T) * mSize);
+        Memory::Set(mData, value, sizeof(T) * mSize);
     }
 
-    template<typename T>
-    const T* Array<T>::getRawData() const
+    template<typename T, typename STORAGE>
+    const T* Array<T, STORAGE>::getRawData() const
     {
-        return mInternalArray.getRawData();
+        return mData;
     }
 
-    template<typename T>
-    T* Array<T>::getRawData()
+    template<typename T, typename STORAGE>
+    T* Array<T, STORAGE>::getRawData()
     {
-        return mInternalArray.getRawData();
+        return mData;
     }
 
-    template<typename T>
-    void Array<T>::setSize(const uint_t size)
+    template<typename T, typename STORAGE>
+    void Array<T, STORAGE>::setSize(const uint_t size)
     {
-        InternalArray tmpArray(size);
-        mInternalArray.swap(tmpArray);
-        mSize = size;
+        Array<T, STORAGE> tmpArray(size);
+        swap(tmpArray);
     }
 }
 
@@ -0,0 +1,1253 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_BTREEMAP_H
+#define CAPU_BTREEMAP_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Comparator.h"
+#include "capu/container/Vector.h"
+#include "capu/util/Allocator.h"
+
+//defines the size of the keys (and values) of one node. A multiple of the cache line,
+//so that searching a node touches a few neighboring lines only
+#define BTREE_NODE_SIZE (4 * CAPU_CACHE_LINE_SIZE)
+
+namespace capu
+{
+    /**
+     * Key and value stored in the leaves of a BTreeMap
+     */
+    template <class Key, class T>
+    struct BTreeEntry
+    {
+        Key key; // must not be modified while the entry is in the map
+        T value;
+    };
+
+    /**
+     * Value type of a BTreeMap which only stores keys
+     */
+    struct BTreeNoValue
+    {
+    };
+
+    /**
+     * Entry without value, used by BTreeSet. The static value takes no space in the leaves.
+     */
+    template <class Key>
+    struct BTreeEntry<Key, BTreeNoValue>
+    {
+        Key key;
+        static BTreeNoValue value;
+    };
+
+    template <class Key>
+    BTreeNoValue BTreeEntry<Key, BTreeNoValue>::value;
+
+    /**
+     * Common part of the nodes of a BTreeMap
+     */
+    struct BTreeNode
+    {
+        BTreeNode()
+            : count(0)
+        {
+        }
+
+        uint_t count; // number of keys in the node
+    };
+
+    /**
+     * Leaf node of a BTreeMap. The leaves hold all entries and are linked in key order.
+     */
+    template <class Key, class T>
+    struct BTreeLeafNode: public BTreeNode
+    {
+        static const uint_t Capacity = BTREE_NODE_SIZE / sizeof(BTreeEntry<Key, T>) < 4 ? 4 : BTREE_NODE_SIZE / sizeof(BTreeEntry<Key, T>);
+
+        BTreeLeafNode()
+            : previous(0)
+            , next(0)
+        {
+        }
+
+        BTreeLeafNode* previous;
+        BTreeLeafNode* next;
+        BTreeEntry<Key, T> entries[Capacity];
+    };
+
+    /**
+     * Inner node of a BTreeMap. All keys of children[i] are smaller than keys[i],
+     * all keys of children[i + 1] are not.
+     */
+    template <class Key>
+    struct BTreeInnerNode: public BTreeNode
+    {
+        static const uint_t Capacity = BTREE_NODE_SIZE / sizeof(Key) < 4 ? 4 : BTREE_NODE_SIZE / sizeof(Key);
+
+        Key keys[Capacity];
+        BTreeNode* children[Capacity + 1];
+    };
+
+    /**
+     * Map which keeps its keys sorted, so it supports sorted iteration and range queries.
+     *
+     * The entries are stored in a B+ tree. Every node is a few cache lines big and all entries
+     * are in the leaves, which are linked for iteration. Iterators stay valid until the map is changed.
+     *
+     * @param C orders the keys, C(a, b) returns true if a sorts before b
+     * @param LA allocator for the leaf nodes
+     * @param IA allocator for the inner nodes
+     */
+    template <class Key, class T, class C = LessComparator, class LA = Allocator<BTreeLeafNode<Key, T> >, class IA = Allocator<BTreeInnerNode<Key> > >
+    class BTreeMap
+    {
+    public:
+        /**
+         * Key and value stored in the map
+         */
+        typedef BTreeEntry<Key, T> Entry;
+
+    private:
+        typedef BTreeLeafNode<Key, T> LeafNode;
+        typedef BTreeInnerNode<Key> InnerNode;
+
+        /**
+         * Iterator over the entries, ENTRY is Entry or const Entry
+         */
+        template <class ENTRY>
+        class BTreeMapIterator
+        {
+        public:
+            friend class BTreeMap;
+
+            /**
+             * Converts an iterator into a const iterator, or copies it
+             */
+            BTreeMapIterator(const BTreeMapIterator<Entry>& other)
+                : mLeaf(other.mLeaf)
+                , mIndex(other.mIndex)
+            {
+            }
+
+            /**
+             * Get current iterator element.
+             * @return current element
+             */
+            ENTRY& operator*() const
+            {
+                return mLeaf->entries[mIndex];
+            }
+
+            /**
+             * Get current iterator element.
+             * @return pointer to current element
+             */
+            ENTRY* operator->() const
+            {
+                return &mLeaf->entries[mIndex];
+            }
+
+            /**
+             * Step the iterator forward to the next element in key order (prefix operator)
+             * @return the next iterator
+             */
+            BTreeMapIterator& operator++()
+            {
+                ++mIndex;
+                if (mIndex == mLeaf->count)
+                {
+                    mLeaf = mLeaf->next;
+                    mIndex = 0;
+                }
+                return *this;
+            }
+
+            /**
+             * Step the iterator forward to the next element in key order (postfix operator)
+             * @return the next iterator
+             */
+            BTreeMapIterator operator++(int32_t)
+            {
+                BTreeMapIterator oldValue(*this);
+                ++(*this);
+                return oldValue;
+            }
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators point to the same position
+             */
+            bool_t operator==(const BTreeMapIterator& other) const
+            {
+                return mLeaf == other.mLeaf && mIndex == other.mIndex;
+            }
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators do not point to the same position
+             */
+            bool_t operator!=(const BTreeMapIterator& other) const
+            {
+                return !(*this == other);
+            }
+
+        private:
+            template <class OTHER>
+            friend class BTreeMapIterator;
+
+            BTreeMapIterator(LeafNode* leaf, const uint_t index)
+                : mLeaf(leaf)
+                , mIndex(index)
+            {
+            }
+
+            LeafNode* mLeaf;
+            uint_t mIndex;
+        };
+
+    public:
+        /**
+         * Iterator over the entries in key order
+         */
+        typedef BTreeMapIterator<Entry> Iterator;
+
+        /**
+         * Iterator over the entries in key order which does not allow changing the values
+         */
+        typedef BTreeMapIterator<const Entry> ConstIterator;
+
+        /**
+         * Constructs an empty map
+         */
+        BTreeMap();
+
+        /**
+         * Copy constructor
+         */
+        BTreeMap(const BTreeMap& other);
+
+        /**
+         * Destructor
+         */
+        ~BTreeMap();
+
+        /**
+         * Assignment operator
+         */
+        BTreeMap& operator=(const BTreeMap& other);
+
+        /**
+         * Puts a value into the map, an existing value for the key is replaced
+         * @param key the key
+         * @param value the value
+         * @param oldValue receives the replaced value if not 0
+         * @return CAPU_OK if the value was put
+         *         CAPU_ENO_MEMORY if no node could be allocated
+         */
+        status_t put(const Key& key, const T& value, T* oldValue = 0);
+
+        /**
+         * Get value associated with key
+         * @param key the key
+         * @param returnCode receives CAPU_OK if the key is contained and CAPU_ENOT_EXIST otherwise. Optional.
+         * @return the value or a default constructed value if the key is not contained
+         */
+        const T& at(const Key& key, status_t* returnCode = 0) const;
+
+        /**
+         * Get value associated with key
+         * @param key the key
+         * @param returnCode receives CAPU_OK if the key is contained and CAPU_ENOT_EXIST otherwise. Optional.
+         * @return the value or a default constructed value if the key is not contained. Writing to
+         *         the value of a missing key does not change the map.
+         */
+        T& at(const Key& key, status_t* returnCode = 0);
+
+        /**
+         * Checks whether the key is contained
+         * @param key the key
+         * @return true if the key is contained
+         */
+        bool_t contains(const Key& key) const;
+
+        /**
+         * Removes a key
+         * @param key the key
+         * @param oldValue receives the removed value if not 0
+         * @return CAPU_OK if the key was removed
+         *         CAPU_ERANGE if the key was not contained
+         */
+        status_t remove(const Key& key, T* oldValue = 0);
+
+        /**
+         * Replaces the content of the map with the given entries in one go. Much faster than
+         * putting the entries one by one, because the nodes are filled and linked directly.
+         * @param keys the keys in strictly ascending order
+         * @param values the values of the keys
+         * @param count number of entries
+         * @return CAPU_OK if the entries were loaded
+         *         CAPU_EINVAL if the keys are not strictly ascending, the map is not changed then
+         *         CAPU_ENO_MEMORY if no node could be allocated, the map is empty then
+         */
+        status_t load(const Key keys[], const T values[], const uint_t count);
+
+        /**
+         * Returns the number of entries
+         * @return number of entries
+         */
+        uint_t count() const;
+
+        /**
+         * Removes all entries
+         */
+        void clear();
+
+        /**
+         * Returns an iterator to the entry with the given key
+         * @param key the key
+         * @return iterator to the entry or end() if the key is not contained
+         */
+        Iterator find(const Key& key);
+        ConstIterator find(const Key& key) const;
+
+        /**
+         * Returns an iterator to the first entry whose key does not sort before the given key
+         * @param key the key
+         * @return iterator to the entry or end() if there is none
+         */
+        Iterator lowerBound(const Key& key);
+        ConstIterator lowerBound(const Key& key) const;
+
+        /**
+         * Returns an iterator to the first entry whose key sorts after the given key.
+         * Iterating from lowerBound(a) to upperBound(b) visits all keys in [a, b].
+         * @param key the key
+         * @return iterator to the entry or end() if there is none
+         */
+        Iterator upperBound(const Key& key);
+        ConstIterator upperBound(const Key& key) const;
+
+        /**
+         * Returns an iterator to the entry with the smallest key
+         * @return iterator
+         */
+        Iterator begin();
+        ConstIterator begin() const;
+
+        /**
+         * Returns an iterator pointing after the entry with the biggest key
+         * @return iterator
+         */
+        Iterator end();
+        ConstIterator end() const;
+
+    private:
+        // deep enough for any tree which fits into memory, the nodes have at least 2 children
+        static const uint_t MaxDepth = sizeof(uint_t) * 8;
+        static const uint_t MinLeafCount = LeafNode::Capacity / 2;
+        static const uint_t MinInnerCount = InnerNode::Capacity / 2;
+
+        template <class SOURCE>
+        status_t build(SOURCE& source, const uint_t count);
+
+        uint_t leafLowerBound(const LeafNode* leaf, const Key& key) const;
+        uint_t leafUpperBound(const LeafNode* leaf, const Key& key) const;
+        uint_t innerChildIndex(const InnerNode* inner, const Key& key) const;
+        LeafNode* findLeaf(const Key& key, InnerNode** path, uint_t* childIndices) const;
+        void insertIntoParents(InnerNode** path, const uint_t* childIndices, Key key, BTreeNode* right, InnerNode** spareNodes);
+        void rebalanceLeaf(LeafNode* leaf, InnerNode** path, const uint_t* childIndices);
+        void rebalanceInner(InnerNode** path, const uint_t* childIndices, uint_t level);
+        void removeFromInner(InnerNode* inner, const uint_t keyIndex);
+        void freeNode(BTreeNode* node, const uint_t level);
+
+        BTreeNode* mRoot;
+        uint_t mDepth; // number of inner node levels
+        LeafNode* mFirstLeaf;
+        uint_t mCount;
+        mutable T mMissingValue; // returned by at() for missing keys, reset on every miss
+        const C mComparator;
+        LA mLeafAllocator;
+        IA mInnerAllocator;
+    };
+
+    namespace internal
+    {
+        template <class Key, class T>
+        struct BTreeArraySource
+        {
+            BTreeArraySource(const Key* keys_, const T* values_)
+                : keys(keys_)
+                , values(values_)
+            {
+            }
+
+            void next(BTreeEntry<Key, T>& entry)
+            {
+                entry.key = *keys++;
+                entry.value = *values++;
+            }
+
+            const Key* keys;
+            const T* values;
+        };
+
+        template <class Key>
+        struct BTreeArraySource<Key, BTreeNoValue>
+        {
+            BTreeArraySource(const Key* keys_, const BTreeNoValue*)
+                : keys(keys_)
+            {
+            }
+
+            void next(BTreeEntry<Key, BTreeNoValue>& entry)
+            {
+                entry.key = *keys++;
+            }
+
+            const Key* keys;
+        };
+
+        template <class ITERATOR, class Key, class T>
+        struct BTreeIteratorSource
+        {
+            BTreeIteratorSource(ITERATOR current_)
+                : current(current_)
+            {
+            }
+
+            void next(BTreeEntry<Key, T>& entry)
+            {
+                entry = *current;
+                ++current;
+            }
+
+            ITERATOR current;
+        };
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline BTreeMap<Key, T, C, LA, IA>::BTreeMap()
+        : mRoot(0)
+        , mDepth(0)
+        , mFirstLeaf(0)
+        , mCount(0)
+        , mMissingValue()
+        , mComparator()
+    {
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline BTreeMap<Key, T, C, LA, IA>::BTreeMap(const BTreeMap& other)
+        : mRoot(0)
+        , mDepth(0)
+        , mFirstLeaf(0)
+        , mCount(0)
+        , mMissingValue()
+        , mComparator()
+    {
+        internal::BTreeIteratorSource<ConstIterator, Key, T> source(other.begin());
+        build(source, other.count());
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline BTreeMap<Key, T, C, LA, IA>::~BTreeMap()
+    {
+        clear();
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline BTreeMap<Key, T, C, LA, IA>& BTreeMap<Key, T, C, LA, IA>::operator=(const BTreeMap& other)
+    {
+        if (&other != this)
+        {
+            clear();
+            internal::BTreeIteratorSource<ConstIterator, Key, T> source(other.begin());
+            build(source, other.count());
+        }
+        return *this;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline uint_t BTreeMap<Key, T, C, LA, IA>::count() const
+    {
+        return mCount;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline uint_t BTreeMap<Key, T, C, LA, IA>::leafLowerBound(const LeafNode* leaf, const Key& key) const
+    {
+        uint_t first = 0;
+        uint_t size = leaf->count;
+        while (size > 0)
+        {
+            const uint_t half = size / 2;
+            if (mComparator(leaf->entries[first + half].key, key))
+            {
+                first += half + 1;
+                size -= half + 1;
+            }
+            else
+            {
+                size = half;
+            }
+        }
+        return first;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline uint_t BTreeMap<Key, T, C, LA, IA>::leafUpperBound(const LeafNode* leaf, const Key& key) const
+    {
+        uint_t first = 0;
+        uint_t size = leaf->count;
+        while (size > 0)
+        {
+            const uint_t half = size / 2;
+            if (!mComparator(key, leaf->entries[first + half].key))
+            {
+                first += half + 1;
+                size -= half + 1;
+            }
+            else
+            {
+                size = half;
+            }
+        }
+        return first;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline uint_t BTreeMap<Key, T, C, LA, IA>::innerChildIndex(const InnerNode* inner, const Key& key) const
+    {
+        // index of the first separator which is bigger than the key
+        uint_t first = 0;
+        uint_t size = inner->count;
+        while (size > 0)
+        {
+            const uint_t half = size / 2;
+            if (!mComparator(key, inner->keys[first + half]))
+            {
+                first += half + 1;
+                size -= half + 1;
+            }
+            else
+            {
+                size = half;
+            }
+        }
+        return first;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::LeafNode* BTreeMap<Key, T, C, LA, IA>::findLeaf(const Key& key, InnerNode** path, uint_t* childIndices) const
+    {
+        BTreeNode* node = mRoot;
+        for (uint_t level = 0; level < mDepth; ++level)
+        {
+            InnerNode* inner = static_cast<InnerNode*>(node);
+            const uint_t index = innerChildIndex(inner, key);
+            if (path)
+            {
+                path[level] = inner;
+                childIndices[level] = index;
+            }
+            node = inner->children[index];
+        }
+        return static_cast<LeafNode*>(node);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline const T& BTreeMap<Key, T, C, LA, IA>::at(const Key& key, status_t* returnCode) const
+    {
+        ConstIterator it = find(key);
+        if (it != end())
+        {
+            if (returnCode)
+            {
+                *returnCode = CAPU_OK;
+            }
+            return it->value;
+        }
+        if (returnCode)
+        {
+            *returnCode = CAPU_ENOT_EXIST;
+        }
+        mMissingValue = T();
+        return mMissingValue;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline T& BTreeMap<Key, T, C, LA, IA>::at(const Key& key, status_t* returnCode)
+    {
+        // the missing value is reset by every miss, so writing to it has no lasting effect
+        return const_cast<T&>(static_cast<const BTreeMap&>(*this).at(key, returnCode));
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline bool_t BTreeMap<Key, T, C, LA, IA>::contains(const Key& key) const
+    {
+        return find(key) != end();
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::Iterator BTreeMap<Key, T, C, LA, IA>::find(const Key& key)
+    {
+        const ConstIterator it = static_cast<const BTreeMap&>(*this).find(key);
+        return Iterator(it.mLeaf, it.mIndex);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::ConstIterator BTreeMap<Key, T, C, LA, IA>::find(const Key& key) const
+    {
+        if (!mRoot)
+        {
+            return end();
+        }
+        LeafNode* leaf = findLeaf(key, 0, 0);
+        const uint_t index = leafLowerBound(leaf, key);
+        if (index < leaf->count && !mComparator(key, leaf->entries[index].key))
+        {
+            return ConstIterator(leaf, index);
+        }
+        return end();
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::Iterator BTreeMap<Key, T, C, LA, IA>::lowerBound(const Key& key)
+    {
+        const ConstIterator it = static_cast<const BTreeMap&>(*this).lowerBound(key);
+        return Iterator(it.mLeaf, it.mIndex);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::ConstIterator BTreeMap<Key, T, C, LA, IA>::lowerBound(const Key& key) const
+    {
+        if (!mRoot)
+        {
+            return end();
+        }
+        LeafNode* leaf = findLeaf(key, 0, 0);
+        const uint_t index = leafLowerBound(leaf, key);
+        if (index < leaf->count)
+        {
+            return ConstIterator(leaf, index);
+        }
+        // all keys of the leaf are smaller, so the first key of the next leaf is the bound
+        return ConstIterator(leaf->next, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::Iterator BTreeMap<Key, T, C, LA, IA>::upperBound(const Key& key)
+    {
+        const ConstIterator it = static_cast<const BTreeMap&>(*this).upperBound(key);
+        return Iterator(it.mLeaf, it.mIndex);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::ConstIterator BTreeMap<Key, T, C, LA, IA>::upperBound(const Key& key) const
+    {
+        if (!mRoot)
+        {
+            return end();
+        }
+        LeafNode* leaf = findLeaf(key, 0, 0);
+        const uint_t index = leafUpperBound(leaf, key);
+        if (index < leaf->count)
+        {
+            return ConstIterator(leaf, index);
+        }
+        return ConstIterator(leaf->next, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::Iterator BTreeMap<Key, T, C, LA, IA>::begin()
+    {
+        return Iterator(mFirstLeaf, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::ConstIterator BTreeMap<Key, T, C, LA, IA>::begin() const
+    {
+        return ConstIterator(mFirstLeaf, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::Iterator BTreeMap<Key, T, C, LA, IA>::end()
+    {
+        return Iterator(0, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline typename BTreeMap<Key, T, C, LA, IA>::ConstIterator BTreeMap<Key, T, C, LA, IA>::end() const
+    {
+        return ConstIterator(0, 0);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    status_t BTreeMap<Key, T, C, LA, IA>::put(const Key& key, const T& value, T* oldValue)
+    {
+        if (!mRoot)
+        {
+            LeafNode* leaf = mLeafAllocator.allocate();
+            if (!leaf)
+            {
+                return CAPU_ENO_MEMORY;
+            }
+            leaf->entries[0].key = key;
+            leaf->entries[0].value = value;
+            leaf->count = 1;
+            mRoot = leaf;
+            mFirstLeaf = leaf;
+            mCount = 1;
+            return CAPU_OK;
+        }
+
+        InnerNode* path[MaxDepth];
+        uint_t childIndices[MaxDepth];
+        LeafNode* leaf = findLeaf(key, path, childIndices);
+        const uint_t index = leafLowerBound(leaf, key);
+        if (index < leaf->count && !mComparator(key, leaf->entries[index].key))
+        {
+            if (oldValue)
+            {
+                *oldValue = leaf->entries[index].value;
+            }
+            leaf->entries[index].value = value;
+            return CAPU_OK;
+        }
+
+        if (leaf->count < LeafNode::Capacity)
+        {
+            for (uint_t i = leaf->count; i > index; --i)
+            {
+                leaf->entries[i] = leaf->entries[i - 1];
+            }
+            leaf->entries[index].key = key;
+            leaf->entries[index].value = value;
+            ++leaf->count;
+            ++mCount;
+            return CAPU_OK;
+        }
+
+        // all nodes needed by the splits are allocated up front,
+        // so the tree is not changed if the allocation fails
+        LeafNode* right = mLeafAllocator.allocate();
+        InnerNode* spareNodes[MaxDepth + 1];
+        uint_t spareCount = 0;
+        bool_t allocated = right != 0;
+        for (uint_t level = mDepth; allocated; --level)
+        {
+            if (level > 0 && path[level - 1]->count < InnerNode::Capacity)
+            {
+                break;
+            }
+            spareNodes[spareCount] = mInnerAllocator.allocate();
+            allocated = spareNodes[spareCount] != 0;
+            if (allocated)
+            {
+                ++spareCount;
+            }
+            if (level == 0)
+            {
+                break;
+            }
+        }
+        if (!allocated)
+        {
+            while (spareCount > 0)
+            {
+                mInnerAllocator.deallocate(spareNodes[--spareCount]);
+            }
+            if (right)
+            {
+                mLeafAllocator.deallocate(right);
+            }
+            return CAPU_ENO_MEMORY;
+        }
+
+        // split the full leaf, the entries are numbered as if the new one was already inserted
+        const uint_t total = LeafNode::Capacity + 1;
+        const uint_t middle = total / 2;
+        for (uint_t i = middle; i < total; ++i)
+        {
+            Entry& target = right->entries[i - middle];
+            if (i < index)
+            {
+                target = leaf->entries[i];
+            }
+            else if (i == index)
+            {
+                target.key = key;
+                target.value = value;
+            }
+            else
+            {
+                target = leaf->entries[i - 1];
+            }
+        }
+        if (index < middle)
+        {
+            for (uint_t i = middle; i > index; --i)
+            {
+                leaf->entries[i] = leaf->entries[i - 1];
+            }
+            leaf->entries[index].key = key;
+            leaf->entries[index].value = value;
+        }
+        for (uint_t i = middle; i < LeafNode::Capacity; ++i)
+        {
+            leaf->entries[i] = Entry();
+        }
+        leaf->count = middle;
+        right->count = total - middle;
+
+        right->next = leaf->next;
+        right->previous = leaf;
+        if (leaf->next)
+        {
+            leaf->next->previous = right;
+        }
+        leaf->next = right;
+        ++mCount;
+
+        insertIntoParents(path, childIndices, right->entries[0].key, right, spareNodes);
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    void BTreeMap<Key, T, C, LA, IA>::insertIntoParents(InnerNode** path, const uint_t* childIndices, Key key, BTreeNode* right, InnerNode** spareNodes)
+    {
+        // insert the separator and the new right node into the parents, splitting them as long as they are full
+        for (uint_t level = mDepth; level > 0; --level)
+        {
+            InnerNode* inner = path[level - 1];
+            const uint_t index = childIndices[level - 1];
+            if (inner->count < InnerNode::Capacity)
+            {
+                for (uint_t i = inner->count; i > index; --i)
+                {
+                    inner->keys[i] = inner->keys[i - 1];
+                    inner->children[i + 1] = inner->children[i];
+                }
+                inner->keys[index] = key;
+                inner->children[index + 1] = right;
+                ++inner->count;
+                return;
+            }
+
+            InnerNode* newInner = *spareNodes++;
+
+            // keys and children are numbered as if the new ones were already inserted,
+            // the key in the middle moves up to the parent
+            const uint_t total = InnerNode::Capacity + 1;
+            const uint_t middle = total / 2;
+            for (uint_t i = middle + 1; i < total; ++i)
+            {
+                newInner->keys[i - middle - 1] = i < index ? inner->keys[i] : (i == index ? key : inner->keys[i - 1]);
+            }
+            for (uint_t i = middle + 1; i <= total; ++i)
+            {
+                newInner->children[i - middle - 1] = i <= index ? inner->children[i] : (i == index + 1 ? right : inner->children[i - 1]);
+            }
+            const Key up = middle < index ? inner->keys[middle] : (middle == index ? key : inner->keys[middle - 1]);
+            if (index < middle)
+            {
+                for (uint_t i = middle; i > index; --i)
+                {
+                    inner->keys[i] = inner->keys[i - 1];
+                    inner->children[i + 1] = inner->children[i];
+                }
+                inner->keys[index] = key;
+                inner->children[index + 1] = right;
+            }
+            for (uint_t i = middle; i < InnerNode::Capacity; ++i)
+            {
+                inner->keys[i] = Key();
+            }
+            inner->count = middle;
+            newInner->count = total - middle - 1;
+
+            key = up;
+            right = newInner;
+        }
+
+        // the root was split, the tree grows by one level
+        InnerNode* root = *spareNodes;
+        root->keys[0] = key;
+        root->children[0] = mRoot;
+        root->children[1] = right;
+        root->count = 1;
+        mRoot = root;
+        ++mDepth;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    status_t BTreeMap<Key, T, C, LA, IA>::remove(const Key& key, T* oldValue)
+    {
+        if (!mRoot)
+        {
+            return CAPU_ERANGE;
+        }
+
+        InnerNode* path[MaxDepth];
+        uint_t childIndices[MaxDepth];
+        LeafNode* leaf = findLeaf(key, path, childIndices);
+        const uint_t index = leafLowerBound(leaf, key);
+        if (index >= leaf->count || mComparator(key, leaf->entries[index].key))
+        {
+            return CAPU_ERANGE;
+        }
+
+        if (oldValue)
+        {
+            *oldValue = leaf->entries[index].value;
+        }
+        for (uint_t i = index + 1; i < leaf->count; ++i)
+        {
+            leaf->entries[i - 1] = leaf->entries[i];
+        }
+        --leaf->count;
+        leaf->entries[leaf->count] = Entry();
+        --mCount;
+
+        // the separators in the inner nodes stay valid bounds, even if they are not contained anymore
+        rebalanceLeaf(leaf, path, childIndices);
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    void BTreeMap<Key, T, C, LA, IA>::rebalanceLeaf(LeafNode* leaf, InnerNode** path, const uint_t* childIndices)
+    {
+        if (mDepth == 0)
+        {
+            if (leaf->count == 0)
+            {
+                mLeafAllocator.deallocate(leaf);
+                mRoot = 0;
+                mFirstLeaf = 0;
+            }
+            return;
+        }
+        if (leaf->count >= MinLeafCount)
+        {
+            return;
+        }
+
+        InnerNode* parent = path[mDepth - 1];
+        const uint_t index = childIndices[mDepth - 1];
+        LeafNode* left = index > 0 ? static_cast<LeafNode*>(parent->children[index - 1]) : 0;
+        LeafNode* right = index < parent->count ? static_cast<LeafNode*>(parent->children[index + 1]) : 0;
+
+        if (left && left->count > MinLeafCount)
+        {
+            // borrow the biggest entry of the left sibling
+            for (uint_t i = leaf->count; i > 0; --i)
+            {
+                leaf->entries[i] = leaf->entries[i - 1];
+            }
+            --left->count;
+            leaf->entries[0] = left->entries[left->count];
+            left->entries[left->count] = Entry();
+            ++leaf->count;
+            parent->keys[index - 1] = leaf->entries[0].key;
+            return;
+        }
+        if (right && right->count > MinLeafCount)
+        {
+            // borrow the smallest entry of the right sibling
+            leaf->entries[leaf->count] = right->entries[0];
+            ++leaf->count;
+            for (uint_t i = 1; i < right->count; ++i)
+            {
+                right->entries[i - 1] = right->entries[i];
+            }
+            --right->count;
+            right->entries[right->count] = Entry();
+            parent->keys[index] = right->entries[0].key;
+            return;
+        }
+
+        // merge with a sibling, the right one of the two nodes is released
+        uint_t separator = index;
+        if (left)
+        {
+            right = leaf;
+            leaf = left;
+            separator = index - 1;
+        }
+        for (uint_t i = 0; i < right->count; ++i)
+        {
+            leaf->entries[leaf->count + i] = right->entries[i];
+        }
+        leaf->count += right->count;
+        leaf->next = right->next;
+        if (right->next)
+        {
+            right->next->previous = leaf;
+        }
+        mLeafAllocator.deallocate(right);
+
+        removeFromInner(parent, separator);
+        rebalanceInner(path, childIndices, mDepth - 1);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    inline void BTreeMap<Key, T, C, LA, IA>::removeFromInner(InnerNode* inner, const uint_t keyIndex)
+    {
+        // removes keys[keyIndex] and children[keyIndex + 1]
+        for (uint_t i = keyIndex + 1; i < inner->count; ++i)
+        {
+            inner->keys[i - 1] = inner->keys[i];
+            inner->children[i] = inner->children[i + 1];
+        }
+        --inner->count;
+        inner->keys[inner->count] = Key();
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    void BTreeMap<Key, T, C, LA, IA>::rebalanceInner(InnerNode** path, const uint_t* childIndices, uint_t level)
+    {
+        // level is the index of the node in the path which may have too few keys now
+        while (true)
+        {
+            InnerNode* inner = path[level];
+            if (level == 0)
+            {
+                if (inner->count == 0)
+                {
+                    // the root has a single child left, the tree shrinks by one level
+                    mRoot = inner->children[0];
+                    mInnerAllocator.deallocate(inner);
+                    --mDepth;
+                }
+                return;
+            }
+            if (inner->count >= MinInnerCount)
+            {
+                return;
+            }
+
+            InnerNode* parent = path[level - 1];
+            const uint_t index = childIndices[level - 1];
+            InnerNode* left = index > 0 ? static_cast<InnerNode*>(parent->children[index - 1]) : 0;
+            InnerNode* right = index < parent->count ? static_cast<InnerNode*>(parent->children[index + 1]) : 0;
+
+            if (left && left->count > MinInnerCount)
+            {
+                // rotate the biggest child of the left sibling over the parent
+                inner->children[inner->count + 1] = inner->children[inner->count];
+                for (uint_t i = inner->count; i > 0; --i)
+                {
+                    inner->keys[i] = inner->keys[i - 1];
+                    inner->children[i] = inner->children[i - 1];
+                }
+                inner->keys[0] = parent->keys[index - 1];
+                inner->children[0] = left->children[left->count];
+                ++inner->count;
+                parent->keys[index - 1] = left->keys[left->count - 1];
+                --left->count;
+                left->keys[left->count] = Key();
+                return;
+            }
+            if (right && right->count > MinInnerCount)
+            {
+                // rotate the smallest child of the right sibling over the parent
+                inner->keys[inner->count] = parent->keys[index];
+                inner->children[inner->count + 1] = right->children[0];
+                ++inner->count;
+                parent->keys[index] = right->keys[0];
+                right->children[0] = right->children[1];
+                for (uint_t i = 1; i < right->count; ++i)
+                {
+                    right->keys[i - 1] = right->keys[i];
+                    right->children[i] = right->children[i + 1];
+                }
+                --right->count;
+                right->keys[right->count] = Key();
+                return;
+            }
+
+            // merge with a sibling and the separator between them, the right one is released
+            uint_t separator = index;
+            if (left)
+            {
+                right = inner;
+                inner = left;
+                separator = index - 1;
+            }
+            inner->keys[inner->count] = parent->keys[separator];
+            for (uint_t i = 0; i < right->count; ++i)
+            {
+                inner->keys[inner->count + 1 + i] = right->keys[i];
+            }
+            for (uint_t i = 0; i <= right->count; ++i)
+            {
+                inner->children[inner->count + 1 + i] = right->children[i];
+            }
+            inner->count += right->count + 1;
+            mInnerAllocator.deallocate(right);
+
+            removeFromInner(parent, separator);
+            --level;
+        }
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    status_t BTreeMap<Key, T, C, LA, IA>::load(const Key keys[], const T values[], const uint_t count)
+    {
+        for (uint_t i = 1; i < count; ++i)
+        {
+            if (!mComparator(keys[i - 1], keys[i]))
+            {
+                return CAPU_EINVAL;
+            }
+        }
+        clear();
+        internal::BTreeArraySource<Key, T> source(keys, values);
+        return build(source, count);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    template <class SOURCE>
+    status_t BTreeMap<Key, T, C, LA, IA>::build(SOURCE& source, const uint_t count)
+    {
+        if (count == 0)
+        {
+            return CAPU_OK;
+        }
+
+        // the entries are spread evenly over the fewest possible leaves,
+        // so every leaf is at least half full
+        const uint_t leafCount = (count + LeafNode::Capacity - 1) / LeafNode::Capacity;
+        Vector<BTreeNode*> nodes(static_cast<uint32_t>(leafCount));
+        Vector<Key> firstKeys(static_cast<uint32_t>(leafCount));
+        LeafNode* previous = 0;
+        for (uint_t i = 0; i < leafCount; ++i)
+        {
+            LeafNode* leaf = mLeafAllocator.allocate();
+            if (!leaf)
+            {
+                for (uint_t j = 0; j < nodes.size(); ++j)
+                {
+                    freeNode(nodes[j], 0);
+                }
+                mFirstLeaf = 0;
+                mCount = 0;
+                return CAPU_ENO_MEMORY;
+            }
+            leaf->count = count / leafCount + (i < count % leafCount ? 1 : 0);
+            for (uint_t j = 0; j < leaf->count; ++j)
+            {
+                source.next(leaf->entries[j]);
+            }
+            leaf->previous = previous;
+            if (previous)
+            {
+                previous->next = leaf;
+            }
+            else
+            {
+                mFirstLeaf = leaf;
+            }
+            previous = leaf;
+            mCount += leaf->count;
+            nodes.push_back(leaf);
+            firstKeys.push_back(leaf->entries[0].key);
+        }
+
+        // build the inner levels bottom up, again with evenly filled nodes
+        while (nodes.size() > 1)
+        {
+            const uint_t childCount = nodes.size();
+            const uint_t parentCount = (childCount + InnerNode::Capacity) / (InnerNode::Capacity + 1);
+            Vector<BTreeNode*> parents(static_cast<uint32_t>(parentCount));
+            Vector<Key> parentFirstKeys(static_cast<uint32_t>(parentCount));
+            uint_t child = 0;
+            for (uint_t i = 0; i < parentCount; ++i)
+            {
+                InnerNode* inner = mInnerAllocator.allocate();
+                if (!inner)
+                {
+                    // release the subtrees built so far, the new parents are one level higher
+                    for (uint_t j = 0; j < parents.size(); ++j)
+                    {
+                        freeNode(parents[j], mDepth + 1);
+                    }
+                    for (uint_t j = child; j < childCount; ++j)
+                    {
+                        freeNode(nodes[j], mDepth);
+                    }
+                    mDepth = 0;
+                    mFirstLeaf = 0;
+                    mCount = 0;
+                    return CAPU_ENO_MEMORY;
+                }
+                const uint_t children = childCount / parentCount + (i < childCount % parentCount ? 1 : 0);
+                inner->children[0] = nodes[child];
+                for (uint_t j = 1; j < children; ++j)
+                {
+                    inner->keys[j - 1] = firstKeys[child + j];
+                    inner->children[j] = nodes[child + j];
+                }
+                inner->count = children - 1;
+                parents.push_back(inner);
+                parentFirstKeys.push_back(firstKeys[child]);
+                child += children;
+            }
+            ++mDepth;
+            nodes = parents;
+            firstKeys = parentFirstKeys;
+        }
+        mRoot = nodes[0];
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    void BTreeMap<Key, T, C, LA, IA>::freeNode(BTreeNode* node, const uint_t level)
+    {
+        // level is the number of inner node levels below and including the node
+        if (level == 0)
+        {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            mLeafAllocator.deallocate(leaf);
+            return;
+        }
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (uint_t i = 0; i <= inner->count; ++i)
+        {
+            freeNode(inner->children[i], level - 1);
+        }
+        mInnerAllocator.deallocate(inner);
+    }
+
+    template <class Key, class T, class C, class LA, class IA>
+    void BTreeMap<Key, T, C, LA, IA>::clear()
+    {
+        if (mRoot)
+        {
+            freeNode(mRoot, mDepth);
+        }
+        mRoot = 0;
+        mDepth = 0;
+        mFirstLeaf = 0;
+        mCount = 0;
+    }
+}
+
+#endif // CAPU_BTREEMAP_H
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_BTREESET_H
+#define CAPU_BTREESET_H
+
+#include "capu/container/BTreeMap.h"
+
+namespace capu
+{
+    /**
+     * Set which keeps its values sorted, so it supports sorted iteration and range queries.
+     * Stored in a BTreeMap whose leaves only hold the values.
+     *
+     * @param C orders the values, C(a, b) returns true if a sorts before b
+     * @param LA allocator for the leaf nodes
+     * @param IA allocator for the inner nodes
+     */
+    template <class T, class C = LessComparator, class LA = Allocator<BTreeLeafNode<T, BTreeNoValue> >, class IA = Allocator<BTreeInnerNode<T> > >
+    class BTreeSet
+    {
+    private:
+        typedef BTreeMap<T, BTreeNoValue, C, LA, IA> Map;
+
+        class BTreeSetIterator
+        {
+        public:
+            friend class BTreeSet;
+
+            /**
+             * Get current iterator element.
+             * @return current element
+             */
+            const T& operator*() const
+            {
+                return mCurrent->key;
+            }
+
+            /**
+             * Get current iterator element.
+             * @return pointer to current element
+             */
+            const T* operator->() const
+            {
+                return &mCurrent->key;
+            }
+
+            /**
+             * Step the iterator forward to the next element in sort order (prefix operator)
+             * @return the next iterator
+             */
+            BTreeSetIterator& operator++()
+            {
+                ++mCurrent;
+                return *this;
+            }
+
+            /**
+             * Step the iterator forward to the next element in sort order (postfix operator)
+             * @return the next iterator
+             */
+            BTreeSetIterator operator++(int32_t)
+            {
+                BTreeSetIterator oldValue(*this);
+                ++mCurrent;
+                return oldValue;
+            }
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators point to the same position
+             */
+            bool_t operator==(const BTreeSetIterator& other) const
+            {
+                return mCurrent == other.mCurrent;
+            }
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators do not point to the same position
+             */
+            bool_t operator!=(const BTreeSetIterator& other) const
+            {
+                return mCurrent != other.mCurrent;
+            }
+
+        private:
+            BTreeSetIterator(const typename Map::ConstIterator& current)
+                : mCurrent(current)
+            {
+            }
+
+            typename Map::ConstIterator mCurrent;
+        };
+
+    public:
+        /**
+         * Iterator over the values in sort order
+         */
+        typedef BTreeSetIterator Iterator;
+
+        /**
+         * Puts a value into the set
+         * @param value the value
+         * @return CAPU_OK if the value was put
+         *         CAPU_ERROR if the value is already contained
+         *         CAPU_ENO_MEMORY if no node could be allocated
+         */
+        status_t put(const T& value);
+
+        /**
+         * Removes a value
+         * @param value the value
+         * @return CAPU_OK if the value was removed
+         *         CAPU_ERANGE if the value was not contained
+         */
+        status_t remove(const T& value);
+
+        /**
+         * Checks whether the value is contained
+         * @param value the value
+         * @return true if the value is contained
+         */
+        bool_t hasElement(const T& value) const;
+
+        /**
+         * Replaces the content of the set with the given values in one go
+         * @param values the values in strictly ascending order
+         * @param count number of values
+         * @return CAPU_OK if the values were loaded
+         *         CAPU_EINVAL if the values are not strictly ascending, the set is not changed then
+         *         CAPU_ENO_MEMORY if no node could be allocated, the set is empty then
+         */
+        status_t load(const T values[], const uint_t count);
+
+        /**
+         * Returns the number of values
+         * @return number of values
+         */
+        uint_t count() const;
+
+        /**
+         * Removes all values
+         */
+        void clear();
+
+        /**
+         * Returns an iterator to the first value which does not sort before the given value
+         * @param value the value
+         * @return iterator to the value or end() if there is none
+         */
+        Iterator lowerBound(const T& value) const;
+
+        /**
+         * Returns an iterator to the first value which sorts after the given value
+         * @param value the value
+         * @return iterator to the value or end() if there is none
+         */
+        Iterator upperBound(const T& value) const;
+
+        /**
+         * Returns an iterator to the smallest value
+         * @return iterator
+         */
+        Iterator begin() const;
+
+        /**
+         * Returns an iterator pointing after the biggest value
+         * @return iterator
+         */
+        Iterator end() const;
+
+    private:
+        Map mMap;
+    };
+
+    template <class T, class C, class LA, class IA>
+    inline status_t BTreeSet<T, C, LA, IA>::put(const T& value)
+    {
+        // putting an existing value changes nothing, so the count tells if it was new
+        const uint_t count = mMap.count();
+        const status_t result = mMap.put(value, BTreeNoValue());
+        if (result == CAPU_OK && mMap.count() == count)
+        {
+            return CAPU_ERROR;
+        }
+        return result;
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline status_t BTreeSet<T, C, LA, IA>::remove(const T& value)
+    {
+        return mMap.remove(value);
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline bool_t BTreeSet<T, C, LA, IA>::hasElement(const T& value) const
+    {
+        return mMap.contains(value);
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline status_t BTreeSet<T, C, LA, IA>::load(const T values[], const uint_t count)
+    {
+        // the entries do not store values, so no values are read
+        return mMap.load(values, static_cast<const BTreeNoValue*>(0), count);
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline uint_t BTreeSet<T, C, LA, IA>::count() const
+    {
+        return mMap.count();
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline void BTreeSet<T, C, LA, IA>::clear()
+    {
+        mMap.clear();
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline typename BTreeSet<T, C, LA, IA>::Iterator BTreeSet<T, C, LA, IA>::lowerBound(const T& value) const
+    {
+        return Iterator(mMap.lowerBound(value));
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline typename BTreeSet<T, C, LA, IA>::Iterator BTreeSet<T, C, LA, IA>::upperBound(const T& value) const
+    {
+        return Iterator(mMap.upperBound(value));
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline typename BTreeSet<T, C, LA, IA>::Iterator BTreeSet<T, C, LA, IA>::begin() const
+    {
+        return Iterator(mMap.begin());
+    }
+
+    template <class T, class C, class LA, class IA>
+    inline typename BTreeSet<T, C, LA, IA>::Iterator BTreeSet<T, C, LA, IA>::end() const
+    {
+        return Iterator(mMap.end());
+    }
+}
+
+#endif // CAPU_BTREESET_H
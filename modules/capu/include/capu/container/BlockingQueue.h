@@ -27,9 +27,11 @@ namespace capu
 {
     /**
      * Queue for concurrent access. All methods are threadsafe.
+     *
+     * The storage S is handed to the underlying Queue, see there.
      */
-    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator>
-    class BlockingQueue: private Queue<T, A, C>
+    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator, class S = List<T, A, C> >
+    class BlockingQueue: private Queue<T, A, C, S>
     {
     public:
         virtual ~BlockingQueue();
@@ -80,36 +82,36 @@ namespace capu
         Mutex mMutex;
     };
 
-    template <class T, class A, class C>
-    inline BlockingQueue<T, A, C>::~BlockingQueue()
+    template <class T, class A, class C, class S>
+    inline BlockingQueue<T, A, C, S>::~BlockingQueue()
     {
     }
 
-    template <class T, class A, class C>
-    inline bool_t BlockingQueue<T, A, C>::empty()
+    template <class T, class A, class C, class S>
+    inline bool_t BlockingQueue<T, A, C, S>::empty()
     {
         ScopedMutexLock locker(mMutex);
-        return Queue<T, A, C>::empty();
+        return Queue<T, A, C, S>::empty();
     }
 
-    template <class T, class A, class C>
-    inline status_t BlockingQueue<T, A, C>::push(const T& element)
+    template <class T, class A, class C, class S>
+    inline status_t BlockingQueue<T, A, C, S>::push(const T& element)
     {
         ScopedMutexLock locker(mMutex);
-        status_t retVal = Queue<T, A, C>::push(element);
+        status_t retVal = Queue<T, A, C, S>::push(element);
         mSemaphore.release();
         return retVal;
     }
 
-    template <class T, class A, class C>
-    inline status_t BlockingQueue<T, A, C>::peek(T& element)
+    template <class T, class A, class C, class S>
+    inline status_t BlockingQueue<T, A, C, S>::peek(T& element)
     {
         ScopedMutexLock locker(mMutex);
-        return Queue<T, A, C>::peek(element);
+        return Queue<T, A, C, S>::peek(element);
     }
 
-    template <class T, class A, class C>
-    inline status_t BlockingQueue<T, A, C>::pop(T* element, const uint32_t timeoutMillis)
+    template <class T, class A, class C, class S>
+    inline status_t BlockingQueue<T, A, C, S>::pop(T* element, const uint32_t timeoutMillis)
     {
         // wait outside the lock
         status_t retVal = mSemaphore.tryAquire(timeoutMillis);
@@ -118,21 +120,21 @@ namespace capu
             return retVal;
         }
         ScopedMutexLock locker(mMutex);
-        return Queue<T, A, C>::pop(element);
+        return Queue<T, A, C, S>::pop(element);
     }
 
-    template <class T, class A, class C>
-    inline void BlockingQueue<T, A, C>::clear()
+    template <class T, class A, class C, class S>
+    inline void BlockingQueue<T, A, C, S>::clear()
     {
         ScopedMutexLock locker(mMutex);
-        Queue<T, A, C>::clear();
+        Queue<T, A, C, S>::clear();
     }
 
-    template <class T, class A, class C>
-    inline uint_t BlockingQueue<T, A, C>::size()
+    template <class T, class A, class C, class S>
+    inline uint_t BlockingQueue<T, A, C, S>::size()
     {
         ScopedMutexLock locker(mMutex);
-        return Queue<T, A, C>::size();
+        return Queue<T, A, C, S>::size();
     }
 
     /**
@@ -54,6 +54,39 @@ namespace capu
             return (StringUtils::Strcmp(x, y) == 0);
         }
     };
+
+    /**
+     * Ordering used in sorted container classes.
+     */
+    class LessComparator
+    {
+
+    public:
+        /**
+         * Return if x sorts before y.
+         */
+        template <class T>
+        bool_t operator()(const T& x, const T& y) const
+        {
+            return x < y;
+        }
+
+        /**
+         * Return if string x sorts before string y.
+         */
+        bool_t operator()(const char_t* x, const char_t* y) const
+        {
+            return StringUtils::Strcmp(x, y) < 0;
+        }
+
+        /**
+         * Return if string x sorts before string y.
+         */
+        bool_t operator()(char_t* x, char_t* y) const
+        {
+            return StringUtils::Strcmp(x, y) < 0;
+        }
+    };
 }
 
 #endif /* CAPU_COMPARATOR_H */
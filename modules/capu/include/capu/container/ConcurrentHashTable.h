@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_CONCURRENTHASHTABLE_H
+#define CAPU_CONCURRENTHASHTABLE_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Array.h"
+#include "capu/container/HashTable.h"
+#include "capu/os/Mutex.h"
+#include "capu/util/ScopedLock.h"
+#include "capu/util/SmartPointer.h"
+
+//defines the amount of bits used to select the segment of a key
+#define DEFAULT_CONCURRENT_HASH_TABLE_SEGMENT_BIT_SIZE 4
+
+namespace capu
+{
+    /**
+     * Hash table for concurrent access. All methods are threadsafe.
+     *
+     * The keys are distributed over independent segments, each holding a HashTable
+     * guarded by its own Mutex. Threads working on keys of different segments do not
+     * wait for each other, so unlike one HashTable behind one lock the throughput
+     * grows with the number of threads.
+     *
+     * Values are copied in and out, references to values are never handed out
+     * because they could be changed or removed by other threads.
+     */
+    template <class Key, class T, class C = Comparator, class H = CapuDefaultHashFunction>
+    class ConcurrentHashTable
+    {
+    private:
+        class ConcurrentHashTableIterator;
+
+    public:
+        /**
+         * Weakly consistent iterator. Each segment is copied when the iterator reaches it,
+         * so the iterator never fails and never returns an entry twice, but it may or may
+         * not reflect the changes done by other threads while iterating.
+         */
+        typedef ConcurrentHashTableIterator Iterator;
+
+        /**
+         * Creates a table with 2^DEFAULT_CONCURRENT_HASH_TABLE_SEGMENT_BIT_SIZE segments
+         */
+        ConcurrentHashTable();
+
+        /**
+         * Creates a table with the given number of segments
+         * @param segmentBitSize the table has 2^segmentBitSize segments. Should be
+         *                       big enough to give every thread its own segment most of the time.
+         */
+        ConcurrentHashTable(const uint8_t segmentBitSize);
+
+        /**
+         * Puts a value into the table, an existing value for the key is replaced
+         * @param key the key
+         * @param value the new value
+         * @param oldValue receives the replaced value if not 0
+         * @return CAPU_OK if the value was put
+         *         CAPU_ENO_MEMORY if the segment could not grow
+         */
+        status_t put(const Key& key, const T& value, T* oldValue = 0);
+
+        /**
+         * Puts a value into the table only if the key is not contained yet.
+         * Checking and inserting is one atomic step.
+         * @param key the key
+         * @param value the value to insert
+         * @param existingValue receives the contained value if the key is already contained
+         * @return CAPU_OK if the value was inserted
+         *         CAPU_ERROR if the key is already contained
+         *         CAPU_ENO_MEMORY if the segment could not grow
+         */
+        status_t putIfAbsent(const Key& key, const T& value, T* existingValue = 0);
+
+        /**
+         * Copies the value of a key
+         * @param key the key
+         * @param value receives the value
+         * @return CAPU_OK if the key is contained
+         *         CAPU_ENOT_EXIST otherwise
+         */
+        status_t get(const Key& key, T& value) const;
+
+        /**
+         * Checks whether the key is contained
+         * @param key the key
+         * @return true if the key is contained
+         */
+        bool_t contains(const Key& key) const;
+
+        /**
+         * Updates the value of a key in one atomic step. The function is called with the
+         * segment of the key locked, so it must be short and must not access this table.
+         * @param key the key
+         * @param function is called as function(value) with a reference to the contained value,
+         *                 which it may change. If it returns false the entry is removed.
+         * @return CAPU_OK if the key was contained and the function was called
+         *         CAPU_ENOT_EXIST otherwise
+         */
+        template <class F>
+        status_t computeIfPresent(const Key& key, F& function);
+
+        /**
+         * Removes a key
+         * @param key the key
+         * @param oldValue receives the removed value if not 0
+         * @return CAPU_OK if the key was removed
+         *         CAPU_ERANGE if the key was not contained
+         */
+        status_t remove(const Key& key, T* oldValue = 0);
+
+        /**
+         * Returns the number of entries. Other threads may change it while
+         * the segments are counted one after the other.
+         * @return number of entries
+         */
+        uint_t count() const;
+
+        /**
+         * Removes all entries, one segment after the other
+         */
+        void clear();
+
+        /**
+         * Returns a weakly consistent iterator to the first entry
+         * @return iterator
+         */
+        Iterator begin() const;
+
+        /**
+         * Returns an iterator pointing after the last entry
+         * @return iterator
+         */
+        Iterator end() const;
+
+    private:
+        typedef HashTable<Key, T, C, H> SegmentTable;
+
+        struct Segment
+        {
+            Mutex mutex;
+            SegmentTable table;
+            char_t padding[CAPU_CACHE_LINE_SIZE]; // keeps the locks of neighboring segments on different cache lines
+        };
+
+        class ConcurrentHashTableIterator
+        {
+        public:
+            /**
+             * Get current iterator element.
+             * @return current element
+             */
+            const typename SegmentTable::HashTableEntry& operator*();
+
+            /**
+             * Get current iterator element.
+             * @return pointer to current element
+             */
+            const typename SegmentTable::HashTableEntry* operator->();
+
+            /**
+             * Step the iterator forward to the next element (prefix operator)
+             * @return the next iterator
+             */
+            ConcurrentHashTableIterator& operator++();
+
+            /**
+             * Step the iterator forward to the next element (postfix operator)
+             * @return the next iterator
+             */
+            ConcurrentHashTableIterator operator++(int32_t);
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators point to the same position
+             */
+            bool_t operator==(const ConcurrentHashTableIterator& other) const;
+
+            /**
+             * Compares two iterators
+             * @return true if the iterators do not point to the same position
+             */
+            bool_t operator!=(const ConcurrentHashTableIterator& other) const;
+
+        private:
+            friend class ConcurrentHashTable<Key, T, C, H>;
+
+            ConcurrentHashTableIterator(const ConcurrentHashTable& table, const uint_t segment);
+
+            void skipEmptySegments();
+
+            const ConcurrentHashTable* mTable;
+            uint_t mSegment;
+            SmartPointer<SegmentTable> mSnapshot; // shared by the copies of the iterator
+            typename SegmentTable::Iterator mCurrent;
+        };
+
+        // forbid copies, the segments can not be copied
+        ConcurrentHashTable(const ConcurrentHashTable& other);
+        ConcurrentHashTable& operator=(const ConcurrentHashTable& other);
+
+        Segment& segmentOf(const Key& key) const;
+
+        const uint8_t mSegmentBitCount;
+        Array<Segment, AlignedArrayStorage<Segment> > mSegments;
+    };
+
+    template <class Key, class T, class C, class H>
+    inline ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTable()
+        : mSegmentBitCount(DEFAULT_CONCURRENT_HASH_TABLE_SEGMENT_BIT_SIZE)
+        , mSegments(static_cast<uint_t>(1) << DEFAULT_CONCURRENT_HASH_TABLE_SEGMENT_BIT_SIZE)
+    {
+    }
+
+    template <class Key, class T, class C, class H>
+    inline ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTable(const uint8_t segmentBitSize)
+        : mSegmentBitCount(segmentBitSize)
+        , mSegments(static_cast<uint_t>(1) << segmentBitSize)
+    {
+    }
+
+    template <class Key, class T, class C, class H>
+    inline typename ConcurrentHashTable<Key, T, C, H>::Segment& ConcurrentHashTable<Key, T, C, H>::segmentOf(const Key& key) const
+    {
+        if (mSegmentBitCount == 0)
+        {
+            return mSegments[0];
+        }
+        // the segment tables use the lower bits of the digest for their buckets,
+        // so the segment is taken from the upper bits of a fibonacci multiplication
+        const uint_t mixed = H::Digest(key) * static_cast<uint_t>(sizeof(uint_t) == 8 ? 0x9E3779B97F4A7C15ULL : 0x9E3779B9UL);
+        return mSegments[mixed >> (sizeof(uint_t) * 8 - mSegmentBitCount)];
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t ConcurrentHashTable<Key, T, C, H>::put(const Key& key, const T& value, T* oldValue)
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        return segment.table.put(key, value, oldValue);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t ConcurrentHashTable<Key, T, C, H>::putIfAbsent(const Key& key, const T& value, T* existingValue)
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        typename SegmentTable::Iterator entry = segment.table.find(key);
+        if (entry != segment.table.end())
+        {
+            if (existingValue)
+            {
+                *existingValue = entry->value;
+            }
+            return CAPU_ERROR;
+        }
+        return segment.table.put(key, value);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t ConcurrentHashTable<Key, T, C, H>::get(const Key& key, T& value) const
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        typename SegmentTable::Iterator entry = segment.table.find(key);
+        if (entry == segment.table.end())
+        {
+            return CAPU_ENOT_EXIST;
+        }
+        value = entry->value;
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t ConcurrentHashTable<Key, T, C, H>::contains(const Key& key) const
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        return segment.table.contains(key);
+    }
+
+    template <class Key, class T, class C, class H>
+    template <class F>
+    inline status_t ConcurrentHashTable<Key, T, C, H>::computeIfPresent(const Key& key, F& function)
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        typename SegmentTable::Iterator entry = segment.table.find(key);
+        if (entry == segment.table.end())
+        {
+            return CAPU_ENOT_EXIST;
+        }
+        if (!function(entry->value))
+        {
+            segment.table.remove(entry);
+        }
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t ConcurrentHashTable<Key, T, C, H>::remove(const Key& key, T* oldValue)
+    {
+        Segment& segment = segmentOf(key);
+        ScopedMutexLock lock(segment.mutex);
+        return segment.table.remove(key, oldValue);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t ConcurrentHashTable<Key, T, C, H>::count() const
+    {
+        uint_t result = 0;
+        for (uint_t i = 0; i < mSegments.size(); ++i)
+        {
+            ScopedMutexLock lock(mSegments[i].mutex);
+            result += mSegments[i].table.count();
+        }
+        return result;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline void ConcurrentHashTable<Key, T, C, H>::clear()
+    {
+        for (uint_t i = 0; i < mSegments.size(); ++i)
+        {
+            ScopedMutexLock lock(mSegments[i].mutex);
+            mSegments[i].table.clear();
+        }
+    }
+
+    template <class Key, class T, class C, class H>
+    inline typename ConcurrentHashTable<Key, T, C, H>::Iterator ConcurrentHashTable<Key, T, C, H>::begin() const
+    {
+        return Iterator(*this, 0);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline typename ConcurrentHashTable<Key, T, C, H>::Iterator ConcurrentHashTable<Key, T, C, H>::end() const
+    {
+        return Iterator(*this, mSegments.size());
+    }
+
+    template <class Key, class T, class C, class H>
+    inline ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::ConcurrentHashTableIterator(const ConcurrentHashTable& table, const uint_t segment)
+        : mTable(&table)
+        , mSegment(segment)
+        , mSnapshot()
+        , mCurrent(0, 0)
+    {
+        skipEmptySegments();
+    }
+
+    template <class Key, class T, class C, class H>
+    inline void ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::skipEmptySegments()
+    {
+        while (mSegment < mTable->mSegments.size())
+        {
+            Segment& segment = mTable->mSegments[mSegment];
+            {
+                ScopedMutexLock lock(segment.mutex);
+                if (segment.table.count() > 0)
+                {
+                    mSnapshot = new SegmentTable(segment.table);
+                }
+            }
+            if (mSnapshot.get() != 0)
+            {
+                mCurrent = mSnapshot->begin();
+                return;
+            }
+            ++mSegment;
+        }
+        mCurrent = typename SegmentTable::Iterator(0, 0);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const typename HashTable<Key, T, C, H>::HashTableEntry& ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator*()
+    {
+        return *mCurrent;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const typename HashTable<Key, T, C, H>::HashTableEntry* ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator->()
+    {
+        return &(*mCurrent);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline typename ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator& ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator++()
+    {
+        ++mCurrent;
+        if (mCurrent == mSnapshot->end())
+        {
+            // the snapshot may still be used by copies of this iterator
+            mSnapshot = SmartPointer<SegmentTable>();
+            ++mSegment;
+            skipEmptySegments();
+        }
+        return *this;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline typename ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator++(int32_t)
+    {
+        ConcurrentHashTableIterator oldValue(*this);
+        ++(*this);
+        return oldValue;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator==(const ConcurrentHashTableIterator& other) const
+    {
+        return mSegment == other.mSegment && mCurrent == other.mCurrent;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t ConcurrentHashTable<Key, T, C, H>::ConcurrentHashTableIterator::operator!=(const ConcurrentHashTableIterator& other) const
+    {
+        return !(*this == other);
+    }
+}
+
+#endif // CAPU_CONCURRENTHASHTABLE_H
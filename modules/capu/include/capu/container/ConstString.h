@@ -200,7 +200,7 @@ namespace capu
     int_t 
     ConstString::find(const ConstString& substr) const
     {
-        return StringUtils::IndexOf(c_str(), substr);
+        return StringUtils::IndexOf(m_data, m_length, substr.m_data, substr.m_length);
     }
 
     inline 
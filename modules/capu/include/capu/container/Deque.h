@@ -0,0 +1,485 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAPU_DEQUE_H
+#define CAPU_DEQUE_H
+
+#include "capu/Error.h"
+#include "capu/Config.h"
+#include <new>
+
+namespace capu
+{
+    /**
+     * Double ended queue which stores its elements in fixed size contiguous chunks.
+     *
+     * Pushing and popping at both ends is O(1) and only touches the allocator when a
+     * chunk runs full or empty. One released chunk is kept for reuse, so a deque
+     * which is drained and refilled at a steady level does not allocate at all.
+     * The deque can be used as storage for Queue, Stack and BlockingQueue.
+     */
+    template <class T, uint32_t CHUNK_SIZE = 64>
+    class Deque
+    {
+    public:
+        /**
+         * Default Constructor
+         */
+        Deque();
+
+        /**
+         * Copy constructor
+         */
+        Deque(const Deque<T, CHUNK_SIZE>& other);
+
+        /**
+         * Destructor
+         */
+        virtual ~Deque();
+
+        /**
+         * Replaces the content of the deque with a copy of the other deque.
+         * @param other The deque to copy from.
+         * @return This deque.
+         */
+        Deque<T, CHUNK_SIZE>& operator=(const Deque<T, CHUNK_SIZE>& other);
+
+        /**
+         * Inserts element at the end of the deque
+         * @param element element that will be added
+         * @return CAPU_ENO_MEMORY if allocation of element is failed
+         *         CAPU_OK if the element is successfully added
+         */
+        status_t push_back(const T& element);
+
+        /**
+         * Inserts element at the begin of the deque
+         * @param element element that will be added
+         * @return CAPU_ENO_MEMORY if allocation of element is failed
+         *         CAPU_OK if the element is successfully added
+         */
+        status_t push_front(const T& element);
+
+        /**
+         * Deletes element at the end of the deque
+         * @return CAPU_EINVAL if deque was empty
+         *         CAPU_OK if the element is successfully deleted
+         */
+        status_t pop_back();
+
+        /**
+         * Deletes element at the begin of the deque
+         * @return CAPU_EINVAL if deque was empty
+         *         CAPU_OK if the element is successfully deleted
+         */
+        status_t pop_front();
+
+        /**
+         * Returns a reference to the first element in the deque
+         * @return reference to first element
+         */
+        T& front();
+
+        /**
+         * Returns a const reference to the first element in the deque
+         * @return const reference to first element
+         */
+        const T& front() const;
+
+        /**
+         * Returns a reference to the last element in the deque
+         * @return reference to the last element
+         */
+        T& back();
+
+        /**
+         * Returns a const reference to the last element in the deque
+         * @return const reference to the last element
+         */
+        const T& back() const;
+
+        /**
+         * Allows access of an element by its position counted from the front
+         * @param index the index of the element to retrieve
+         * @return reference to the element at the given position
+         */
+        T& operator[](const uint_t index);
+
+        /**
+         * Allows access of an element by its position counted from the front
+         * @param index the index of the element to retrieve
+         * @return const reference to the element at the given position
+         */
+        const T& operator[](const uint_t index) const;
+
+        /**
+         * Return the number of elements in the deque
+         * @return the number of elements in the deque
+         */
+        uint_t size() const;
+
+        /**
+         * Check the deque is empty or not
+         * @return true if empty
+         *         false otherwise
+         */
+        bool_t isEmpty() const;
+
+        /**
+         * Check whether the deque is empty or not
+         *
+         * this method ensures the compability to the STL interface
+         *
+         * @return true if empty
+         *         false otherwise
+         */
+        bool_t empty() const;
+
+        /**
+         * Removes all elements from the deque and releases all chunks
+         */
+        void clear();
+
+    private:
+        union Chunk
+        {
+            char_t data[sizeof(T) * CHUNK_SIZE];
+            uint64_t alignInteger;
+            double_t alignDouble;
+            void* alignPointer;
+        };
+
+        T* elementAt(const uint_t position) const;
+        Chunk* acquireChunk();
+        void releaseChunk(Chunk* chunk);
+        bool_t reserveMapSlot();
+        void destroyAll();
+
+        /**
+         * Circular array of chunk pointers. The capacity is always a power of two.
+         */
+        Chunk** mMap;
+        uint_t mMapCapacity;
+        uint_t mFirstChunk;
+        uint_t mChunkCount;
+
+        /**
+         * Offset of the first element inside the first chunk
+         */
+        uint_t mHead;
+        uint_t mSize;
+
+        /**
+         * Chunk kept for reuse after it has been released
+         */
+        Chunk* mSpareChunk;
+    };
+
+    /*
+     * Implementation
+     */
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline Deque<T, CHUNK_SIZE>::Deque()
+        : mMap(0)
+        , mMapCapacity(0)
+        , mFirstChunk(0)
+        , mChunkCount(0)
+        , mHead(0)
+        , mSize(0)
+        , mSpareChunk(0)
+    {
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline Deque<T, CHUNK_SIZE>::Deque(const Deque<T, CHUNK_SIZE>& other)
+        : mMap(0)
+        , mMapCapacity(0)
+        , mFirstChunk(0)
+        , mChunkCount(0)
+        , mHead(0)
+        , mSize(0)
+        , mSpareChunk(0)
+    {
+        for (uint_t i = 0; i < other.mSize; ++i)
+        {
+            push_back(other[i]);
+        }
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline Deque<T, CHUNK_SIZE>::~Deque()
+    {
+        clear();
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline Deque<T, CHUNK_SIZE>& Deque<T, CHUNK_SIZE>::operator=(const Deque<T, CHUNK_SIZE>& other)
+    {
+        if (this != &other)
+        {
+            destroyAll();
+            for (uint_t i = 0; i < other.mSize; ++i)
+            {
+                push_back(other[i]);
+            }
+        }
+        return *this;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline T* Deque<T, CHUNK_SIZE>::elementAt(const uint_t position) const
+    {
+        const uint_t absolute = mHead + position;
+        Chunk* chunk = mMap[(mFirstChunk + absolute / CHUNK_SIZE) & (mMapCapacity - 1)];
+        return reinterpret_cast<T*>(chunk->data) + (absolute % CHUNK_SIZE);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline typename Deque<T, CHUNK_SIZE>::Chunk* Deque<T, CHUNK_SIZE>::acquireChunk()
+    {
+        Chunk* chunk = mSpareChunk;
+        if (chunk != 0)
+        {
+            mSpareChunk = 0;
+            return chunk;
+        }
+        return new Chunk;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline void Deque<T, CHUNK_SIZE>::releaseChunk(Chunk* chunk)
+    {
+        if (mSpareChunk == 0)
+        {
+            mSpareChunk = chunk;
+        }
+        else
+        {
+            delete chunk;
+        }
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    bool_t Deque<T, CHUNK_SIZE>::reserveMapSlot()
+    {
+        if (mChunkCount < mMapCapacity)
+        {
+            return true;
+        }
+
+        const uint_t newCapacity = (mMapCapacity == 0) ? 8 : mMapCapacity * 2;
+        Chunk** newMap = new Chunk*[newCapacity];
+        if (newMap == 0)
+        {
+            return false;
+        }
+
+        // unroll the circular map so that the first chunk is at index 0 again
+        for (uint_t i = 0; i < mChunkCount; ++i)
+        {
+            newMap[i] = mMap[(mFirstChunk + i) & (mMapCapacity - 1)];
+        }
+        delete[] mMap;
+        mMap = newMap;
+        mMapCapacity = newCapacity;
+        mFirstChunk = 0;
+        return true;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    status_t Deque<T, CHUNK_SIZE>::push_back(const T& element)
+    {
+        if (mHead + mSize == mChunkCount * CHUNK_SIZE)
+        {
+            // last chunk is full
+            if (!reserveMapSlot())
+            {
+                return CAPU_ENO_MEMORY;
+            }
+            Chunk* chunk = acquireChunk();
+            if (chunk == 0)
+            {
+                return CAPU_ENO_MEMORY;
+            }
+            mMap[(mFirstChunk + mChunkCount) & (mMapCapacity - 1)] = chunk;
+            ++mChunkCount;
+        }
+
+        new(elementAt(mSize)) T(element);
+        ++mSize;
+        return CAPU_OK;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    status_t Deque<T, CHUNK_SIZE>::push_front(const T& element)
+    {
+        if (mHead == 0)
+        {
+            // first chunk is full
+            if (!reserveMapSlot())
+            {
+                return CAPU_ENO_MEMORY;
+            }
+            Chunk* chunk = acquireChunk();
+            if (chunk == 0)
+            {
+                return CAPU_ENO_MEMORY;
+            }
+            mFirstChunk = (mFirstChunk - 1) & (mMapCapacity - 1);
+            mMap[mFirstChunk] = chunk;
+            ++mChunkCount;
+            mHead = CHUNK_SIZE;
+        }
+
+        --mHead;
+        new(elementAt(0)) T(element);
+        ++mSize;
+        return CAPU_OK;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    status_t Deque<T, CHUNK_SIZE>::pop_front()
+    {
+        if (mSize == 0)
+        {
+            return CAPU_EINVAL;
+        }
+
+        elementAt(0)->~T();
+        ++mHead;
+        --mSize;
+
+        if (mHead == CHUNK_SIZE)
+        {
+            // first chunk drained
+            releaseChunk(mMap[mFirstChunk]);
+            mFirstChunk = (mFirstChunk + 1) & (mMapCapacity - 1);
+            --mChunkCount;
+            mHead = 0;
+        }
+        return CAPU_OK;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    status_t Deque<T, CHUNK_SIZE>::pop_back()
+    {
+        if (mSize == 0)
+        {
+            return CAPU_EINVAL;
+        }
+
+        elementAt(mSize - 1)->~T();
+        --mSize;
+
+        if (mHead + mSize <= (mChunkCount - 1) * CHUNK_SIZE)
+        {
+            // last chunk drained
+            releaseChunk(mMap[(mFirstChunk + mChunkCount - 1) & (mMapCapacity - 1)]);
+            --mChunkCount;
+            if (mChunkCount == 0)
+            {
+                mHead = 0;
+            }
+        }
+        return CAPU_OK;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline T& Deque<T, CHUNK_SIZE>::front()
+    {
+        return *elementAt(0);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline const T& Deque<T, CHUNK_SIZE>::front() const
+    {
+        return *elementAt(0);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline T& Deque<T, CHUNK_SIZE>::back()
+    {
+        return *elementAt(mSize - 1);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline const T& Deque<T, CHUNK_SIZE>::back() const
+    {
+        return *elementAt(mSize - 1);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline T& Deque<T, CHUNK_SIZE>::operator[](const uint_t index)
+    {
+        return *elementAt(index);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline const T& Deque<T, CHUNK_SIZE>::operator[](const uint_t index) const
+    {
+        return *elementAt(index);
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline uint_t Deque<T, CHUNK_SIZE>::size() const
+    {
+        return mSize;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline bool_t Deque<T, CHUNK_SIZE>::isEmpty() const
+    {
+        return mSize == 0;
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    inline bool_t Deque<T, CHUNK_SIZE>::empty() const
+    {
+        return isEmpty();
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    void Deque<T, CHUNK_SIZE>::destroyAll()
+    {
+        while (mSize > 0)
+        {
+            pop_back();
+        }
+    }
+
+    template <class T, uint32_t CHUNK_SIZE>
+    void Deque<T, CHUNK_SIZE>::clear()
+    {
+        destroyAll();
+
+        for (uint_t i = 0; i < mChunkCount; ++i)
+        {
+            delete mMap[(mFirstChunk + i) & (mMapCapacity - 1)];
+        }
+        delete mSpareChunk;
+        delete[] mMap;
+
+        mMap = 0;
+        mMapCapacity = 0;
+        mFirstChunk = 0;
+        mChunkCount = 0;
+        mHead = 0;
+        mSpareChunk = 0;
+    }
+}
+
+#endif // CAPU_DEQUE_H
@@ -0,0 +1,428 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FROZENHASHTABLE_H
+#define CAPU_FROZENHASHTABLE_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Array.h"
+#include "capu/container/Comparator.h"
+#include "capu/container/Hash.h"
+#include "capu/container/HashTable.h"
+
+namespace capu
+{
+    /**
+     * Immutable hash table for key sets which are known up front.
+     * The keys are placed with a minimal perfect hash (hash and displace, as in CHD):
+     * the keys are split into small groups and every group stores a 16 bit pilot which
+     * moves its keys to free positions. The positions range over about 3% more than count(),
+     * so the last groups still find free positions, and the keys placed behind count() are
+     * remapped to the slots left free in front. Every key has its own slot, so a lookup is
+     * one probe into a contiguous array of count() entries, plus one for remapped keys.
+     * Building costs a multiple of filling a HashTable, lookups and memory are cheaper.
+     */
+    template <class Key, class T, class C = Comparator, class H = CapuDefaultHashFunction>
+    class FrozenHashTable
+    {
+    public:
+        /**
+         * Key value pair in the table
+         */
+        struct Entry
+        {
+            Key key;
+            T value;
+        };
+
+        /**
+         * Creates an empty table
+         */
+        FrozenHashTable();
+
+        /**
+         * Builds the table from the contents of a HashTable. Replaces the previous contents.
+         * @return see build(const Key*, const T*, const uint_t)
+         */
+        status_t build(const HashTable<Key, T, C, H>& table);
+
+        /**
+         * Builds the table from arrays of keys and values. Replaces the previous contents.
+         * @param keys the keys, must not contain duplicates
+         * @param values the values, values[i] belongs to keys[i]
+         * @param count number of keys
+         * @return CAPU_OK if the table was built
+         *         CAPU_EINVAL if a key is contained twice
+         *         CAPU_ERROR if different keys have the same hash value of H
+         */
+        status_t build(const Key* keys, const T* values, const uint_t count);
+
+        /**
+         * Get the value associated with a key
+         * @param key the key
+         * @param returnCode optional, CAPU_OK if the key was found, CAPU_ENOT_EXIST otherwise
+         * @return the value, a default constructed one if the key was not found
+         */
+        const T& at(const Key& key, status_t* returnCode = 0) const;
+
+        /**
+         * Checks whether the key is contained in the table
+         */
+        bool_t contains(const Key& key) const;
+
+        /**
+         * Returns the number of entries
+         */
+        uint_t count() const;
+
+        /**
+         * Returns the number of bytes the table allocated
+         */
+        uint_t getMemoryUsage() const;
+
+        /**
+         * Entries for iteration, the order is the slot order and not related to the keys
+         * @{
+         */
+        const Entry* begin() const;
+        const Entry* end() const;
+        /**
+         * @}
+         */
+
+    private:
+        // average number of keys per pilot
+        static const uint_t KeysPerPilot = 4;
+        // global seeds tried before giving up
+        static const uint32_t MaxSeeds = 16;
+        // the positions exceed the slots by count / ExtraPositionsDivisor, a load factor of about 0.97
+        static const uint_t ExtraPositionsDivisor = 32;
+
+        Array<Entry> mEntries; // count() entries plus a default one for failed lookups
+        Array<uint16_t> mPilots;
+        Array<uint_t> mRemap; // slots of the positions from count() on
+        uint_t mCount;
+        uint_t mPositionCount;
+        uint64_t mSeed;
+        const C mComparator;
+
+        static uint64_t Mix(uint64_t value);
+        static uint_t Reduce(const uint64_t hash, const uint_t range);
+        uint64_t hashOf(const Key& key) const;
+        uint_t positionOf(const uint64_t hash) const;
+        uint_t slotOf(const uint64_t hash) const;
+        status_t place(const Array<uint64_t>& hashes, Array<uint_t>& slots);
+    };
+
+    template <class Key, class T, class C, class H>
+    inline FrozenHashTable<Key, T, C, H>::FrozenHashTable()
+        : mEntries(1, Entry())
+        , mPilots()
+        , mRemap()
+        , mCount(0)
+        , mPositionCount(0)
+        , mSeed(0)
+        , mComparator()
+    {
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint64_t FrozenHashTable<Key, T, C, H>::Mix(uint64_t value)
+    {
+        // finalizer of splitmix64
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t FrozenHashTable<Key, T, C, H>::Reduce(const uint64_t hash, const uint_t range)
+    {
+        // maps the upper 32 bits to [0, range) without a division
+        return static_cast<uint_t>(((hash >> 32) * static_cast<uint64_t>(range)) >> 32);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint64_t FrozenHashTable<Key, T, C, H>::hashOf(const Key& key) const
+    {
+        return Mix(static_cast<uint64_t>(H::Digest(key)) ^ mSeed);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t FrozenHashTable<Key, T, C, H>::positionOf(const uint64_t hash) const
+    {
+        const uint16_t pilot = mPilots[Reduce(hash, mPilots.size())];
+        return Reduce(Mix(hash ^ (pilot * 0x9e3779b97f4a7c15ULL)), mPositionCount);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t FrozenHashTable<Key, T, C, H>::slotOf(const uint64_t hash) const
+    {
+        const uint_t position = positionOf(hash);
+        return position < mCount ? position : mRemap[position - mCount];
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t FrozenHashTable<Key, T, C, H>::place(const Array<uint64_t>& hashes, Array<uint_t>& slots)
+    {
+        const uint_t count = hashes.size();
+        const uint_t pilotCount = mPilots.size();
+
+        // group the keys by pilot, counting sort
+        Array<uint_t> groupStart(pilotCount + 1, 0);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            ++groupStart[Reduce(hashes[i], pilotCount) + 1];
+        }
+        uint_t maxGroupSize = 0;
+        for (uint_t i = 0; i < pilotCount; ++i)
+        {
+            const uint_t size = groupStart[i + 1];
+            maxGroupSize = size > maxGroupSize ? size : maxGroupSize;
+            groupStart[i + 1] += groupStart[i];
+        }
+        Array<uint_t> groupKeys(count);
+        Array<uint_t> next(groupStart);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            groupKeys[next[Reduce(hashes[i], pilotCount)]++] = i;
+        }
+
+        // the largest groups are placed first while most slots are free, counting sort by size
+        Array<uint_t> sizeStart(maxGroupSize + 2, 0);
+        for (uint_t group = 0; group < pilotCount; ++group)
+        {
+            ++sizeStart[maxGroupSize - (groupStart[group + 1] - groupStart[group]) + 1];
+        }
+        for (uint_t i = 0; i <= maxGroupSize; ++i)
+        {
+            sizeStart[i + 1] += sizeStart[i];
+        }
+        Array<uint_t> groupOrder(pilotCount);
+        for (uint_t group = 0; group < pilotCount; ++group)
+        {
+            groupOrder[sizeStart[maxGroupSize - (groupStart[group + 1] - groupStart[group])]++] = group;
+        }
+
+        Array<uint8_t> taken(mPositionCount, 0);
+        Array<uint_t> candidates(maxGroupSize > 0 ? maxGroupSize : 1);
+        for (uint_t i = 0; i < pilotCount; ++i)
+        {
+            const uint_t group = groupOrder[i];
+            const uint_t first = groupStart[group];
+            const uint_t size = groupStart[group + 1] - first;
+            if (size == 0)
+            {
+                // no keys, the remaining groups are empty as well
+                break;
+            }
+
+            uint32_t pilot = 0;
+            for (; pilot <= 0xffff; ++pilot)
+            {
+                mPilots[group] = static_cast<uint16_t>(pilot);
+                uint_t placed = 0;
+                for (; placed < size; ++placed)
+                {
+                    const uint_t position = positionOf(hashes[groupKeys[first + placed]]);
+                    if (taken[position])
+                    {
+                        break;
+                    }
+                    taken[position] = 1;
+                    candidates[placed] = position;
+                }
+                if (placed == size)
+                {
+                    break;
+                }
+                // undo the partial placement
+                for (uint_t k = 0; k < placed; ++k)
+                {
+                    taken[candidates[k]] = 0;
+                }
+            }
+            if (pilot > 0xffff)
+            {
+                return CAPU_ERROR;
+            }
+            for (uint_t k = 0; k < size; ++k)
+            {
+                slots[groupKeys[first + k]] = candidates[k];
+            }
+        }
+
+        // there are as many keys behind count as free slots in front, pair them in order
+        uint_t freeSlot = 0;
+        for (uint_t position = count; position < mPositionCount; ++position)
+        {
+            if (taken[position])
+            {
+                while (taken[freeSlot])
+                {
+                    ++freeSlot;
+                }
+                mRemap[position - count] = freeSlot++;
+            }
+            else
+            {
+                mRemap[position - count] = 0;
+            }
+        }
+        for (uint_t i = 0; i < count; ++i)
+        {
+            if (slots[i] >= count)
+            {
+                slots[i] = mRemap[slots[i] - count];
+            }
+        }
+        return CAPU_OK;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t FrozenHashTable<Key, T, C, H>::build(const HashTable<Key, T, C, H>& table)
+    {
+        const uint_t count = table.count();
+        Array<Key> keys(count);
+        Array<T> values(count);
+        uint_t i = 0;
+        typename HashTable<Key, T, C, H>::Iterator current = table.begin();
+        const typename HashTable<Key, T, C, H>::Iterator end = table.end();
+        for (; current != end; ++current, ++i)
+        {
+            keys[i] = current->key;
+            values[i] = current->value;
+        }
+        return build(keys.getRawData(), values.getRawData(), count);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t FrozenHashTable<Key, T, C, H>::build(const Key* keys, const T* values, const uint_t count)
+    {
+        // keys with the same hash value of H can not be separated, find them first
+        {
+            HashTable<uint64_t, uint_t> digests;
+            digests.reserve(count);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                const uint64_t digest = H::Digest(keys[i]);
+                status_t found = CAPU_OK;
+                const uint_t other = digests.at(digest, &found);
+                if (found == CAPU_OK)
+                {
+                    return mComparator(keys[other], keys[i]) ? CAPU_EINVAL : CAPU_ERROR;
+                }
+                digests.put(digest, i);
+            }
+        }
+
+        mCount = count;
+        mPositionCount = count + count / ExtraPositionsDivisor + 1;
+        mPilots.setSize(count > 0 ? (count + KeysPerPilot - 1) / KeysPerPilot : 1);
+        mPilots.setRawData(0);
+        mRemap.setSize(mPositionCount - count);
+
+        Array<uint64_t> hashes(count);
+        Array<uint_t> slots(count);
+        status_t status = CAPU_ERROR;
+        for (uint32_t seed = 0; seed < MaxSeeds && status != CAPU_OK; ++seed)
+        {
+            mSeed = Mix(seed + 1);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                hashes[i] = hashOf(keys[i]);
+            }
+            status = place(hashes, slots);
+        }
+
+        Array<Entry> entries(count + 1);
+        entries[count] = Entry();
+        if (status == CAPU_OK)
+        {
+            for (uint_t i = 0; i < count; ++i)
+            {
+                entries[slots[i]].key = keys[i];
+                entries[slots[i]].value = values[i];
+            }
+        }
+        else
+        {
+            mCount = 0;
+        }
+        mEntries.swap(entries);
+        return status;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const T& FrozenHashTable<Key, T, C, H>::at(const Key& key, status_t* returnCode) const
+    {
+        if (mCount > 0)
+        {
+            const Entry& entry = mEntries[slotOf(hashOf(key))];
+            if (mComparator(entry.key, key))
+            {
+                if (returnCode)
+                {
+                    *returnCode = CAPU_OK;
+                }
+                return entry.value;
+            }
+        }
+
+        if (returnCode)
+        {
+            *returnCode = CAPU_ENOT_EXIST;
+        }
+        return mEntries[mCount].value;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t FrozenHashTable<Key, T, C, H>::contains(const Key& key) const
+    {
+        return mCount > 0 && mComparator(mEntries[slotOf(hashOf(key))].key, key);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t FrozenHashTable<Key, T, C, H>::count() const
+    {
+        return mCount;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t FrozenHashTable<Key, T, C, H>::getMemoryUsage() const
+    {
+        return mEntries.size() * sizeof(Entry) + mPilots.size() * sizeof(uint16_t) + mRemap.size() * sizeof(uint_t);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const typename FrozenHashTable<Key, T, C, H>::Entry* FrozenHashTable<Key, T, C, H>::begin() const
+    {
+        return mEntries.getRawData();
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const typename FrozenHashTable<Key, T, C, H>::Entry* FrozenHashTable<Key, T, C, H>::end() const
+    {
+        return mEntries.getRawData() + mCount;
+    }
+}
+
+#endif // CAPU_FROZENHASHTABLE_H
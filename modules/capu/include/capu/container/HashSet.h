@@ -17,6 +17,7 @@
 #ifndef CAPU_HASHSET_H
 #define CAPU_HASHSET_H
 
+#include "capu/container/Array.h"
 #include "capu/container/Hash.h"
 #include "capu/container/HashTable.h"
 
@@ -24,6 +25,20 @@ namespace capu
 {
     /**
      * Unordered set of objects with fast lookup and retrieval.
+     * The values are stored with open addressing and linear probing in one array of values
+     * and one array of control bytes. A control byte is 0 for a free slot and otherwise
+     * holds 7 bits of the hash of the value, so most mismatches are rejected without
+     * calling the comparator. Removing shifts the following values back instead of
+     * leaving tombstones, so lookups never get slower by removing.
+     *
+     * Free slots hold default constructed values, so T has to be default constructible and
+     * every slot costs sizeof(T) even when it is free. remove() and clear() assign T() to the
+     * slots they free, which releases the resources the removed values held.
+     *
+     * put() may rehash and invalidates all iterators. remove() moves later values into the
+     * freed slot and may move values from the start of the array to its end, so removing
+     * while iterating can skip values or visit them twice. Collect the values to remove and
+     * remove them after the iteration.
      */
     template <class T, class C = Comparator, class H = CapuDefaultHashFunction>
     class HashSet
@@ -34,10 +49,7 @@ namespace capu
         public:
 
             /**
-             * constructor
-             *
-             * @param list     array of linked list which provide channing for hash set
-             * @param listSize size of hash set (size of linked list array)
+             * Copy constructor
              */
             HashSetIterator(const HashSetIterator& iter);
 
@@ -46,68 +58,55 @@ namespace capu
              */
             ~HashSetIterator();
 
+            /**
+             * Assignment operator
+             */
             HashSetIterator& operator=(const HashSetIterator& iter);
 
             /**
-             * Indirection
-             * @return the current value referenced by the iterator
+             * Get current iterator element.
+             * @return current element
              */
             const T& operator*();
 
             /**
-             * Dereference
-             * @return a pointer to the current object the iterator points to
+             * Get current iterator element.
+             * @return pointer to current element
              */
             const T* operator->();
 
             /**
-             * Compares two iterators
-             * @return true if the iterators point to the same position
+             * Check if two iterators point to the same element
              */
             capu::bool_t operator==(const HashSetIterator& iter) const;
 
             /**
-             * Compares two iterators
-             * @return true if the iterators do not point to the same position
+             * Check if two iterators point to different elements
              */
             capu::bool_t operator!=(const HashSetIterator& iter) const;
 
             /**
-             * Step the iterator forward to the next element (prefix operator)
-             * @return the next iterator
+             * Step to the next element
+             * @{
              */
             const HashSetIterator& operator++() const;
-
-            /**
-             * Step the iterator forward to the next element (prefix operator)
-             * @return the next iterator
-             */
             HashSetIterator& operator++();
-
-            /**
-             * Step the iterator forward to the next element (postfix operator)
-             * @return the next iterator
-             */
             const HashSetIterator operator++(int32_t) const;
-
+            HashSetIterator operator++(int32_t);
             /**
-             * Step the iterator forward to the next element (postfix operator)
-             * @return the next iterator
+             * @}
              */
-            HashSetIterator operator++(int32_t);
 
         private:
-
             friend class HashSet<T, C, H>;
 
             /**
-             * Internal constructor for HashSet
-             *
-             * @para iter iterator of the underlying hashtable
+             * Internal constructor for HashSet, moves to the first used slot from index
              */
-            HashSetIterator(const typename HashTable<T, char_t, C, H>::Iterator& iter);
+            HashSetIterator(const HashSet<T, C, H>& set, const uint_t index);
 
-            typename HashTable<T, char_t, C, H>::Iterator m_iter;
+            const HashSet<T, C, H>* m_set;
+            mutable uint_t m_index;
         };
 
     public:
@@ -133,6 +132,11 @@ namespace capu
          */
         HashSet(const HashSet& other);
 
+        /**
+         * Assignment operator
+         */
+        HashSet& operator=(const HashSet& other);
+
         /**
          * Destructor
          */
@@ -184,6 +188,17 @@ namespace capu
          */
         status_t clear();
 
+        /**
+         * Grows the set so that it holds at least count values without rehashing.
+         * @param count number of values the set should hold
+         */
+        void reserve(const uint_t count);
+
+        /**
+         * Returns the number of bytes allocated for the values and control bytes
+         */
+        uint_t getMemoryUsage() const;
+
         /**
          * Return iterator for iterating key value tuples.
          * @return Iterator
@@ -197,18 +212,50 @@ namespace capu
         const Iterator end() const;
 
     private:
-        HashTable<T, char_t, C, H> m_table;
+        // a control byte of a used slot has the upper bit set and 7 bits of the hash
+        static const uint8_t UsedFlag = 0x80;
+        static const uint8_t TagBits = 7;
+
+        Array<T> m_values;
+        Array<uint8_t> m_control;
+        uint_t m_count;
+        uint8_t m_bitCount;
+        const C m_comparator;
+
+        uint_t mask() const;
+        uint_t calcHashValue(const T& value, uint8_t& control) const;
+        bool_t findSlot(const T& value, uint_t& slot, uint8_t& control) const;
+        bool_t isFull() const;
+        void rehash(const uint8_t bitCount);
     };
 
     template <class T, class C, class H>
     HashSet<T, C, H>::HashSet(const HashSet& other)
-        : m_table(other.m_table) // just copy the inner hash table (which defines a copy constructor)
+        : m_values(other.m_values)
+        , m_control(other.m_control)
+        , m_count(other.m_count)
+        , m_bitCount(other.m_bitCount)
+        , m_comparator()
+    {
+    }
+
+    template <class T, class C, class H>
+    HashSet<T, C, H>& HashSet<T, C, H>::operator=(const HashSet& other)
     {
+        m_values = other.m_values;
+        m_control = other.m_control;
+        m_count = other.m_count;
+        m_bitCount = other.m_bitCount;
+        return *this;
     }
 
     template <class T, class C, class H>
     HashSet<T, C, H>::HashSet()
-        : m_table(DEFAULT_HASH_SET_BIT_SIZE)
+        : m_values(static_cast<uint_t>(1) << DEFAULT_HASH_SET_BIT_SIZE)
+        , m_control(static_cast<uint_t>(1) << DEFAULT_HASH_SET_BIT_SIZE, 0)
+        , m_count(0)
+        , m_bitCount(DEFAULT_HASH_SET_BIT_SIZE)
+        , m_comparator()
     {
     }
 
@@ -219,66 +266,208 @@ namespace capu
 
     template <class T, class C, class H>
     HashSet<T, C, H>::HashSet(const uint8_t bitsize)
-        : m_table(bitsize)
+        : m_values(static_cast<uint_t>(1) << bitsize)
+        , m_control(static_cast<uint_t>(1) << bitsize, 0)
+        , m_count(0)
+        , m_bitCount(bitsize)
+        , m_comparator()
+    {
+    }
+
+    template <class T, class C, class H>
+    inline uint_t HashSet<T, C, H>::mask() const
     {
+        return m_control.size() - 1;
+    }
+
+    template <class T, class C, class H>
+    inline uint_t HashSet<T, C, H>::calcHashValue(const T& value, uint8_t& control) const
+    {
+        // the digests of integers are close to the identity, which would build long runs of
+        // consecutive slots with linear probing, so they are spread by a fibonacci multiplication.
+        // the top bits of the product select the slot and the bits below provide the tag
+        const uint8_t wordBits = sizeof(uint_t) * 8;
+        const uint_t mixed = H::Digest(value) * static_cast<uint_t>(sizeof(uint_t) == 8 ? 0x9E3779B97F4A7C15ULL : 0x9E3779B9UL);
+        const uint_t tag = m_bitCount + TagBits <= wordBits ? mixed >> (wordBits - m_bitCount - TagBits) : mixed;
+        control = static_cast<uint8_t>(UsedFlag | (tag & (UsedFlag - 1)));
+        return m_bitCount > 0 ? mixed >> (wordBits - m_bitCount) : 0;
+    }
+
+    template <class T, class C, class H>
+    inline bool_t HashSet<T, C, H>::findSlot(const T& value, uint_t& slot, uint8_t& control) const
+    {
+        slot = calcHashValue(value, control);
+        while (m_control[slot] != 0)
+        {
+            if (m_control[slot] == control && m_comparator(m_values[slot], value))
+            {
+                return true;
+            }
+            slot = (slot + 1) & mask();
+        }
+        return false;
+    }
+
+    template <class T, class C, class H>
+    inline bool_t HashSet<T, C, H>::isFull() const
+    {
+        // the maximum load is 3/4, linear probing gets slow above
+        return (m_count + 1) * 4 > m_control.size() * 3;
+    }
+
+    template <class T, class C, class H>
+    void HashSet<T, C, H>::rehash(const uint8_t bitCount)
+    {
+        Array<T> oldValues(static_cast<uint_t>(1) << bitCount);
+        Array<uint8_t> oldControl(static_cast<uint_t>(1) << bitCount, 0);
+        m_values.swap(oldValues);
+        m_control.swap(oldControl);
+        m_bitCount = bitCount;
+
+        for (uint_t i = 0; i < oldControl.size(); ++i)
+        {
+            if (oldControl[i] != 0)
+            {
+                uint8_t control = 0;
+                uint_t slot = calcHashValue(oldValues[i], control);
+                while (m_control[slot] != 0)
+                {
+                    slot = (slot + 1) & mask();
+                }
+                m_control[slot] = control;
+                m_values[slot] = oldValues[i];
+            }
+        }
     }
 
     template <class T, class C, class H>
     status_t HashSet<T, C, H>::put(const T& value)
     {
-        if (m_table.contains(value))
+        uint_t slot = 0;
+        uint8_t control = 0;
+        if (findSlot(value, slot, control))
         {
             return CAPU_ERROR;
         }
-        return m_table.put(value, 0);
+        if (isFull())
+        {
+            rehash(m_bitCount + 1);
+            findSlot(value, slot, control);
+        }
+
+        m_control[slot] = control;
+        m_values[slot] = value;
+        ++m_count;
+        return CAPU_OK;
     }
 
     template <class T, class C, class H>
     status_t HashSet<T, C, H>::remove(const T& value)
     {
-        return m_table.remove(value);
+        uint_t slot = 0;
+        uint8_t control = 0;
+        if (!findSlot(value, slot, control))
+        {
+            return CAPU_ERANGE;
+        }
+
+        // shift back the following values of the probe sequence which may move into the gap
+        uint_t gap = slot;
+        uint_t current = (slot + 1) & mask();
+        while (m_control[current] != 0)
+        {
+            const uint_t home = calcHashValue(m_values[current], control);
+            // the value may move if its home slot is not in the cyclic range (gap, current]
+            if (((current - home) & mask()) >= ((current - gap) & mask()))
+            {
+                m_values[gap] = m_values[current];
+                m_control[gap] = m_control[current];
+                gap = current;
+            }
+            current = (current + 1) & mask();
+        }
+        m_control[gap] = 0;
+        m_values[gap] = T();
+        --m_count;
+        return CAPU_OK;
     }
 
     template <class T, class C, class H>
     bool_t HashSet<T, C, H>::hasElement(const T& value) const
     {
-        return m_table.contains(value);
+        uint_t slot = 0;
+        uint8_t control = 0;
+        return findSlot(value, slot, control);
     }
 
     template <class T, class C, class H>
     uint_t HashSet<T, C, H>::count() const
     {
-        return m_table.count();
+        return m_count;
     }
 
     template <class T, class C, class H>
     status_t HashSet<T, C, H>::clear()
     {
-        m_table.clear();
+        for (uint_t i = 0; i < m_control.size(); ++i)
+        {
+            if (m_control[i] != 0)
+            {
+                m_values[i] = T();
+            }
+        }
+        m_control.setRawData(0);
+        m_count = 0;
         return CAPU_OK;
     }
 
+    template <class T, class C, class H>
+    void HashSet<T, C, H>::reserve(const uint_t count)
+    {
+        uint8_t bitCount = m_bitCount;
+        while (count * 4 > (static_cast<uint_t>(3) << bitCount))
+        {
+            ++bitCount;
+        }
+        if (bitCount != m_bitCount)
+        {
+            rehash(bitCount);
+        }
+    }
+
+    template <class T, class C, class H>
+    uint_t HashSet<T, C, H>::getMemoryUsage() const
+    {
+        return m_control.size() * (sizeof(T) + sizeof(uint8_t));
+    }
+
     template <class T, class C, class H>
     typename HashSet<T, C, H>::Iterator HashSet<T, C, H>::begin() const
     {
-        return Iterator(m_table.begin());
+        return Iterator(*this, 0);
     }
 
     template <class T, class C, class H>
     const typename HashSet<T, C, H>::Iterator HashSet<T, C, H>::end() const
     {
-        return Iterator(m_table.end());
+        return Iterator(*this, m_control.size());
     }
 
     template <class T, class C, class H>
-    HashSet<T, C, H>::HashSetIterator::HashSetIterator(const typename HashTable<T, char_t, C, H>::Iterator& iter)
-        : m_iter(iter)
+    HashSet<T, C, H>::HashSetIterator::HashSetIterator(const HashSet<T, C, H>& set, const uint_t index)
+        : m_set(&set)
+        , m_index(index)
     {
+        while (m_index < m_set->m_control.size() && m_set->m_control[m_index] == 0)
+        {
+            ++m_index;
+        }
     }
 
     template <class T, class C, class H>
     HashSet<T, C, H>::HashSetIterator::HashSetIterator(const HashSetIterator& iter)
-        : m_iter(iter.m_iter)
+        : m_set(iter.m_set)
+        , m_index(iter.m_index)
     {
     }
 
@@ -290,47 +479,51 @@ namespace capu
     template <class T, class C, class H>
     typename HashSet<T, C, H>::HashSetIterator& HashSet<T, C, H>::HashSetIterator::operator=(const HashSetIterator& iter)
     {
-        m_iter = iter.m_iter;
+        m_set = iter.m_set;
+        m_index = iter.m_index;
         return *this;
     }
 
     template <class T, class C, class H>
     const T& HashSet<T, C, H>::HashSetIterator::operator*()
     {
-        typename HashTable<T, char_t, C, H>::HashTableEntry& entry = *m_iter;
-        return entry.key;
+        return m_set->m_values[m_index];
     }
 
     template <class T, class C, class H>
     const T* HashSet<T, C, H>::HashSetIterator::operator->()
     {
-        const typename HashTable<T, char_t, C, H>::HashTableEntry& entry = *m_iter;
-        return &(entry.key);
+        return &m_set->m_values[m_index];
     }
 
     template <class T, class C, class H>
     capu::bool_t HashSet<T, C, H>::HashSetIterator::operator==(const HashSetIterator& iter) const
     {
-        return m_iter == iter.m_iter;
+        return m_index == iter.m_index;
     }
 
     template <class T, class C, class H>
     capu::bool_t HashSet<T, C, H>::HashSetIterator::operator!=(const HashSetIterator& iter) const
     {
-        return m_iter != iter.m_iter;
+        return m_index != iter.m_index;
     }
 
     template <class T, class C, class H>
     const typename HashSet<T, C, H>::HashSetIterator& HashSet<T, C, H>::HashSetIterator::operator++() const
     {
-        m_iter++;
+        do
+        {
+            ++m_index;
+        }
+        while (m_index < m_set->m_control.size() && m_set->m_control[m_index] == 0);
         return *this;
     }
 
     template <class T, class C, class H>
     typename HashSet<T, C, H>::HashSetIterator& HashSet<T, C, H>::HashSetIterator::operator++()
     {
-        m_iter++;
+        const HashSetIterator& self = *this;
+        ++self;
         return *this;
     }
 
@@ -56,8 +56,7 @@ namespace capu
                 , key(internalKey)
                 , next(0)
                 , previous(0)
-                , isChainElement(0)
-
+                , hash(0)
             {
                 // 'preconnect' free entries
                 next = this + 1;
@@ -69,7 +68,7 @@ namespace capu
                 value = other.value;
                 next = other.next;
                 previous = other.previous;
-                isChainElement = other.isChainElement;
+                hash = other.hash;
                 return *this;
             }
 
@@ -79,20 +78,20 @@ namespace capu
                 , key(internalKey)
                 , next(other.next)
                 , previous(other.previous)
-                , isChainElement(other.isChainElement)
+                , hash(other.hash)
             {
             }
 
             T value;
 
         private:
-            Key internalKey; // private non const key
+            Key internalKey; // private non const key, the stored digest and bucket depend on it
         public:
             const Key& key; // public const reference to the key
         private:
             HashTableEntry* next; // pointer to the next entry (chaining)
             HashTableEntry* previous; // pointer to the previous entry (chaining)
-            uint8_t isChainElement; // true if the element is not the first element in a chain
+            uint_t hash; // full digest of the key, compared before the keys and reused for rehashing
 
             friend class HashTable<Key, T, C, H>;
         };
@@ -271,6 +270,21 @@ namespace capu
          */
         Iterator find(const Key& key) const;
 
+        /**
+         * Looks up many keys at once. The buckets and entries of all keys are prefetched
+         * before any of them is resolved, so the cache misses of the keys overlap instead
+         * of being waited for one after the other. Worth it for big tables which do not fit
+         * into the cache.
+         *
+         * NOTE: Not STL compatible
+         *
+         * @param keys      the keys to look up
+         * @param count     number of keys
+         * @param results   receives for each key a pointer to its value or 0 if the key is not contained
+         * @return number of keys which were found
+         */
+        uint_t findMany(const Key keys[], const uint_t count, T* results[]) const;
+
         /**
          * Checks weather the given key is present in the table.
          *
@@ -315,6 +329,15 @@ namespace capu
          */
         void clear();
 
+        /**
+         * Grows the table so that it holds at least count entries without rehashing.
+         * Does nothing if the table is already large enough.
+         * @param count number of entries the table should hold
+         * @return CAPU_OK if the table can hold count entries
+         *         CAPU_ENO_MEMORY if the table is not resizeable and too small
+         */
+        status_t reserve(const uint_t count);
+
         /**
          * Returns an iterator for iterating over the key and values in the map.
          * @return Iterator
@@ -350,10 +373,13 @@ namespace capu
         const C mComparator; // compares keys
 
         void rehash();
+        void rehash(const uint8_t bitCount);
         uint_t calcHashValue(const Key& key) const;
+        uint_t calcBucket(const uint_t hashValue) const;
+        bool_t isInBucket(const HashTableEntry* entry, const uint_t bucket) const;
         HashTableEntry* internalGet(const Key& key) const;
-        void internalPut(HashTableEntry* entry, uint_t hashValue);
-        void internalRemove(HashTableEntry* entry, const uint_t hashValue, T* value_old = 0);
+        void internalPut(HashTableEntry* entry);
+        void internalRemove(HashTableEntry* entry, T* value_old = 0);
     };
 
     template <class Key, class T, class C, class H>
@@ -399,7 +425,8 @@ namespace capu
         {
             mFirstFreeHashMapEntry->internalKey = iter->key;
             mFirstFreeHashMapEntry->value = iter->value;
-            internalPut(mFirstFreeHashMapEntry, calcHashValue(iter->key));
+            mFirstFreeHashMapEntry->hash = iter->hash;
+            internalPut(mFirstFreeHashMapEntry);
             ++iter;
             ++mFirstFreeHashMapEntry;
         }
@@ -491,7 +518,21 @@ namespace capu
     template <class Key, class T, class C, class H>
     inline uint_t HashTable<Key, T, C, H>::calcHashValue(const Key& key) const
     {
-        return H::Digest(key, mBitCount);
+        return H::Digest(key);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline uint_t HashTable<Key, T, C, H>::calcBucket(const uint_t hashValue) const
+    {
+        // fold the upper bits in, like the resizers of the hash functions do
+        return ((hashValue >> mBitCount) ^ hashValue) & (mSize - 1);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t HashTable<Key, T, C, H>::isInBucket(const HashTableEntry* entry, const uint_t bucket) const
+    {
+        // the entries of a bucket follow each other in the list of all entries
+        return entry != mLastHashMapEntry && calcBucket(entry->hash) == bucket;
     }
 
     template <class Key, class T, class C, class H>
@@ -511,15 +552,16 @@ namespace capu
     template <class Key, class T, class C, class H>
     inline status_t HashTable<Key, T, C, H>::put(const Key& key, const T& value, T* oldValue)
     {
-        uint_t hashValue = calcHashValue(key);
+        const uint_t hashValue = calcHashValue(key);
+        const uint_t bucket = calcBucket(hashValue);
 
         // check if we already have the key in the map, if so, just override the value
-        HashTableEntry* current = mBuckets[hashValue];
+        HashTableEntry* current = mBuckets[bucket];
         if (current)
         {
             do
             {
-                if (mComparator(current->key, key))
+                if (current->hash == hashValue && mComparator(current->key, key))
                 {
                     if (oldValue)
                     {
@@ -530,7 +572,7 @@ namespace capu
                 }
                 current = current->next;
             }
-            while (current->isChainElement);
+            while (isInBucket(current, bucket));
         }
 
         // check if the next free entry is outside of the threshold (resizing would be necessary)
@@ -542,7 +584,6 @@ namespace capu
                 return CAPU_ENO_MEMORY;
             }
             rehash();
-            hashValue = calcHashValue(key); // calculate the new index (in the resized map)
         }
 
         // the entry holding the values is the first free entry
@@ -553,8 +594,9 @@ namespace capu
 
         newentry->internalKey = key;   // copy operation
         newentry->value = value; // copy operation
+        newentry->hash = hashValue;
 
-        internalPut(newentry, hashValue);
+        internalPut(newentry);
 
         // done
         return CAPU_OK;
@@ -616,25 +658,81 @@ namespace capu
         return end();
     }
 
+    template <class Key, class T, class C, class H>
+    uint_t HashTable<Key, T, C, H>::findMany(const Key keys[], const uint_t count, T* results[]) const
+    {
+        // keys are processed in batches, so the state of the batch stays on the stack
+        const uint_t batchSize = 32;
+        uint_t hashValues[batchSize];
+        uint_t buckets[batchSize];
+        HashTableEntry* entries[batchSize];
+
+        uint_t found = 0;
+        for (uint_t first = 0; first < count; first += batchSize)
+        {
+            const uint_t size = count - first < batchSize ? count - first : batchSize;
+            const Key* batchKeys = keys + first;
+
+            for (uint_t i = 0; i < size; ++i)
+            {
+                hashValues[i] = calcHashValue(batchKeys[i]);
+                buckets[i] = calcBucket(hashValues[i]);
+                Memory::Prefetch(mBuckets + buckets[i]);
+            }
+
+            for (uint_t i = 0; i < size; ++i)
+            {
+                entries[i] = mBuckets[buckets[i]];
+                if (entries[i])
+                {
+                    Memory::Prefetch(entries[i]);
+                }
+            }
+
+            T** batchResults = results + first;
+            for (uint_t i = 0; i < size; ++i)
+            {
+                batchResults[i] = 0;
+                HashTableEntry* current = entries[i];
+                if (current)
+                {
+                    do
+                    {
+                        if (current->hash == hashValues[i] && mComparator(current->key, batchKeys[i]))
+                        {
+                            batchResults[i] = &current->value;
+                            ++found;
+                            break;
+                        }
+                        current = current->next;
+                    }
+                    while (isInBucket(current, buckets[i]));
+                }
+            }
+        }
+        return found;
+    }
+
     template <class Key, class T, class C, class H>
     inline status_t HashTable<Key, T, C, H>::remove(const Key& key, T* value_old)
     {
         const uint_t hashValue = calcHashValue(key);
-        HashTableEntry* current = mBuckets[hashValue];
+        const uint_t bucket = calcBucket(hashValue);
+        HashTableEntry* current = mBuckets[bucket];
         if (current)
         {
             do
             {
-                if (mComparator(current->key, key))
+                if (current->hash == hashValue && mComparator(current->key, key))
                 {
-                    internalRemove(current, hashValue, value_old);
+                    internalRemove(current, value_old);
 
                     // done
                     return CAPU_OK;
                 }
                 current = current->next;
             }
-            while (current->isChainElement);
+            while (isInBucket(current, bucket));
         }
 
         // element was not found
@@ -645,18 +743,17 @@ namespace capu
     inline status_t HashTable<Key, T, C, H>::remove(Iterator& iter, T* value_old)
     {
         HashTableEntry* current = iter.mCurrentHashMapEntry;
-        uint_t hashValue = calcHashValue(current->key);
 
         iter.mCurrentHashMapEntry = current->next;
 
-        internalRemove(current, hashValue, value_old);
+        internalRemove(current, value_old);
 
         // done
         return CAPU_OK;
     }
 
     template <class Key, class T, class C, class H>
-    inline void HashTable<Key, T, C, H>::internalRemove(HashTableEntry* entry, const uint_t hashValue, T* value_old)
+    inline void HashTable<Key, T, C, H>::internalRemove(HashTableEntry* entry, T* value_old)
     {
         if (value_old)
         {
@@ -668,10 +765,10 @@ namespace capu
         // so that the current element is taken out of the chain
         entry->previous->next = entry->next;
         entry->next->previous = entry->previous;
-        if (mBuckets[hashValue] == entry)
+        const uint_t bucket = calcBucket(entry->hash);
+        if (mBuckets[bucket] == entry)
         {
-            mBuckets[hashValue] = entry->next && entry->next->isChainElement ? entry->next : 0;
-            entry->next->isChainElement = 0;
+            mBuckets[bucket] = isInBucket(entry->next, bucket) ? entry->next : 0;
         }
 
         // connect the unused entries:
@@ -694,7 +791,6 @@ namespace capu
         {
             entry->previous = 0;
             entry->next = entry + 1;
-            entry->isChainElement = 0;
             ++entry;
         }
         mFirstFreeHashMapEntry = mData;
@@ -703,6 +799,27 @@ namespace capu
         mCount = 0;
     }
 
+    template <class Key, class T, class C, class H>
+    inline status_t HashTable<Key, T, C, H>::reserve(const uint_t count)
+    {
+        if (count <= mThreshold)
+        {
+            return CAPU_OK;
+        }
+        if (!mResizeable)
+        {
+            return CAPU_ENO_MEMORY;
+        }
+
+        uint8_t bitCount = mBitCount + 1;
+        while (static_cast<uint_t>((static_cast<uint_t>(1) << bitCount) * DEFAULT_HASH_TABLE_MAX_LOAD_FACTOR) < count)
+        {
+            ++bitCount;
+        }
+        rehash(bitCount);
+        return CAPU_OK;
+    }
+
     template <class Key, class T, class C, class H>
     inline typename HashTable<Key, T, C, H>::Iterator HashTable<Key, T, C, H>::begin() const
     {
@@ -785,43 +902,40 @@ namespace capu
     inline typename HashTable<Key, T, C, H>::HashTableEntry* HashTable<Key, T, C, H>::internalGet(const Key& key) const
     {
         const uint_t hashValue = calcHashValue(key);
-        HashTableEntry* current = mBuckets[hashValue];
+        const uint_t bucket = calcBucket(hashValue);
+        HashTableEntry* current = mBuckets[bucket];
         if (current)
         {
             do
             {
-                if (mComparator(current->key, key))
+                // the comparator is only called for equal digests
+                if (current->hash == hashValue && mComparator(current->key, key))
                 {
                     return current;
                 }
                 current = current->next;
             }
-            while (current->isChainElement);
+            while (isInBucket(current, bucket));
         }
 
         return 0;
     }
 
     template <class Key, class T, class C, class H>
-    inline void HashTable<Key, T, C, H>::internalPut(HashTableEntry* newentry, const uint_t hashValue)
+    inline void HashTable<Key, T, C, H>::internalPut(HashTableEntry* newentry)
     {
         // chaining of entries
-        HashTableEntry* entry = mBuckets[hashValue];
-        if (entry)
-        {
-            // chaining
-            entry->isChainElement = 1;
-        }
-        else
+        const uint_t bucket = calcBucket(newentry->hash);
+        HashTableEntry* entry = mBuckets[bucket];
+        if (!entry)
         {
             // we hit a free bucket
             entry = mLastHashMapEntry->next;
         }
 
-        mBuckets[hashValue]   = newentry;
+        mBuckets[bucket]      = newentry;
         newentry->next        = entry;
         newentry->previous    = entry->previous;
-        newentry->isChainElement = 0;
         entry->previous->next = newentry;
         entry->previous       = newentry;
         ++mCount;
@@ -853,11 +967,11 @@ namespace capu
         mLastHashMapEntry->previous = mLastHashMapEntry;
         mLastHashMapEntry->next = mLastHashMapEntry;
 
-        // now perform the rehashing on each entry
+        // now perform the rehashing on each entry, the digests of the keys are stored in the entries
         HashTableEntry* newentry = mData;
         for (uint_t i = old_threshold; i != 0; --i)
         {
-            internalPut(newentry, calcHashValue(newentry->key));
+            internalPut(newentry);
             ++newentry;
         }
 
@@ -865,6 +979,43 @@ namespace capu
         delete[] old_buckets;
         delete[] old_data;
     }
+
+    template <class Key, class T, class C, class H>
+    inline void HashTable<Key, T, C, H>::rehash(const uint8_t bitCount)
+    {
+        // unlike rehash() the table may have gaps of removed entries,
+        // so only the entries in the chain are moved to the new memory
+        HashTableEntry*  old_data    = mData;
+        HashTableEntry** old_buckets = mBuckets;
+        HashTableEntry*  old_last    = mLastHashMapEntry;
+
+        mCount                 = 0;
+        mBitCount              = bitCount;
+        mSize                  = static_cast<uint_t>(1) << mBitCount;
+        mThreshold             = static_cast<uint_t>(mSize * DEFAULT_HASH_TABLE_MAX_LOAD_FACTOR);
+        mBuckets               = new HashTableEntry*[mSize];
+        mData                  = new HashTableEntry[mThreshold + 1];
+
+        mFirstFreeHashMapEntry = mData;
+        mLastHashMapEntry      = mData + mThreshold;
+
+        Memory::Set(mBuckets, 0, sizeof(HashTableEntry*) * mSize);
+        mLastHashMapEntry->previous = mLastHashMapEntry;
+        mLastHashMapEntry->next = mLastHashMapEntry;
+
+        for (HashTableEntry* entry = old_last->next; entry != old_last; entry = entry->next)
+        {
+            // the new entries are 'preconnected', so the next free one directly follows
+            HashTableEntry* newentry = mFirstFreeHashMapEntry++;
+            newentry->internalKey = entry->key;
+            newentry->value = entry->value;
+            newentry->hash = entry->hash;
+            internalPut(newentry);
+        }
+
+        delete[] old_buckets;
+        delete[] old_data;
+    }
 }
 
 #endif // CAPU_HASHTABLE_H
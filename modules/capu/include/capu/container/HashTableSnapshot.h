@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_HASHTABLESNAPSHOT_H
+#define CAPU_HASHTABLESNAPSHOT_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/HashTable.h"
+#include "capu/container/HashSet.h"
+#include "capu/container/Array.h"
+#include "capu/os/File.h"
+#include "capu/os/Memory.h"
+#include "capu/os/NumericLimits.h"
+
+namespace capu
+{
+    /**
+     * Header at the start of a snapshot file
+     */
+    struct HashSnapshotHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t wordSize; // sizeof(uint_t) of the writer, the hash values depend on it
+        uint32_t keySize;
+        uint32_t valueSize;
+        uint32_t bitCount; // bit size of the hash function, there are 2^bitCount buckets
+        uint64_t count;
+        uint64_t keysOffset;
+        uint64_t valuesOffset;
+        uint64_t size;
+    };
+
+    /**
+     * Common part of the read only hash snapshots.
+     * A snapshot file contains the header, the start index of every bucket plus the end index,
+     * the keys sorted by bucket and the values in the same order. The reader maps the file and
+     * looks up keys directly in the mapping, so opening a snapshot costs the same for any size.
+     * Keys and values are stored as raw memory, so they must be trivially copyable (no pointers
+     * and no members that own memory like String). A snapshot can only be read on a platform
+     * with the same word size and byte order and with the hash function H it was written with.
+     */
+    template <class Key, class C, class H>
+    class HashSnapshotKeys
+    {
+    public:
+        /**
+         * Returns the number of keys in the snapshot
+         */
+        uint_t count() const;
+
+    protected:
+        HashSnapshotKeys();
+
+        /**
+         * Writes keys and values, which are given as valueSize bytes per key, to the file
+         */
+        static status_t WriteSnapshot(File& file, const Key* keys, const char_t* values, const uint32_t valueSize, const uint32_t count);
+
+        /**
+         * Maps the file and checks that it fits to the key and value type and that the bucket table
+         * is consistent, so lookups can trust it
+         */
+        status_t mapSnapshot(File& file, const uint32_t valueSize);
+
+        /**
+         * Looks up the position of a key
+         * @return true if the key was found
+         */
+        bool_t findIndex(const Key& key, uint32_t& index) const;
+
+        /**
+         * Maximum number of keys in a snapshot, more keys would need 2^32 buckets
+         */
+        static const uint32_t MaxCount = 0x80000000u;
+
+        const char_t* mValues;
+
+    private:
+        static const uint32_t Magic = 0x53504143; // "CAPS"
+        static const uint32_t Version = 1;
+        static const uint32_t SectionAlignment = 16;
+
+        static uint64_t Align(const uint64_t offset);
+        static status_t WritePadding(File& file, const uint64_t from, const uint64_t to);
+
+        const uint32_t* mBuckets;
+        const Key* mKeys;
+        uint_t mCount;
+        uint8_t mBitCount;
+        const C mComparator;
+    };
+
+    /**
+     * Read only HashTable in a memory mapped file.
+     * Write() stores a HashTable, open() maps the file and makes the snapshot usable without
+     * building a table. The File has to outlive the snapshot, it owns the mapping.
+     */
+    template <class Key, class T, class C = Comparator, class H = CapuDefaultHashFunction>
+    class HashTableSnapshot: public HashSnapshotKeys<Key, C, H>
+    {
+    public:
+        /**
+         * Writes a snapshot of the table to the file, an existing file is overwritten
+         * @return CAPU_OK if the snapshot was written
+         *         CAPU_ERANGE if the table has more than 2^31 entries or its keys or values
+         *                     need more memory than uint_t can address
+         *         CAPU_ENO_MEMORY if the sorted copy of the table could not be allocated
+         *         CAPU_ERROR if the file could not be written
+         */
+        static status_t Write(const HashTable<Key, T, C, H>& table, File& file);
+
+        /**
+         * Maps a snapshot file
+         * @return CAPU_OK if the snapshot can be used
+         *         CAPU_EINVAL if the file is no snapshot of this table type
+         *         the error of File::mapReadOnly otherwise
+         */
+        status_t open(File& file);
+
+        /**
+         * Looks up a value
+         * @return pointer to the value in the mapping, 0 if the key is not contained
+         */
+        const T* find(const Key& key) const;
+
+        /**
+         * Checks whether the key is contained in the snapshot
+         */
+        bool_t contains(const Key& key) const;
+    };
+
+    /**
+     * Read only HashSet in a memory mapped file, see HashTableSnapshot
+     */
+    template <class T, class C = Comparator, class H = CapuDefaultHashFunction>
+    class HashSetSnapshot: public HashSnapshotKeys<T, C, H>
+    {
+    public:
+        /**
+         * Writes a snapshot of the set to the file, see HashTableSnapshot::Write
+         */
+        static status_t Write(const HashSet<T, C, H>& set, File& file);
+
+        /**
+         * Maps a snapshot file, see HashTableSnapshot::open
+         */
+        status_t open(File& file);
+
+        /**
+         * Checks whether the value is contained in the snapshot
+         */
+        bool_t contains(const T& value) const;
+    };
+
+    template <class Key, class C, class H>
+    inline HashSnapshotKeys<Key, C, H>::HashSnapshotKeys()
+        : mValues(0)
+        , mBuckets(0)
+        , mKeys(0)
+        , mCount(0)
+        , mBitCount(0)
+        , mComparator()
+    {
+    }
+
+    template <class Key, class C, class H>
+    inline uint_t HashSnapshotKeys<Key, C, H>::count() const
+    {
+        return mCount;
+    }
+
+    template <class Key, class C, class H>
+    inline uint64_t HashSnapshotKeys<Key, C, H>::Align(const uint64_t offset)
+    {
+        return (offset + SectionAlignment - 1) & ~static_cast<uint64_t>(SectionAlignment - 1);
+    }
+
+    template <class Key, class C, class H>
+    inline status_t HashSnapshotKeys<Key, C, H>::WritePadding(File& file, const uint64_t from, const uint64_t to)
+    {
+        const char_t zeros[SectionAlignment] = {0};
+        return from == to ? CAPU_OK : file.write(zeros, static_cast<uint_t>(to - from));
+    }
+
+    template <class Key, class C, class H>
+    inline status_t HashSnapshotKeys<Key, C, H>::WriteSnapshot(File& file, const Key* keys, const char_t* values, const uint32_t valueSize, const uint32_t count)
+    {
+        // at most one key per bucket on average
+        uint8_t bitCount = 1;
+        while ((static_cast<uint64_t>(1) << bitCount) < count)
+        {
+            ++bitCount;
+        }
+        const uint32_t bucketCount = static_cast<uint32_t>(1) << bitCount;
+
+        // the sections are held in memory while writing, their sizes have to fit into uint_t
+        const uint64_t keysSize = static_cast<uint64_t>(count) * sizeof(Key);
+        const uint64_t valuesSize = static_cast<uint64_t>(count) * valueSize;
+        if (keysSize > NumericLimits::Max<uint_t>() || valuesSize > NumericLimits::Max<uint_t>())
+        {
+            return CAPU_ERANGE;
+        }
+
+        // sort the keys by bucket: count the keys per bucket, then place them
+        Array<uint32_t> hashes(count);
+        Array<uint32_t> buckets(bucketCount + 1, 0);
+        if (hashes.size() != count || buckets.size() != bucketCount + 1)
+        {
+            return CAPU_ENO_MEMORY;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            hashes[i] = static_cast<uint32_t>(H::Digest(keys[i], bitCount));
+            ++buckets[hashes[i] + 1];
+        }
+        for (uint32_t i = 0; i < bucketCount; ++i)
+        {
+            buckets[i + 1] += buckets[i];
+        }
+
+        Array<uint32_t> next(buckets);
+        Array<Key> sortedKeys(count);
+        Array<char_t> sortedValues(static_cast<uint_t>(valuesSize));
+        if (next.size() != bucketCount + 1 || sortedKeys.size() != count || sortedValues.size() != valuesSize)
+        {
+            return CAPU_ENO_MEMORY;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t index = next[hashes[i]]++;
+            sortedKeys[index] = keys[i];
+            if (valueSize > 0)
+            {
+                Memory::Copy(sortedValues.getRawData() + static_cast<uint_t>(index) * valueSize, values + static_cast<uint_t>(i) * valueSize, valueSize);
+            }
+        }
+
+        HashSnapshotHeader header;
+        Memory::Set(&header, 0, sizeof(header));
+        header.magic = Magic;
+        header.version = Version;
+        header.wordSize = sizeof(uint_t);
+        header.keySize = sizeof(Key);
+        header.valueSize = valueSize;
+        header.bitCount = bitCount;
+        header.count = count;
+        const uint64_t bucketsEnd = sizeof(HashSnapshotHeader) + (bucketCount + 1) * sizeof(uint32_t);
+        header.keysOffset = Align(bucketsEnd);
+        const uint64_t keysEnd = header.keysOffset + keysSize;
+        header.valuesOffset = Align(keysEnd);
+        header.size = header.valuesOffset + valuesSize;
+
+        status_t status = file.open(WRITE_EXISTING_BINARY);
+        if (status != CAPU_OK)
+        {
+            return status;
+        }
+        status = file.write(reinterpret_cast<const char_t*>(&header), sizeof(header));
+        if (status == CAPU_OK)
+        {
+            status = file.write(reinterpret_cast<const char_t*>(buckets.getRawData()), (bucketCount + 1) * sizeof(uint32_t));
+        }
+        if (status == CAPU_OK)
+        {
+            status = WritePadding(file, bucketsEnd, header.keysOffset);
+        }
+        if (status == CAPU_OK && count > 0)
+        {
+            status = file.write(reinterpret_cast<const char_t*>(sortedKeys.getRawData()), static_cast<uint_t>(keysSize));
+        }
+        if (status == CAPU_OK)
+        {
+            status = WritePadding(file, keysEnd, header.valuesOffset);
+        }
+        if (status == CAPU_OK && count > 0 && valueSize > 0)
+        {
+            status = file.write(sortedValues.getRawData(), static_cast<uint_t>(valuesSize));
+        }
+        const status_t closeStatus = file.close();
+        return status == CAPU_OK ? closeStatus : status;
+    }
+
+    template <class Key, class C, class H>
+    inline status_t HashSnapshotKeys<Key, C, H>::mapSnapshot(File& file, const uint32_t valueSize)
+    {
+        const char_t* data = 0;
+        uint_t size = 0;
+        const status_t status = file.mapReadOnly(data, size);
+        if (status != CAPU_OK)
+        {
+            return status;
+        }
+
+        if (size < sizeof(HashSnapshotHeader))
+        {
+            return CAPU_EINVAL;
+        }
+        const HashSnapshotHeader& header = *reinterpret_cast<const HashSnapshotHeader*>(data);
+        if (header.magic != Magic || header.version != Version || header.wordSize != sizeof(uint_t) ||
+            header.keySize != sizeof(Key) || header.valueSize != valueSize ||
+            header.bitCount == 0 || header.bitCount >= 32 || header.size != size || header.count > MaxCount)
+        {
+            return CAPU_EINVAL;
+        }
+        // the offsets come from the file, compare the section sizes by division so nothing can wrap
+        if (header.keysOffset > header.valuesOffset || header.valuesOffset > size ||
+            header.keysOffset % SectionAlignment != 0 || header.valuesOffset % SectionAlignment != 0 ||
+            sizeof(HashSnapshotHeader) + ((static_cast<uint64_t>(1) << header.bitCount) + 1) * sizeof(uint32_t) > header.keysOffset ||
+            header.count > (header.valuesOffset - header.keysOffset) / sizeof(Key) ||
+            (valueSize > 0 && header.count > (size - header.valuesOffset) / valueSize))
+        {
+            return CAPU_EINVAL;
+        }
+
+        // the bucket ranges must be ascending and end at the key count, findIndex relies on it
+        const uint32_t* buckets = reinterpret_cast<const uint32_t*>(data + sizeof(HashSnapshotHeader));
+        const uint32_t bucketCount = static_cast<uint32_t>(1) << header.bitCount;
+        for (uint32_t i = 0; i < bucketCount; ++i)
+        {
+            if (buckets[i] > buckets[i + 1])
+            {
+                return CAPU_EINVAL;
+            }
+        }
+        if (buckets[bucketCount] != header.count)
+        {
+            return CAPU_EINVAL;
+        }
+
+        mBuckets = buckets;
+        mKeys = reinterpret_cast<const Key*>(data + header.keysOffset);
+        mValues = data + header.valuesOffset;
+        mCount = static_cast<uint_t>(header.count);
+        mBitCount = static_cast<uint8_t>(header.bitCount);
+        return CAPU_OK;
+    }
+
+    template <class Key, class C, class H>
+    inline bool_t HashSnapshotKeys<Key, C, H>::findIndex(const Key& key, uint32_t& index) const
+    {
+        if (mBuckets == 0)
+        {
+            return false;
+        }
+
+        const uint_t bucket = H::Digest(key, mBitCount);
+        const uint32_t end = mBuckets[bucket + 1];
+        for (uint32_t current = mBuckets[bucket]; current != end; ++current)
+        {
+            if (mComparator(mKeys[current], key))
+            {
+                index = current;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t HashTableSnapshot<Key, T, C, H>::Write(const HashTable<Key, T, C, H>& table, File& file)
+    {
+        if (static_cast<uint64_t>(table.count()) > HashSnapshotKeys<Key, C, H>::MaxCount)
+        {
+            return CAPU_ERANGE;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(table.count());
+        Array<Key> keys(count);
+        Array<T> values(count);
+        uint32_t i = 0;
+        typename HashTable<Key, T, C, H>::Iterator current = table.begin();
+        const typename HashTable<Key, T, C, H>::Iterator end = table.end();
+        for (; current != end; ++current, ++i)
+        {
+            keys[i] = current->key;
+            values[i] = current->value;
+        }
+        return HashSnapshotKeys<Key, C, H>::WriteSnapshot(file, keys.getRawData(), reinterpret_cast<const char_t*>(values.getRawData()), sizeof(T), count);
+    }
+
+    template <class Key, class T, class C, class H>
+    inline status_t HashTableSnapshot<Key, T, C, H>::open(File& file)
+    {
+        return HashSnapshotKeys<Key, C, H>::mapSnapshot(file, sizeof(T));
+    }
+
+    template <class Key, class T, class C, class H>
+    inline const T* HashTableSnapshot<Key, T, C, H>::find(const Key& key) const
+    {
+        uint32_t index = 0;
+        if (!HashSnapshotKeys<Key, C, H>::findIndex(key, index))
+        {
+            return 0;
+        }
+        return reinterpret_cast<const T*>(HashSnapshotKeys<Key, C, H>::mValues) + index;
+    }
+
+    template <class Key, class T, class C, class H>
+    inline bool_t HashTableSnapshot<Key, T, C, H>::contains(const Key& key) const
+    {
+        uint32_t index = 0;
+        return HashSnapshotKeys<Key, C, H>::findIndex(key, index);
+    }
+
+    template <class T, class C, class H>
+    inline status_t HashSetSnapshot<T, C, H>::Write(const HashSet<T, C, H>& set, File& file)
+    {
+        if (static_cast<uint64_t>(set.count()) > HashSnapshotKeys<T, C, H>::MaxCount)
+        {
+            return CAPU_ERANGE;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(set.count());
+        Array<T> keys(count);
+        uint32_t i = 0;
+        typename HashSet<T, C, H>::Iterator current = set.begin();
+        const typename HashSet<T, C, H>::Iterator end = set.end();
+        for (; current != end; ++current, ++i)
+        {
+            keys[i] = *current;
+        }
+        return HashSnapshotKeys<T, C, H>::WriteSnapshot(file, keys.getRawData(), 0, 0, count);
+    }
+
+    template <class T, class C, class H>
+    inline status_t HashSetSnapshot<T, C, H>::open(File& file)
+    {
+        return HashSnapshotKeys<T, C, H>::mapSnapshot(file, 0);
+    }
+
+    template <class T, class C, class H>
+    inline bool_t HashSetSnapshot<T, C, H>::contains(const T& value) const
+    {
+        uint32_t index = 0;
+        return HashSnapshotKeys<T, C, H>::findIndex(value, index);
+    }
+}
+
+#endif // CAPU_HASHTABLESNAPSHOT_H
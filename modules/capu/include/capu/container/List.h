@@ -139,6 +139,9 @@ namespace capu
         status_t deleteElement(ListNode* deletePosition);
         ListNode* findElement(const uint_t index) const;
 
+        template<class L>
+        static ListNode* mergeNodes(ListNode* first, ListNode* second, const L& comparator);
+
     public:
         /**
          * An iterator for lists
@@ -425,6 +428,20 @@ namespace capu
          *         false otherwise
          */
         bool_t contains(const T& element) const;
+
+        /**
+         * Sorts the list in ascending order with a stable merge sort.
+         * Only the nodes are relinked, no element is copied, so iterators
+         * keep referring to the same elements.
+         */
+        void sort();
+
+        /**
+         * Sorts the list with a stable merge sort which relinks the nodes.
+         * @param comparator ordering which returns true if the first argument sorts before the second
+         */
+        template<class L>
+        void sort(const L& comparator);
     };
 
     /*
@@ -589,6 +606,94 @@ namespace capu
         return CAPU_OK;
     }
 
+    template <class T, class A, class C>
+    inline void List<T, A , C>::sort()
+    {
+        sort(LessComparator());
+    }
+
+    template <class T, class A, class C>
+    template <class L>
+    void List<T, A , C>::sort(const L& comparator)
+    {
+        if (mSize < 2)
+        {
+            return;
+        }
+
+        // bottom up merge sort on a singly linked chain, bin i holds a sorted run of 2^i nodes
+        ListNode* bins[sizeof(uint_t) * 8 + 1] = {};
+        uint_t usedBins = 0;
+        mBoundary.mPrev->mNext = 0;
+        ListNode* current = mBoundary.mNext;
+        while (current)
+        {
+            ListNode* next = current->mNext;
+            current->mNext = 0;
+
+            ListNode* carry = current;
+            uint_t bin = 0;
+            while (bin < usedBins && bins[bin])
+            {
+                carry = mergeNodes(bins[bin], carry, comparator);
+                bins[bin] = 0;
+                ++bin;
+            }
+            if (bin == usedBins)
+            {
+                ++usedBins;
+            }
+            bins[bin] = carry;
+            current = next;
+        }
+
+        // higher bins hold the earlier nodes
+        ListNode* sorted = 0;
+        for (uint_t bin = 0; bin < usedBins; ++bin)
+        {
+            if (bins[bin])
+            {
+                sorted = sorted ? mergeNodes(bins[bin], sorted, comparator) : bins[bin];
+            }
+        }
+
+        // restore the backward links and close the ring
+        ListNode* previous = &mBoundary;
+        for (current = sorted; current; current = current->mNext)
+        {
+            previous->mNext = current;
+            current->mPrev = previous;
+            previous = current;
+        }
+        previous->mNext = &mBoundary;
+        mBoundary.mPrev = previous;
+    }
+
+    template <class T, class A, class C>
+    template <class L>
+    typename List<T, A , C>::ListNode* List<T, A , C>::mergeNodes(ListNode* first, ListNode* second, const L& comparator)
+    {
+        // nodes of first come before equal nodes of second, which keeps the sort stable
+        ListNode* result = 0;
+        ListNode** tail = &result;
+        while (first && second)
+        {
+            if (comparator(second->mData, first->mData))
+            {
+                *tail = second;
+                second = second->mNext;
+            }
+            else
+            {
+                *tail = first;
+                first = first->mNext;
+            }
+            tail = &(*tail)->mNext;
+        }
+        *tail = first ? first : second;
+        return result;
+    }
+
     template <class T, class A, class C>
     typename List<T, A , C>::ListNode* List<T, A , C>::findElement(const uint_t index) const
     {
@@ -20,15 +20,19 @@
 #include "capu/Error.h"
 #include "capu/Config.h"
 #include "capu/container/List.h"
+#include "capu/container/Deque.h"
 #include "capu/util/StaticAllocator.h"
 
 namespace capu
 {
     /**
      * Queue. A container to which one can push and pop objects to and from the same side. The operations are not thread safe.
+     *
+     * The elements are stored in a List by default. Passing a Deque as storage S keeps them
+     * in contiguous chunks instead, which avoids one allocation per push.
      */
-    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator>
-    class Queue : private List<T, A, C>
+    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator, class S = List<T, A, C> >
+    class Queue : private S
     {
     public:
         /**
@@ -123,59 +127,67 @@ namespace capu
      * Implementation queue
      */
 
-    template <class T, class A, class C>
-    Queue<T, A, C>::Queue()
+    template <class T, class A, class C, class S>
+    Queue<T, A, C, S>::Queue()
     {
     }
 
-    template <class T, class A, class C>
-    Queue<T, A, C>::~Queue()
+    template <class T, class A, class C, class S>
+    Queue<T, A, C, S>::~Queue()
     {
     }
 
-    template <class T, class A, class C>
-    inline T& Queue<T, A, C>::front()
+    template <class T, class A, class C, class S>
+    inline T& Queue<T, A, C, S>::front()
     {
-        return List<T, A, C>::front();
+        return S::front();
     }
 
-    template <class T, class A, class C>
-    inline const T& Queue<T, A, C>::front() const
+    template <class T, class A, class C, class S>
+    inline const T& Queue<T, A, C, S>::front() const
     {
-        return List<T, A, C>::front();
+        return S::front();
     }
 
-    template <class T, class A, class C>
-    inline T& Queue<T, A, C>::back()
+    template <class T, class A, class C, class S>
+    inline T& Queue<T, A, C, S>::back()
     {
-        return List<T, A, C>::back();
+        return S::back();
     }
 
-    template <class T, class A, class C>
-    inline const T& Queue<T, A, C>::back() const
+    template <class T, class A, class C, class S>
+    inline const T& Queue<T, A, C, S>::back() const
     {
-        return List<T, A, C>::back();
+        return S::back();
     }
 
-    template <class T, class A, class C>
-    inline status_t Queue<T, A, C>::peek(T& element) const
+    template <class T, class A, class C, class S>
+    inline status_t Queue<T, A, C, S>::peek(T& element) const
     {
         if (empty())
         {
             return CAPU_EINVAL;
         }
-        element = List<T, A, C>::front();
+        element = S::front();
         return CAPU_OK;
     }
 
-    template <class T, class A, class C>
-    inline status_t Queue<T, A, C>::pop(T* element)
+    template <class T, class A, class C, class S>
+    inline status_t Queue<T, A, C, S>::pop(T* element)
     {
-        return List<T, A, C>::erase(0, element);
+        if (empty())
+        {
+            return CAPU_EINVAL;
+        }
+        if (element)
+        {
+            *element = S::front(); // copy out
+        }
+        return S::pop_front();
     }
 
-    template <class T, class A, class C>
-    inline status_t Queue<T, A, C>::popAll(List<T, A, C>& list)
+    template <class T, class A, class C, class S>
+    inline status_t Queue<T, A, C, S>::popAll(List<T, A, C>& list)
     {
         T current;
         while (pop(&current) == CAPU_OK)
@@ -188,28 +200,28 @@ namespace capu
         return CAPU_OK;
     }
 
-    template <class T, class A, class C>
-    inline uint_t Queue<T, A, C>::size() const
+    template <class T, class A, class C, class S>
+    inline uint_t Queue<T, A, C, S>::size() const
     {
-        return List<T, A, C>::size();
+        return S::size();
     }
 
-    template <class T, class A, class C>
-    inline void Queue<T, A, C>::clear()
+    template <class T, class A, class C, class S>
+    inline void Queue<T, A, C, S>::clear()
     {
-        List<T, A, C>::clear();
+        S::clear();
     }
 
-    template <class T, class A, class C>
-    inline bool_t Queue<T, A, C>::empty() const
+    template <class T, class A, class C, class S>
+    inline bool_t Queue<T, A, C, S>::empty() const
     {
-        return List<T, A, C>::isEmpty();
+        return S::isEmpty();
     }
 
-    template <class T, class A, class C>
-    inline status_t Queue<T, A, C>::push(const T& element)
+    template <class T, class A, class C, class S>
+    inline status_t Queue<T, A, C, S>::push(const T& element)
     {
-        return List<T, A, C>::insert(element);
+        return S::push_back(element);
     }
 
     /**
@@ -0,0 +1,662 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_SORT_H
+#define CAPU_SORT_H
+
+#include "capu/Config.h"
+#include "capu/container/Array.h"
+#include "capu/container/Comparator.h"
+#include "capu/container/Vector.h"
+#include "capu/os/Memory.h"
+#include "capu/util/ParallelAlgorithms.h"
+#include "capu/util/Swap.h"
+#include "capu/util/ThreadPool.h"
+
+namespace capu
+{
+    /**
+     * Sorts the elements with an introsort: quicksort with a median of three pivot,
+     * heapsort when the recursion gets too deep and insertion sort for small ranges.
+     * The sort is not stable.
+     * @param data the elements to sort
+     * @param count number of elements
+     * @param comparator ordering which returns true if the first argument sorts before the second
+     */
+    template<typename T, typename C>
+    void sort(T* data, const uint_t count, const C& comparator);
+
+    /**
+     * Sorts the elements in ascending order with an introsort.
+     */
+    template<typename T>
+    void sort(T* data, const uint_t count);
+
+    /**
+     * Sorts the elements of an array with an introsort.
+     */
+    template<typename T, typename STORAGE, typename C>
+    void sort(Array<T, STORAGE>& array, const C& comparator);
+
+    /**
+     * Sorts the elements of an array in ascending order with an introsort.
+     */
+    template<typename T, typename STORAGE>
+    void sort(Array<T, STORAGE>& array);
+
+    /**
+     * Sorts the elements of a vector with an introsort.
+     */
+    template<typename T, typename C>
+    void sort(Vector<T>& vector, const C& comparator);
+
+    /**
+     * Sorts the elements of a vector in ascending order with an introsort.
+     */
+    template<typename T>
+    void sort(Vector<T>& vector);
+
+    /**
+     * Sorts integers in ascending order with a least significant digit radix sort,
+     * one pass per byte. Passes in which all elements have the same byte are skipped.
+     * Needs a temporary buffer of the same size as the data, the sort is stable.
+     * @param data the integers to sort
+     * @param count number of integers
+     */
+    template<typename T>
+    void radixSort(T* data, const uint_t count);
+
+    /**
+     * Sorts the integers of an array with a radix sort.
+     */
+    template<typename T, typename STORAGE>
+    void radixSort(Array<T, STORAGE>& array);
+
+    /**
+     * Sorts the integers of a vector with a radix sort.
+     */
+    template<typename T>
+    void radixSort(Vector<T>& vector);
+
+    /**
+     * Sorts the elements on the threads of a pool. Equal sized chunks are sorted
+     * in parallel, then the sorted runs are merged pairwise. Every merge is split
+     * into independent pieces so all threads stay busy until the last round.
+     * The calling thread takes a share of the work. Small inputs are sorted directly.
+     * @param pool the pool to run the chunks on
+     * @param data the elements to sort
+     * @param count number of elements
+     * @param comparator ordering which returns true if the first argument sorts before the second
+     */
+    template<typename T, typename C>
+    void parallelSort(ThreadPool& pool, T* data, const uint_t count, const C& comparator);
+
+    /**
+     * Sorts the elements in ascending order on the threads of a pool.
+     */
+    template<typename T>
+    void parallelSort(ThreadPool& pool, T* data, const uint_t count);
+
+    /**
+     * Sorts the elements of an array on the threads of a pool.
+     */
+    template<typename T, typename STORAGE, typename C>
+    void parallelSort(ThreadPool& pool, Array<T, STORAGE>& array, const C& comparator);
+
+    /**
+     * Sorts the elements of an array in ascending order on the threads of a pool.
+     */
+    template<typename T, typename STORAGE>
+    void parallelSort(ThreadPool& pool, Array<T, STORAGE>& array);
+
+    /**
+     * Sorts the elements of a vector on the threads of a pool.
+     */
+    template<typename T, typename C>
+    void parallelSort(ThreadPool& pool, Vector<T>& vector, const C& comparator);
+
+    /**
+     * Sorts the elements of a vector in ascending order on the threads of a pool.
+     */
+    template<typename T>
+    void parallelSort(ThreadPool& pool, Vector<T>& vector);
+
+    namespace internal
+    {
+        /**
+         * Ranges up to this size are finished with insertion sort
+         */
+        static const uint_t SortInsertionThreshold = 16;
+
+        /**
+         * Inputs below this size are not worth splitting over threads
+         */
+        static const uint_t ParallelSortThreshold = 16384;
+
+        template<typename T, typename C>
+        void InsertionSort(T* data, const uint_t count, const C& comparator)
+        {
+            for (uint_t i = 1; i < count; ++i)
+            {
+                if (comparator(data[i], data[i - 1]))
+                {
+                    T value = data[i];
+                    uint_t j = i;
+                    do
+                    {
+                        data[j] = data[j - 1];
+                        --j;
+                    }
+                    while (j > 0 && comparator(value, data[j - 1]));
+                    data[j] = value;
+                }
+            }
+        }
+
+        template<typename T, typename C>
+        void SiftDown(T* data, uint_t root, const uint_t count, const C& comparator)
+        {
+            T value = data[root];
+            uint_t child = 2 * root + 1;
+            while (child < count)
+            {
+                if (child + 1 < count && comparator(data[child], data[child + 1]))
+                {
+                    ++child;
+                }
+                if (!comparator(value, data[child]))
+                {
+                    break;
+                }
+                data[root] = data[child];
+                root = child;
+                child = 2 * root + 1;
+            }
+            data[root] = value;
+        }
+
+        template<typename T, typename C>
+        void HeapSort(T* data, const uint_t count, const C& comparator)
+        {
+            for (uint_t i = count / 2; i > 0; --i)
+            {
+                SiftDown(data, i - 1, count, comparator);
+            }
+            for (uint_t end = count - 1; end > 0; --end)
+            {
+                swap(data[0], data[end]);
+                SiftDown(data, 0, end, comparator);
+            }
+        }
+
+        template<typename T, typename C>
+        void IntroSort(T* data, uint_t count, uint_t depthLimit, const C& comparator)
+        {
+            while (count > SortInsertionThreshold)
+            {
+                if (depthLimit == 0)
+                {
+                    HeapSort(data, count, comparator);
+                    return;
+                }
+                --depthLimit;
+
+                // order first, middle and last, the middle one becomes the pivot
+                const uint_t middle = count / 2;
+                if (comparator(data[middle], data[0]))
+                {
+                    swap(data[middle], data[0]);
+                }
+                if (comparator(data[count - 1], data[middle]))
+                {
+                    swap(data[count - 1], data[middle]);
+                    if (comparator(data[middle], data[0]))
+                    {
+                        swap(data[middle], data[0]);
+                    }
+                }
+                const T pivot = data[middle];
+
+                // hoare partition, both sides are never empty because the pivot is not the last element
+                int_t left = -1;
+                int_t right = static_cast<int_t>(count);
+                for (;;)
+                {
+                    do
+                    {
+                        ++left;
+                    }
+                    while (comparator(data[left], pivot));
+                    do
+                    {
+                        --right;
+                    }
+                    while (comparator(pivot, data[right]));
+                    if (left >= right)
+                    {
+                        break;
+                    }
+                    swap(data[left], data[right]);
+                }
+                const uint_t split = static_cast<uint_t>(right) + 1;
+
+                // recurse into the smaller part to bound the stack depth
+                if (split < count - split)
+                {
+                    IntroSort(data, split, depthLimit, comparator);
+                    data += split;
+                    count -= split;
+                }
+                else
+                {
+                    IntroSort(data + split, count - split, depthLimit, comparator);
+                    count = split;
+                }
+            }
+            InsertionSort(data, count, comparator);
+        }
+
+        /**
+         * Maps an integer to an unsigned key with the same order
+         */
+        template<typename T>
+        struct RadixKey;
+
+        template<>
+        struct RadixKey<uint8_t>
+        {
+            static uint8_t Get(const uint8_t value) { return value; }
+        };
+
+        template<>
+        struct RadixKey<int8_t>
+        {
+            static uint8_t Get(const int8_t value) { return static_cast<uint8_t>(value) ^ 0x80u; }
+        };
+
+        template<>
+        struct RadixKey<char_t>
+        {
+            static uint8_t Get(const char_t value) { return static_cast<uint8_t>(value) ^ (static_cast<char_t>(-1) < 0 ? 0x80u : 0u); }
+        };
+
+        template<>
+        struct RadixKey<uint16_t>
+        {
+            static uint16_t Get(const uint16_t value) { return value; }
+        };
+
+        template<>
+        struct RadixKey<int16_t>
+        {
+            static uint16_t Get(const int16_t value) { return static_cast<uint16_t>(value) ^ 0x8000u; }
+        };
+
+        template<>
+        struct RadixKey<uint32_t>
+        {
+            static uint32_t Get(const uint32_t value) { return value; }
+        };
+
+        template<>
+        struct RadixKey<int32_t>
+        {
+            static uint32_t Get(const int32_t value) { return static_cast<uint32_t>(value) ^ 0x80000000u; }
+        };
+
+        template<>
+        struct RadixKey<uint64_t>
+        {
+            static uint64_t Get(const uint64_t value) { return value; }
+        };
+
+        template<>
+        struct RadixKey<int64_t>
+        {
+            static uint64_t Get(const int64_t value) { return static_cast<uint64_t>(value) ^ (static_cast<uint64_t>(1) << 63); }
+        };
+
+        /**
+         * Returns how many elements of the first run go to the first outputIndex elements
+         * of the stable merge of both runs
+         */
+        template<typename T, typename C>
+        uint_t MergeSplit(const T* first, const uint_t firstCount, const T* second, const uint_t secondCount, const uint_t outputIndex, const C& comparator)
+        {
+            uint_t low = outputIndex > secondCount ? outputIndex - secondCount : 0;
+            uint_t high = outputIndex < firstCount ? outputIndex : firstCount;
+            while (low < high)
+            {
+                const uint_t i = low + (high - low) / 2;
+                const uint_t j = outputIndex - i;
+                if (j == 0 || comparator(second[j - 1], first[i]))
+                {
+                    high = i;
+                }
+                else
+                {
+                    low = i + 1;
+                }
+            }
+            return low;
+        }
+
+        template<typename T, typename C>
+        void Merge(const T* first, const uint_t firstCount, const T* second, const uint_t secondCount, T* output, const C& comparator)
+        {
+            const T* firstEnd = first + firstCount;
+            const T* secondEnd = second + secondCount;
+            while (first != firstEnd && second != secondEnd)
+            {
+                if (comparator(*second, *first))
+                {
+                    *output++ = *second++;
+                }
+                else
+                {
+                    *output++ = *first++;
+                }
+            }
+            Memory::CopyObject(output, first, firstEnd - first);
+            output += firstEnd - first;
+            Memory::CopyObject(output, second, secondEnd - second);
+        }
+
+        /**
+         * Sorts chunks of a parallel sort, called with a range of chunk indices
+         */
+        template<typename T, typename C>
+        class SortChunksFunction
+        {
+        public:
+            SortChunksFunction(T* data, const uint_t* bounds, const C& comparator)
+                : mData(data)
+                , mBounds(bounds)
+                , mComparator(comparator)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                for (uint_t chunk = begin; chunk < end; ++chunk)
+                {
+                    sort(mData + mBounds[chunk], mBounds[chunk + 1] - mBounds[chunk], mComparator);
+                }
+            }
+
+        private:
+            T* mData;
+            const uint_t* mBounds;
+            const C mComparator;
+        };
+
+        /**
+         * Part of the output of merging two sorted runs
+         */
+        template<typename T>
+        struct MergePiece
+        {
+            const T* first;
+            uint_t firstCount;
+            const T* second;
+            uint_t secondCount;
+            uint_t outputBegin;
+            uint_t outputEnd;
+            T* output;
+        };
+
+        /**
+         * Merges pieces of a parallel sort, called with a range of piece indices
+         */
+        template<typename T, typename C>
+        class MergePiecesFunction
+        {
+        public:
+            MergePiecesFunction(const MergePiece<T>* pieces, const C& comparator)
+                : mPieces(pieces)
+                , mComparator(comparator)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                for (uint_t i = begin; i < end; ++i)
+                {
+                    const MergePiece<T>& piece = mPieces[i];
+                    const uint_t firstBegin = MergeSplit(piece.first, piece.firstCount, piece.second, piece.secondCount, piece.outputBegin, mComparator);
+                    const uint_t firstEnd = MergeSplit(piece.first, piece.firstCount, piece.second, piece.secondCount, piece.outputEnd, mComparator);
+                    const uint_t secondBegin = piece.outputBegin - firstBegin;
+                    const uint_t secondEnd = piece.outputEnd - firstEnd;
+                    Merge(piece.first + firstBegin, firstEnd - firstBegin, piece.second + secondBegin, secondEnd - secondBegin,
+                          piece.output + piece.outputBegin, mComparator);
+                }
+            }
+
+        private:
+            const MergePiece<T>* mPieces;
+            const C mComparator;
+        };
+    }
+
+    template<typename T, typename C>
+    inline void sort(T* data, const uint_t count, const C& comparator)
+    {
+        uint_t depthLimit = 0;
+        for (uint_t remaining = count; remaining > 1; remaining >>= 1)
+        {
+            depthLimit += 2;
+        }
+        internal::IntroSort(data, count, depthLimit, comparator);
+    }
+
+    template<typename T>
+    inline void sort(T* data, const uint_t count)
+    {
+        sort(data, count, LessComparator());
+    }
+
+    template<typename T, typename STORAGE, typename C>
+    inline void sort(Array<T, STORAGE>& array, const C& comparator)
+    {
+        sort(array.getRawData(), array.size(), comparator);
+    }
+
+    template<typename T, typename STORAGE>
+    inline void sort(Array<T, STORAGE>& array)
+    {
+        sort(array.getRawData(), array.size(), LessComparator());
+    }
+
+    template<typename T, typename C>
+    inline void sort(Vector<T>& vector, const C& comparator)
+    {
+        if (vector.size() > 0)
+        {
+            sort(&vector[0], vector.size(), comparator);
+        }
+    }
+
+    template<typename T>
+    inline void sort(Vector<T>& vector)
+    {
+        sort(vector, LessComparator());
+    }
+
+    template<typename T>
+    void radixSort(T* data, const uint_t count)
+    {
+        typedef internal::RadixKey<T> Key;
+        const uint_t digits = sizeof(T);
+        if (count < 2)
+        {
+            return;
+        }
+
+        Array<T> buffer(count);
+
+        // one histogram per byte, all gathered in a single pass
+        Array<uint_t> histograms(digits * 256, 0);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            const uint64_t key = Key::Get(data[i]);
+            for (uint_t digit = 0; digit < digits; ++digit)
+            {
+                ++histograms[digit * 256 + ((key >> (digit * 8)) & 0xFF)];
+            }
+        }
+
+        T* source = data;
+        T* target = buffer.getRawData();
+        for (uint_t digit = 0; digit < digits; ++digit)
+        {
+            uint_t* histogram = &histograms[digit * 256];
+            const uint64_t firstKey = Key::Get(source[0]);
+            if (histogram[(firstKey >> (digit * 8)) & 0xFF] == count)
+            {
+                // every element has the same byte, the pass would not change the order
+                continue;
+            }
+
+            uint_t offset = 0;
+            for (uint_t bucket = 0; bucket < 256; ++bucket)
+            {
+                const uint_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+            for (uint_t i = 0; i < count; ++i)
+            {
+                const uint64_t key = Key::Get(source[i]);
+                target[histogram[(key >> (digit * 8)) & 0xFF]++] = source[i];
+            }
+            swap(source, target);
+        }
+
+        if (source != data)
+        {
+            Memory::CopyObject(data, source, count);
+        }
+    }
+
+    template<typename T, typename STORAGE>
+    inline void radixSort(Array<T, STORAGE>& array)
+    {
+        radixSort(array.getRawData(), array.size());
+    }
+
+    template<typename T>
+    inline void radixSort(Vector<T>& vector)
+    {
+        if (vector.size() > 0)
+        {
+            radixSort(&vector[0], vector.size());
+        }
+    }
+
+    template<typename T, typename C>
+    void parallelSort(ThreadPool& pool, T* data, const uint_t count, const C& comparator)
+    {
+        const uint_t threads = pool.getSize() + 1;
+        if (pool.isClosed() || threads < 2 || count < internal::ParallelSortThreshold)
+        {
+            sort(data, count, comparator);
+            return;
+        }
+
+        // sort one chunk per thread
+        const uint_t chunks = threads;
+        Array<uint_t> bounds(chunks + 1);
+        for (uint_t i = 0; i <= chunks; ++i)
+        {
+            bounds[i] = static_cast<uint_t>(static_cast<uint64_t>(count) * i / chunks);
+        }
+        internal::SortChunksFunction<T, C> sortChunks(data, bounds.getRawData(), comparator);
+        parallelFor(pool, 0, chunks, 1, sortChunks);
+
+        // merge neighboring runs until a single one is left, alternating between data and buffer
+        Array<T> buffer(count);
+        T* source = data;
+        T* target = buffer.getRawData();
+        Array<internal::MergePiece<T> > pieces(2 * threads + 1);
+        for (uint_t width = 1; width < chunks; width *= 2)
+        {
+            // the merges of a round share the threads by output size
+            uint_t pieceCount = 0;
+            for (uint_t first = 0; first < chunks; first += 2 * width)
+            {
+                const uint_t begin = bounds[first];
+                const uint_t middle = bounds[first + width < chunks ? first + width : chunks];
+                const uint_t end = bounds[first + 2 * width < chunks ? first + 2 * width : chunks];
+                const uint_t mergePieces = 1 + static_cast<uint_t>(static_cast<uint64_t>(end - begin) * threads / count);
+                for (uint_t i = 0; i < mergePieces; ++i, ++pieceCount)
+                {
+                    internal::MergePiece<T>& piece = pieces[pieceCount];
+                    piece.first = source + begin;
+                    piece.firstCount = middle - begin;
+                    piece.second = source + middle;
+                    piece.secondCount = end - middle;
+                    piece.outputBegin = static_cast<uint_t>(static_cast<uint64_t>(end - begin) * i / mergePieces);
+                    piece.outputEnd = static_cast<uint_t>(static_cast<uint64_t>(end - begin) * (i + 1) / mergePieces);
+                    piece.output = target + begin;
+                }
+            }
+            internal::MergePiecesFunction<T, C> mergePieces(pieces.getRawData(), comparator);
+            parallelFor(pool, 0, pieceCount, 1, mergePieces);
+            swap(source, target);
+        }
+
+        if (source != data)
+        {
+            Memory::CopyObject(data, source, count);
+        }
+    }
+
+    template<typename T>
+    inline void parallelSort(ThreadPool& pool, T* data, const uint_t count)
+    {
+        parallelSort(pool, data, count, LessComparator());
+    }
+
+    template<typename T, typename STORAGE, typename C>
+    inline void parallelSort(ThreadPool& pool, Array<T, STORAGE>& array, const C& comparator)
+    {
+        parallelSort(pool, array.getRawData(), array.size(), comparator);
+    }
+
+    template<typename T, typename STORAGE>
+    inline void parallelSort(ThreadPool& pool, Array<T, STORAGE>& array)
+    {
+        parallelSort(pool, array.getRawData(), array.size(), LessComparator());
+    }
+
+    template<typename T, typename C>
+    inline void parallelSort(ThreadPool& pool, Vector<T>& vector, const C& comparator)
+    {
+        if (vector.size() > 0)
+        {
+            parallelSort(pool, &vector[0], vector.size(), comparator);
+        }
+    }
+
+    template<typename T>
+    inline void parallelSort(ThreadPool& pool, Vector<T>& vector)
+    {
+        parallelSort(pool, vector, LessComparator());
+    }
+}
+
+#endif // CAPU_SORT_H
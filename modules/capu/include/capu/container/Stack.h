@@ -18,15 +18,19 @@
 #define CAPU_STACK_H
 
 #include "capu/container/List.h"
+#include "capu/container/Deque.h"
 #include "capu/util/StaticAllocator.h"
 
 namespace capu
 {
     /**
      * Implements a non-synchronized stack with the common push and pop operations (LIFO - last-in, first-out).
+     *
+     * The elements are stored in a List by default. Passing a Deque as storage S keeps them
+     * in contiguous chunks instead, which avoids one allocation per push.
      */
-    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator>
-    class Stack : private List<T, A, C>
+    template <class T, class A = Allocator<GenericListNode<T> >, class C = Comparator, class S = List<T, A, C> >
+    class Stack : private S
     {
     public:
         /**
@@ -79,54 +83,62 @@ namespace capu
         void clear();
     };
 
-    template <class T, class A, class C>
-    inline Stack<T, A, C>::Stack()
+    template <class T, class A, class C, class S>
+    inline Stack<T, A, C, S>::Stack()
     {
     }
 
-    template <class T, class A, class C>
-    inline Stack<T, A, C>::~Stack()
+    template <class T, class A, class C, class S>
+    inline Stack<T, A, C, S>::~Stack()
     {
     }
 
-    template <class T, class A, class C>
-    status_t Stack<T, A, C>::pop(T* element)
+    template <class T, class A, class C, class S>
+    status_t Stack<T, A, C, S>::pop(T* element)
     {
-        return List<T, A, C>::erase(0, element);
+        if (isEmpty())
+        {
+            return CAPU_EINVAL;
+        }
+        if (element)
+        {
+            *element = S::front(); // copy out
+        }
+        return S::pop_front();
     }
 
-    template <class T, class A, class C>
-    int_t Stack<T, A, C>::size() const
+    template <class T, class A, class C, class S>
+    int_t Stack<T, A, C, S>::size() const
     {
-        return List<T, A, C>::size();
+        return S::size();
     }
 
-    template <class T, class A, class C>
-    void Stack<T, A, C>::clear()
+    template <class T, class A, class C, class S>
+    void Stack<T, A, C, S>::clear()
     {
-        List<T, A, C>::clear();
+        S::clear();
     }
 
-    template <class T, class A, class C>
-    bool_t Stack<T, A, C>::isEmpty() const
+    template <class T, class A, class C, class S>
+    bool_t Stack<T, A, C, S>::isEmpty() const
     {
-        return List<T, A, C>::isEmpty();
+        return S::isEmpty();
     }
 
-    template <class T, class A, class C>
-    status_t Stack<T, A, C>::push(const T& element)
+    template <class T, class A, class C, class S>
+    status_t Stack<T, A, C, S>::push(const T& element)
     {
-        return List<T, A, C>::insert(0, element);
+        return S::push_front(element);
     }
 
-    template <class T, class A, class C>
-    status_t Stack<T, A, C>::peek(T& element) const
+    template <class T, class A, class C, class S>
+    status_t Stack<T, A, C, S>::peek(T& element) const
     {
         if (isEmpty())
         {
             return CAPU_EINVAL;
         }
-        element = List<T, A, C>::front();
+        element = S::front();
         return CAPU_OK;
     }
 
@@ -85,6 +85,16 @@ namespace capu
          */
         String& operator=(const char_t* other);
 
+        /**
+         * Assign a number of characters, which need not be terminated.
+         * The current buffer is reused if it is large enough, so assigning
+         * to the same string again and again does not allocate.
+         * @param data The characters to copy, must not point into this string
+         * @param length The number of characters
+         * @return Reference to this string
+         */
+        String& assign(const char_t* data, const uint_t length);
+
         /**
          * Add two strings together and return the concatenated string
          */
@@ -105,6 +115,11 @@ namespace capu
          */
         bool_t operator!=(const String& other) const;
 
+        /**
+         * Return if this string sorts before another
+         */
+        bool_t operator<(const String& other) const;
+
         /**
          * Return the string as characters
          */
@@ -324,6 +339,19 @@ namespace capu
         return *this;
     }
 
+    inline String& String::assign(const char_t* data, const uint_t length)
+    {
+        if (m_data.size() <= length)
+        {
+            Array<char_t> tmpArray(length + 1); // with ending \0
+            capu::swap(m_data, tmpArray);
+        }
+        Memory::Copy(m_data.getRawData(), data, length);
+        m_data[length] = 0;
+        m_size = length;
+        return *this;
+    }
+
     inline String String::operator+(const String& rOperand)
     {
         String result(*this);
@@ -352,6 +380,11 @@ namespace capu
         return !operator==(other);
     }
 
+    inline bool_t String::operator<(const String& other) const
+    {
+        return StringUtils::Strcmp(c_str(), other.c_str()) < 0;
+    }
+
     inline String& String::append(const String& other)
     {
         return append(other.c_str());
@@ -359,26 +392,12 @@ namespace capu
 
     inline void String::toUpperCase()
     {
-        uint_t length = getLength();
-        for (uint_t i = 0; i < length; ++i)
-        {
-            if (m_data[i] > 96 && m_data[i] < 123) // ascii 'a' - 'z' (german umlauts missing!)
-            {
-                m_data[i] -= 32;
-            }
-        }
+        StringUtils::ToUpperCase(m_data.getRawData(), getLength());
     }
 
     inline void String::toLowerCase()
     {
-        uint_t length = getLength();
-        for (uint_t i = 0; i < length; ++i)
-        {
-            if (m_data[i] > 64 && m_data[i] < 91) // ascii 'A' - 'Z' (german umlauts missing!)
-            {
-                m_data[i] += 32;
-            }
-        }
+        StringUtils::ToLowerCase(m_data.getRawData(), getLength());
     }
 
     inline String& String::append(const char_t* other)
@@ -437,17 +456,17 @@ namespace capu
 
     inline int_t String::find(const char_t ch) const
     {
-        return ConstString(c_str()).find(ch);
+        return StringUtils::IndexOf(c_str(), ch);
     }
 
     inline int_t String::find(const String& substr) const
     {
-        return ConstString(c_str()).find(ConstString(substr.c_str()));
+        return StringUtils::IndexOf(c_str(), m_size, substr.c_str(), substr.m_size);
     }
 
     inline int_t String::rfind(const char_t ch) const
     {
-        return ConstString(c_str()).rfind(ch);
+        return StringUtils::LastIndexOf(c_str(), ch);
     }
 
     inline String& String::swap(String& other)
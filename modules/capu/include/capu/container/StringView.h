@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_STRINGVIEW_H
+#define CAPU_STRINGVIEW_H
+
+#include <capu/Config.h>
+#include <capu/container/String.h>
+#include <capu/os/Memory.h>
+#include <capu/os/StringUtils.h>
+
+namespace capu
+{
+    /**
+     * Refers to a number of characters owned by someone else, like ConstString,
+     * but the characters need not be terminated. This allows to refer to strings
+     * inside of a message buffer without copying them. The view is only valid as
+     * long as the characters it points to.
+     */
+    class StringView
+    {
+    public:
+        /**
+         * Constructs an empty view
+         */
+        StringView();
+
+        /**
+         * Constructs a view of a terminated string
+         * @param str the characters to refer to
+         */
+        StringView(const char_t* str);
+
+        /**
+         * Constructs a view of a number of characters
+         * @param data the first character
+         * @param length the number of characters
+         */
+        StringView(const char_t* data, const uint_t length);
+
+        /**
+         * Constructs a view of a String
+         * @param str the string to refer to
+         */
+        StringView(const String& str);
+
+        /**
+         * Returns a pointer to the first character. The characters are not terminated.
+         * @return a pointer to the first character
+         */
+        const char_t* data() const;
+
+        /**
+         * Returns the number of characters
+         * @return the number of characters
+         */
+        uint_t length() const;
+
+        /**
+         * Returns true if the view has no characters
+         * @return true if the view has no characters
+         */
+        bool_t empty() const;
+
+        /**
+         * Compares the characters of two views
+         * @param other view to compare with
+         * @return true if both views have the same characters, false otherwise
+         */
+        bool_t operator==(const StringView& other) const;
+
+        /**
+         * Compares the characters of two views
+         * @param other view to compare with
+         * @return true if the views differ, false otherwise
+         */
+        bool_t operator!=(const StringView& other) const;
+
+        /**
+         * Copies the characters into a String
+         * @return a String with the characters of the view
+         */
+        String toString() const;
+
+    private:
+        const char_t* m_data;
+        uint_t m_length;
+    };
+
+    inline
+    StringView::StringView()
+        : m_data("")
+        , m_length(0)
+    {
+    }
+
+    inline
+    StringView::StringView(const char_t* str)
+        : m_data(str ? str : "")
+        , m_length(StringUtils::Strlen(str))
+    {
+    }
+
+    inline
+    StringView::StringView(const char_t* data, const uint_t length)
+        : m_data(data)
+        , m_length(length)
+    {
+    }
+
+    inline
+    StringView::StringView(const String& str)
+        : m_data(str.c_str())
+        , m_length(str.getLength())
+    {
+    }
+
+    inline
+    const char_t*
+    StringView::data() const
+    {
+        return m_data;
+    }
+
+    inline
+    uint_t
+    StringView::length() const
+    {
+        return m_length;
+    }
+
+    inline
+    bool_t
+    StringView::empty() const
+    {
+        return m_length == 0;
+    }
+
+    inline
+    bool_t
+    StringView::operator==(const StringView& other) const
+    {
+        return m_length == other.m_length && Memory::Compare(m_data, other.m_data, m_length) == 0;
+    }
+
+    inline
+    bool_t
+    StringView::operator!=(const StringView& other) const
+    {
+        return !operator==(other);
+    }
+
+    inline
+    String
+    StringView::toString() const
+    {
+        String result;
+        result.assign(m_data, m_length);
+        return result;
+    }
+}
+
+#endif // CAPU_STRINGVIEW_H
@@ -96,6 +96,24 @@ namespace capu
          */
         const uint32_t size() const;
 
+        /**
+         * Makes room for at least capacity elements, so that push_back does not grow the Vector
+         * @param capacity number of elements the Vector should be able to hold
+         */
+        void reserve(const uint32_t capacity);
+
+        /**
+         * Changes the size of the Vector. New elements are default constructed.
+         * @param size the new size of the Vector
+         */
+        void resize(const uint32_t size);
+
+        /**
+         * Removes all elements. The capacity is kept, the elements are reset to default values
+         * so they do not keep resources alive.
+         */
+        void clear();
+
         /**
          * Operator to access internal data with index
          * @param index of the element to access
@@ -176,10 +194,51 @@ namespace capu
     void
     Vector<T>::grow()
     {
-        Array<T> tmpArray(m_data.size()  * 2);
+        reserve(m_data.size() > 0 ? m_data.size() * 2 : 16);
+    }
+
+    template<typename T>
+    inline
+    void
+    Vector<T>::reserve(const uint32_t capacity)
+    {
+        if (capacity <= m_data.size())
+        {
+            return;
+        }
+
+        Array<T> tmpArray(capacity);
         m_data.swap(tmpArray);
 
-        Memory::CopyObject(m_data.getRawData(), tmpArray.getRawData(), tmpArray.size());
+        if (m_size > 0)
+        {
+            Memory::CopyObject(m_data.getRawData(), tmpArray.getRawData(), m_size);
+        }
+    }
+
+    template<typename T>
+    inline
+    void
+    Vector<T>::resize(const uint32_t size)
+    {
+        reserve(size);
+        for (uint32_t i = m_size; i < size; ++i)
+        {
+            m_data[i] = T();
+        }
+        m_size = size;
+    }
+
+    template<typename T>
+    inline
+    void
+    Vector<T>::clear()
+    {
+        for (uint32_t i = 0; i < m_size; ++i)
+        {
+            m_data[i] = T();
+        }
+        m_size = 0;
     }
 
     template<typename T>
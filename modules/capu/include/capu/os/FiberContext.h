@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FIBERCONTEXT_H
+#define CAPU_FIBERCONTEXT_H
+
+#include "capu/Config.h"
+#include "capu/os/PlatformInclude.h"
+
+namespace capu
+{
+    /**
+     * Function a fiber starts with. It must not return, the fiber has to switch away at its end.
+     */
+    typedef void (*FiberEntryFunction)(void* argument);
+}
+
+#include CAPU_PLATFORM_INCLUDE(FiberContext)
+
+namespace capu
+{
+    /**
+     * Saved execution state of a fiber: the registers a function call has to preserve and the
+     * stack pointer. Switching contexts is an ordinary function call in user space, there is no
+     * kernel transition, so a switch costs about as much as an indirect call.
+     */
+    class FiberContext: private os::arch::FiberContext
+    {
+    public:
+        /**
+         * Maps a stack. With a guard page an inaccessible page below the stack turns an overflow
+         * into a fault instead of silently overwriting other memory, but every guarded stack costs
+         * two memory mappings of which the system only allows a limited number per process.
+         * @param size usable size of the stack, rounded up to whole pages
+         * @param guardPage put an inaccessible page below the stack
+         * @return lowest usable address of the stack, NULL if no memory could be mapped
+         */
+        static void* AllocateStack(const uint_t size, const bool_t guardPage);
+
+        /**
+         * Unmaps a stack from AllocateStack.
+         * @param stack the address AllocateStack returned
+         * @param size the size given to AllocateStack
+         * @param guardPage the guard page flag given to AllocateStack
+         */
+        static void FreeStack(void* stack, const uint_t size, const bool_t guardPage);
+
+        /**
+         * Prepares the context to call entry(argument) on the given stack when it is switched to
+         * the first time.
+         * @param stack lowest address of the stack
+         * @param stackSize size of the stack in bytes
+         * @param entry the function to start with, it must never return
+         * @param argument passed to entry
+         */
+        void init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument);
+
+        /**
+         * Saves the state of the caller in from and continues with to. The call returns when
+         * another switch targets from again, possibly on a different thread.
+         * @param from receives the state of the caller
+         * @param to the context to continue with
+         */
+        static void Switch(FiberContext& from, FiberContext& to);
+    };
+
+    inline
+    void*
+    FiberContext::AllocateStack(const uint_t size, const bool_t guardPage)
+    {
+        return os::arch::FiberContext::AllocateStack(size, guardPage);
+    }
+
+    inline
+    void
+    FiberContext::FreeStack(void* stack, const uint_t size, const bool_t guardPage)
+    {
+        os::arch::FiberContext::FreeStack(stack, size, guardPage);
+    }
+
+    inline
+    void
+    FiberContext::init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument)
+    {
+        os::arch::FiberContext::init(stack, stackSize, entry, argument);
+    }
+
+    inline
+    void
+    FiberContext::Switch(FiberContext& from, FiberContext& to)
+    {
+        os::arch::FiberContext::Switch(from, to);
+    }
+}
+
+#endif // CAPU_FIBERCONTEXT_H
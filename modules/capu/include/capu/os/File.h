@@ -35,6 +35,24 @@ namespace capu
         WRITE_EXISTING_BINARY,    // opens file for writing in binary mode
         READ_EXISTING_BINARY      // opens file for reading in binary mode
     };
+
+    /**
+     * Interface to observe and cancel File::copyTo
+     */
+    class IFileCopyListener
+    {
+    public:
+        virtual ~IFileCopyListener() {}
+
+        /**
+         * Called whenever a chunk of the file has been copied.
+         * @param copiedBytes number of bytes copied so far
+         * @param totalBytes size of the source file
+         * @return CAPU_OK to continue. Any other value cancels the copy, removes the
+         *         destination and is returned by copyTo.
+         */
+        virtual status_t copyProgress(const uint64_t copiedBytes, const uint64_t totalBytes) = 0;
+    };
 }
 
 #include CAPU_PLATFORM_INCLUDE(File)
@@ -101,12 +119,15 @@ namespace capu
         status_t renameTo(const String& newPath);
 
         /**
-         * Copy the file.
+         * Copy the file. Where the platform allows it the data does not pass user space.
+         * A failed or cancelled copy leaves no destination file behind.
          * @param newPath The filename of the copied file.
+         * @param listener Optional listener which is informed about the progress and can cancel the copy.
          * @return CAPU_OK if file was copied
+         *        the status of the listener if it cancelled the copy
          *        CAPU_ERROR otherwise
          */
-        status_t copyTo(const String& newPath);
+        status_t copyTo(const String& newPath, IFileCopyListener* listener = NULL);
 
         /**
          * return true if file is open else false
@@ -154,6 +175,41 @@ namespace capu
          */
         status_t flush();
 
+        /**
+         * Writes any unwritten data to the file and waits until the storage device
+         * has it. Metadata like the modification time is only synchronized where
+         * the platform requires it. Expensive, callers should batch their writes.
+         * @return CAPU_OK if the data was synchronized
+         *         CAPU_ERROR if the file is not open or synchronizing failed
+         */
+        status_t sync();
+
+        /**
+         * Get the descriptor of the open file for platform specific operations like
+         * TcpSocket::sendFile. Data written through this File has to be flushed first.
+         * @return the native descriptor, invalid if the file is not open
+         */
+        capu::os::arch::FileDescriptor getFileDescriptor() const;
+
+        /**
+         * Maps the whole file read only into memory. The file does not have to be open.
+         * Mapping an already mapped file returns the existing mapping.
+         * @param data receives the start of the mapping
+         * @param size receives the size of the mapping in bytes
+         * @return CAPU_OK if the file was mapped
+         *         CAPU_ENOT_EXIST if the file does not exist
+         *         CAPU_EINVAL if the file is empty
+         *         CAPU_ERROR otherwise
+         */
+        status_t mapReadOnly(const char_t*& data, uint_t& size);
+
+        /**
+         * Releases the mapping of mapReadOnly. The destructor does this as well.
+         * @return CAPU_OK if the mapping was released
+         *         CAPU_ERROR if the file is not mapped
+         */
+        status_t unmap();
+
         /**
          * Close the stream.
          *@return
@@ -248,6 +304,34 @@ namespace capu
         return capu::os::arch::File::flush();
     }
 
+    inline
+    status_t
+    File::sync()
+    {
+        return capu::os::arch::File::sync();
+    }
+
+    inline
+    capu::os::arch::FileDescriptor
+    File::getFileDescriptor() const
+    {
+        return capu::os::arch::File::getFileDescriptor();
+    }
+
+    inline
+    status_t
+    File::mapReadOnly(const char_t*& data, uint_t& size)
+    {
+        return capu::os::arch::File::mapReadOnly(data, size);
+    }
+
+    inline
+    status_t
+    File::unmap()
+    {
+        return capu::os::arch::File::unmap();
+    }
+
     inline
     status_t
     File::close()
@@ -292,9 +376,9 @@ namespace capu
 
     inline
     status_t
-    File::copyTo(const capu::String& newPath)
+    File::copyTo(const capu::String& newPath, IFileCopyListener* listener)
     {
-        return capu::os::arch::File::copyTo(newPath);
+        return capu::os::arch::File::copyTo(newPath, listener);
     }
 
     inline
@@ -19,6 +19,7 @@
 
 #include "capu/util/Traits.h"
 #include <cstring>
+#include <cstdlib>
 
 namespace capu
 {
@@ -37,8 +38,73 @@ namespace capu
 
             template<typename T>
             static void MoveObject(T* dst, const T* src, const uint_t size); // move with assignment operator
+
+            static void* AllocateAligned(const uint_t size, const uint_t alignment);
+            static void FreeAligned(void* ptr);
+            static void* AllocateLarge(const uint_t size);
+            static void FreeLarge(void* ptr, const uint_t size);
+            static void Prefetch(const void* address);
+            static void CopyNonTemporal(void* dst, const void* src, const uint_t size);
         };
 
+        inline
+        void* Memory::AllocateAligned(const uint_t size, const uint_t alignment)
+        {
+            if (size == 0 || alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+            {
+                return 0;
+            }
+
+            // over allocate and remember the original pointer right in front of the aligned block
+            char_t* raw = static_cast<char_t*>(malloc(size + alignment - 1 + sizeof(void*)));
+            if (!raw)
+            {
+                return 0;
+            }
+            const uint_t start = reinterpret_cast<uint_t>(raw + sizeof(void*));
+            void** aligned = reinterpret_cast<void**>((start + alignment - 1) & ~(alignment - 1));
+            aligned[-1] = raw;
+            return aligned;
+        }
+
+        inline
+        void Memory::FreeAligned(void* ptr)
+        {
+            if (ptr)
+            {
+                free(static_cast<void**>(ptr)[-1]);
+            }
+        }
+
+        inline
+        void* Memory::AllocateLarge(const uint_t size)
+        {
+            // no huge page support, at least start on a page boundary
+            return AllocateAligned(size, 4096);
+        }
+
+        inline
+        void Memory::FreeLarge(void* ptr, const uint_t)
+        {
+            FreeAligned(ptr);
+        }
+
+        inline
+        void Memory::Prefetch(const void* address)
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(address);
+#else
+            (void)address;
+#endif
+        }
+
+        inline
+        void Memory::CopyNonTemporal(void* dst, const void* src, const uint_t size)
+        {
+            memcpy(dst, src, size);
+        }
+
         inline
         void Memory::Set(void* dst, int32_t val, uint_t size)
         {
@@ -69,6 +135,11 @@ namespace capu
             static void DeepCopyDescending(T* dst, const T* src, const uint_t count)
             {
                 // default copy method: deep copy with assignment operator
+                if (count == 0)
+                {
+                    // the unrolled copy below starts with the default case
+                    return;
+                }
 
                 const T* currentSrc = &src[count];
                 T* currentDst = &dst[count];
@@ -18,11 +18,17 @@
 #define CAPU_GENERIC_RANDOM_H
 
 #include "capu/os/Time.h"
+#include "capu/os/AtomicOperation.h"
+#include <cstring>
 
 namespace capu
 {
     namespace os
     {
+        /**
+         * xoshiro256** generator. Every instance owns its state, so no global
+         * state and no lock is involved in drawing numbers.
+         */
         class Random
         {
         public:
@@ -30,28 +36,125 @@ namespace capu
             uint8_t nextUInt8();
             uint16_t nextUInt16();
             uint32_t nextUInt32();
+            uint64_t nextUInt64();
+            void fill(void* buffer, uint_t length);
+            static void FillThreadLocal(void* buffer, uint_t length);
+
+        private:
+            struct State
+            {
+                uint64_t s[4];
+            };
+
+            static void Seed(State& state);
+            static uint64_t Next(State& state);
+            static void Fill(State& state, void* buffer, uint_t length);
+            static uint64_t SplitMix64(uint64_t& x);
+            static uint64_t Rotl(const uint64_t x, const int32_t k);
+
+            State mState;
         };
 
         inline Random::Random()
         {
-            srand(static_cast<uint32_t>(Time::GetMilliseconds()));
+            Seed(mState);
+        }
+
+        inline uint64_t Random::Rotl(const uint64_t x, const int32_t k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        inline uint64_t Random::SplitMix64(uint64_t& x)
+        {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        inline void Random::Seed(State& state)
+        {
+            // the sequence number separates generators created within the same millisecond,
+            // the address separates generators of different threads
+            static volatile uint32_t sequence = 0;
+            uint64_t seed = Time::GetMilliseconds();
+            seed ^= static_cast<uint64_t>(AtomicOperation::AtomicInc32(sequence)) << 40;
+            seed ^= static_cast<uint64_t>(reinterpret_cast<uint_t>(&state));
+
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                state.s[i] = SplitMix64(seed);
+            }
+        }
+
+        inline uint64_t Random::Next(State& state)
+        {
+            uint64_t* s = state.s;
+            const uint64_t result = Rotl(s[1] * 5, 7) * 9;
+            const uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = Rotl(s[3], 45);
+
+            return result;
+        }
+
+        inline void Random::Fill(State& state, void* buffer, uint_t length)
+        {
+            uint8_t* current = static_cast<uint8_t*>(buffer);
+            while (length >= sizeof(uint64_t))
+            {
+                const uint64_t value = Next(state);
+                memcpy(current, &value, sizeof(uint64_t));
+                current += sizeof(uint64_t);
+                length -= sizeof(uint64_t);
+            }
+            if (length > 0)
+            {
+                const uint64_t value = Next(state);
+                memcpy(current, &value, length);
+            }
         }
 
         inline uint8_t Random::nextUInt8()
         {
-            return static_cast<uint8_t>(nextUInt16());
+            return static_cast<uint8_t>(Next(mState) >> 56);
         }
 
         inline uint16_t Random::nextUInt16()
         {
-            // RAND_MAX is at least 32767, which are 15 bit, so we need to shift here already
-            return static_cast<uint16_t>((rand() << 8) | rand()); // avoid compiler warnings.
+            return static_cast<uint16_t>(Next(mState) >> 48);
         }
 
         inline uint32_t Random::nextUInt32()
         {
-            // because RAND_MAX is not guarantueed to be bigger than 32767, we do the distribution on ourself.
-            return nextUInt16() | (nextUInt16() << 16);
+            return static_cast<uint32_t>(Next(mState) >> 32);
+        }
+
+        inline uint64_t Random::nextUInt64()
+        {
+            return Next(mState);
+        }
+
+        inline void Random::fill(void* buffer, uint_t length)
+        {
+            Fill(mState, buffer, length);
+        }
+
+        inline void Random::FillThreadLocal(void* buffer, uint_t length)
+        {
+            // zero initialized per thread, an all zero state is never produced by Seed
+            static CAPU_THREAD_LOCAL State threadState;
+            if ((threadState.s[0] | threadState.s[1] | threadState.s[2] | threadState.s[3]) == 0)
+            {
+                Seed(threadState);
+            }
+            Fill(threadState, buffer, length);
         }
     }
 }
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAPU_GENERIC_STRINGUTILS_H
+#define CAPU_GENERIC_STRINGUTILS_H
+
+#include "capu/Config.h"
+#include <string.h>
+
+namespace capu
+{
+    namespace generic
+    {
+        class StringUtils
+        {
+        public:
+            static int_t IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength);
+            static void ToUpperCase(char_t* str, const uint_t length);
+            static void ToLowerCase(char_t* str, const uint_t length);
+        };
+
+        inline
+        int_t
+        StringUtils::IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength)
+        {
+            if (substrLength == 0)
+            {
+                return 0;
+            }
+            if (substrLength > length)
+            {
+                return -1;
+            }
+
+            const char_t* current = str;
+            const char_t* last = str + (length - substrLength);
+            while (current <= last)
+            {
+                // skip to the next candidate for the first character
+                current = static_cast<const char_t*>(memchr(current, substr[0], last - current + 1));
+                if (!current)
+                {
+                    return -1;
+                }
+                if (memcmp(current + 1, substr + 1, substrLength - 1) == 0)
+                {
+                    return current - str;
+                }
+                ++current;
+            }
+            return -1;
+        }
+
+        inline
+        void
+        StringUtils::ToUpperCase(char_t* str, const uint_t length)
+        {
+            for (uint_t i = 0; i < length; ++i)
+            {
+                if (str[i] > 96 && str[i] < 123) // ascii 'a' - 'z' (german umlauts missing!)
+                {
+                    str[i] -= 32;
+                }
+            }
+        }
+
+        inline
+        void
+        StringUtils::ToLowerCase(char_t* str, const uint_t length)
+        {
+            for (uint_t i = 0; i < length; ++i)
+            {
+                if (str[i] > 64 && str[i] < 91) // ascii 'A' - 'Z' (german umlauts missing!)
+                {
+                    str[i] += 32;
+                }
+            }
+        }
+    }
+}
+#endif // CAPU_GENERIC_STRINGUTILS_H
@@ -18,6 +18,7 @@
 #define CAPU_GENERIC_THREAD_H
 
 #include "capu/util/Runnable.h"
+#include "capu/os/ThreadAttributes.h"
 
 namespace capu
 {
@@ -34,6 +35,9 @@ namespace capu
 
             Thread* thread;
             Runnable* runnable;
+
+            // applied by the new thread itself before the runnable runs, where supported
+            char_t name[ThreadAttributes::MaxNameLength + 1];
         };
 
         class Thread
@@ -57,6 +61,7 @@ namespace capu
             : thread(NULL)
             , runnable(NULL)
         {
+            name[0] = 0;
         }
 
         inline
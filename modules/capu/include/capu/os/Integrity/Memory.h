@@ -33,6 +33,12 @@ namespace capu
             using capu::generic::Memory::Compare;
             using capu::generic::Memory::CopyObject;
             using capu::generic::Memory::Copy;
+            using capu::generic::Memory::AllocateAligned;
+            using capu::generic::Memory::FreeAligned;
+            using capu::generic::Memory::AllocateLarge;
+            using capu::generic::Memory::FreeLarge;
+            using capu::generic::Memory::Prefetch;
+            using capu::generic::Memory::CopyNonTemporal;
             static uint_t CurrentMemoryUsage();
         };
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_LINUX_ARMV7L_FIBERCONTEXT_H
+#define CAPU_LINUX_ARMV7L_FIBERCONTEXT_H
+
+#include <capu/os/Linux/FiberContext.h>
+
+/**
+ * Words of d8-d15 in a saved frame. These registers have to be preserved whenever the core has
+ * VFP registers, also with the softfp calling convention.
+ */
+#if defined(__VFP_FP__) && !defined(__SOFTFP__)
+#define CAPU_FIBER_VFP_WORDS 16
+#else
+#define CAPU_FIBER_VFP_WORDS 0
+#endif
+
+extern "C"
+{
+    // implemented in assembly, see src/os/Linux/ARMV7L/FiberContext.cpp
+    void capu_fiber_switch_armv7l(void** fromStackPointer, void* toStackPointer);
+    void capu_fiber_start_armv7l();
+}
+
+namespace capu
+{
+    namespace os
+    {
+        namespace arch
+        {
+            /**
+             * Keeps the callee saved registers on the stack of the suspended fiber, the context
+             * itself is only the stack pointer.
+             */
+            class FiberContext: private capu::posix::FiberStack
+            {
+            public:
+                FiberContext();
+
+                using capu::posix::FiberStack::AllocateStack;
+                using capu::posix::FiberStack::FreeStack;
+                void init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument);
+                static void Switch(FiberContext& from, FiberContext& to);
+
+            private:
+                void* mStackPointer;
+            };
+
+            inline FiberContext::FiberContext()
+                : mStackPointer(0)
+            {
+            }
+
+            inline void FiberContext::init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument)
+            {
+                // build the frame capu_fiber_switch_armv7l leaves behind: d8-d15, r4-r11 and lr, so
+                // the first switch returns into capu_fiber_start_armv7l with argument in r4 and entry
+                // in r5. The stack pointer after popping the frame is 8 byte aligned as AAPCS requires.
+                const uint_t top = (reinterpret_cast<uint_t>(stack) + stackSize) & ~static_cast<uint_t>(7);
+                const uint_t words = CAPU_FIBER_VFP_WORDS + 9;
+                uint32_t* frame = reinterpret_cast<uint32_t*>(top - 8) - words;
+                for (uint_t i = 0; i < words; ++i)
+                {
+                    frame[i] = 0;
+                }
+                uint32_t* registers = frame + CAPU_FIBER_VFP_WORDS;
+                registers[0] = reinterpret_cast<uint32_t>(argument); // r4
+                registers[1] = reinterpret_cast<uint32_t>(entry); // r5
+                registers[8] = reinterpret_cast<uint32_t>(&capu_fiber_start_armv7l); // lr, popped into pc
+                mStackPointer = frame;
+            }
+
+            inline void FiberContext::Switch(FiberContext& from, FiberContext& to)
+            {
+                capu_fiber_switch_armv7l(&from.mStackPointer, to.mStackPointer);
+            }
+        }
+    }
+}
+
+#endif // CAPU_LINUX_ARMV7L_FIBERCONTEXT_H
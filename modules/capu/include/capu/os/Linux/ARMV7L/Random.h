@@ -31,6 +31,9 @@ namespace capu
                 using capu::os::Random::nextUInt8;
                 using capu::os::Random::nextUInt16;
                 using capu::os::Random::nextUInt32;
+                using capu::os::Random::nextUInt64;
+                using capu::os::Random::fill;
+                using capu::os::Random::FillThreadLocal;
             };
         }
     }
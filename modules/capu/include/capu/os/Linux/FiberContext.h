@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_LINUX_FIBERCONTEXT_H
+#define CAPU_LINUX_FIBERCONTEXT_H
+
+#include <capu/os/Posix/FiberContext.h>
+
+namespace capu
+{
+    namespace os
+    {
+        class FiberContext: private capu::posix::FiberContext
+        {
+        public:
+            using capu::posix::FiberContext::AllocateStack;
+            using capu::posix::FiberContext::FreeStack;
+            using capu::posix::FiberContext::init;
+            static void Switch(FiberContext& from, FiberContext& to);
+        };
+
+        inline void FiberContext::Switch(FiberContext& from, FiberContext& to)
+        {
+            // the base is private, callers cannot convert to it themselves
+            capu::posix::FiberContext::Switch(from, to);
+        }
+    }
+}
+
+#endif // CAPU_LINUX_FIBERCONTEXT_H
@@ -19,7 +19,9 @@
 
 #include <capu/os/Posix/File.h>
 #include <sys/sendfile.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
+#include <errno.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -29,6 +31,8 @@ namespace capu
 {
     namespace os
     {
+        typedef capu::posix::FileDescriptor FileDescriptor;
+
         class File: private capu::posix::File
         {
         public:
@@ -40,6 +44,10 @@ namespace capu
             using capu::posix::File::read;
             using capu::posix::File::write;
             using capu::posix::File::flush;
+            using capu::posix::File::sync;
+            using capu::posix::File::getFileDescriptor;
+            using capu::posix::File::mapReadOnly;
+            using capu::posix::File::unmap;
             using capu::posix::File::close;
             using capu::posix::File::renameTo;
             using capu::posix::File::createFile;
@@ -52,7 +60,10 @@ namespace capu
             using capu::posix::File::getParentPath;
             using capu::posix::File::getSizeInBytes;
             using capu::posix::File::isDirectory;
-            status_t copyTo(const capu::String& otherFilename);
+            status_t copyTo(const capu::String& otherFilename, IFileCopyListener* listener);
+        private:
+            static const uint64_t CopyChunkSize = 64 * 1024 * 1024;
+            static status_t CopyInKernel(int_t sourceFile, int_t destinationFile, const uint64_t size, uint64_t& copied, IFileCopyListener* listener);
         };
 
         inline
@@ -68,40 +79,98 @@ namespace capu
         }
 
         inline
-        status_t File::copyTo(const capu::String& otherFilename)
+        status_t File::copyTo(const capu::String& otherFilename, IFileCopyListener* listener)
         {
-            int_t sourceFile = ::open(mPath.c_str(), O_RDONLY, 0);
-            if (-1 == sourceFile)
+            int_t sourceFile = -1;
+            int_t destinationFile = -1;
+            uint64_t size = 0;
+            status_t status = OpenCopyFiles(mPath, otherFilename, sourceFile, destinationFile, size);
+            if (status != CAPU_OK)
             {
-                return CAPU_ERROR;
+                return status;
             }
 
-            struct stat sourceAttributes;
-            int_t status = fstat(sourceFile, &sourceAttributes);
-            if (status != 0)
+            uint64_t copied = 0;
+            if (size == 0)
             {
-                ::close(sourceFile);
-                return CAPU_ERROR;
+                // files in /proc and similar report no size, only reading them tells the content
+                status = CopyBuffered(sourceFile, destinationFile, size, copied, listener);
+                return FinishCopy(sourceFile, destinationFile, otherFilename, status);
             }
 
-            // make sure file is not present
-            File destFile(otherFilename);
-            destFile.remove();
+            // reserve the blocks at once to avoid fragmentation, not every file system supports it
+            fallocate(destinationFile, 0, 0, size);
 
-            int_t destinationFile = ::open(otherFilename.c_str(), O_WRONLY | O_CREAT, 0644);
-            if (-1 == destinationFile)
+            status = CopyInKernel(sourceFile, destinationFile, size, copied, listener);
+            if (status == CAPU_ENOT_SUPPORTED)
             {
-                ::close(sourceFile);
-                return CAPU_ERROR;
+                status = CopyBuffered(sourceFile, destinationFile, size, copied, listener);
             }
-            int bytesSent = sendfile(destinationFile, sourceFile, 0, sourceAttributes.st_size);
-
-            ::close(sourceFile);
-            ::close(destinationFile);
+            if (status == CAPU_OK && copied != size && ftruncate(destinationFile, copied) != 0)
+            {
+                // the source shrunk while copying, drop the preallocated rest
+                status = CAPU_ERROR;
+            }
+            return FinishCopy(sourceFile, destinationFile, otherFilename, status);
+        }
 
-            if (bytesSent != sourceAttributes.st_size)
+        inline
+        status_t File::CopyInKernel(int_t sourceFile, int_t destinationFile, const uint64_t size, uint64_t& copied, IFileCopyListener* listener)
+        {
+            // copy_file_range lets the file system clone or copy server side, sendfile
+            // at least keeps the data in the kernel. Both advance the file offsets, so a
+            // fallback can continue where the previous method stopped.
+            bool_t useCopyFileRange = true;
+            while (copied < size)
             {
-                return CAPU_ERROR;
+                const uint64_t remaining = size - copied;
+                const size_t chunk = static_cast<size_t>(remaining < CopyChunkSize ? remaining : static_cast<uint64_t>(CopyChunkSize));
+                ssize_t result = -1;
+                if (useCopyFileRange)
+                {
+#ifdef SYS_copy_file_range
+                    result = syscall(SYS_copy_file_range, sourceFile, NULL, destinationFile, NULL, chunk, 0u);
+#else
+                    errno = ENOSYS;
+#endif
+                    if (result < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+                    {
+                        useCopyFileRange = false;
+                        continue;
+                    }
+                }
+                else
+                {
+                    result = sendfile(destinationFile, sourceFile, NULL, chunk);
+                    if (result < 0 && (errno == ENOSYS || errno == EINVAL))
+                    {
+                        return CAPU_ENOT_SUPPORTED;
+                    }
+                }
+
+                if (result < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return CAPU_ERROR;
+                }
+                if (result == 0)
+                {
+                    // the source is shorter than reported
+                    break;
+                }
+
+                copied += result;
+                if (listener)
+                {
+                    const status_t status = listener->copyProgress(copied, size);
+                    if (status != CAPU_OK)
+                    {
+                        return status;
+                    }
+                }
             }
             return CAPU_OK;
         }
@@ -35,6 +35,8 @@ namespace capu
             using capu::posix::StringUtils::LastIndexOf;
             using capu::posix::StringUtils::IndexOf;
             using capu::posix::StringUtils::StartsWith;
+            using capu::posix::StringUtils::ToUpperCase;
+            using capu::posix::StringUtils::ToLowerCase;
         };
     }
 }
@@ -18,6 +18,9 @@
 #define CAPU_LINUX_TCP_SOCKET_H
 
 #include <capu/os/Posix/TcpSocket.h>
+#ifndef __APPLE__
+#include <sys/sendfile.h>
+#endif
 
 namespace capu
 {
@@ -44,7 +47,13 @@ namespace capu
             using capu::posix::TcpSocket::getNoDelay;
             using capu::posix::TcpSocket::getKeepAlive;
             using capu::posix::TcpSocket::getTimeout;
-
+            using capu::posix::TcpSocket::getSocketDescription;
+#ifdef __APPLE__
+            // MacOSX shares this header, but has a sendfile with different semantics
+            using capu::posix::TcpSocket::sendFile;
+#else
+            status_t sendFile(int_t fileDescriptor, uint64_t offset, uint_t length, uint_t& sentBytes);
+#endif
         };
 
         inline
@@ -58,6 +67,48 @@ namespace capu
         {
 
         }
+
+#ifndef __APPLE__
+        inline
+        status_t
+        TcpSocket::sendFile(int_t fileDescriptor, uint64_t offset, uint_t length, uint_t& sentBytes)
+        {
+            sentBytes = 0;
+            if (fileDescriptor < 0)
+            {
+                return CAPU_EINVAL;
+            }
+            if (mSocket == -1)
+            {
+                return CAPU_SOCKET_ESOCKET;
+            }
+            if (length == 0)
+            {
+                return CAPU_OK;
+            }
+
+            // the data goes from the page cache to the socket without a copy through user space
+            const uint_t maxLength = 0x7ffff000; // maximum transfer of a single sendfile call
+            off64_t fileOffset = offset;
+            ssize_t res;
+            do
+            {
+                res = sendfile64(mSocket, fileDescriptor, &fileOffset, length < maxLength ? length : maxLength);
+            }
+            while (res < 0 && errno == EINTR);
+
+            if (res < 0)
+            {
+                return (errno == EAGAIN || errno == EWOULDBLOCK) ? CAPU_ETIMEOUT : CAPU_ERROR;
+            }
+            if (res == 0)
+            {
+                return CAPU_EOF;
+            }
+            sentBytes = res;
+            return CAPU_OK;
+        }
+#endif
     }
 }
 #endif // CAPU_LINUX_TCP_SOCKET_H
@@ -33,15 +33,96 @@ namespace capu
             using capu::posix::Thread::resetCancel;
             using capu::posix::Thread::getState;
             using capu::posix::Thread::Sleep;
+            status_t start(Runnable& runnable, const ThreadAttributes& attributes);
             static uint_t CurrentThreadId();
+            static status_t GetAvailableCpus(CpuSet& cpus);
+
+        private:
+            static void* runNamed(void* arg);
         };
 
+        inline
+        void*
+        Thread::runNamed(void* arg)
+        {
+            // named by the thread itself, so the runnable never runs under the inherited name
+            generic::ThreadRunnable* tr = static_cast<generic::ThreadRunnable*>(arg);
+            pthread_setname_np(pthread_self(), tr->name);
+            return posix::Thread::run(arg);
+        }
+
+        inline
+        status_t
+        Thread::start(Runnable& runnable, const ThreadAttributes& attributes)
+        {
+            pthread_attr_t attr;
+            status_t status = InitAttributes(attr, attributes);
+            if (status != CAPU_OK)
+            {
+                return status;
+            }
+
+            const CpuSet& cpus = attributes.getCpuSet();
+            if (!cpus.empty())
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (uint32_t cpu = 0; cpu < CpuSet::MaxCpus; ++cpu)
+                {
+                    if (cpus.contains(cpu))
+                    {
+                        CPU_SET(cpu, &set);
+                    }
+                }
+                if (pthread_attr_setaffinity_np(&attr, sizeof(set), &set) != 0)
+                {
+                    status = CAPU_EINVAL;
+                }
+            }
+            if (status == CAPU_OK)
+            {
+                if (attributes.getName()[0] != 0)
+                {
+                    // the name only helps debugging, the thread keeps running without it
+                    status = create(runnable, attr, &Thread::runNamed, attributes.getName());
+                }
+                else
+                {
+                    status = create(runnable, attr);
+                }
+            }
+            pthread_attr_destroy(&attr);
+            return status;
+        }
+
         inline
         uint_t
         Thread::CurrentThreadId()
         {
             return pthread_self();
         }
+
+        inline
+        status_t
+        Thread::GetAvailableCpus(CpuSet& cpus)
+        {
+            // the affinity of the calling thread, which the threads it creates inherit
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) != 0)
+            {
+                return CAPU_ERROR;
+            }
+            cpus.clear();
+            for (uint32_t cpu = 0; cpu < CpuSet::MaxCpus; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    cpus.add(cpu);
+                }
+            }
+            return CAPU_OK;
+        }
     }
 }
 
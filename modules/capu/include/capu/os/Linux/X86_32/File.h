@@ -25,6 +25,8 @@ namespace capu
     {
         namespace arch
         {
+            typedef capu::os::FileDescriptor FileDescriptor;
+
             class File: private capu::os::File
             {
             public:
@@ -36,6 +38,10 @@ namespace capu
                 using capu::os::File::read;
                 using capu::os::File::write;
                 using capu::os::File::flush;
+                using capu::os::File::sync;
+                using capu::os::File::getFileDescriptor;
+                using capu::os::File::mapReadOnly;
+                using capu::os::File::unmap;
                 using capu::os::File::close;
                 using capu::os::File::createFile;
                 using capu::os::File::createDirectory;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_LINUX_X86_64_FIBERCONTEXT_H
+#define CAPU_LINUX_X86_64_FIBERCONTEXT_H
+
+#include <capu/os/Linux/FiberContext.h>
+
+extern "C"
+{
+    // implemented in assembly, see src/os/Linux/X86_64/FiberContext.cpp
+    void capu_fiber_switch_x86_64(void** fromStackPointer, void* toStackPointer);
+    void capu_fiber_start_x86_64();
+}
+
+namespace capu
+{
+    namespace os
+    {
+        namespace arch
+        {
+            /**
+             * Keeps the callee saved registers on the stack of the suspended fiber, the context
+             * itself is only the stack pointer.
+             */
+            class FiberContext: private capu::posix::FiberStack
+            {
+            public:
+                FiberContext();
+
+                using capu::posix::FiberStack::AllocateStack;
+                using capu::posix::FiberStack::FreeStack;
+                void init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument);
+                static void Switch(FiberContext& from, FiberContext& to);
+
+            private:
+                void* mStackPointer;
+            };
+
+            inline FiberContext::FiberContext()
+                : mStackPointer(0)
+            {
+            }
+
+            inline void FiberContext::init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument)
+            {
+                // build the frame capu_fiber_switch_x86_64 leaves behind, so the first switch returns
+                // into capu_fiber_start_x86_64 with entry in r13 and argument in r12. The frame starts
+                // 16 byte aligned, which leaves the stack aligned as the ABI requires when entry is called.
+                const uint_t top = (reinterpret_cast<uint_t>(stack) + stackSize) & ~static_cast<uint_t>(15);
+                uint64_t* frame = reinterpret_cast<uint64_t*>(top) - 10;
+                frame[0] = (static_cast<uint64_t>(0x037F) << 32) | 0x1F80; // default MXCSR and x87 control word
+                frame[1] = 0; // r15
+                frame[2] = 0; // r14
+                frame[3] = reinterpret_cast<uint64_t>(entry); // r13
+                frame[4] = reinterpret_cast<uint64_t>(argument); // r12
+                frame[5] = 0; // rbx
+                frame[6] = 0; // rbp
+                frame[7] = reinterpret_cast<uint64_t>(&capu_fiber_start_x86_64);
+                frame[8] = 0;
+                frame[9] = 0;
+                mStackPointer = frame;
+            }
+
+            inline void FiberContext::Switch(FiberContext& from, FiberContext& to)
+            {
+                capu_fiber_switch_x86_64(&from.mStackPointer, to.mStackPointer);
+            }
+        }
+    }
+}
+
+#endif // CAPU_LINUX_X86_64_FIBERCONTEXT_H
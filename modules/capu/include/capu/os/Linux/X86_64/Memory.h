@@ -18,6 +18,7 @@
 #define CAPU_LINUX_X86_64_MEMORY_H
 
 #include <capu/os/Linux/Memory.h>
+#include <emmintrin.h>
 
 namespace capu
 {
@@ -35,7 +36,53 @@ namespace capu
                 using capu::os::Memory::MoveObject;
                 using capu::os::Memory::Set;
                 using capu::os::Memory::CurrentMemoryUsage;
+                using capu::os::Memory::AllocateAligned;
+                using capu::os::Memory::FreeAligned;
+                using capu::os::Memory::AllocateLarge;
+                using capu::os::Memory::FreeLarge;
+                using capu::os::Memory::Prefetch;
+                static void CopyNonTemporal(void* dst, const void* src, const uint_t size);
+
+            private:
+                /**
+                 * Below this size the destination most likely still fits into the cache
+                 * and a regular copy is faster
+                 */
+                static const uint_t NonTemporalThreshold = 256 * 1024;
             };
+
+            inline void Memory::CopyNonTemporal(void* dst, const void* src, const uint_t size)
+            {
+                if (size < NonTemporalThreshold)
+                {
+                    Copy(dst, src, size);
+                    return;
+                }
+
+                // copy the unaligned head regularly so that the streaming stores are aligned
+                char_t* target = static_cast<char_t*>(dst);
+                const char_t* source = static_cast<const char_t*>(src);
+                const uint_t head = (16 - (reinterpret_cast<uint_t>(target) & 15)) & 15;
+                Copy(target, source, head);
+
+                uint_t i = head;
+                for (; i + 64 <= size; i += 64)
+                {
+                    const __m128i* from = reinterpret_cast<const __m128i*>(source + i);
+                    __m128i* to = reinterpret_cast<__m128i*>(target + i);
+                    const __m128i a = _mm_loadu_si128(from);
+                    const __m128i b = _mm_loadu_si128(from + 1);
+                    const __m128i c = _mm_loadu_si128(from + 2);
+                    const __m128i d = _mm_loadu_si128(from + 3);
+                    _mm_stream_si128(to, a);
+                    _mm_stream_si128(to + 1, b);
+                    _mm_stream_si128(to + 2, c);
+                    _mm_stream_si128(to + 3, d);
+                }
+                // streaming stores are weakly ordered, make them visible before returning
+                _mm_sfence();
+                Copy(target + i, source + i, size - i);
+            }
         }
     }
 }
@@ -18,6 +18,7 @@
 #define CAPU_LINUX_X86_64_STRINGUTILS_H
 
 #include <capu/os/Linux/StringUtils.h>
+#include <immintrin.h>
 
 namespace capu
 {
@@ -25,6 +26,12 @@ namespace capu
     {
         namespace arch
         {
+            /**
+             * Substring search and case conversion with SSE2 (always available on x86_64)
+             * and AVX2 (selected at runtime if the cpu supports it). Strlen, Strcmp and the
+             * single character searches stay with libc, which already dispatches to vectorized
+             * implementations.
+             */
             class StringUtils: private capu::os::StringUtils
             {
             public:
@@ -37,9 +44,218 @@ namespace capu
                 using capu::os::StringUtils::LastIndexOf;
                 using capu::os::StringUtils::IndexOf;
                 using capu::os::StringUtils::StartsWith;
+
+                static int_t IndexOf(const char_t* str, const char_t* str2);
+                static int_t IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength);
+                static void ToUpperCase(char_t* str, const uint_t length);
+                static void ToLowerCase(char_t* str, const uint_t length);
+
+            private:
+                static bool_t HasAvx2();
+                static int_t IndexOfSse2(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength);
+                static int_t IndexOfAvx2(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength);
+                static void FlipCaseSse2(char_t* str, const uint_t length, const char_t first, const char_t last);
+                static void FlipCaseAvx2(char_t* str, const uint_t length, const char_t first, const char_t last);
+                static int_t IndexOfTail(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength, uint_t start);
+                static void FlipCaseTail(char_t* str, const uint_t length, const char_t first, const char_t last, uint_t start);
             };
+
+            inline
+            bool_t
+            StringUtils::HasAvx2()
+            {
+                static const bool_t hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+                return hasAvx2;
+            }
+
+            inline
+            int_t
+            StringUtils::IndexOf(const char_t* str, const char_t* str2)
+            {
+                if (!str || !str2)
+                {
+                    return -1;
+                }
+                return IndexOf(str, strlen(str), str2, strlen(str2));
+            }
+
+            inline
+            int_t
+            StringUtils::IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength)
+            {
+                if (substrLength == 0)
+                {
+                    return 0;
+                }
+                if (substrLength > length)
+                {
+                    return -1;
+                }
+                if (substrLength == 1)
+                {
+                    const char_t* pos = static_cast<const char_t*>(memchr(str, substr[0], length));
+                    return pos ? pos - str : -1;
+                }
+                return HasAvx2() ? IndexOfAvx2(str, length, substr, substrLength) : IndexOfSse2(str, length, substr, substrLength);
+            }
+
+            inline
+            void
+            StringUtils::ToUpperCase(char_t* str, const uint_t length)
+            {
+                if (HasAvx2())
+                {
+                    FlipCaseAvx2(str, length, 'a', 'z');
+                }
+                else
+                {
+                    FlipCaseSse2(str, length, 'a', 'z');
+                }
+            }
+
+            inline
+            void
+            StringUtils::ToLowerCase(char_t* str, const uint_t length)
+            {
+                if (HasAvx2())
+                {
+                    FlipCaseAvx2(str, length, 'A', 'Z');
+                }
+                else
+                {
+                    FlipCaseSse2(str, length, 'A', 'Z');
+                }
+            }
+
+            inline
+            int_t
+            StringUtils::IndexOfTail(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength, uint_t start)
+            {
+                for (uint_t i = start; i + substrLength <= length; ++i)
+                {
+                    if (str[i] == substr[0] && memcmp(str + i + 1, substr + 1, substrLength - 1) == 0)
+                    {
+                        return i;
+                    }
+                }
+                return -1;
+            }
+
+            /*
+             * Compares the first and the last character of the substring against 16 (32) positions
+             * at once and only calls memcmp for positions where both match.
+             */
+            inline
+            int_t
+            StringUtils::IndexOfSse2(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength)
+            {
+                const __m128i first = _mm_set1_epi8(substr[0]);
+                const __m128i last = _mm_set1_epi8(substr[substrLength - 1]);
+
+                uint_t i = 0;
+                for (; i + substrLength - 1 + 16 <= length; i += 16)
+                {
+                    const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+                    const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + substrLength - 1));
+                    const __m128i matches = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+                    uint32_t mask = _mm_movemask_epi8(matches);
+                    while (mask != 0)
+                    {
+                        const uint32_t bit = __builtin_ctz(mask);
+                        if (memcmp(str + i + bit + 1, substr + 1, substrLength - 2) == 0)
+                        {
+                            return i + bit;
+                        }
+                        mask &= mask - 1;
+                    }
+                }
+                return IndexOfTail(str, length, substr, substrLength, i);
+            }
+
+            __attribute__((target("avx2")))
+            inline
+            int_t
+            StringUtils::IndexOfAvx2(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength)
+            {
+                const __m256i first = _mm256_set1_epi8(substr[0]);
+                const __m256i last = _mm256_set1_epi8(substr[substrLength - 1]);
+
+                uint_t i = 0;
+                for (; i + substrLength - 1 + 32 <= length; i += 32)
+                {
+                    const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i));
+                    const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str + i + substrLength - 1));
+                    const __m256i matches = _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast));
+                    uint32_t mask = _mm256_movemask_epi8(matches);
+                    while (mask != 0)
+                    {
+                        const uint32_t bit = __builtin_ctz(mask);
+                        if (memcmp(str + i + bit + 1, substr + 1, substrLength - 2) == 0)
+                        {
+                            return i + bit;
+                        }
+                        mask &= mask - 1;
+                    }
+                }
+                return IndexOfTail(str, length, substr, substrLength, i);
+            }
+
+            inline
+            void
+            StringUtils::FlipCaseTail(char_t* str, const uint_t length, const char_t first, const char_t last, uint_t start)
+            {
+                for (uint_t i = start; i < length; ++i)
+                {
+                    if (str[i] >= first && str[i] <= last)
+                    {
+                        str[i] ^= 0x20;
+                    }
+                }
+            }
+
+            /*
+             * Toggles the 0x20 bit of every character within [first, last]. The signed compare
+             * leaves all non ascii characters untouched, like the scalar implementation.
+             */
+            inline
+            void
+            StringUtils::FlipCaseSse2(char_t* str, const uint_t length, const char_t first, const char_t last)
+            {
+                const __m128i lower = _mm_set1_epi8(first - 1);
+                const __m128i upper = _mm_set1_epi8(last + 1);
+                const __m128i flip = _mm_set1_epi8(0x20);
+
+                uint_t i = 0;
+                for (; i + 16 <= length; i += 16)
+                {
+                    __m128i* position = reinterpret_cast<__m128i*>(str + i);
+                    const __m128i block = _mm_loadu_si128(position);
+                    const __m128i inRange = _mm_and_si128(_mm_cmpgt_epi8(block, lower), _mm_cmplt_epi8(block, upper));
+                    _mm_storeu_si128(position, _mm_xor_si128(block, _mm_and_si128(inRange, flip)));
+                }
+                FlipCaseTail(str, length, first, last, i);
+            }
+
+            __attribute__((target("avx2")))
+            inline
+            void
+            StringUtils::FlipCaseAvx2(char_t* str, const uint_t length, const char_t first, const char_t last)
+            {
+                const __m256i lower = _mm256_set1_epi8(first - 1);
+                const __m256i upper = _mm256_set1_epi8(last + 1);
+                const __m256i flip = _mm256_set1_epi8(0x20);
+
+                uint_t i = 0;
+                for (; i + 32 <= length; i += 32)
+                {
+                    __m256i* position = reinterpret_cast<__m256i*>(str + i);
+                    const __m256i block = _mm256_loadu_si256(position);
+                    const __m256i inRange = _mm256_and_si256(_mm256_cmpgt_epi8(block, lower), _mm256_cmpgt_epi8(upper, block));
+                    _mm256_storeu_si256(position, _mm256_xor_si256(block, _mm256_and_si256(inRange, flip)));
+                }
+                FlipCaseTail(str, length, first, last, i);
+            }
         }
     }
 }
 #endif // CAPU_LINUX_X86_64_STRINGUTILS_H
-
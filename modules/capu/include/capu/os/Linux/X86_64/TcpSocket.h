@@ -33,6 +33,7 @@ namespace capu
                 TcpSocket();
                 TcpSocket(const SocketDescription& socketDescription);
                 using capu::os::TcpSocket::send;
+                using capu::os::TcpSocket::sendFile;
                 using capu::os::TcpSocket::receive;
                 using capu::os::TcpSocket::close;
                 using capu::os::TcpSocket::connect;
@@ -46,6 +47,7 @@ namespace capu
                 using capu::os::TcpSocket::getNoDelay;
                 using capu::os::TcpSocket::getKeepAlive;
                 using capu::os::TcpSocket::getTimeout;
+                using capu::os::TcpSocket::getSocketDescription;
 
             };
 
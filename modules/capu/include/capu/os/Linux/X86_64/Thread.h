@@ -35,6 +35,7 @@ namespace capu
                 using capu::os::Thread::resetCancel;
                 using capu::os::Thread::getState;
                 using capu::os::Thread::Sleep;
+                using capu::os::Thread::GetAvailableCpus;
                 using capu::os::Thread::CurrentThreadId;
             };
         }
@@ -25,6 +25,8 @@ namespace capu
     {
         namespace arch
         {
+            typedef capu::posix::FileDescriptor FileDescriptor;
+
             class File: private capu::posix::File
             {
             public:
@@ -36,6 +38,10 @@ namespace capu
                 using capu::posix::File::read;
                 using capu::posix::File::write;
                 using capu::posix::File::flush;
+                using capu::posix::File::sync;
+                using capu::posix::File::getFileDescriptor;
+                using capu::posix::File::mapReadOnly;
+                using capu::posix::File::unmap;
                 using capu::posix::File::close;
                 using capu::posix::File::createFile;
                 using capu::posix::File::createDirectory;
@@ -35,6 +35,12 @@ namespace capu
                 using capu::generic::Memory::Move;
                 using capu::generic::Memory::MoveObject;
                 using capu::generic::Memory::Set;
+                using capu::generic::Memory::AllocateAligned;
+                using capu::generic::Memory::FreeAligned;
+                using capu::generic::Memory::AllocateLarge;
+                using capu::generic::Memory::FreeLarge;
+                using capu::generic::Memory::Prefetch;
+                using capu::generic::Memory::CopyNonTemporal;
                 static uint_t CurrentMemoryUsage();
             };
 
@@ -35,6 +35,7 @@ namespace capu
                 using capu::posix::Thread::resetCancel;
                 using capu::posix::Thread::getState;
                 using capu::posix::Thread::Sleep;
+                using capu::posix::Thread::GetAvailableCpus;
                 static uint_t CurrentThreadId();
             };
 
@@ -96,6 +96,56 @@ namespace capu
         * @return The current memory usage in bytes.
         */
         static uint_t CurrentMemoryUsage();
+
+        /**
+         * Allocates size bytes which start at a multiple of alignment.
+         * Use CAPU_CACHE_LINE_SIZE to keep data of different threads on different cache lines.
+         * @param size number of bytes to allocate
+         * @param alignment power of two, at least sizeof(void*)
+         * @return pointer to the memory or NULL if size is 0, the alignment is invalid or no memory is left.
+         *         The memory must be released with FreeAligned.
+         */
+        static void* AllocateAligned(const uint_t size, const uint_t alignment);
+
+        /**
+         * Releases memory allocated with AllocateAligned
+         * @param ptr the memory to release, NULL is ignored
+         */
+        static void FreeAligned(void* ptr);
+
+        /**
+         * Allocates a big block of memory directly from the operating system, bypassing the heap.
+         * Where supported the block is backed by huge pages to reduce TLB misses.
+         * The memory is page aligned and initialized with zeros on posix and windows.
+         * @param size number of bytes to allocate
+         * @return pointer to the memory or NULL if size is 0 or no memory is left.
+         *         The memory must be released with FreeLarge.
+         */
+        static void* AllocateLarge(const uint_t size);
+
+        /**
+         * Releases memory allocated with AllocateLarge
+         * @param ptr the memory to release, NULL is ignored
+         * @param size the size which was passed to AllocateLarge
+         */
+        static void FreeLarge(void* ptr, const uint_t size);
+
+        /**
+         * Hints the cpu to load the cache line containing the given address.
+         * Does nothing on compilers without prefetch support.
+         * @param address the data which will be accessed soon
+         */
+        static void Prefetch(const void* address);
+
+        /**
+         * Copy size number of bytes from src to dst without pulling dst into the cache.
+         * Meant for big copies whose destination is not read again soon. Falls back to
+         * Copy for small sizes and on platforms without streaming stores.
+         * @param dst Pointer where data should be copied to
+         * @param src Pointer to the data to be copied
+         * @param size number of bytes to copy
+         */
+        static void CopyNonTemporal(void* dst, const void* src, const uint_t size);
     };
 
     inline uint_t Memory::CurrentMemoryUsage()
@@ -146,6 +196,48 @@ namespace capu
     {
         os::arch::Memory::MoveObject(dst, src, count);
     }
+
+    inline
+    void*
+    Memory::AllocateAligned(const uint_t size, const uint_t alignment)
+    {
+        return os::arch::Memory::AllocateAligned(size, alignment);
+    }
+
+    inline
+    void
+    Memory::FreeAligned(void* ptr)
+    {
+        os::arch::Memory::FreeAligned(ptr);
+    }
+
+    inline
+    void*
+    Memory::AllocateLarge(const uint_t size)
+    {
+        return os::arch::Memory::AllocateLarge(size);
+    }
+
+    inline
+    void
+    Memory::FreeLarge(void* ptr, const uint_t size)
+    {
+        os::arch::Memory::FreeLarge(ptr, size);
+    }
+
+    inline
+    void
+    Memory::Prefetch(const void* address)
+    {
+        os::arch::Memory::Prefetch(address);
+    }
+
+    inline
+    void
+    Memory::CopyNonTemporal(void* dst, const void* src, const uint_t size)
+    {
+        os::arch::Memory::CopyNonTemporal(dst, src, size);
+    }
 }
 #endif // CAPU_MEMORY_H
 
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_UNIXBASED_FIBERCONTEXT_H
+#define CAPU_UNIXBASED_FIBERCONTEXT_H
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace capu
+{
+    namespace posix
+    {
+        class FiberStack
+        {
+        public:
+            static void* AllocateStack(const uint_t size, const bool_t guardPage);
+            static void FreeStack(void* stack, const uint_t size, const bool_t guardPage);
+
+        private:
+            static uint_t PageSize();
+        };
+
+        inline uint_t FiberStack::PageSize()
+        {
+            return static_cast<uint_t>(sysconf(_SC_PAGESIZE));
+        }
+
+        inline void* FiberStack::AllocateStack(const uint_t size, const bool_t guardPage)
+        {
+            if (size == 0)
+            {
+                return 0;
+            }
+            const uint_t pageSize = PageSize();
+            const uint_t guardSize = guardPage ? pageSize : 0;
+            const uint_t stackSize = (size + pageSize - 1) & ~(pageSize - 1);
+
+            void* mapping = mmap(0, guardSize + stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED)
+            {
+                return 0;
+            }
+            // stacks grow downwards, the guard page sits below the lowest usable address
+            if (guardPage && mprotect(mapping, guardSize, PROT_NONE) != 0)
+            {
+                munmap(mapping, guardSize + stackSize);
+                return 0;
+            }
+            return static_cast<char*>(mapping) + guardSize;
+        }
+
+        inline void FiberStack::FreeStack(void* stack, const uint_t size, const bool_t guardPage)
+        {
+            if (stack)
+            {
+                const uint_t pageSize = PageSize();
+                const uint_t guardSize = guardPage ? pageSize : 0;
+                const uint_t stackSize = (size + pageSize - 1) & ~(pageSize - 1);
+                munmap(static_cast<char*>(stack) - guardSize, guardSize + stackSize);
+            }
+        }
+
+        /**
+         * Context switch with ucontext. swapcontext also saves and restores the signal mask,
+         * which costs a system call per switch, platforms override it with a plain register switch.
+         */
+        class FiberContext: private FiberStack
+        {
+        public:
+            FiberContext();
+
+            using FiberStack::AllocateStack;
+            using FiberStack::FreeStack;
+            void init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument);
+            static void Switch(FiberContext& from, FiberContext& to);
+
+        private:
+            static void Start(uint32_t high, uint32_t low);
+
+            ucontext_t mContext;
+            FiberEntryFunction mEntry;
+            void* mArgument;
+        };
+
+        inline FiberContext::FiberContext()
+            : mEntry(0)
+            , mArgument(0)
+        {
+        }
+
+        inline void FiberContext::init(void* stack, const uint_t stackSize, FiberEntryFunction entry, void* argument)
+        {
+            mEntry = entry;
+            mArgument = argument;
+            getcontext(&mContext);
+            mContext.uc_stack.ss_sp = stack;
+            mContext.uc_stack.ss_size = stackSize;
+            mContext.uc_link = 0;
+
+            // makecontext only passes int arguments, the context pointer is split into two halves
+            const uint64_t self = reinterpret_cast<uint_t>(this);
+            makecontext(&mContext, reinterpret_cast<void (*)()>(&FiberContext::Start), 2,
+                        static_cast<uint32_t>(self >> 32), static_cast<uint32_t>(self));
+        }
+
+        inline void FiberContext::Start(uint32_t high, uint32_t low)
+        {
+            const uint64_t self = (static_cast<uint64_t>(high) << 32) | low;
+            FiberContext* context = reinterpret_cast<FiberContext*>(static_cast<uint_t>(self));
+            context->mEntry(context->mArgument);
+        }
+
+        inline void FiberContext::Switch(FiberContext& from, FiberContext& to)
+        {
+            swapcontext(&from.mContext, &to.mContext);
+        }
+    }
+}
+
+#endif // CAPU_UNIXBASED_FIBERCONTEXT_H
@@ -18,8 +18,12 @@
 #define CAPU_UNIXBASED_FILE_H
 
 #include "capu/os/Generic/File.h"
+#include "capu/os/Memory.h"
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <climits>
 #include <libgen.h>
 
@@ -27,6 +31,8 @@ namespace capu
 {
     namespace posix
     {
+        typedef int_t FileDescriptor;
+
         class File : private generic::File
         {
         public:
@@ -38,7 +44,11 @@ namespace capu
             status_t read(char_t* buffer, uint_t length, uint_t& numBytes);
             status_t write(const char_t* buffer, uint_t length);
             status_t flush();
+            status_t sync();
             status_t close();
+            FileDescriptor getFileDescriptor() const;
+            status_t mapReadOnly(const char_t*& data, uint_t& size);
+            status_t unmap();
             status_t renameTo(const capu::String& newName);
             status_t createFile();
             status_t createDirectory();
@@ -50,15 +60,21 @@ namespace capu
             status_t getSizeInBytes(uint_t& size) const;
             bool_t isDirectory() const;
             bool_t exists() const;
-            status_t copyTo(const capu::String& newPath);
+            status_t copyTo(const capu::String& newPath, IFileCopyListener* listener);
             ~File();
         protected:
             using generic::File::mPath;
+            static const uint_t CopyBufferSize = 1024 * 1024;
+            static status_t OpenCopyFiles(const String& sourcePath, const String& destinationPath, int_t& sourceFile, int_t& destinationFile, uint64_t& size);
+            static status_t CopyBuffered(int_t sourceFile, int_t destinationFile, const uint64_t size, uint64_t& copied, IFileCopyListener* listener);
+            static status_t FinishCopy(int_t sourceFile, int_t destinationFile, const String& destinationPath, status_t status);
         private:
             static String GetParentPathPrivate(String path, bool_t& success);
             static String StripLastPathComponent(const String& path);
             bool_t  mIsOpen;
             FILE*   mHandle;
+            const char_t* mMappedData;
+            uint_t  mMappedSize;
         };
 
         inline
@@ -66,6 +82,8 @@ namespace capu
             : generic::File(path)
             , mIsOpen(false)
             , mHandle(NULL)
+            , mMappedData(NULL)
+            , mMappedSize(0)
         {
         }
 
@@ -74,6 +92,8 @@ namespace capu
             : generic::File(parent, path)
             , mIsOpen(false)
             , mHandle(NULL)
+            , mMappedData(NULL)
+            , mMappedSize(0)
         {
         }
 
@@ -84,6 +104,7 @@ namespace capu
             {
                 fclose(mHandle);
             }
+            unmap();
         }
 
         inline
@@ -295,6 +316,79 @@ namespace capu
             return CAPU_ERROR;
         }
 
+        inline
+        status_t
+        File::sync()
+        {
+            if (flush() != CAPU_OK)
+            {
+                return CAPU_ERROR;
+            }
+#if defined(__APPLE__)
+            // fdatasync is not available, F_FULLFSYNC would also flush the drive cache
+            const int_t error = fsync(fileno(mHandle));
+#else
+            const int_t error = fdatasync(fileno(mHandle));
+#endif
+            return error == 0 ? CAPU_OK : CAPU_ERROR;
+        }
+
+        inline
+        FileDescriptor
+        File::getFileDescriptor() const
+        {
+            return mHandle != NULL ? fileno(mHandle) : -1;
+        }
+
+        inline
+        status_t
+        File::mapReadOnly(const char_t*& data, uint_t& size)
+        {
+            if (mMappedData == NULL)
+            {
+                const int_t fd = ::open(mPath.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    return errno == ENOENT ? CAPU_ENOT_EXIST : CAPU_ERROR;
+                }
+
+                struct stat info;
+                if (fstat(fd, &info) != 0 || info.st_size == 0)
+                {
+                    ::close(fd);
+                    return CAPU_EINVAL;
+                }
+
+                // the mapping keeps its own reference to the file
+                void* mapping = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mapping == MAP_FAILED)
+                {
+                    return CAPU_ERROR;
+                }
+                mMappedData = static_cast<const char_t*>(mapping);
+                mMappedSize = static_cast<uint_t>(info.st_size);
+            }
+
+            data = mMappedData;
+            size = mMappedSize;
+            return CAPU_OK;
+        }
+
+        inline
+        status_t
+        File::unmap()
+        {
+            if (mMappedData == NULL)
+            {
+                return CAPU_ERROR;
+            }
+            munmap(const_cast<char_t*>(mMappedData), mMappedSize);
+            mMappedData = NULL;
+            mMappedSize = 0;
+            return CAPU_OK;
+        }
+
         inline
         status_t
         File::close()
@@ -368,38 +462,118 @@ namespace capu
             return GetParentPathPrivate(getPath(), success);
         }
 
-        inline status_t File::copyTo(const capu::String& newPath)
+        inline status_t File::copyTo(const capu::String& newPath, IFileCopyListener* listener)
+        {
+            int_t sourceFile = -1;
+            int_t destinationFile = -1;
+            uint64_t size = 0;
+            status_t status = OpenCopyFiles(mPath, newPath, sourceFile, destinationFile, size);
+            if (status != CAPU_OK)
+            {
+                return status;
+            }
+
+            uint64_t copied = 0;
+            status = CopyBuffered(sourceFile, destinationFile, size, copied, listener);
+            return FinishCopy(sourceFile, destinationFile, newPath, status);
+        }
+
+        inline status_t File::OpenCopyFiles(const String& sourcePath, const String& destinationPath, int_t& sourceFile, int_t& destinationFile, uint64_t& size)
         {
-            FILE* handleFrom = fopen(mPath.c_str(), "r");
-            if (!handleFrom)
+            sourceFile = ::open(sourcePath.c_str(), O_RDONLY, 0);
+            if (-1 == sourceFile)
             {
                 return CAPU_ERROR;
             }
 
+            struct stat sourceAttributes;
+            if (fstat(sourceFile, &sourceAttributes) != 0)
+            {
+                ::close(sourceFile);
+                return CAPU_ERROR;
+            }
+            size = sourceAttributes.st_size;
+
             // make sure file is not present
-            File destFile(newPath);
+            File destFile(destinationPath);
             destFile.remove();
 
-            FILE* handleTo = fopen(newPath.c_str(), "w");
-            if (!handleTo)
+            destinationFile = ::open(destinationPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (-1 == destinationFile)
             {
-                fclose(handleFrom);
+                ::close(sourceFile);
                 return CAPU_ERROR;
             }
-            capu::char_t copybuffer[1024];
-            size_t bytesRead = 0;
-            while ((bytesRead = fread(copybuffer, sizeof(capu::char_t), sizeof(copybuffer), handleFrom)) > 0)
+            return CAPU_OK;
+        }
+
+        inline status_t File::CopyBuffered(int_t sourceFile, int_t destinationFile, const uint64_t size, uint64_t& copied, IFileCopyListener* listener)
+        {
+            // one large page aligned buffer instead of many small reads and writes
+            char_t* buffer = static_cast<char_t*>(Memory::AllocateAligned(CopyBufferSize, 4096));
+            if (!buffer)
+            {
+                return CAPU_ENO_MEMORY;
+            }
+
+            status_t status = CAPU_OK;
+            for (;;)
             {
-                if (fwrite(copybuffer, sizeof(capu::char_t), bytesRead, handleTo) != bytesRead)
+                const ssize_t bytesRead = ::read(sourceFile, buffer, CopyBufferSize);
+                if (bytesRead < 0 && errno == EINTR)
                 {
-                    fclose(handleFrom);
-                    fclose(handleTo);
-                    return CAPU_ERROR;
+                    continue;
+                }
+                if (bytesRead <= 0)
+                {
+                    status = bytesRead == 0 ? CAPU_OK : CAPU_ERROR;
+                    break;
+                }
+
+                ssize_t bytesWritten = 0;
+                while (bytesWritten < bytesRead)
+                {
+                    const ssize_t result = ::write(destinationFile, buffer + bytesWritten, bytesRead - bytesWritten);
+                    if (result < 0 && errno != EINTR)
+                    {
+                        break;
+                    }
+                    bytesWritten += result > 0 ? result : 0;
+                }
+                if (bytesWritten < bytesRead)
+                {
+                    status = CAPU_ERROR;
+                    break;
                 }
+
+                copied += bytesRead;
+                if (listener)
+                {
+                    status = listener->copyProgress(copied, size > copied ? size : copied);
+                    if (status != CAPU_OK)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            Memory::FreeAligned(buffer);
+            return status;
+        }
+
+        inline status_t File::FinishCopy(int_t sourceFile, int_t destinationFile, const String& destinationPath, status_t status)
+        {
+            ::close(sourceFile);
+            if (::close(destinationFile) != 0 && status == CAPU_OK)
+            {
+                status = CAPU_ERROR;
+            }
+            if (status != CAPU_OK)
+            {
+                // do not leave a partial copy behind
+                ::unlink(destinationPath.c_str());
             }
-            fclose(handleFrom);
-            fclose(handleTo);
-            return (bytesRead == 0) ? CAPU_OK : CAPU_ERROR;
+            return status;
         }
 
         inline String File::StripLastPathComponent(const String& path)
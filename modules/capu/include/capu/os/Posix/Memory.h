@@ -19,6 +19,8 @@
 
 #include <capu/os/Generic/Memory.h>
 #include <malloc.h>
+#include <stdlib.h>
+#include <sys/mman.h>
 
 namespace capu
 {
@@ -33,7 +35,13 @@ namespace capu
             using capu::generic::Memory::Compare;
             using capu::generic::Memory::CopyObject;
             using capu::generic::Memory::Copy;
+            using capu::generic::Memory::Prefetch;
+            using capu::generic::Memory::CopyNonTemporal;
             static uint_t CurrentMemoryUsage();
+            static void* AllocateAligned(const uint_t size, const uint_t alignment);
+            static void FreeAligned(void* ptr);
+            static void* AllocateLarge(const uint_t size);
+            static void FreeLarge(void* ptr, const uint_t size);
         };
 
         inline uint_t Memory::CurrentMemoryUsage()
@@ -41,6 +49,47 @@ namespace capu
             struct mallinfo info = mallinfo();
             return static_cast<uint_t>(info.arena);
         }
+
+        inline void* Memory::AllocateAligned(const uint_t size, const uint_t alignment)
+        {
+            void* ptr = 0;
+            if (size == 0 || posix_memalign(&ptr, alignment, size) != 0)
+            {
+                return 0;
+            }
+            return ptr;
+        }
+
+        inline void Memory::FreeAligned(void* ptr)
+        {
+            free(ptr);
+        }
+
+        inline void* Memory::AllocateLarge(const uint_t size)
+        {
+            if (size == 0)
+            {
+                return 0;
+            }
+            void* ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+            {
+                return 0;
+            }
+#ifdef MADV_HUGEPAGE
+            // only a hint, the kernel falls back to normal pages if no huge pages are available
+            madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+            return ptr;
+        }
+
+        inline void Memory::FreeLarge(void* ptr, const uint_t size)
+        {
+            if (ptr)
+            {
+                munmap(ptr, size);
+            }
+        }
     }
 }
 
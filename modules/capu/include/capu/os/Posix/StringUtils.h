@@ -18,6 +18,7 @@
 #define CAPU_UNIXBASED_STRINGUTILS_H
 
 #include "capu/Config.h"
+#include "capu/os/Generic/StringUtils.h"
 #include <string.h>
 #include <stdarg.h>
 
@@ -25,9 +26,12 @@ namespace capu
 {
     namespace posix
     {
-        class StringUtils
+        class StringUtils: private capu::generic::StringUtils
         {
         public:
+            using capu::generic::StringUtils::IndexOf;
+            using capu::generic::StringUtils::ToUpperCase;
+            using capu::generic::StringUtils::ToLowerCase;
             static void Strncpy(char_t* dst, const uint_t dstSize, const char_t* src);
             static void Sprintf(char_t* buffer, const uint_t bufferSize, const char_t* format, ...);
             static void Vsprintf(char_t* buffer, const uint_t bufferSize, const char_t* format, va_list values);
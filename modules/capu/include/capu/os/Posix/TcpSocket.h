@@ -36,6 +36,7 @@ namespace capu
             ~TcpSocket();
 
             status_t send(const char_t* buffer, int32_t length, int32_t& sentBytes);
+            status_t sendFile(int_t fileDescriptor, uint64_t offset, uint_t length, uint_t& sentBytes);
             status_t receive(char_t* buffer, int32_t length, int32_t& numBytes);
             status_t close();
             status_t connect(const char_t* dest_addr, uint16_t port);
@@ -49,6 +50,7 @@ namespace capu
             status_t getNoDelay(bool_t& noDelay);
             status_t getKeepAlive(bool_t& keepAlive);
             status_t getTimeout(int32_t& timeout);
+            SocketDescription getSocketDescription() const;
 
         protected:
             int32_t mSocket;
@@ -190,6 +192,45 @@ namespace capu
             return CAPU_OK;
         }
 
+        inline
+        status_t
+        TcpSocket::sendFile(int_t fileDescriptor, uint64_t offset, uint_t length, uint_t& sentBytes)
+        {
+            sentBytes = 0;
+            if (fileDescriptor < 0)
+            {
+                return CAPU_EINVAL;
+            }
+            if (mSocket == -1)
+            {
+                return CAPU_SOCKET_ESOCKET;
+            }
+            if (length == 0)
+            {
+                return CAPU_OK;
+            }
+
+            // read one chunk at the offset without moving the file position and send what the socket takes
+            char_t buffer[16384];
+            const ssize_t bytesRead = pread(fileDescriptor, buffer, length < sizeof(buffer) ? length : sizeof(buffer), offset);
+            if (bytesRead < 0)
+            {
+                return CAPU_ERROR;
+            }
+            if (bytesRead == 0)
+            {
+                return CAPU_EOF;
+            }
+
+            const ssize_t res = ::send(mSocket, buffer, bytesRead, 0);
+            if (res < 0)
+            {
+                return (errno == EAGAIN || errno == EWOULDBLOCK) ? CAPU_ETIMEOUT : CAPU_ERROR;
+            }
+            sentBytes = res;
+            return CAPU_OK;
+        }
+
         inline
         status_t
         TcpSocket::receive(char_t* buffer, int32_t length, int32_t& numBytes)
@@ -510,6 +551,11 @@ namespace capu
             return CAPU_OK;
         }
 
+        inline SocketDescription TcpSocket::getSocketDescription() const
+        {
+            return mSocket;
+        }
+
         inline status_t TcpSocket::getTimeout(int32_t& timeout)
         {
             if (mSocket == -1)
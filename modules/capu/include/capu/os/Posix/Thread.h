@@ -18,6 +18,8 @@
 #define CAPU_UNIXBASED_THREAD_H
 
 #include <pthread.h>
+#include <sched.h>
+#include <string.h>
 #include <unistd.h>
 #include "capu/os/Generic/Thread.h"
 
@@ -31,17 +33,34 @@ namespace capu
             Thread();
             ~Thread();
             status_t start(Runnable& runnable);
+            status_t start(Runnable& runnable, const ThreadAttributes& attributes);
             status_t join();
             static status_t Sleep(uint32_t millis);
+            static status_t GetAvailableCpus(CpuSet& cpus);
             using capu::generic::Thread::cancel;
             using capu::generic::Thread::resetCancel;
             using capu::generic::Thread::getState;
 
-        private:
+        protected:
             pthread_t mThread;
-            pthread_attr_t mAttr;
+
+            /**
+             * Initializes attr with the stack size and scheduling of attributes. CPU set and
+             * name are left to the platforms which support them.
+             * @return CAPU_OK if attr has to be destroyed by the caller
+             *         CAPU_EINVAL if the system rejected the attributes, attr is destroyed then
+             */
+            static status_t InitAttributes(pthread_attr_t& attr, const ThreadAttributes& attributes);
+            /**
+             * Creates the thread with entry as its start function
+             * @param name handed to the new thread in its ThreadRunnable, cut to ThreadAttributes::MaxNameLength
+             */
+            status_t create(Runnable& runnable, const pthread_attr_t& attr, void* (*entry)(void*) = &Thread::run, const char_t* name = "");
 
             static void* run(void* arg);
+
+        private:
+            pthread_attr_t mAttr;
         };
 
 
@@ -78,6 +97,72 @@ namespace capu
         inline
         status_t
         Thread::start(Runnable& runnable)
+        {
+            return create(runnable, mAttr);
+        }
+
+        inline
+        status_t
+        Thread::start(Runnable& runnable, const ThreadAttributes& attributes)
+        {
+            pthread_attr_t attr;
+            status_t status = InitAttributes(attr, attributes);
+            if (status != CAPU_OK)
+            {
+                return status;
+            }
+            status = create(runnable, attr);
+            pthread_attr_destroy(&attr);
+            return status;
+        }
+
+        inline
+        status_t
+        Thread::InitAttributes(pthread_attr_t& attr, const ThreadAttributes& attributes)
+        {
+            pthread_attr_init(&attr);
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+            bool_t valid = true;
+            if (attributes.getStackSize() > 0)
+            {
+                // fails for sizes below PTHREAD_STACK_MIN
+                valid = pthread_attr_setstacksize(&attr, attributes.getStackSize()) == 0;
+            }
+            if (valid && attributes.getSchedulingPolicy() != TSP_DEFAULT)
+            {
+                int32_t policy = SCHED_OTHER;
+                switch (attributes.getSchedulingPolicy())
+                {
+                case TSP_FIFO:
+                    policy = SCHED_FIFO;
+                    break;
+                case TSP_ROUND_ROBIN:
+                    policy = SCHED_RR;
+                    break;
+                default:
+                    break;
+                }
+                sched_param param;
+                memset(&param, 0, sizeof(param));
+                param.sched_priority = attributes.getPriority();
+
+                // without explicit scheduling the attributes of the creating thread are inherited
+                valid = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) == 0
+                        && pthread_attr_setschedpolicy(&attr, policy) == 0
+                        && pthread_attr_setschedparam(&attr, &param) == 0;
+            }
+            if (!valid)
+            {
+                pthread_attr_destroy(&attr);
+                return CAPU_EINVAL;
+            }
+            return CAPU_OK;
+        }
+
+        inline
+        status_t
+        Thread::create(Runnable& runnable, const pthread_attr_t& attr, void* (*entry)(void*), const char_t* name)
         {
             if (mIsStarted)
             {
@@ -86,9 +171,11 @@ namespace capu
             }
 
             mRunnable.runnable = &runnable;
+            strncpy(mRunnable.name, name, sizeof(mRunnable.name) - 1);
+            mRunnable.name[sizeof(mRunnable.name) - 1] = 0;
             mRunnable.thread->setState(TS_STARTING);
             mIsStarted = true;
-            int32_t result = pthread_create(&mThread, &mAttr, Thread::run, &mRunnable);
+            int32_t result = pthread_create(&mThread, &attr, entry, &mRunnable);
             if (result != 0)
             {
                 mRunnable.thread->setState(TS_NEW);
@@ -124,6 +211,27 @@ namespace capu
             }
             return CAPU_ERROR;
         }
+
+        inline
+        status_t
+        Thread::GetAvailableCpus(CpuSet& cpus)
+        {
+            cpus.clear();
+#ifdef _SC_NPROCESSORS_ONLN
+            const long online = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+            const long online = 1;
+#endif
+            if (online < 1)
+            {
+                return CAPU_ERROR;
+            }
+            for (uint32_t cpu = 0; cpu < static_cast<uint32_t>(online) && cpu < CpuSet::MaxCpus; ++cpu)
+            {
+                cpus.add(cpu);
+            }
+            return CAPU_OK;
+        }
     }
 }
 #endif // CAPU_UNIXBASED_THREAD_H
@@ -33,6 +33,12 @@ namespace capu
             using capu::posix::Memory::CopyObject;
             using capu::posix::Memory::Copy;
             using capu::posix::Memory::CurrentMemoryUsage;
+            using capu::posix::Memory::AllocateAligned;
+            using capu::posix::Memory::FreeAligned;
+            using capu::posix::Memory::AllocateLarge;
+            using capu::posix::Memory::FreeLarge;
+            using capu::posix::Memory::Prefetch;
+            using capu::posix::Memory::CopyNonTemporal;
         };
     }
 }
@@ -32,6 +32,7 @@ namespace capu
             TcpSocket();
             TcpSocket(const SocketDescription& socketDescription);
             using capu::posix::TcpSocket::send;
+            using capu::posix::TcpSocket::sendFile;
             using capu::posix::TcpSocket::receive;
             using capu::posix::TcpSocket::close;
             using capu::posix::TcpSocket::connect;
@@ -46,6 +47,7 @@ namespace capu
             using capu::posix::TcpSocket::getNoDelay;
             using capu::posix::TcpSocket::getKeepAlive;
             using capu::posix::TcpSocket::getTimeout;
+            using capu::posix::TcpSocket::getSocketDescription;
 
         private:
             using capu::posix::TcpSocket::mSocket;
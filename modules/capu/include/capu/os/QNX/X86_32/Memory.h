@@ -35,6 +35,12 @@ namespace capu
                 using capu::os::Memory::MoveObject;
                 using capu::os::Memory::Set;
                 using capu::os::Memory::CurrentMemoryUsage;
+                using capu::os::Memory::AllocateAligned;
+                using capu::os::Memory::FreeAligned;
+                using capu::os::Memory::AllocateLarge;
+                using capu::os::Memory::FreeLarge;
+                using capu::os::Memory::Prefetch;
+                using capu::os::Memory::CopyNonTemporal;
             };
         }
     }
@@ -23,7 +23,8 @@
 namespace capu
 {
     /**
-     * Represents a random number generator.
+     * Represents a random number generator. Each instance has its own state,
+     * an instance must not be used by several threads at the same time.
      */
     class Random: private capu::os::arch::Random
     {
@@ -45,6 +46,28 @@ namespace capu
          * @return A new random number.
          */
         uint32_t nextUInt32();
+
+        /**
+         * Creates a new random number.
+         * @return A new random number.
+         */
+        uint64_t nextUInt64();
+
+        /**
+         * Fills the given buffer with random bytes.
+         * @param buffer The buffer to fill.
+         * @param length Number of bytes to write.
+         */
+        void fill(void* buffer, uint_t length);
+
+        /**
+         * Fills the given buffer with random bytes drawn from a generator which
+         * is private to the calling thread. It is seeded on its first use in each
+         * thread, so no instance has to be shared between threads.
+         * @param buffer The buffer to fill.
+         * @param length Number of bytes to write.
+         */
+        static void FillThreadLocal(void* buffer, uint_t length);
     };
 
     inline uint8_t Random::nextUInt8()
@@ -61,6 +84,21 @@ namespace capu
     {
         return capu::os::arch::Random::nextUInt32();
     }
+
+    inline uint64_t Random::nextUInt64()
+    {
+        return capu::os::arch::Random::nextUInt64();
+    }
+
+    inline void Random::fill(void* buffer, uint_t length)
+    {
+        capu::os::arch::Random::fill(buffer, length);
+    }
+
+    inline void Random::FillThreadLocal(void* buffer, uint_t length)
+    {
+        capu::os::arch::Random::FillThreadLocal(buffer, length);
+    }
 }
 
 #endif // CAPU_RANDOM_H
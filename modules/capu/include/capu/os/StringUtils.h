@@ -107,6 +107,30 @@ namespace capu
          */
         static int_t IndexOf(const char_t* str, const char_t* str2);
 
+        /**
+         * Calculates the first index of a given string if the lengths of both strings are known
+         * @param str string to search in
+         * @param length number of characters in str
+         * @param substr string to search for
+         * @param substrLength number of characters in substr
+         * @return the first index of substr in str, 0 if substr is empty or -1 if it was not found
+         */
+        static int_t IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength);
+
+        /**
+         * Converts all ascii characters 'a' - 'z' to upper case in place
+         * @param str the characters to convert
+         * @param length number of characters to convert
+         */
+        static void ToUpperCase(char_t* str, const uint_t length);
+
+        /**
+         * Converts all ascii characters 'A' - 'Z' to lower case in place
+         * @param str the characters to convert
+         * @param length number of characters to convert
+         */
+        static void ToLowerCase(char_t* str, const uint_t length);
+
         /**
          * Checks if the given testString starts with the given prefix.
          * @param str The string which is tested.
@@ -188,6 +212,27 @@ namespace capu
     {
         return capu::os::arch::StringUtils::IndexOf(str, str2);
     }
+
+    inline
+    int_t
+    StringUtils::IndexOf(const char_t* str, const uint_t length, const char_t* substr, const uint_t substrLength)
+    {
+        return capu::os::arch::StringUtils::IndexOf(str, length, substr, substrLength);
+    }
+
+    inline
+    void
+    StringUtils::ToUpperCase(char_t* str, const uint_t length)
+    {
+        capu::os::arch::StringUtils::ToUpperCase(str, length);
+    }
+
+    inline
+    void
+    StringUtils::ToLowerCase(char_t* str, const uint_t length)
+    {
+        capu::os::arch::StringUtils::ToLowerCase(str, length);
+    }
 }
 #endif //CAPU_STRINGUTILS_H
 
@@ -18,6 +18,7 @@
 #define CAPU_TCP_SOCKET_H
 
 #include "capu/Error.h"
+#include "capu/os/File.h"
 #include <capu/os/PlatformInclude.h>
 
 #include CAPU_PLATFORM_INCLUDE(TcpSocket)
@@ -59,6 +60,26 @@ namespace capu
          */
         inline status_t send(const char_t* buffer, int32_t length, int32_t& sentBytes);
 
+        /**
+         * Sends a part of a file. Where the platform supports it the data goes from the
+         * file system to the socket without being copied through user space.
+         * Like send, a call transfers as much as the socket accepts, which may be less
+         * than length. Callers continue at offset + sentBytes, which fits an event loop
+         * that waits for the socket to become writable between calls. The read position
+         * of the file is not changed.
+         * @param file      the open file to send from. Data written through it has to be flushed first.
+         * @param offset    position in the file of the first byte to send
+         * @param length    number of bytes to send
+         * @param sentBytes reference which will contain the number of bytes sent
+         * @return CAPU_OK if sentBytes bytes were sent
+         *         CAPU_ETIMEOUT if the socket could not take any data within its timeout
+         *         CAPU_EOF if offset is at or behind the end of the file
+         *         CAPU_EINVAL if the file is not open
+         *         CAPU_SOCKET_ESOCKET if the socket is not created
+         *         CAPU_ERROR otherwise
+         */
+        inline status_t sendFile(const File& file, uint64_t offset, uint_t length, uint_t& sentBytes);
+
         /**
          * Receive message
          * @param buffer    buffer that will be used to store incoming message
@@ -179,6 +200,13 @@ namespace capu
          *         CAPU_ERROR otherwise
          */
         inline status_t getTimeout(int32_t& timeout);
+
+        /**
+         * Gets the operating system handle of the socket, e.g. to wait for it to become readable.
+         * The socket keeps the ownership, the handle must not be closed.
+         * @return the handle, an invalid handle if the socket is not created
+         */
+        inline capu::os::arch::SocketDescription getSocketDescription() const;
     };
 
     inline
@@ -206,6 +234,13 @@ namespace capu
         return capu::os::arch::TcpSocket::send(buffer, length, sentBytes);
     }
 
+    inline
+    status_t
+    TcpSocket::sendFile(const File& file, uint64_t offset, uint_t length, uint_t& sentBytes)
+    {
+        return capu::os::arch::TcpSocket::sendFile(file.getFileDescriptor(), offset, length, sentBytes);
+    }
+
     inline
     status_t
     TcpSocket::receive(char_t* buffer, int32_t length, int32_t& numBytes)
@@ -296,6 +331,13 @@ namespace capu
     {
         return capu::os::arch::TcpSocket::getTimeout(timeout);
     }
+
+    inline
+    capu::os::arch::SocketDescription
+    TcpSocket::getSocketDescription() const
+    {
+        return capu::os::arch::TcpSocket::getSocketDescription();
+    }
 }
 
 #endif /* CAPU_TCP_SOCKET_H */
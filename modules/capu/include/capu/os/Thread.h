@@ -20,6 +20,7 @@
 #include <capu/os/PlatformInclude.h>
 #include "capu/Error.h"
 #include "capu/util/Runnable.h"
+#include "capu/os/ThreadAttributes.h"
 
 namespace capu
 {
@@ -58,6 +59,21 @@ namespace capu
          */
         status_t start(Runnable& runnable);
 
+        /**
+         * Starts the thread with the given attributes.
+         *
+         * If the thread was already started it has to be joined to be
+         * able to start another thread.
+         * @param runnable the runnable which should be executed by the
+         *                 new thread.
+         * @param attributes stack size, scheduling, CPU set and name of the new thread
+         * @return CAPU_OK if thread has been started successfully
+         *         CAPU_EINVAL if the system does not accept the stack size or the scheduling
+         *         CAPU_ERROR otherwise, e.g. if the CPU set holds no usable CPU or the
+         *                    process may not use the scheduling policy
+         */
+        status_t start(Runnable& runnable, const ThreadAttributes& attributes);
+
         /**
          * Waits the thread completeness
          * @return CAPU_OK if thread is currently waiting for completeness or has terminated
@@ -93,6 +109,14 @@ namespace capu
          * @return The id of the current thread.
          */
         static uint_t CurrentThreadId();
+
+        /**
+         * Gets the CPUs the process may run its threads on.
+         * @param cpus receives the CPUs
+         * @return CAPU_OK if the CPUs could be determined
+         *         CAPU_ERROR otherwise
+         */
+        static status_t GetAvailableCpus(CpuSet& cpus);
     };
 
     inline
@@ -102,6 +126,13 @@ namespace capu
         return capu::os::arch::Thread::start(runnable);
     }
 
+    inline
+    status_t
+    Thread::start(Runnable& runnable, const ThreadAttributes& attributes)
+    {
+        return capu::os::arch::Thread::start(runnable, attributes);
+    }
+
     inline
     status_t
     Thread::join()
@@ -144,6 +175,13 @@ namespace capu
         return capu::os::arch::Thread::CurrentThreadId();
     }
 
+    inline
+    status_t
+    Thread::GetAvailableCpus(CpuSet& cpus)
+    {
+        return capu::os::arch::Thread::GetAvailableCpus(cpus);
+    }
+
 
 }
 
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2013 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_THREADATTRIBUTES_H
+#define CAPU_THREADATTRIBUTES_H
+
+#include "capu/Error.h"
+
+namespace capu
+{
+    /**
+     * Scheduling policies a thread can be started with
+     */
+    enum ThreadSchedulingPolicy
+    {
+        TSP_DEFAULT,     ///< inherit policy and priority of the creating thread
+        TSP_OTHER,       ///< normal time sharing scheduling
+        TSP_FIFO,        ///< real time, runs until it blocks or a higher priority thread is ready
+        TSP_ROUND_ROBIN  ///< real time, like TSP_FIFO but with time slices among equal priorities
+    };
+
+    /**
+     * Set of CPUs by their index, as used by the operating system
+     */
+    class CpuSet
+    {
+    public:
+        /**
+         * Highest number of CPUs a set can hold
+         */
+        static const uint32_t MaxCpus = 256;
+
+        /**
+         * Creates an empty set
+         */
+        CpuSet();
+
+        /**
+         * Adds a CPU to the set
+         * @param cpu index of the CPU
+         * @return CAPU_OK if the CPU was added
+         *         CAPU_ERANGE if the index is not below MaxCpus
+         */
+        status_t add(const uint32_t cpu);
+
+        /**
+         * Removes a CPU from the set
+         * @param cpu index of the CPU
+         */
+        void remove(const uint32_t cpu);
+
+        /**
+         * Checks if a CPU is in the set
+         * @param cpu index of the CPU
+         * @return true if the CPU is in the set
+         */
+        bool_t contains(const uint32_t cpu) const;
+
+        /**
+         * Returns the CPU at a position, counting only the CPUs in the set
+         * @param position zero based position among the CPUs of the set
+         * @return index of the CPU, MaxCpus if the set holds fewer CPUs
+         */
+        uint32_t get(const uint32_t position) const;
+
+        /**
+         * @return number of CPUs in the set
+         */
+        uint32_t count() const;
+
+        /**
+         * @return true if the set holds no CPU
+         */
+        bool_t empty() const;
+
+        /**
+         * Removes all CPUs
+         */
+        void clear();
+
+    private:
+        uint64_t mBits[MaxCpus / 64];
+    };
+
+    /**
+     * Properties a thread is created with. The defaults leave every property to the system.
+     * Properties a platform cannot express are ignored: CPU sets beyond the first 64 CPUs and
+     * thread names on Windows, and CPU sets and names on posix systems other than Linux.
+     */
+    class ThreadAttributes
+    {
+    public:
+        /**
+         * Longest name a thread can get, Linux does not support more
+         */
+        static const uint32_t MaxNameLength = 15;
+
+        /**
+         * Creates attributes which leave everything to the system
+         */
+        ThreadAttributes();
+
+        /**
+         * Restricts the thread to the given CPUs
+         * @param cpus the CPUs the thread may run on, an empty set allows all CPUs
+         */
+        void setCpuSet(const CpuSet& cpus);
+
+        /**
+         * @return the CPUs the thread may run on, empty if it is not restricted
+         */
+        const CpuSet& getCpuSet() const;
+
+        /**
+         * Sets the size of the stack of the thread
+         * @param size of the stack in bytes, 0 for the default of the system
+         */
+        void setStackSize(const uint_t size);
+
+        /**
+         * @return size of the stack in bytes, 0 for the default of the system
+         */
+        uint_t getStackSize() const;
+
+        /**
+         * Sets the scheduling policy and the priority of the thread. Real time policies usually
+         * need special privileges.
+         * @param policy the scheduling policy
+         * @param priority priority within the policy, the valid range depends on the system
+         */
+        void setScheduling(const ThreadSchedulingPolicy policy, const int32_t priority);
+
+        /**
+         * @return the scheduling policy
+         */
+        ThreadSchedulingPolicy getSchedulingPolicy() const;
+
+        /**
+         * @return the priority within the scheduling policy
+         */
+        int32_t getPriority() const;
+
+        /**
+         * Sets the name of the thread, which shows up in debuggers and profilers
+         * @param name of the thread, cut after MaxNameLength characters
+         */
+        void setName(const char_t* name);
+
+        /**
+         * @return name of the thread, empty if it keeps the name the system gives it
+         */
+        const char_t* getName() const;
+
+    private:
+        CpuSet mCpus;
+        uint_t mStackSize;
+        ThreadSchedulingPolicy mPolicy;
+        int32_t mPriority;
+        char_t mName[MaxNameLength + 1];
+    };
+
+    inline
+    CpuSet::CpuSet()
+    {
+        clear();
+    }
+
+    inline
+    status_t
+    CpuSet::add(const uint32_t cpu)
+    {
+        if (cpu >= MaxCpus)
+        {
+            return CAPU_ERANGE;
+        }
+        mBits[cpu / 64] |= static_cast<uint64_t>(1) << (cpu % 64);
+        return CAPU_OK;
+    }
+
+    inline
+    void
+    CpuSet::remove(const uint32_t cpu)
+    {
+        if (cpu < MaxCpus)
+        {
+            mBits[cpu / 64] &= ~(static_cast<uint64_t>(1) << (cpu % 64));
+        }
+    }
+
+    inline
+    bool_t
+    CpuSet::contains(const uint32_t cpu) const
+    {
+        return cpu < MaxCpus && (mBits[cpu / 64] & (static_cast<uint64_t>(1) << (cpu % 64))) != 0;
+    }
+
+    inline
+    uint32_t
+    CpuSet::get(const uint32_t position) const
+    {
+        uint32_t remaining = position;
+        for (uint32_t cpu = 0; cpu < MaxCpus; ++cpu)
+        {
+            if (contains(cpu))
+            {
+                if (remaining == 0)
+                {
+                    return cpu;
+                }
+                --remaining;
+            }
+        }
+        return MaxCpus;
+    }
+
+    inline
+    uint32_t
+    CpuSet::count() const
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < MaxCpus / 64; ++i)
+        {
+            // clears the lowest bit until none is left
+            for (uint64_t bits = mBits[i]; bits != 0; bits &= bits - 1)
+            {
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    inline
+    bool_t
+    CpuSet::empty() const
+    {
+        for (uint32_t i = 0; i < MaxCpus / 64; ++i)
+        {
+            if (mBits[i] != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline
+    void
+    CpuSet::clear()
+    {
+        for (uint32_t i = 0; i < MaxCpus / 64; ++i)
+        {
+            mBits[i] = 0;
+        }
+    }
+
+    inline
+    ThreadAttributes::ThreadAttributes()
+        : mStackSize(0)
+        , mPolicy(TSP_DEFAULT)
+        , mPriority(0)
+    {
+        mName[0] = 0;
+    }
+
+    inline
+    void
+    ThreadAttributes::setCpuSet(const CpuSet& cpus)
+    {
+        mCpus = cpus;
+    }
+
+    inline
+    const CpuSet&
+    ThreadAttributes::getCpuSet() const
+    {
+        return mCpus;
+    }
+
+    inline
+    void
+    ThreadAttributes::setStackSize(const uint_t size)
+    {
+        mStackSize = size;
+    }
+
+    inline
+    uint_t
+    ThreadAttributes::getStackSize() const
+    {
+        return mStackSize;
+    }
+
+    inline
+    void
+    ThreadAttributes::setScheduling(const ThreadSchedulingPolicy policy, const int32_t priority)
+    {
+        mPolicy = policy;
+        mPriority = priority;
+    }
+
+    inline
+    ThreadSchedulingPolicy
+    ThreadAttributes::getSchedulingPolicy() const
+    {
+        return mPolicy;
+    }
+
+    inline
+    int32_t
+    ThreadAttributes::getPriority() const
+    {
+        return mPriority;
+    }
+
+    inline
+    void
+    ThreadAttributes::setName(const char_t* name)
+    {
+        uint32_t length = 0;
+        if (name != NULL)
+        {
+            for (; length < MaxNameLength && name[length] != 0; ++length)
+            {
+                mName[length] = name[length];
+            }
+        }
+        mName[length] = 0;
+    }
+
+    inline
+    const char_t*
+    ThreadAttributes::getName() const
+    {
+        return mName;
+    }
+}
+
+#endif // CAPU_THREADATTRIBUTES_H
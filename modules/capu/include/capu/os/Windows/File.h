@@ -19,6 +19,7 @@
 
 #include "capu/os/Generic/File.h"
 #include <Windows.h>
+#include <io.h>
 
 // Hack to remove OS_WINDOWS: macro redefinition.
 // Shlwapi also defines OS_WINDOWS.
@@ -34,6 +35,8 @@ namespace capu
 {
     namespace os
     {
+        typedef HANDLE FileDescriptor;
+
         class File : private generic::File
         {
         public:
@@ -45,9 +48,13 @@ namespace capu
             status_t read(char_t* buffer, uint_t length, uint_t& numBytes);
             status_t write(const char_t* buffer, uint_t length);
             status_t flush();
+            status_t sync();
+            FileDescriptor getFileDescriptor() const;
+            status_t mapReadOnly(const char_t*& data, uint_t& size);
+            status_t unmap();
             status_t close();
             status_t renameTo(const capu::String& newPath);
-            status_t copyTo(const capu::String& otherPath);
+            status_t copyTo(const capu::String& otherPath, IFileCopyListener* listener);
             status_t createFile();
             status_t createDirectory();
             status_t remove();
@@ -64,7 +71,18 @@ namespace capu
         private:
             FILE*   mHandle;
             bool_t  mIsOpen;
+            const char_t* mMappedData;
+            uint_t  mMappedSize;
             static String removeTrailingBackslash(String path);
+
+            struct CopyProgress
+            {
+                IFileCopyListener* listener;
+                status_t status;
+            };
+            static DWORD CALLBACK CopyProgressRoutine(LARGE_INTEGER totalFileSize, LARGE_INTEGER totalBytesTransferred,
+                    LARGE_INTEGER streamSize, LARGE_INTEGER streamBytesTransferred, DWORD streamNumber,
+                    DWORD callbackReason, HANDLE sourceFile, HANDLE destinationFile, LPVOID data);
         };
 
         inline
@@ -72,6 +90,8 @@ namespace capu
             : generic::File(removeTrailingBackslash(path))
             , mHandle(NULL)
             , mIsOpen(false)
+            , mMappedData(NULL)
+            , mMappedSize(0)
         {
         }
 
@@ -80,6 +100,8 @@ namespace capu
             : generic::File(parent, removeTrailingBackslash(path))
             , mHandle(NULL)
             , mIsOpen(false)
+            , mMappedData(NULL)
+            , mMappedSize(0)
         {
         }
 
@@ -183,16 +205,27 @@ namespace capu
         }
 
         inline
-        status_t File::copyTo(const capu::String& otherPath)
+        status_t File::copyTo(const capu::String& otherPath, IFileCopyListener* listener)
         {
-            int_t status = CopyFileA(mPath.c_str(), otherPath.c_str(), false);
+            // CopyFileEx copies without user space buffers and reports the progress
+            CopyProgress progress = { listener, CAPU_OK };
+            int_t status = CopyFileExA(mPath.c_str(), otherPath.c_str(), listener ? CopyProgressRoutine : NULL, &progress, NULL, 0);
             if (status == 0)
             {
-                return CAPU_ERROR;
+                return progress.status != CAPU_OK ? progress.status : CAPU_ERROR;
             }
             return CAPU_OK;
         }
 
+        inline
+        DWORD CALLBACK File::CopyProgressRoutine(LARGE_INTEGER totalFileSize, LARGE_INTEGER totalBytesTransferred,
+                LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD, HANDLE, HANDLE, LPVOID data)
+        {
+            CopyProgress* progress = static_cast<CopyProgress*>(data);
+            progress->status = progress->listener->copyProgress(totalBytesTransferred.QuadPart, totalFileSize.QuadPart);
+            return progress->status == CAPU_OK ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+        }
+
         inline
         status_t File::open(const FileMode& mode)
         {
@@ -315,6 +348,80 @@ namespace capu
             return CAPU_ERROR;
         }
 
+        inline
+        status_t
+        File::sync()
+        {
+            if (flush() != CAPU_OK)
+            {
+                return CAPU_ERROR;
+            }
+            HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(mHandle)));
+            return FlushFileBuffers(handle) ? CAPU_OK : CAPU_ERROR;
+        }
+
+        inline
+        FileDescriptor
+        File::getFileDescriptor() const
+        {
+            return mHandle != NULL ? reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(mHandle))) : INVALID_HANDLE_VALUE;
+        }
+
+        inline
+        status_t
+        File::mapReadOnly(const char_t*& data, uint_t& size)
+        {
+            if (mMappedData == NULL)
+            {
+                HANDLE file = CreateFileA(mPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+                if (file == INVALID_HANDLE_VALUE)
+                {
+                    return GetLastError() == ERROR_FILE_NOT_FOUND ? CAPU_ENOT_EXIST : CAPU_ERROR;
+                }
+
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+                {
+                    CloseHandle(file);
+                    return CAPU_EINVAL;
+                }
+
+                // the view keeps the mapping and the file alive
+                HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+                CloseHandle(file);
+                if (mapping == NULL)
+                {
+                    return CAPU_ERROR;
+                }
+                const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+                if (view == NULL)
+                {
+                    return CAPU_ERROR;
+                }
+                mMappedData = static_cast<const char_t*>(view);
+                mMappedSize = static_cast<uint_t>(fileSize.QuadPart);
+            }
+
+            data = mMappedData;
+            size = mMappedSize;
+            return CAPU_OK;
+        }
+
+        inline
+        status_t
+        File::unmap()
+        {
+            if (mMappedData == NULL)
+            {
+                return CAPU_ERROR;
+            }
+            UnmapViewOfFile(mMappedData);
+            mMappedData = NULL;
+            mMappedSize = 0;
+            return CAPU_OK;
+        }
+
         inline
         status_t
         File::close()
@@ -336,6 +443,7 @@ namespace capu
             {
                 fclose(mHandle);
             }
+            unmap();
         }
     }
 }
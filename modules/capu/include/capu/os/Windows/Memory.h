@@ -20,6 +20,7 @@
 #include "capu/os/Generic/Memory.h"
 #include <Windows.h>
 #include <Psapi.h>
+#include <malloc.h>
 
 namespace capu
 {
@@ -34,7 +35,13 @@ namespace capu
             using capu::generic::Memory::Compare;
             using capu::generic::Memory::CopyObject;
             using capu::generic::Memory::Copy;
+            using capu::generic::Memory::CopyNonTemporal;
             static uint_t CurrentMemoryUsage();
+            static void* AllocateAligned(const uint_t size, const uint_t alignment);
+            static void FreeAligned(void* ptr);
+            static void* AllocateLarge(const uint_t size);
+            static void FreeLarge(void* ptr, const uint_t size);
+            static void Prefetch(const void* address);
         };
 
         inline uint_t Memory::CurrentMemoryUsage()
@@ -50,6 +57,43 @@ namespace capu
                 return 0;
             }
         }
+
+        inline void* Memory::AllocateAligned(const uint_t size, const uint_t alignment)
+        {
+            if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+            {
+                return 0;
+            }
+            return _aligned_malloc(size, alignment);
+        }
+
+        inline void Memory::FreeAligned(void* ptr)
+        {
+            _aligned_free(ptr);
+        }
+
+        inline void* Memory::AllocateLarge(const uint_t size)
+        {
+            if (size == 0)
+            {
+                return 0;
+            }
+            // large pages need the SeLockMemoryPrivilege, so only bypass the heap here
+            return ::VirtualAlloc(0, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        }
+
+        inline void Memory::FreeLarge(void* ptr, const uint_t)
+        {
+            if (ptr)
+            {
+                ::VirtualFree(ptr, 0, MEM_RELEASE);
+            }
+        }
+
+        inline void Memory::Prefetch(const void* address)
+        {
+            PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, address);
+        }
     }
 }
 
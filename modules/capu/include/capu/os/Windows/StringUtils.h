@@ -20,15 +20,19 @@
 #include <windows.h>
 #include <stdarg.h>
 #include "capu/Config.h"
+#include "capu/os/Generic/StringUtils.h"
 #include <capu/os/Memory.h>
 
 namespace capu
 {
     namespace os
     {
-        class StringUtils
+        class StringUtils: private capu::generic::StringUtils
         {
         public:
+            using capu::generic::StringUtils::IndexOf;
+            using capu::generic::StringUtils::ToUpperCase;
+            using capu::generic::StringUtils::ToLowerCase;
             static void Strncpy(char_t* dst, const uint_t dstSize, const char_t* src);
             static void Sprintf(char_t* buffer, const uint_t bufferSize, const char_t* format, ...);
             static void Vsprintf(char_t* buffer, const uint_t bufferSize, const char_t* format, va_list values);
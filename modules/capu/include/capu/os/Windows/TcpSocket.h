@@ -35,6 +35,7 @@ namespace capu
             ~TcpSocket();
 
             status_t send(const char_t* buffer, int32_t length, int32_t& sentBytes);
+            status_t sendFile(HANDLE file, uint64_t offset, uint_t length, uint_t& sentBytes);
             status_t receive(char_t* buffer, int32_t length, int32_t& numBytes);
             status_t close();
             status_t connect(const char_t* dest_addr, uint16_t port);
@@ -48,6 +49,7 @@ namespace capu
             status_t getNoDelay(bool_t& noDelay);
             status_t getKeepAlive(bool_t& keepAlive);
             status_t getTimeout(int32_t& timeout);
+            SocketDescription getSocketDescription() const;
 
         protected:
         private:
@@ -255,6 +257,64 @@ namespace capu
             return CAPU_OK;
         }
 
+        inline status_t TcpSocket::sendFile(HANDLE file, uint64_t offset, uint_t length, uint_t& sentBytes)
+        {
+            sentBytes = 0;
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return CAPU_EINVAL;
+            }
+            if (mSocket == INVALID_SOCKET)
+            {
+                return CAPU_SOCKET_ESOCKET;
+            }
+            if (length == 0)
+            {
+                return CAPU_OK;
+            }
+
+            // ReadFile at an offset moves the file pointer of a synchronous handle, keep it for the caller
+            LARGE_INTEGER zero;
+            zero.QuadPart = 0;
+            LARGE_INTEGER filePointer;
+            if (!SetFilePointerEx(file, zero, &filePointer, FILE_CURRENT))
+            {
+                return CAPU_ERROR;
+            }
+
+            // read one chunk at the offset and send what the socket takes
+            char_t buffer[16384];
+            OVERLAPPED position = {0};
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD bytesRead = 0;
+            const BOOL readResult = ReadFile(file, buffer, length < sizeof(buffer) ? static_cast<DWORD>(length) : sizeof(buffer), &bytesRead, &position);
+            const DWORD readError = readResult ? ERROR_SUCCESS : GetLastError();
+            SetFilePointerEx(file, filePointer, 0, FILE_BEGIN);
+            if (!readResult)
+            {
+                return readError == ERROR_HANDLE_EOF ? CAPU_EOF : CAPU_ERROR;
+            }
+            if (bytesRead == 0)
+            {
+                return CAPU_EOF;
+            }
+
+            const int32_t result = ::send(mSocket, buffer, bytesRead, 0);
+            if (result == SOCKET_ERROR)
+            {
+                const int32_t error = WSAGetLastError();
+                if (error == WSAEWOULDBLOCK || error == WSAETIMEDOUT)
+                {
+                    return CAPU_ETIMEOUT;
+                }
+                close();
+                return CAPU_ERROR;
+            }
+            sentBytes = result;
+            return CAPU_OK;
+        }
+
         inline status_t TcpSocket::receive(char_t* buffer, int32_t length, int32_t& numBytes)
         {
             if ((buffer == NULL) || (length < 0))
@@ -525,6 +585,11 @@ namespace capu
             return CAPU_OK;
         }
 
+        inline SocketDescription TcpSocket::getSocketDescription() const
+        {
+            return mSocket;
+        }
+
         inline status_t TcpSocket::getTimeout(int32_t& timeout)
         {
             if (mSocket == INVALID_SOCKET)
@@ -32,12 +32,14 @@ namespace capu
             Thread();
             ~Thread();
             status_t start(Runnable& runnable);
+            status_t start(Runnable& runnable, const ThreadAttributes& attributes);
             status_t join();
             using capu::generic::Thread::cancel;
             using capu::generic::Thread::resetCancel;
             using capu::generic::Thread::getState;
             static status_t Sleep(uint32_t millis);
             static uint_t CurrentThreadId();
+            static status_t GetAvailableCpus(CpuSet& cpus);
         private:
 
             DWORD  mThreadId;
@@ -96,6 +98,70 @@ namespace capu
             return CAPU_OK;
         }
 
+        inline
+        status_t
+        Thread::start(Runnable& runnable, const ThreadAttributes& attributes)
+        {
+            if (mIsStarted)
+            {
+                // thread must have not been started or be joined before it can be started again
+                return CAPU_ERROR;
+            }
+
+            mRunnable.runnable = &runnable;
+            mRunnable.thread->setState(TS_STARTING);
+            mIsStarted = true;
+            // suspended until the attributes are applied, the stack size is a reservation like the default size
+            const DWORD flags = CREATE_SUSPENDED | (attributes.getStackSize() > 0 ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0);
+            mThreadHandle = CreateThread(NULL, attributes.getStackSize(), Thread::run, &mRunnable, flags, &mThreadId);
+            if (mThreadHandle == NULL)
+            {
+                mRunnable.thread->setState(TS_NEW);
+                mIsStarted = false;
+                return CAPU_ERROR;
+            }
+
+            status_t status = CAPU_OK;
+            const CpuSet& cpus = attributes.getCpuSet();
+            if (!cpus.empty())
+            {
+                // an affinity mask covers only the CPUs of the processor group of the process
+                DWORD_PTR mask = 0;
+                for (uint32_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+                {
+                    if (cpus.contains(cpu))
+                    {
+                        mask |= static_cast<DWORD_PTR>(1) << cpu;
+                    }
+                }
+                if (SetThreadAffinityMask(mThreadHandle, mask) == 0)
+                {
+                    status = CAPU_ERROR;
+                }
+            }
+            if (status == CAPU_OK && attributes.getSchedulingPolicy() != TSP_DEFAULT)
+            {
+                // there are no scheduling policies, only the priority (THREAD_PRIORITY_*) applies
+                if (!SetThreadPriority(mThreadHandle, attributes.getPriority()))
+                {
+                    status = CAPU_EINVAL;
+                }
+            }
+            if (status != CAPU_OK)
+            {
+                // the runnable has not run yet, it must not run with other attributes than requested
+                TerminateThread(mThreadHandle, 0);
+                CloseHandle(mThreadHandle);
+                mThreadHandle = 0;
+                mRunnable.thread->setState(TS_NEW);
+                mIsStarted = false;
+                return status;
+            }
+
+            ResumeThread(mThreadHandle);
+            return CAPU_OK;
+        }
+
         inline
         status_t
         Thread::join()
@@ -127,6 +193,27 @@ namespace capu
         {
             return GetCurrentThreadId();
         }
+
+        inline
+        status_t
+        Thread::GetAvailableCpus(CpuSet& cpus)
+        {
+            DWORD_PTR processMask = 0;
+            DWORD_PTR systemMask = 0;
+            if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+            {
+                return CAPU_ERROR;
+            }
+            cpus.clear();
+            for (uint32_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+            {
+                if ((processMask >> cpu) & 1)
+                {
+                    cpus.add(cpu);
+                }
+            }
+            return CAPU_OK;
+        }
     }
 }
 
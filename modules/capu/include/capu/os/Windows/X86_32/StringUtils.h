@@ -37,6 +37,8 @@ namespace capu
                 using capu::os::StringUtils::LastIndexOf;
                 using capu::os::StringUtils::IndexOf;
                 using capu::os::StringUtils::StartsWith;
+                using capu::os::StringUtils::ToUpperCase;
+                using capu::os::StringUtils::ToLowerCase;
             };
         }
     }
@@ -35,6 +35,12 @@ namespace capu
                 using os::Memory::MoveObject;
                 using os::Memory::Set;
                 using os::Memory::CurrentMemoryUsage;
+                using os::Memory::AllocateAligned;
+                using os::Memory::FreeAligned;
+                using os::Memory::AllocateLarge;
+                using os::Memory::FreeLarge;
+                using os::Memory::Prefetch;
+                using os::Memory::CopyNonTemporal;
             };
         }
     }
@@ -33,6 +33,14 @@ namespace capu
         capu::LoggerLevel mLvl;
     public:
 
+        /**
+         * Creates an appender which accepts all levels
+         */
+        Appender()
+            : mLvl(CLL_TRACE)
+        {
+        }
+
         virtual ~Appender() {}
 
         /**
@@ -62,6 +70,16 @@ namespace capu
         void setLoggingLevel(const LoggerLevel level)
         {
             mLvl = level;
+            Logger::AppenderLevelChanged();
+        }
+
+        /**
+         * get Logging Level
+         * @return the minimum level of messages the appender accepts
+         */
+        LoggerLevel getLoggingLevel() const
+        {
+            return mLvl;
         }
     };
 }
@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_BINARYCONTAINERSERIALIZATION_H
+#define CAPU_BINARYCONTAINERSERIALIZATION_H
+
+#include <capu/util/BinaryOutputStream.h>
+#include <capu/util/BinaryInputStream.h>
+#include <capu/util/Traits.h>
+#include <capu/container/Array.h>
+#include <capu/container/Vector.h>
+#include <capu/container/List.h>
+#include <capu/container/HashTable.h>
+
+/**
+ * Stream operators for whole containers on binary streams.
+ * A container is written as its element count (uint32_t) followed by the elements.
+ * Primitive elements are moved with a single copy of the payload, all other elements
+ * are streamed one by one with their own operators, so containers can be nested.
+ * When reading, the target container is sized once from the element count and its
+ * previous contents are replaced. On streams with a size, a count which cannot fit into
+ * the rest of the buffer is rejected before anything is allocated. If the stream ends
+ * early, getState() of the input stream reports the error and the contents of the
+ * container are undefined.
+ */
+namespace capu
+{
+    /**
+     * Reads and writes a sequence of container elements
+     */
+    template<typename T, int TYPE = Type<T>::Identifier>
+    struct BinaryContainerElements
+    {
+        /**
+         * Least number of bytes an element takes in the stream, every element takes at least one
+         */
+        static uint32_t MinimumSize(const BinaryInputStream&)
+        {
+            return 1;
+        }
+
+        static void Write(BinaryOutputStream& stream, const T* values, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                stream << values[i];
+            }
+        }
+
+        static void Read(BinaryInputStream& stream, T* values, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count && stream.getState() == CAPU_OK; ++i)
+            {
+                stream >> values[i];
+            }
+        }
+    };
+
+    /**
+     * Element sequences with the varint encoding. Types without a varint representation
+     * are stored like in the fixed encoding.
+     */
+    struct BinaryVarIntElements
+    {
+        template<typename T>
+        static void Write(BinaryOutputStream& stream, const T* values, const uint32_t count)
+        {
+            stream.write(values, count * sizeof(T));
+        }
+
+        template<typename T>
+        static void Read(BinaryInputStream& stream, T* values, const uint32_t count)
+        {
+            stream.read(reinterpret_cast<char_t*>(values), count * sizeof(T));
+        }
+
+        static void Write(BinaryOutputStream& stream, const uint16_t* values, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                stream << values[i];
+            }
+        }
+
+        static void Read(BinaryInputStream& stream, uint16_t* values, const uint32_t count)
+        {
+            for (uint32_t i = 0; i < count && stream.getState() == CAPU_OK; ++i)
+            {
+                stream >> values[i];
+            }
+        }
+
+        static void Write(BinaryOutputStream& stream, const int32_t* values, const uint32_t count)
+        {
+            stream.writeArray(values, count);
+        }
+
+        static void Read(BinaryInputStream& stream, int32_t* values, const uint32_t count)
+        {
+            stream.readArray(values, count);
+        }
+
+        static void Write(BinaryOutputStream& stream, const uint32_t* values, const uint32_t count)
+        {
+            stream.writeArray(values, count);
+        }
+
+        static void Read(BinaryInputStream& stream, uint32_t* values, const uint32_t count)
+        {
+            stream.readArray(values, count);
+        }
+
+        static void Write(BinaryOutputStream& stream, const int64_t* values, const uint32_t count)
+        {
+            stream.writeArray(values, count);
+        }
+
+        static void Read(BinaryInputStream& stream, int64_t* values, const uint32_t count)
+        {
+            stream.readArray(values, count);
+        }
+
+        static void Write(BinaryOutputStream& stream, const uint64_t* values, const uint32_t count)
+        {
+            stream.writeArray(values, count);
+        }
+
+        static void Read(BinaryInputStream& stream, uint64_t* values, const uint32_t count)
+        {
+            stream.readArray(values, count);
+        }
+    };
+
+    /**
+     * Primitive elements are stored in memory exactly as in the fixed encoding,
+     * so the whole sequence is copied at once
+     */
+    template<typename T>
+    struct BinaryContainerElements<T, CAPU_TYPE_PRIMITIVE>
+    {
+        static uint32_t MinimumSize(const BinaryInputStream& stream)
+        {
+            // a varint takes a single byte for small values
+            return stream.getEncoding() == STREAM_ENCODING_VARINT ? 1 : sizeof(T);
+        }
+
+        static void Write(BinaryOutputStream& stream, const T* values, const uint32_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            if (stream.getEncoding() == STREAM_ENCODING_VARINT)
+            {
+                BinaryVarIntElements::Write(stream, values, count);
+                return;
+            }
+            stream.write(values, count * sizeof(T));
+        }
+
+        static void Read(BinaryInputStream& stream, T* values, const uint32_t count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            if (stream.getEncoding() == STREAM_ENCODING_VARINT)
+            {
+                BinaryVarIntElements::Read(stream, values, count);
+                return;
+            }
+            stream.read(reinterpret_cast<char_t*>(values), count * sizeof(T));
+        }
+    };
+
+    template<typename T, typename STORAGE>
+    inline
+    BinaryOutputStream&
+    operator<<(BinaryOutputStream& stream, const Array<T, STORAGE>& values)
+    {
+        const uint32_t count = static_cast<uint32_t>(values.size());
+        stream << count;
+        BinaryContainerElements<T>::Write(stream, values.getRawData(), count);
+        return stream;
+    }
+
+    template<typename T, typename STORAGE>
+    inline
+    BinaryInputStream&
+    operator>>(BinaryInputStream& stream, Array<T, STORAGE>& values)
+    {
+        uint32_t count = 0;
+        stream >> count;
+        if (stream.getState() != CAPU_OK || !stream.checkAvailableElements(count, BinaryContainerElements<T>::MinimumSize(stream)))
+        {
+            return stream;
+        }
+
+        if (values.size() != count)
+        {
+            values.setSize(count);
+        }
+        BinaryContainerElements<T>::Read(stream, values.getRawData(), count);
+        return stream;
+    }
+
+    template<typename T>
+    inline
+    BinaryOutputStream&
+    operator<<(BinaryOutputStream& stream, const Vector<T>& values)
+    {
+        const uint32_t count = values.size();
+        stream << count;
+        if (count > 0)
+        {
+            BinaryContainerElements<T>::Write(stream, &values[0], count);
+        }
+        return stream;
+    }
+
+    template<typename T>
+    inline
+    BinaryInputStream&
+    operator>>(BinaryInputStream& stream, Vector<T>& values)
+    {
+        uint32_t count = 0;
+        stream >> count;
+        if (stream.getState() != CAPU_OK || !stream.checkAvailableElements(count, BinaryContainerElements<T>::MinimumSize(stream)))
+        {
+            return stream;
+        }
+
+        values.resize(count);
+        if (count > 0)
+        {
+            BinaryContainerElements<T>::Read(stream, &values[0], count);
+        }
+        return stream;
+    }
+
+    template<class T, class A, class C>
+    inline
+    BinaryOutputStream&
+    operator<<(BinaryOutputStream& stream, const List<T, A, C>& values)
+    {
+        stream << static_cast<uint32_t>(values.size());
+        typename List<T, A, C>::Iterator current = values.begin();
+        const typename List<T, A, C>::Iterator end = values.end();
+        for (; current != end; ++current)
+        {
+            BinaryContainerElements<T>::Write(stream, &*current, 1);
+        }
+        return stream;
+    }
+
+    template<class T, class A, class C>
+    inline
+    BinaryInputStream&
+    operator>>(BinaryInputStream& stream, List<T, A, C>& values)
+    {
+        uint32_t count = 0;
+        stream >> count;
+        if (stream.getState() != CAPU_OK || !stream.checkAvailableElements(count, BinaryContainerElements<T>::MinimumSize(stream)))
+        {
+            return stream;
+        }
+
+        values.clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            T value;
+            BinaryContainerElements<T>::Read(stream, &value, 1);
+            if (stream.getState() != CAPU_OK)
+            {
+                break;
+            }
+            values.push_back(value);
+        }
+        return stream;
+    }
+
+    template<class Key, class T, class C, class H>
+    inline
+    BinaryOutputStream&
+    operator<<(BinaryOutputStream& stream, const HashTable<Key, T, C, H>& values)
+    {
+        stream << static_cast<uint32_t>(values.count());
+        typename HashTable<Key, T, C, H>::Iterator current = values.begin();
+        const typename HashTable<Key, T, C, H>::Iterator end = values.end();
+        for (; current != end; ++current)
+        {
+            BinaryContainerElements<Key>::Write(stream, &current->key, 1);
+            BinaryContainerElements<T>::Write(stream, &current->value, 1);
+        }
+        return stream;
+    }
+
+    template<class Key, class T, class C, class H>
+    inline
+    BinaryInputStream&
+    operator>>(BinaryInputStream& stream, HashTable<Key, T, C, H>& values)
+    {
+        uint32_t count = 0;
+        stream >> count;
+        const uint32_t minimumSize = BinaryContainerElements<Key>::MinimumSize(stream) + BinaryContainerElements<T>::MinimumSize(stream);
+        if (stream.getState() != CAPU_OK || !stream.checkAvailableElements(count, minimumSize))
+        {
+            return stream;
+        }
+
+        // size the table once, so that loading does not rehash
+        values.clear();
+        values.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Key key;
+            T value;
+            BinaryContainerElements<Key>::Read(stream, &key, 1);
+            BinaryContainerElements<T>::Read(stream, &value, 1);
+            if (stream.getState() != CAPU_OK)
+            {
+                break;
+            }
+            values.put(key, value);
+        }
+        return stream;
+    }
+}
+
+#endif // CAPU_BINARYCONTAINERSERIALIZATION_H
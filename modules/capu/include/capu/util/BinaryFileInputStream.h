@@ -26,7 +26,7 @@ namespace capu
     class BinaryFileInputStream: public BinaryInputStream
     {
     public:
-        BinaryFileInputStream(File& file);
+        BinaryFileInputStream(File& file, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~BinaryFileInputStream();
 
         /**
@@ -45,8 +45,8 @@ namespace capu
     };
 
     inline
-    BinaryFileInputStream::BinaryFileInputStream(File& file)
-        : BinaryInputStream(0)  // no buffer is needed to read from since we read direct from file
+    BinaryFileInputStream::BinaryFileInputStream(File& file, const StreamEncoding encoding)
+        : BinaryInputStream(0, encoding)  // no buffer is needed to read from since we read direct from file
         , m_file(file)
         , m_fileState(CAPU_OK)
     {
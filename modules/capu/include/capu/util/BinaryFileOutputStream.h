@@ -26,7 +26,7 @@ namespace capu
     class BinaryFileOutputStream: public BinaryOutputStream
     {
     public:
-        BinaryFileOutputStream(File& file);
+        BinaryFileOutputStream(File& file, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~BinaryFileOutputStream();
 
         /**
@@ -45,8 +45,9 @@ namespace capu
     };
 
     inline
-    BinaryFileOutputStream::BinaryFileOutputStream(File& file)
-        : m_file(file)
+    BinaryFileOutputStream::BinaryFileOutputStream(File& file, const StreamEncoding encoding)
+        : BinaryOutputStream(16, encoding)
+        , m_file(file)
         , m_fileState(CAPU_OK)
     {
         m_fileState = m_file.open(WRITE_EXISTING_BINARY);
@@ -18,11 +18,16 @@
 #define CAPU_BINARYINPUTSTREAM_H
 
 #include <capu/util/IInputStream.h>
+#include <capu/util/StreamEncoding.h>
+#include <capu/container/StringView.h>
 
 namespace capu
 {
     /**
-     * Reads data from a binary stream
+     * Reads data from a binary stream.
+     * Without a size the stream trusts the data to be complete and reads without checks.
+     * With a size every read is checked against the end of the buffer. A read which
+     * exceeds the buffer does not change its destination and sets the state to CAPU_EOF.
      */
     class BinaryInputStream: public IInputStream
     {
@@ -31,8 +36,17 @@ namespace capu
         /**
          * Constructor with a buffer to read from
          * @param input A pointer to the data to read from
+         * @param encoding of integers in the buffer, must match the encoding of the writer
          */
-        BinaryInputStream(const char_t* input);
+        BinaryInputStream(const char_t* input, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
+
+        /**
+         * Constructor with a buffer of known size, which is never read beyond
+         * @param input A pointer to the data to read from
+         * @param size The number of bytes in the buffer
+         * @param encoding of integers in the buffer, must match the encoding of the writer
+         */
+        BinaryInputStream(const char_t* input, const uint32_t size, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
 
         ~BinaryInputStream();
 
@@ -48,12 +62,32 @@ namespace capu
          */
         IInputStream& operator>>(uint32_t& value);
 
+        /**
+         * Read a 64 bit integer from the stream
+         * @param value The variable to write the value to
+         */
+        IInputStream& operator>>(int64_t& value);
+
+        /**
+         * Read a 64 bit integer from the stream
+         * @param value The variable to write the value to
+         */
+        IInputStream& operator>>(uint64_t& value);
+
         /**
          * Read a String from the stream
          * @param value The variable to write the value to
          */
         IInputStream& operator>>(String&  value);
 
+        /**
+         * Read a string from the stream without copying it. The view points into the
+         * buffer of the stream and is valid as long as the buffer. Streams without
+         * buffer set the state to CAPU_ENOT_SUPPORTED.
+         * @param value The variable to write the value to
+         */
+        BinaryInputStream& operator>>(StringView& value);
+
         /**
          * Read a bool from the stream
          * @param value The variable to write the value to
@@ -66,6 +100,12 @@ namespace capu
          */
         IInputStream& operator>>(float_t& value);
 
+        /**
+         * Read a double from the stream
+         * @param value The variable to write the value to
+         */
+        IInputStream& operator>>(double_t& value);
+
         /**
          * Read a uint16_t from the stream
          * @param value The variable to write the value to
@@ -86,10 +126,51 @@ namespace capu
         IInputStream& read(char_t* data, const uint32_t size);
 
         /**
-         * Resets the current reading position to the start of the buffer
+         * Read a number of integers which were written with BinaryOutputStream::writeArray.
+         * The state becomes CAPU_ERANGE if the integers take more than 2^32 - 1 bytes.
+         * @param values Pointer to which the integers will be written
+         * @param count Number of integers to read
+         * @{
+         */
+        IInputStream& readArray(int32_t* values, const uint32_t count);
+        IInputStream& readArray(uint32_t* values, const uint32_t count);
+        IInputStream& readArray(int64_t* values, const uint32_t count);
+        IInputStream& readArray(uint64_t* values, const uint32_t count);
+        /**
+         * @}
+         */
+
+        /**
+         * Returns the encoding of integers in the stream
+         * @return the encoding of integers in the stream
+         */
+        StreamEncoding getEncoding() const;
+
+        /**
+         * Returns the state of the stream
+         * CAPU_OK if all reads succeeded
+         * CAPU_EOF if a read exceeded the size of the buffer
+         * CAPU_ENOT_SUPPORTED if a string view was read from a stream without buffer
+         * CAPU_ERANGE if an array was too large to be read at once
+         * @return the state of the stream
+         */
+        status_t getState() const;
+
+        /**
+         * Resets the current reading position to the start of the buffer and the state to CAPU_OK
          */
         void reset();
 
+        /**
+         * Checks if the buffer can still hold a number of elements, before a container is
+         * sized for them. Streams without a size accept every count.
+         * @param count number of elements announced by the stream
+         * @param minimumSize the least number of bytes a single element takes in the stream
+         * @return true if count elements fit into the rest of the buffer,
+         *         false otherwise, the state is set to CAPU_EOF then
+         */
+        bool_t checkAvailableElements(const uint32_t count, const uint32_t minimumSize);
+
     protected:
     private:
 
@@ -102,7 +183,125 @@ namespace capu
          * Pointer to the current position of the buffer
          */
         const char_t* mCurrent;
+
+        /**
+         * End of the buffer, or 0 if the size is unknown
+         */
+        const char_t* mEnd;
+
+        /**
+         * Encoding of integers
+         */
+        StreamEncoding mEncoding;
+
+        /**
+         * State of the stream
+         */
+        status_t mState;
+
+        /**
+         * Returns true if the given number of bytes can be read from the buffer,
+         * sets the state to CAPU_EOF otherwise
+         * @param size number of bytes to read
+         */
+        bool_t checkAvailable(const uint32_t size);
+
+        /**
+         * Reads a varint from the end of a sized buffer, where it might be cut off
+         * @param value The variable to write the value to
+         * @return false if the varint is cut off
+         */
+        bool_t readVarIntNearEnd(uint64_t& value);
+
+        /**
+         * Reads a varint, directly from the buffer if there is one
+         * @param value The variable to write the value to
+         * @return false if the varint exceeds the size of the buffer
+         */
+        bool_t readVarInt(uint64_t& value);
+
+        /**
+         * Reads values which were written as varints
+         * @param values Pointer to which the values will be written
+         * @param count Number of values to read
+         */
+        template<typename T>
+        void readVarIntArray(T* values, const uint32_t count);
+
+        /**
+         * Reads count values of elementSize bytes which were written with their full size
+         * @param values Pointer to which the values will be written
+         * @param count Number of values to read
+         * @param elementSize Size of a single value
+         */
+        IInputStream& readFixedArray(char_t* values, const uint32_t count, const uint32_t elementSize);
     };
+
+    inline
+    StreamEncoding
+    BinaryInputStream::getEncoding() const
+    {
+        return mEncoding;
+    }
+
+    inline
+    status_t
+    BinaryInputStream::getState() const
+    {
+        return mState;
+    }
+
+    inline
+    bool_t
+    BinaryInputStream::checkAvailable(const uint32_t size)
+    {
+        if (mEnd && static_cast<uint_t>(mEnd - mCurrent) < size)
+        {
+            // nothing more can be read after the first failure
+            mCurrent = mEnd;
+            mState = CAPU_EOF;
+            return false;
+        }
+        return true;
+    }
+
+    inline
+    bool_t
+    BinaryInputStream::checkAvailableElements(const uint32_t count, const uint32_t minimumSize)
+    {
+        if (mEnd && minimumSize > 0 && count > static_cast<uint_t>(mEnd - mCurrent) / minimumSize)
+        {
+            mCurrent = mEnd;
+            mState = CAPU_EOF;
+            return false;
+        }
+        return true;
+    }
+
+    inline
+    bool_t
+    BinaryInputStream::readVarInt(uint64_t& value)
+    {
+        if (mBuffer)
+        {
+            if (mEnd && mEnd - mCurrent < static_cast<int_t>(VarInt::MAX_LENGTH_64))
+            {
+                return readVarIntNearEnd(value);
+            }
+            mCurrent += VarInt::Decode(mCurrent, value);
+            return true;
+        }
+
+        // derived streams without buffer only provide read()
+        value = 0;
+        uint8_t byte = 0x80;
+        for (uint32_t shift = 0; (byte & 0x80) && shift < 7 * VarInt::MAX_LENGTH_64; shift += 7)
+        {
+            read(reinterpret_cast<char_t*>(&byte), 1);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        }
+        return true;
+    }
 }
 
 #endif // CAPU_BINARYINPUTSTREAM_H
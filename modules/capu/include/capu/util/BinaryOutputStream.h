@@ -18,13 +18,19 @@
 #define CAPU_BINARYOUTPUTSTREAM_H
 
 #include <capu/util/IOutputStream.h>
+#include <capu/util/StreamEncoding.h>
 #include <capu/container/Array.h>
 
 namespace capu
 {
+    template<StreamEncoding ENCODING>
+    class BinaryWriter;
+
     /**
      * The BinaryOutputStream writes data directly to a stream.
-     * The initial size is doubled each time the stream is full
+     * The initial size is doubled each time the stream is full.
+     * Integers and string lengths are written with their full size in host byte order,
+     * or as varints with STREAM_ENCODING_VARINT. Floating point values always take their full size.
      */
     class BinaryOutputStream: public IOutputStream
     {
@@ -32,8 +38,9 @@ namespace capu
         /**
          * Constructor with initial capacity for the stream
          * @param startSize the initial capacity of the stream
+         * @param encoding of integers in the stream
          */
-        BinaryOutputStream(const uint32_t startSize = 16);
+        BinaryOutputStream(const uint32_t startSize = 16, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~BinaryOutputStream();
 
         /**
@@ -54,6 +61,24 @@ namespace capu
          */
         IOutputStream& operator<<(const uint32_t value);
 
+        /**
+         * Write a 64 bit integer into the stream
+         * @param value The variable to write to the stream
+         */
+        IOutputStream& operator<<(const int64_t value);
+
+        /**
+         * Write a 64 bit integer into the stream
+         * @param value The variable to write to the stream
+         */
+        IOutputStream& operator<<(const uint64_t value);
+
+        /**
+         * Write a double into the stream
+         * @param value The variable to write to the stream
+         */
+        IOutputStream& operator<<(const double_t value);
+
         /**
          * Write a string into the stream
          * @param value The variable to write to the stream
@@ -91,6 +116,28 @@ namespace capu
          */
         IOutputStream& write(const void* data, const uint32_t size);
 
+        /**
+         * Write a number of integers into the stream. With the fixed encoding this is
+         * a single copy, with the varint encoding the values are encoded in blocks.
+         * The values are not preceded by their count.
+         * @param values The integers to write to the stream
+         * @param count The number of integers to write
+         * @{
+         */
+        IOutputStream& writeArray(const int32_t* values, const uint32_t count);
+        IOutputStream& writeArray(const uint32_t* values, const uint32_t count);
+        IOutputStream& writeArray(const int64_t* values, const uint32_t count);
+        IOutputStream& writeArray(const uint64_t* values, const uint32_t count);
+        /**
+         * @}
+         */
+
+        /**
+         * Returns the encoding of integers in the stream
+         * @return the encoding of integers in the stream
+         */
+        StreamEncoding getEncoding() const;
+
         /**
          * Returns a pointer to the raw data
          * @return a pointer to the raw data
@@ -114,6 +161,20 @@ namespace capu
          */
         void clear();
 
+        /**
+         * Makes sure that the given number of bytes can be written without growing the stream again
+         * @param size number of bytes which will be written
+         */
+        void reserve(const uint32_t size);
+
+        /**
+         * Hands the data of the stream over without copying it. The stream is empty
+         * and without capacity afterwards and can be used again.
+         * @param buffer receives the buffer of the stream, its size is the former capacity
+         * @return the number of valid bytes in the buffer
+         */
+        uint32_t release(Array<char_t>& buffer);
+
         /**
          * @see IOutputStream
          * @{
@@ -124,6 +185,13 @@ namespace capu
          */
 
     private:
+        template<StreamEncoding ENCODING>
+        friend class BinaryWriter;
+
+        /**
+         * Encoding of integers
+         */
+        StreamEncoding mEncoding;
 
         /**
          * Point to the internal stream data
@@ -141,7 +209,8 @@ namespace capu
         uint32_t mCapacity;
 
         /**
-         * Resizes the local buffer to a given minimum size. The size is always power of 2
+         * Resizes the local buffer to a given minimum size. The capacity is at least doubled,
+         * so writing a stream byte by byte only copies each byte a constant number of times on average
          * @param minSize of the internal buffer after resizing
          */
         void resize(const uint32_t minSize);
@@ -151,8 +220,54 @@ namespace capu
          * @paran the requested size for the internal buffer
          */
         void requestSize(const uint32_t size);
+
+        /**
+         * Writes a value as varint
+         * @param value to write
+         */
+        IOutputStream& writeVarInt(const uint64_t value);
+
+        /**
+         * Writes values as varints through a local buffer
+         * @param values to write
+         * @param count of the values
+         */
+        template<typename T>
+        IOutputStream& writeVarIntArray(const T* values, const uint32_t count);
     };
 
+    inline
+    StreamEncoding
+    BinaryOutputStream::getEncoding() const
+    {
+        return mEncoding;
+    }
+
+    inline
+    void
+    BinaryOutputStream::requestSize(const uint32_t size)
+    {
+        if (mSize + size > mCapacity)
+        {
+            resize(mSize + size);
+        }
+    }
+
+    inline
+    void
+    BinaryOutputStream::reserve(const uint32_t size)
+    {
+        requestSize(size);
+    }
+
+    inline
+    IOutputStream&
+    BinaryOutputStream::writeVarInt(const uint64_t value)
+    {
+        char_t buffer[VarInt::MAX_LENGTH_64];
+        return write(buffer, VarInt::Encode(value, buffer));
+    }
+
     inline
     const char_t*
     BinaryOutputStream::getData() const
@@ -181,10 +296,21 @@ namespace capu
         return write(&value, sizeof(float_t));
     }
 
+    inline
+    IOutputStream&
+    BinaryOutputStream::operator<<(const double_t value)
+    {
+        return write(&value, sizeof(double_t));
+    }
+
     inline
     IOutputStream&
     BinaryOutputStream::operator<<(const uint16_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
         return write(&value, sizeof(uint16_t));
     }
 
@@ -192,6 +318,10 @@ namespace capu
     IOutputStream&
     BinaryOutputStream::operator<<(const int32_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(VarInt::ZigZag(value));
+        }
         return write(&value, sizeof(int32_t));
     }
 
@@ -199,9 +329,35 @@ namespace capu
     IOutputStream&
     BinaryOutputStream::operator<<(const uint32_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
         return write(&value, sizeof(uint32_t));
     }
 
+    inline
+    IOutputStream&
+    BinaryOutputStream::operator<<(const int64_t value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(VarInt::ZigZag(value));
+        }
+        return write(&value, sizeof(int64_t));
+    }
+
+    inline
+    IOutputStream&
+    BinaryOutputStream::operator<<(const uint64_t value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
+        return write(&value, sizeof(uint64_t));
+    }
+
     inline
     IOutputStream&
     BinaryOutputStream::operator<<(const Guid& value)
@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_BINARYWRITER_H
+#define CAPU_BINARYWRITER_H
+
+#include <capu/util/BinaryOutputStream.h>
+#include <capu/util/StreamEncoding.h>
+#include <capu/os/Memory.h>
+#include <capu/os/StringUtils.h>
+
+namespace capu
+{
+    /**
+     * Writes directly into the buffer of a BinaryOutputStream without virtual calls.
+     * The encoding is a template parameter, so every operator compiles to a capacity
+     * check and a copy. The data is the same as written by a BinaryOutputStream with
+     * that encoding and can be read with a BinaryInputStream.
+     *
+     * The writer only writes to the memory of the stream, not through write(), so
+     * streams which write somewhere else like BinaryFileOutputStream are not supported.
+     */
+    template<StreamEncoding ENCODING = STREAM_ENCODING_FIXED>
+    class BinaryWriter
+    {
+    public:
+        /**
+         * Constructor
+         * @param stream whose buffer is appended to
+         */
+        explicit BinaryWriter(BinaryOutputStream& stream);
+
+        /**
+         * Write a value into the stream
+         * @param value The value to write to the stream
+         * @{
+         */
+        BinaryWriter& operator<<(const int32_t value);
+        BinaryWriter& operator<<(const uint32_t value);
+        BinaryWriter& operator<<(const int64_t value);
+        BinaryWriter& operator<<(const uint64_t value);
+        BinaryWriter& operator<<(const uint16_t value);
+        BinaryWriter& operator<<(const float_t value);
+        BinaryWriter& operator<<(const double_t value);
+        BinaryWriter& operator<<(const bool_t value);
+        BinaryWriter& operator<<(const String& value);
+        BinaryWriter& operator<<(const char_t* value);
+        BinaryWriter& operator<<(const Guid& value);
+        /**
+         * @}
+         */
+
+        /**
+         * Write a number of bytes into the stream
+         * @param data The data to write to the stream
+         * @param size The number of bytes to write
+         */
+        BinaryWriter& write(const void* data, const uint32_t size);
+
+        /**
+         * Write a number of integers like BinaryOutputStream::writeArray.
+         * The space is reserved once for the whole array.
+         * @param values The integers to write to the stream
+         * @param count The number of integers to write
+         * @{
+         */
+        BinaryWriter& writeArray(const int32_t* values, const uint32_t count);
+        BinaryWriter& writeArray(const uint32_t* values, const uint32_t count);
+        BinaryWriter& writeArray(const int64_t* values, const uint32_t count);
+        BinaryWriter& writeArray(const uint64_t* values, const uint32_t count);
+        /**
+         * @}
+         */
+
+        /**
+         * Grows the stream once for a sequence of the given size, e.g. a number of
+         * fixed size records, instead of growing it while writing
+         * @param size number of bytes which will be written
+         */
+        BinaryWriter& reserve(const uint32_t size);
+
+        /**
+         * Returns the stream which is written to
+         * @return the stream which is written to
+         */
+        BinaryOutputStream& getStream() const;
+
+    private:
+        BinaryOutputStream& mStream;
+
+        char_t* append(const uint32_t size);
+        BinaryWriter& writeVarInt(const uint64_t value);
+
+        template<typename T>
+        BinaryWriter& writeFixed(const T& value);
+
+        template<typename T>
+        BinaryWriter& writeFixedArray(const T* values, const uint32_t count);
+
+        template<typename T>
+        BinaryWriter& writeVarIntArray(const T* values, const uint32_t count);
+
+        static uint64_t VarIntValue(const int32_t value);
+        static uint64_t VarIntValue(const uint32_t value);
+        static uint64_t VarIntValue(const int64_t value);
+        static uint64_t VarIntValue(const uint64_t value);
+    };
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>::BinaryWriter(BinaryOutputStream& stream)
+        : mStream(stream)
+    {
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryOutputStream&
+    BinaryWriter<ENCODING>::getStream() const
+    {
+        return mStream;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::reserve(const uint32_t size)
+    {
+        mStream.requestSize(size);
+        return *this;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    char_t*
+    BinaryWriter<ENCODING>::append(const uint32_t size)
+    {
+        mStream.requestSize(size);
+        char_t* position = mStream.mBuffer.getRawData() + mStream.mSize;
+        mStream.mSize += size;
+        return position;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::write(const void* data, const uint32_t size)
+    {
+        Memory::Copy(append(size), data, size);
+        return *this;
+    }
+
+    template<StreamEncoding ENCODING>
+    template<typename T>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeFixed(const T& value)
+    {
+        // constant size, the copy becomes a single store
+        Memory::Copy(append(sizeof(T)), &value, sizeof(T));
+        return *this;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeVarInt(const uint64_t value)
+    {
+        mStream.requestSize(VarInt::MAX_LENGTH_64);
+        mStream.mSize += VarInt::Encode(value, mStream.mBuffer.getRawData() + mStream.mSize);
+        return *this;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    uint64_t
+    BinaryWriter<ENCODING>::VarIntValue(const int32_t value)
+    {
+        return VarInt::ZigZag(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    uint64_t
+    BinaryWriter<ENCODING>::VarIntValue(const uint32_t value)
+    {
+        return value;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    uint64_t
+    BinaryWriter<ENCODING>::VarIntValue(const int64_t value)
+    {
+        return VarInt::ZigZag(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    uint64_t
+    BinaryWriter<ENCODING>::VarIntValue(const uint64_t value)
+    {
+        return value;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const int32_t value)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarInt(VarIntValue(value)) : writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const uint32_t value)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarInt(value) : writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const int64_t value)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarInt(VarIntValue(value)) : writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const uint64_t value)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarInt(value) : writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const uint16_t value)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarInt(value) : writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const float_t value)
+    {
+        return writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const double_t value)
+    {
+        return writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const bool_t value)
+    {
+        return writeFixed(value);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const Guid& value)
+    {
+        return writeFixed(value.getGuidData());
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const String& value)
+    {
+        const uint32_t length = static_cast<uint32_t>(value.getLength());
+        operator<<(length);
+        return write(value.c_str(), length);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::operator<<(const char_t* value)
+    {
+        const uint32_t length = static_cast<uint32_t>(StringUtils::Strlen(value));
+        operator<<(length);
+        return write(value, length);
+    }
+
+    template<StreamEncoding ENCODING>
+    template<typename T>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeFixedArray(const T* values, const uint32_t count)
+    {
+        return write(values, count * sizeof(T));
+    }
+
+    template<StreamEncoding ENCODING>
+    template<typename T>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeVarIntArray(const T* values, const uint32_t count)
+    {
+        // reserve the maximum size once per block, encode without further checks
+        static const uint32_t BlockSize = 65536;
+        const T* end = values + count;
+        while (values != end)
+        {
+            const T* blockEnd = (end - values > static_cast<int_t>(BlockSize)) ? values + BlockSize : end;
+            mStream.requestSize(static_cast<uint32_t>(blockEnd - values) * VarInt::MAX_LENGTH_64);
+            char_t* start = mStream.mBuffer.getRawData() + mStream.mSize;
+            char_t* current = start;
+            for (; values != blockEnd; ++values)
+            {
+                current += VarInt::Encode(VarIntValue(*values), current);
+            }
+            mStream.mSize += static_cast<uint32_t>(current - start);
+        }
+        return *this;
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeArray(const int32_t* values, const uint32_t count)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarIntArray(values, count) : writeFixedArray(values, count);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeArray(const uint32_t* values, const uint32_t count)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarIntArray(values, count) : writeFixedArray(values, count);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeArray(const int64_t* values, const uint32_t count)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarIntArray(values, count) : writeFixedArray(values, count);
+    }
+
+    template<StreamEncoding ENCODING>
+    inline
+    BinaryWriter<ENCODING>&
+    BinaryWriter<ENCODING>::writeArray(const uint64_t* values, const uint32_t count)
+    {
+        return ENCODING == STREAM_ENCODING_VARINT ? writeVarIntArray(values, count) : writeFixedArray(values, count);
+    }
+}
+
+#endif // CAPU_BINARYWRITER_H
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAPU_CALLABLE_H
+#define CAPU_CALLABLE_H
+
+#include "capu/Config.h"
+
+namespace capu
+{
+    /**
+     * A task which produces a result. Can be submitted to a ThreadPool,
+     * the result is delivered through the returned Future.
+     */
+    template<typename T>
+    class Callable
+    {
+    public:
+
+        /**
+         * Destructor
+         */
+        virtual ~Callable() {}
+
+        /**
+         * Computes the result of the task
+         * @return the result
+         */
+        virtual T call() = 0;
+    };
+
+    /**
+     * A task which consumes the result of a previous task and produces a new one.
+     * See Future::then.
+     */
+    template<typename T, typename R>
+    class Continuation
+    {
+    public:
+
+        /**
+         * Destructor
+         */
+        virtual ~Continuation() {}
+
+        /**
+         * Computes the result of the task
+         * @param value the result of the previous task
+         * @return the result
+         */
+        virtual R call(const T& value) = 0;
+    };
+}
+
+#endif // CAPU_CALLABLE_H
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FIBER_H
+#define CAPU_FIBER_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Vector.h"
+#include "capu/os/CondVar.h"
+#include "capu/os/FiberContext.h"
+#include "capu/os/Mutex.h"
+#include "capu/os/TcpSocket.h"
+#include "capu/os/Thread.h"
+#include "capu/util/Runnable.h"
+#include "capu/util/SmartPointer.h"
+
+namespace capu
+{
+    class FiberScheduler;
+
+    /**
+     * Hands out fiber stacks and keeps released ones for reuse, so starting a fiber usually
+     * does not need a system call. Not thread safe, the FiberScheduler uses it under its lock.
+     *
+     * With guard pages every stack is a mapping of its own with an inaccessible page below it.
+     * The system limits the number of mappings per process (vm.max_map_count, 65530 by default
+     * on Linux) and a guarded stack takes two of them. Without guard pages stacks are cut from
+     * larger mappings, which makes hundreds of thousands of stacks possible.
+     */
+    class FiberStackPool
+    {
+    public:
+        /**
+         * Creates an empty pool
+         * @param stackSize size of each stack in bytes, rounded up to 4 KiB
+         * @param guardPages protect each stack with a guard page
+         */
+        FiberStackPool(const uint_t stackSize, const bool_t guardPages);
+
+        /**
+         * Unmaps all stacks, including the ones still handed out
+         */
+        ~FiberStackPool();
+
+        /**
+         * Takes a stack from the pool, mapping new ones when the pool is empty
+         * @return lowest address of the stack, NULL if no memory could be mapped
+         */
+        void* acquire();
+
+        /**
+         * Returns a stack to the pool
+         * @param stack the stack from acquire
+         */
+        void release(void* stack);
+
+        /**
+         * @return the size of the stacks
+         */
+        uint_t getStackSize() const;
+
+    private:
+        /**
+         * Number of stacks which share one mapping if there are no guard pages
+         */
+        static const uint32_t StacksPerMapping;
+
+        uint_t mStackSize;
+        bool_t mGuardPages;
+        Vector<void*> mFreeStacks;
+        Vector<void*> mMappings;
+    };
+
+    /**
+     * A thread of execution with its own stack that is scheduled in user space by a
+     * FiberScheduler. Fibers switch cooperatively: a fiber runs until it yields, suspends
+     * or ends, and blocking calls which are fiber aware suspend the fiber instead of the
+     * thread underneath, so a few threads can serve many thousands of fibers.
+     */
+    class Fiber
+    {
+    public:
+        /**
+         * @return the fiber calling, NULL if called on a thread which is not running a fiber
+         */
+        static Fiber* Current();
+
+        /**
+         * Lets other ready fibers run. The calling fiber is ready again immediately.
+         * On a thread which is not running a fiber the thread yields instead.
+         */
+        static void Yield();
+
+        /**
+         * Suspends the calling fiber for at least the given time. Other fibers run meanwhile.
+         * On a thread which is not running a fiber the thread sleeps.
+         * @param millis milliseconds to sleep
+         * @return CAPU_OK
+         */
+        static status_t Sleep(const uint32_t millis);
+
+        /**
+         * Suspends the calling fiber until resume is called. Building block for fiber aware
+         * synchronization: lock protects the state the fiber waits for. It is released only
+         * after the fiber is suspended, so a resume from another thread holding lock cannot
+         * get lost, and it is locked again before Suspend returns.
+         * @param lock locked by the caller
+         * @param timeoutMillis milliseconds until the fiber continues anyway, 0 waits infinitely
+         * @return CAPU_OK if the fiber was resumed
+         *         CAPU_ETIMEOUT if the timeout expired first
+         *         CAPU_ERROR if not called on a fiber
+         */
+        static status_t Suspend(Mutex& lock, const uint32_t timeoutMillis = 0);
+
+        /**
+         * Receives from a socket like TcpSocket::receive. On a fiber the call waits for data by
+         * suspending the fiber instead of blocking the thread, respecting the timeout of the socket.
+         * @param socket the socket to receive from
+         * @param buffer receives the data
+         * @param length size of the buffer
+         * @param numBytes receives the number of bytes received
+         * @return the result of TcpSocket::receive, CAPU_ETIMEOUT if the timeout expired
+         */
+        static status_t Receive(TcpSocket& socket, char_t* buffer, int32_t length, int32_t& numBytes);
+
+        /**
+         * Makes a fiber suspended by Suspend ready to run again. Has no effect on a fiber
+         * which is not suspended.
+         */
+        void resume();
+
+    private:
+        friend class FiberScheduler;
+
+        enum State
+        {
+            FIBER_READY,
+            FIBER_RUNNING,
+            FIBER_SUSPENDED
+        };
+
+        Fiber(FiberScheduler& scheduler, SmartPointer<Runnable> runnable, void* stack);
+
+        static void Entry(void* argument);
+        static status_t SuspendCurrent(Mutex* lock, const uint32_t timeoutMillis, const int32_t descriptor);
+        static status_t WaitReadable(const int32_t descriptor, const uint32_t timeoutMillis);
+
+        FiberContext mContext;
+        FiberScheduler& mScheduler;
+        SmartPointer<Runnable> mRunnable;
+        void* mStack;
+        State mState;
+        status_t mWakeStatus;
+        Fiber* mNext;
+        uint64_t mDeadline;
+        uint32_t mTimerIndex;
+        int32_t mDescriptor;
+        uint32_t mPollIndex;
+        Fiber* mIoPrevious;
+        Fiber* mIoNext;
+    };
+
+    /**
+     * Fibers and threads waiting for a condition, woken in arrival order. The state of the
+     * condition is protected by a Mutex of the user which has to be held for every call.
+     * Fibers are suspended while waiting, threads block on a condition variable.
+     */
+    class FiberWaitQueue
+    {
+    public:
+        FiberWaitQueue();
+
+        /**
+         * Waits until notified. The lock is released while waiting and held again on return.
+         * Waiting may end without notification, callers check their condition in a loop.
+         * @param lock the lock protecting the condition, held by the caller
+         * @param timeoutMillis milliseconds to wait, 0 waits infinitely
+         * @return CAPU_OK if notified or woken spuriously, CAPU_ETIMEOUT if the timeout expired
+         */
+        status_t wait(Mutex& lock, const uint32_t timeoutMillis = 0);
+
+        /**
+         * Wakes the longest waiting fiber or thread
+         * @return true if there was a waiter
+         */
+        bool_t notifyOne();
+
+        /**
+         * Wakes all waiting fibers and threads
+         */
+        void notifyAll();
+
+        /**
+         * @return true if nobody waits
+         */
+        bool_t empty() const;
+
+    private:
+        struct Waiter
+        {
+            Fiber* fiber;
+            bool_t notified;
+            Waiter* previous;
+            Waiter* next;
+        };
+
+        void remove(Waiter& waiter);
+
+        CondVar mThreadWakeup;
+        Waiter* mHead;
+        Waiter* mTail;
+    };
+
+    /**
+     * Runs fibers on a fixed number of threads (M:N scheduling). Ready fibers wait in one
+     * queue shared by all threads; a thread with nothing to run waits for timeouts and for
+     * the sockets fibers wait on.
+     */
+    class FiberScheduler
+    {
+    public:
+        /**
+         * Default stack size of a fiber
+         */
+        static const uint_t DefaultStackSize;
+
+        /**
+         * Creates the scheduler and starts its threads
+         * @param threads number of threads running fibers
+         * @param stackSize stack size of each fiber in bytes
+         * @param guardPages protect the fiber stacks with guard pages, see FiberStackPool
+         */
+        FiberScheduler(const uint32_t threads = 1, const uint_t stackSize = DefaultStackSize, const bool_t guardPages = true);
+
+        /**
+         * Waits until all fibers ended, see close
+         */
+        ~FiberScheduler();
+
+        /**
+         * Starts a fiber running the runnable. The fiber keeps a reference until the runnable returns.
+         * @param runnable the runnable to run
+         * @return CAPU_EINVAL if runnable is NULL
+         *         CAPU_ERROR if the scheduler is closed and no fiber is left
+         *         CAPU_ENO_MEMORY if no stack could be mapped
+         *         CAPU_OK otherwise
+         */
+        status_t spawn(SmartPointer<Runnable> runnable);
+
+        /**
+         * Stops accepting new fibers, waits until all fibers ended and stops the threads.
+         * As long as fibers are left, spawn still succeeds, so running fibers may spawn fibers until then.
+         * Must not be called from a fiber of the scheduler.
+         * @return CAPU_OK if all threads were stopped
+         */
+        status_t close();
+
+        /**
+         * @return true if the scheduler was closed or is closing
+         */
+        bool_t isClosed() const;
+
+        /**
+         * @return the number of fibers which have not ended yet
+         */
+        uint_t getFiberCount() const;
+
+        /**
+         * @return the number of threads running fibers
+         */
+        uint32_t getThreadCount() const;
+
+    private:
+        friend class Fiber;
+
+        enum Action
+        {
+            WORKER_YIELD,
+            WORKER_SUSPEND,
+            WORKER_FINISH
+        };
+
+        class Worker: public Runnable
+        {
+        public:
+            Worker(FiberScheduler& scheduler);
+            void run();
+
+            FiberScheduler& mScheduler;
+            Thread mThread;
+            FiberContext mContext;
+            Fiber* mFiber;
+            Action mAction;
+            Mutex* mLock;
+        };
+
+        static const uint32_t NoIndex;
+
+        static Worker* CurrentWorker();
+
+        void runWorker(Worker& worker);
+        void finishSwitch(Worker& worker, Fiber& fiber);
+        void pushReady(Fiber& fiber);
+        Fiber* popReady();
+        void wake(Fiber& fiber, const status_t status);
+        void addTimer(Fiber& fiber);
+        void removeTimer(Fiber& fiber);
+        void placeTimer(uint32_t index, Fiber* fiber);
+        void expireTimers();
+        int32_t millisToNextTimer() const;
+        void addIoWaiter(Fiber& fiber);
+        void removeIoWaiter(Fiber& fiber);
+        void pollIo(const bool_t block);
+        void wakePoller();
+
+        static CAPU_THREAD_LOCAL Worker* sCurrentWorker;
+
+        mutable Mutex mMutex;
+        CondVar mCondVar;
+        FiberStackPool mStacks;
+        Vector<Worker*> mWorkers;
+        Fiber* mReadyHead;
+        Fiber* mReadyTail;
+        Vector<Fiber*> mTimers;
+        Fiber* mIoWaiters;
+        uint32_t mIoWaiterCount;
+        int32_t mWakePipe[2];
+        bool_t mPolling;
+        bool_t mWakePending;
+        uint32_t mIdleWorkers;
+        uint32_t mDispatches;
+        uint_t mFiberCount;
+        bool_t mClosing;
+        bool_t mClosed;
+    };
+}
+
+#endif // CAPU_FIBER_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FIBERBLOCKINGQUEUE_H
+#define CAPU_FIBERBLOCKINGQUEUE_H
+
+#include "capu/container/Queue.h"
+#include "capu/os/Mutex.h"
+#include "capu/os/Time.h"
+#include "capu/util/Fiber.h"
+#include "capu/util/ScopedLock.h"
+
+namespace capu
+{
+    /**
+     * Queue for concurrent access by fibers and threads. All methods are threadsafe.
+     * Unlike BlockingQueue, pop suspends a waiting fiber instead of blocking the thread
+     * under it, so producers and consumers can be fibers on the same thread.
+     */
+    template <class T>
+    class FiberBlockingQueue
+    {
+    public:
+        /**
+         * Insert an element into the queue and wake a waiting consumer
+         * @param element The element to insert
+         * @return CAPU_OK if push was successful.
+         */
+        status_t push(const T& element);
+
+        /**
+         * Remove and return an element from the queue
+         * @param element Pointer which will receive the removed element
+         * @param timeoutMillis Milliseconds to wait for an element, 0 waits infinitely
+         * @return CAPU_OK if removal was successfull, CAPU_ETIMEOUT if timeout occured
+         */
+        status_t pop(T* element = 0, const uint32_t timeoutMillis = 0);
+
+        /**
+         * Check the queue is empty or not
+         * @return true if empty
+         *         false otherwise
+         */
+        bool_t empty();
+
+        /**
+         * Return size of the queue
+         * @return return the size of queue
+         */
+        uint_t size();
+
+        /**
+         * Remove all elements from queue
+         */
+        void clear();
+
+    private:
+        Mutex mMutex;
+        FiberWaitQueue mConsumers;
+        Queue<T> mQueue;
+    };
+
+    template <class T>
+    inline status_t FiberBlockingQueue<T>::push(const T& element)
+    {
+        ScopedMutexLock locker(mMutex);
+        const status_t retVal = mQueue.push(element);
+        mConsumers.notifyOne();
+        return retVal;
+    }
+
+    template <class T>
+    inline status_t FiberBlockingQueue<T>::pop(T* element, const uint32_t timeoutMillis)
+    {
+        ScopedMutexLock locker(mMutex);
+        const uint64_t start = timeoutMillis > 0 ? Time::GetMilliseconds() : 0;
+        while (mQueue.empty())
+        {
+            uint32_t remaining = 0;
+            if (timeoutMillis > 0)
+            {
+                const uint64_t elapsed = Time::GetMilliseconds() - start;
+                if (elapsed >= timeoutMillis)
+                {
+                    return CAPU_ETIMEOUT;
+                }
+                remaining = static_cast<uint32_t>(timeoutMillis - elapsed);
+            }
+            mConsumers.wait(mMutex, remaining);
+        }
+        return mQueue.pop(element);
+    }
+
+    template <class T>
+    inline bool_t FiberBlockingQueue<T>::empty()
+    {
+        ScopedMutexLock locker(mMutex);
+        return mQueue.empty();
+    }
+
+    template <class T>
+    inline uint_t FiberBlockingQueue<T>::size()
+    {
+        ScopedMutexLock locker(mMutex);
+        return mQueue.size();
+    }
+
+    template <class T>
+    inline void FiberBlockingQueue<T>::clear()
+    {
+        ScopedMutexLock locker(mMutex);
+        mQueue.clear();
+    }
+}
+
+#endif // CAPU_FIBERBLOCKINGQUEUE_H
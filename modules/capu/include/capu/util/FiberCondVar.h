@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FIBERCONDVAR_H
+#define CAPU_FIBERCONDVAR_H
+
+#include "capu/Error.h"
+#include "capu/os/Mutex.h"
+#include "capu/util/Fiber.h"
+#include "capu/util/FiberMutex.h"
+#include "capu/util/ScopedLock.h"
+
+namespace capu
+{
+    /**
+     * Condition variable for fibers, used together with a FiberMutex. A waiting fiber is
+     * suspended, the thread under it continues with other fibers. Threads which are not
+     * running a fiber can wait as well.
+     */
+    class FiberCondVar
+    {
+    public:
+        /**
+         * Wakes the longest waiting fiber or thread
+         * @return CAPU_OK
+         */
+        status_t signal();
+
+        /**
+         * Releases the mutex, waits for a signal and takes the mutex again
+         * @param mutex The mutex to use for locked access, held by the caller
+         * @param millisec Milliseconds to wait (default '0' is infinite)
+         * @return CAPU_OK if the condition variable is correctly waited
+         *         CAPU_ETIMEOUT if the timeout expired
+         *         CAPU_EINVAL if the given mutex is NULL
+         */
+        status_t wait(FiberMutex* mutex, uint32_t millisec = 0);
+
+        /**
+         * Wakes all waiting fibers and threads
+         * @return CAPU_OK
+         */
+        status_t broadcast();
+
+    private:
+        Mutex mLock;
+        FiberWaitQueue mWaiters;
+    };
+
+    inline status_t FiberCondVar::signal()
+    {
+        ScopedMutexLock lock(mLock);
+        mWaiters.notifyOne();
+        return CAPU_OK;
+    }
+
+    inline status_t FiberCondVar::wait(FiberMutex* mutex, uint32_t millisec)
+    {
+        if (!mutex)
+        {
+            return CAPU_EINVAL;
+        }
+
+        // enqueued before the mutex is released, a signal after that finds the waiter
+        mLock.lock();
+        mutex->unlock();
+        const status_t status = mWaiters.wait(mLock, millisec);
+        mLock.unlock();
+        mutex->lock();
+        return status;
+    }
+
+    inline status_t FiberCondVar::broadcast()
+    {
+        ScopedMutexLock lock(mLock);
+        mWaiters.notifyAll();
+        return CAPU_OK;
+    }
+}
+
+#endif // CAPU_FIBERCONDVAR_H
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FIBERMUTEX_H
+#define CAPU_FIBERMUTEX_H
+
+#include "capu/Error.h"
+#include "capu/os/Mutex.h"
+#include "capu/util/Fiber.h"
+#include "capu/util/ScopedLock.h"
+
+namespace capu
+{
+    /**
+     * Mutex for fibers. A fiber waiting for the lock is suspended, the thread under it
+     * continues with other fibers. Threads which are not running a fiber can use it as well,
+     * they block as with a Mutex.
+     */
+    class FiberMutex
+    {
+    public:
+        /**
+         * Constructor
+         */
+        FiberMutex();
+
+        /**
+         * Waits until the lock is available and takes it
+         * @return CAPU_OK if the locking is successful
+         */
+        status_t lock();
+
+        /**
+         * Takes the lock if it is available
+         * @return true if the lock was taken
+         */
+        bool_t trylock();
+
+        /**
+         * Releases the lock and wakes the longest waiting fiber or thread
+         * @return CAPU_OK if the unlocking is successful
+         */
+        status_t unlock();
+
+    private:
+        Mutex mLock;
+        FiberWaitQueue mWaiters;
+        bool_t mLocked;
+    };
+
+    inline
+    FiberMutex::FiberMutex()
+        : mLocked(false)
+    {
+    }
+
+    inline
+    status_t FiberMutex::lock()
+    {
+        ScopedMutexLock lock(mLock);
+        while (mLocked)
+        {
+            mWaiters.wait(mLock);
+        }
+        mLocked = true;
+        return CAPU_OK;
+    }
+
+    inline
+    bool_t FiberMutex::trylock()
+    {
+        ScopedMutexLock lock(mLock);
+        if (mLocked)
+        {
+            return false;
+        }
+        mLocked = true;
+        return true;
+    }
+
+    inline
+    status_t FiberMutex::unlock()
+    {
+        ScopedMutexLock lock(mLock);
+        mLocked = false;
+        mWaiters.notifyOne();
+        return CAPU_OK;
+    }
+
+    /**
+     * ScopedLock for FiberMutex
+     */
+    typedef ScopedLock<FiberMutex> ScopedFiberMutexLock;
+}
+
+#endif // CAPU_FIBERMUTEX_H
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_FILEAPPENDER_H
+#define CAPU_FILEAPPENDER_H
+
+#include "capu/Config.h"
+#include "capu/container/String.h"
+#include "capu/os/CondVar.h"
+#include "capu/os/File.h"
+#include "capu/os/Mutex.h"
+#include "capu/os/Thread.h"
+#include "capu/util/Appender.h"
+#include "capu/util/Runnable.h"
+
+namespace capu
+{
+    /**
+     * Appender which writes log messages to a file.
+     *
+     * Messages are formatted into an in-memory buffer. A background thread writes
+     * the buffer when it is full or when the flush interval has passed, rotates the
+     * file when it exceeds the maximum size and synchronizes the file with the
+     * storage device at most once per sync interval. While the background thread
+     * writes, rotates or syncs, new messages go into a second buffer, so logging
+     * threads only wait if both buffers are full.
+     *
+     * The configuration has to be set before calling open().
+     */
+    class FileAppender : public Appender
+    {
+    public:
+        /**
+         * Default size of each of the two message buffers
+         */
+        static const uint_t DEFAULT_BUFFER_SIZE;
+
+        /**
+         * Creates an appender which writes to the given file
+         * @param path the path of the log file. Rotated files get the suffixes .1, .2, ...
+         */
+        FileAppender(const String& path);
+
+        /**
+         * Closes the appender
+         */
+        virtual ~FileAppender();
+
+        /**
+         * Sets the size of the message buffers
+         * @param size the size of each of the two buffers in bytes
+         */
+        void setBufferSize(const uint_t size);
+
+        /**
+         * Sets the maximum time a message stays in the buffer
+         * @param millis the flush interval, 0 to flush only when the buffer is full
+         */
+        void setFlushInterval(const uint32_t millis);
+
+        /**
+         * Sets the minimum time between two synchronizations of the file with the storage device
+         * @param millis the sync interval, 0 to sync after every write
+         */
+        void setSyncInterval(const uint32_t millis);
+
+        /**
+         * Enables rotation of the log file
+         * @param maxFileSize the file is rotated when it exceeds this size in bytes, 0 disables rotation
+         * @param maxFileCount the number of rotated files to keep besides the current file
+         */
+        void setRotation(const uint_t maxFileSize, const uint32_t maxFileCount);
+
+        /**
+         * Opens the log file and starts the writer thread. An existing file is rotated
+         * first if rotation is enabled, otherwise it is overwritten.
+         * @return CAPU_OK if the file could be opened
+         *         CAPU_ERROR if the appender is already open or the file could not be opened
+         */
+        status_t open();
+
+        /**
+         * Formats the message into the buffer
+         * @param message the message to log
+         * @return CAPU_OK if the message was buffered
+         *         CAPU_ERROR if the appender is not open
+         */
+        status_t log(LoggerMessage& message);
+
+        /**
+         * Writes all buffered messages to the file and waits until they are written
+         * @return CAPU_OK if the buffered messages were written
+         *         CAPU_ERROR if the appender is not open or writing failed
+         */
+        status_t flush();
+
+        /**
+         * Writes all buffered messages, syncs and closes the file and stops the writer thread
+         * @return CAPU_OK if all messages were written
+         *         CAPU_ERROR if the appender was not open or writing failed
+         */
+        status_t close();
+
+    private:
+        class Writer : public Runnable
+        {
+        public:
+            Writer(FileAppender& appender);
+            void run();
+        private:
+            FileAppender& mAppender;
+        };
+
+        FileAppender(const FileAppender&);
+        FileAppender& operator=(const FileAppender&);
+
+        void writerLoop();
+        status_t writeBuffer(const char_t* buffer, const uint_t size);
+        status_t rotate();
+        status_t openFile();
+        String getRotatedPath(const uint32_t index) const;
+        void swapBuffers();
+
+        const String mPath;
+        uint_t mBufferSize;
+        uint32_t mFlushInterval;
+        uint32_t mSyncInterval;
+        uint_t mMaxFileSize;
+        uint32_t mMaxFileCount;
+
+        File* mFile;
+        uint_t mFileSize;
+        uint64_t mLastSync;
+        bool_t mUnsynced;
+
+        char_t* mActiveBuffer;
+        uint_t mActiveSize;
+        uint64_t mActiveSince;
+        char_t* mPendingBuffer;
+        uint_t mPendingSize;
+        uint64_t mWrittenGeneration;
+        uint64_t mPendingGeneration;
+        status_t mWriteStatus;
+        bool_t mOpen;
+        bool_t mCloseRequested;
+
+        Mutex mMutex;
+        CondVar mWriterCondition;
+        CondVar mBufferFreeCondition;
+        Writer mWriter;
+        Thread mThread;
+    };
+}
+
+#endif // CAPU_FILEAPPENDER_H
@@ -0,0 +1,461 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAPU_FUTURE_H
+#define CAPU_FUTURE_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Array.h"
+#include "capu/os/CondVar.h"
+#include "capu/os/Mutex.h"
+#include "capu/util/Callable.h"
+#include "capu/util/Runnable.h"
+#include "capu/util/SmartPointer.h"
+
+namespace capu
+{
+    class ThreadPool;
+
+    /**
+     * Shared state between a task running on a ThreadPool and the Futures waiting for it.
+     * Holds its own reference count, so the state, the result and the bookkeeping for
+     * continuations live in a single allocation. Not meant to be used directly.
+     */
+    class FutureTask : public Runnable
+    {
+    public:
+
+        /**
+         * Link in the list of tasks which depend on another task
+         */
+        struct Dependency
+        {
+            FutureTask* task;
+            Dependency* next;
+        };
+
+        /**
+         * Creates a task
+         * @param pool the pool on which the task is scheduled once all dependencies are done,
+         *             NULL to run it directly on the thread which finished the last dependency
+         * @param dependencies number of tasks which must be done before this task can run
+         */
+        FutureTask(ThreadPool* pool, const uint32_t dependencies);
+
+        /**
+         * Destructor
+         */
+        virtual ~FutureTask();
+
+        /**
+         * Increments the reference count
+         */
+        void addReference();
+
+        /**
+         * Decrements the reference count and deletes the task if it was the last reference
+         */
+        void releaseReference();
+
+        /**
+         * @return true if the task has finished
+         */
+        bool_t isDone();
+
+        /**
+         * Blocks until the task has finished
+         * @param timeoutMillis timeout, 0 waits forever
+         * @return the status of the task, CAPU_ETIMEOUT if the task did not finish in time
+         */
+        status_t wait(const uint32_t timeoutMillis);
+
+        /**
+         * Executes the task and wakes up all waiters and dependent tasks
+         */
+        void run();
+
+        /**
+         * Finishes the task without executing it
+         * @param status the error to report to the waiters
+         */
+        void abandon(const status_t status);
+
+        /**
+         * Makes the task of the given dependency wait for this task.
+         * If this task has already finished the dependency is resolved immediately.
+         * @param dependency link which stays owned by the dependent task
+         */
+        void addDependent(Dependency& dependency);
+
+    protected:
+
+        /**
+         * Computes the result of the task
+         * @param dependencyStatus CAPU_OK if all dependencies finished successfully,
+         *                         the first error otherwise
+         * @return the status reported to the waiters
+         */
+        virtual status_t execute(const status_t dependencyStatus) = 0;
+
+    private:
+        void finish(const status_t status);
+        void dependencyDone(const status_t status);
+
+        volatile uint32_t mReferenceCount;
+        volatile uint32_t mDone;
+        volatile uint32_t mPendingDependencies;
+        status_t mStatus;
+        status_t mDependencyStatus;
+        uint32_t mWaiters;
+        Dependency* mDependents;
+        ThreadPool* mPool;
+        Mutex mMutex;
+        CondVar mCondVar;
+    };
+
+    /**
+     * FutureTask which stores a result of type T
+     */
+    template<typename T>
+    class FutureState : public FutureTask
+    {
+    public:
+        FutureState(ThreadPool* pool, const uint32_t dependencies);
+        const T& getValue() const;
+
+    protected:
+        T mValue;
+    };
+
+    /**
+     * Handle to the result of a task which was submitted to a ThreadPool.
+     * Futures are cheap to copy, all copies refer to the same result.
+     */
+    template<typename T>
+    class Future
+    {
+    public:
+
+        /**
+         * Creates an invalid future which does not refer to any task
+         */
+        Future();
+
+        /**
+         * Creates a future for the given state
+         * @param state the shared state, NULL creates an invalid future
+         */
+        explicit Future(FutureState<T>* state);
+
+        /**
+         * Copy constructor
+         * @param other future to copy
+         */
+        Future(const Future<T>& other);
+
+        /**
+         * Destructor
+         */
+        ~Future();
+
+        /**
+         * Assignment operator
+         * @param other future to assign
+         */
+        Future<T>& operator=(const Future<T>& other);
+
+        /**
+         * @return true if the future refers to a task
+         */
+        bool_t isValid() const;
+
+        /**
+         * @return true if the task has finished, successful or not
+         */
+        bool_t isReady() const;
+
+        /**
+         * Blocks until the task has finished
+         * @param timeoutMillis timeout, default value 0 waits forever
+         * @return CAPU_OK if the task finished successfully
+         *         CAPU_ETIMEOUT if the task did not finish in time
+         *         CAPU_EINVAL if the future is invalid
+         *         CAPU_ERROR if the task could not be executed because its pool was closed
+         *         the error of the previous task for continuations
+         */
+        status_t wait(const uint32_t timeoutMillis = 0);
+
+        /**
+         * Blocks until the task has finished and returns its result.
+         * The future must be valid. If the task failed a default constructed value is returned.
+         * @return the result of the task
+         */
+        const T& get();
+
+        /**
+         * Schedules a continuation on the given pool which receives the result of this
+         * future once it is available. No thread is blocked while waiting for the result.
+         * If this future fails, the continuation is not called and the returned future
+         * reports the same error.
+         * @param pool the pool to run the continuation on
+         * @param continuation the continuation
+         * @return future for the result of the continuation, invalid if this future is invalid
+         */
+        template<typename R>
+        Future<R> then(ThreadPool& pool, SmartPointer<Continuation<T, R> > continuation);
+
+    private:
+        template<typename X>
+        friend Future<status_t> whenAll(Future<X> futures[], const uint_t count);
+
+        FutureState<T>* mState;
+    };
+
+    /**
+     * Creates a future which finishes once all given futures have finished.
+     * The waiting happens without blocking a thread.
+     * @param futures the futures to wait for, all must be valid
+     * @param count number of futures
+     * @return future whose value and status are CAPU_OK if all futures succeeded
+     *         or the first error reported otherwise
+     */
+    template<typename T>
+    Future<status_t> whenAll(Future<T> futures[], const uint_t count);
+
+    /*
+     * Implementation FutureState
+     */
+
+    template<typename T>
+    inline FutureState<T>::FutureState(ThreadPool* pool, const uint32_t dependencies)
+        : FutureTask(pool, dependencies)
+        , mValue()
+    {
+    }
+
+    template<typename T>
+    inline const T& FutureState<T>::getValue() const
+    {
+        return mValue;
+    }
+
+    /*
+     * Tasks created by ThreadPool::submit, Future::then and whenAll
+     */
+
+    template<typename T>
+    class CallableTask : public FutureState<T>
+    {
+    public:
+        CallableTask(SmartPointer<Callable<T> > callable)
+            : FutureState<T>(0, 0)
+            , mCallable(callable)
+        {
+        }
+
+    protected:
+        status_t execute(const status_t)
+        {
+            FutureState<T>::mValue = mCallable->call();
+            return CAPU_OK;
+        }
+
+    private:
+        SmartPointer<Callable<T> > mCallable;
+    };
+
+    template<typename T, typename R>
+    class ContinuationTask : public FutureState<R>
+    {
+    public:
+        ContinuationTask(ThreadPool& pool, const Future<T>& previous, SmartPointer<Continuation<T, R> > continuation)
+            : FutureState<R>(&pool, 1)
+            , mPrevious(previous)
+            , mContinuation(continuation)
+        {
+            mDependency.task = this;
+            mDependency.next = 0;
+        }
+
+        FutureTask::Dependency& getDependency()
+        {
+            return mDependency;
+        }
+
+    protected:
+        status_t execute(const status_t dependencyStatus)
+        {
+            if (dependencyStatus == CAPU_OK)
+            {
+                FutureState<R>::mValue = mContinuation->call(mPrevious.get());
+            }
+            // release the previous result as early as possible
+            mPrevious = Future<T>();
+            return dependencyStatus;
+        }
+
+    private:
+        Future<T> mPrevious;
+        SmartPointer<Continuation<T, R> > mContinuation;
+        FutureTask::Dependency mDependency;
+    };
+
+    class WhenAllTask : public FutureState<status_t>
+    {
+    public:
+        WhenAllTask(const uint_t count)
+            : FutureState<status_t>(0, static_cast<uint32_t>(count))
+            , mDependencies(count)
+        {
+            for (uint_t i = 0; i < count; ++i)
+            {
+                mDependencies[i].task = this;
+                mDependencies[i].next = 0;
+            }
+        }
+
+        FutureTask::Dependency& getDependency(const uint_t index)
+        {
+            return mDependencies[index];
+        }
+
+    protected:
+        status_t execute(const status_t dependencyStatus)
+        {
+            mValue = dependencyStatus;
+            return dependencyStatus;
+        }
+
+    private:
+        Array<FutureTask::Dependency> mDependencies;
+    };
+
+    /*
+     * Implementation Future
+     */
+
+    template<typename T>
+    inline Future<T>::Future()
+        : mState(0)
+    {
+    }
+
+    template<typename T>
+    inline Future<T>::Future(FutureState<T>* state)
+        : mState(state)
+    {
+        if (mState)
+        {
+            mState->addReference();
+        }
+    }
+
+    template<typename T>
+    inline Future<T>::Future(const Future<T>& other)
+        : mState(other.mState)
+    {
+        if (mState)
+        {
+            mState->addReference();
+        }
+    }
+
+    template<typename T>
+    inline Future<T>::~Future()
+    {
+        if (mState)
+        {
+            mState->releaseReference();
+        }
+    }
+
+    template<typename T>
+    inline Future<T>& Future<T>::operator=(const Future<T>& other)
+    {
+        if (other.mState)
+        {
+            other.mState->addReference();
+        }
+        if (mState)
+        {
+            mState->releaseReference();
+        }
+        mState = other.mState;
+        return *this;
+    }
+
+    template<typename T>
+    inline bool_t Future<T>::isValid() const
+    {
+        return mState != 0;
+    }
+
+    template<typename T>
+    inline bool_t Future<T>::isReady() const
+    {
+        return mState && mState->isDone();
+    }
+
+    template<typename T>
+    inline status_t Future<T>::wait(const uint32_t timeoutMillis)
+    {
+        if (!mState)
+        {
+            return CAPU_EINVAL;
+        }
+        return mState->wait(timeoutMillis);
+    }
+
+    template<typename T>
+    inline const T& Future<T>::get()
+    {
+        mState->wait(0);
+        return mState->getValue();
+    }
+
+    template<typename T>
+    template<typename R>
+    inline Future<R> Future<T>::then(ThreadPool& pool, SmartPointer<Continuation<T, R> > continuation)
+    {
+        if (!mState)
+        {
+            return Future<R>();
+        }
+        ContinuationTask<T, R>* task = new ContinuationTask<T, R>(pool, *this, continuation);
+        Future<R> result(task);
+        mState->addDependent(task->getDependency());
+        return result;
+    }
+
+    template<typename T>
+    inline Future<status_t> whenAll(Future<T> futures[], const uint_t count)
+    {
+        WhenAllTask* task = new WhenAllTask(count);
+        Future<status_t> result(task);
+        if (count == 0)
+        {
+            task->run();
+        }
+        for (uint_t i = 0; i < count; ++i)
+        {
+            futures[i].mState->addDependent(task->getDependency(i));
+        }
+        return result;
+    }
+}
+
+#endif // CAPU_FUTURE_H
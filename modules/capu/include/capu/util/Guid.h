@@ -121,7 +121,6 @@ namespace capu
         generic_uuid_t m_id;
         mutable String m_stringRepresentation;
         mutable bool_t m_stringRepresentationIsInvalid;
-        static Random& getRandom();
     };
 
     inline Guid::Guid()
@@ -155,12 +154,6 @@ namespace capu
         return m_id;
     }
 
-    inline Random& Guid::getRandom()
-    {
-        static Random singletonInstance;
-        return singletonInstance;
-    }
-
     inline bool_t Guid::operator==(const Guid& other) const
     {
         return equals(other);
@@ -226,17 +219,9 @@ namespace capu
 
     inline void Guid::createNew()
     {
-        m_id.Data1 = getRandom().nextUInt32();
-        m_id.Data2 = getRandom().nextUInt16();
-        m_id.Data3 = 0x4000 | (getRandom().nextUInt16() & 0x00FF); // a guid V4 starts with 0x0100 in data3
-        m_id.Data4[0] = getRandom().nextUInt8();
-        m_id.Data4[1] = getRandom().nextUInt8();
-        m_id.Data4[2] = getRandom().nextUInt8();
-        m_id.Data4[3] = getRandom().nextUInt8();
-        m_id.Data4[4] = getRandom().nextUInt8();
-        m_id.Data4[5] = getRandom().nextUInt8();
-        m_id.Data4[6] = getRandom().nextUInt8();
-        m_id.Data4[7] = getRandom().nextUInt8();
+        // draw all 16 bytes at once from the generator of the calling thread
+        Random::FillThreadLocal(&m_id, sizeof(generic_uuid_t));
+        m_id.Data3 = 0x4000 | (m_id.Data3 & 0x00FF); // a guid V4 starts with 0x0100 in data3
     }
 
     inline Guid& Guid::parse(const String& guid)
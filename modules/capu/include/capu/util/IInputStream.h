@@ -49,6 +49,20 @@ namespace capu
          */
         virtual IInputStream& operator>>(uint32_t& value) = 0;
 
+        /**
+         * Reads an int64_t value from the stream
+         * @param value the destination of the read value
+         * @return a reference to the input stream for further processing
+         */
+        virtual IInputStream& operator>>(int64_t& value) = 0;
+
+        /**
+         * Reads an uint64_t value from the stream
+         * @param value the destination of the read value
+         * @return a reference to the input stream for further processing
+         */
+        virtual IInputStream& operator>>(uint64_t& value) = 0;
+
         /**
          * Reads a String value from the stream
          * @param value the destination of the read value
@@ -70,6 +84,13 @@ namespace capu
          */
         virtual IInputStream& operator>>(float_t& value) = 0;
 
+        /**
+         * Reads a double_t value from the stream
+         * @param value the destination of the read value
+         * @return a reference to the input stream for further processing
+         */
+        virtual IInputStream& operator>>(double_t& value) = 0;
+
         /**
          * Reads a uint16_t value from the stream
          * @param value the destination of the read value
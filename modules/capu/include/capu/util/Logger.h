@@ -21,24 +21,62 @@
 #include "capu/Config.h"
 #include "capu/container/String.h"
 #include "capu/os/StringUtils.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/os/Mutex.h"
 #include <stdarg.h>
 
 // Defines the max number of possible appenders
 #define LOGGER_APPENDER_MAX 10
 
+// Defines the max number of tags with an own logging level
+#define LOGGER_TAG_LEVEL_MAX 16
+
+// Numeric values of the logger levels for use in preprocessor conditions
+#define CAPU_LOG_LEVEL_TRACE 1
+#define CAPU_LOG_LEVEL_DEBUG 2
+#define CAPU_LOG_LEVEL_INFO  3
+#define CAPU_LOG_LEVEL_WARN  4
+#define CAPU_LOG_LEVEL_ERROR 5
+
+// Log statements below this level are removed at compile time
+#ifndef CAPU_LOG_MIN_LEVEL
+#define CAPU_LOG_MIN_LEVEL CAPU_LOG_LEVEL_TRACE
+#endif
+
 #if CAPU_LOGGING_ENABLED
-#define CAPU_LOG(logger, level, tag, format, ...) if(logger != NULL) logger->log(level, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
-#define CAPU_LOG_TRACE(logger, tag, format, ...) if(logger != NULL) logger->log(capu::CLL_TRACE, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
-#define CAPU_LOG_DEBUG(logger, tag, format, ...) if(logger != NULL) logger->log(capu::CLL_DEBUG, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
-#define CAPU_LOG_INFO(logger, tag, format, ...) if(logger != NULL) logger->log(capu::CLL_INFO, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
-#define CAPU_LOG_WARN(logger, tag, format, ...) if(logger != NULL) logger->log(capu::CLL_WARN, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
-#define CAPU_LOG_ERROR(logger, tag, format, ...) if(logger != NULL) logger->log(capu::CLL_ERROR, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
+// the arguments are only evaluated if the level is enabled for the tag
+#define CAPU_LOG(logger, level, tag, format, ...) if ((level) < CAPU_LOG_MIN_LEVEL || !(logger).isLevelEnabled(level, tag)) {} else (logger).log(level, tag, __FILE__, __LINE__, format, ##__VA_ARGS__)
 #else
 #define CAPU_LOG(logger, level, tag, format, ...)
+#endif
+
+#if CAPU_LOGGING_ENABLED && CAPU_LOG_MIN_LEVEL <= CAPU_LOG_LEVEL_TRACE
+#define CAPU_LOG_TRACE(logger, tag, format, ...) CAPU_LOG(logger, capu::CLL_TRACE, tag, format, ##__VA_ARGS__)
+#else
 #define CAPU_LOG_TRACE(logger, tag, format, ...)
+#endif
+
+#if CAPU_LOGGING_ENABLED && CAPU_LOG_MIN_LEVEL <= CAPU_LOG_LEVEL_DEBUG
+#define CAPU_LOG_DEBUG(logger, tag, format, ...) CAPU_LOG(logger, capu::CLL_DEBUG, tag, format, ##__VA_ARGS__)
+#else
 #define CAPU_LOG_DEBUG(logger, tag, format, ...)
+#endif
+
+#if CAPU_LOGGING_ENABLED && CAPU_LOG_MIN_LEVEL <= CAPU_LOG_LEVEL_INFO
+#define CAPU_LOG_INFO(logger, tag, format, ...) CAPU_LOG(logger, capu::CLL_INFO, tag, format, ##__VA_ARGS__)
+#else
 #define CAPU_LOG_INFO(logger, tag, format, ...)
+#endif
+
+#if CAPU_LOGGING_ENABLED && CAPU_LOG_MIN_LEVEL <= CAPU_LOG_LEVEL_WARN
+#define CAPU_LOG_WARN(logger, tag, format, ...) CAPU_LOG(logger, capu::CLL_WARN, tag, format, ##__VA_ARGS__)
+#else
 #define CAPU_LOG_WARN(logger, tag, format, ...)
+#endif
+
+#if CAPU_LOGGING_ENABLED && CAPU_LOG_MIN_LEVEL <= CAPU_LOG_LEVEL_ERROR
+#define CAPU_LOG_ERROR(logger, tag, format, ...) CAPU_LOG(logger, capu::CLL_ERROR, tag, format, ##__VA_ARGS__)
+#else
 #define CAPU_LOG_ERROR(logger, tag, format, ...)
 #endif
 
@@ -52,11 +90,11 @@ namespace capu
     enum LoggerLevel
     {
         CLL_INVALID,
-        CLL_TRACE,
-        CLL_DEBUG,
-        CLL_INFO,
-        CLL_WARN,
-        CLL_ERROR
+        CLL_TRACE = CAPU_LOG_LEVEL_TRACE,
+        CLL_DEBUG = CAPU_LOG_LEVEL_DEBUG,
+        CLL_INFO = CAPU_LOG_LEVEL_INFO,
+        CLL_WARN = CAPU_LOG_LEVEL_WARN,
+        CLL_ERROR = CAPU_LOG_LEVEL_ERROR
     };
 
     /**
@@ -215,6 +253,37 @@ namespace capu
          */
         status_t open();
 
+        /**
+         * Sets the minimum level of messages which are passed to the appenders.
+         * Tags with an own level set by setTagLoggingLevel are not affected.
+         * @param level the minimum level, default is CLL_TRACE
+         */
+        void setLoggingLevel(const LoggerLevel level);
+
+        /**
+         * Sets the minimum level of messages with the given tag
+         * @param tag the tag
+         * @param level the minimum level for the tag, CLL_INVALID removes the tag specific level
+         * @return CAPU_ERROR if LOGGER_TAG_LEVEL_MAX tags already have an own level
+         */
+        status_t setTagLoggingLevel(const char_t* tag, const LoggerLevel level);
+
+        /**
+         * Checks whether a message would reach at least one appender. Called by the
+         * CAPU_LOG macros before any argument is evaluated. Rejecting a disabled level
+         * costs two atomic reads and no lock.
+         * @param level the level of the message
+         * @param tag the tag of the message
+         * @return true if the message should be formatted
+         */
+        bool_t isLevelEnabled(const LoggerLevel level, const char_t* tag) const;
+
+        /**
+         * Notifies all loggers that the logging level of an appender has changed.
+         * Called by Appender::setLoggingLevel.
+         */
+        static void AppenderLevelChanged();
+
         /**
          * print trace message to the logger.
          * @param tag that will be logged
@@ -288,10 +357,45 @@ namespace capu
          */
         status_t vlog(const LoggerLevel level, const char_t* tag, const char_t* file, const int32_t line, const char_t* msgFormat, va_list args);
 
+        /**
+         * Slow path of isLevelEnabled: tag lookup and refresh after appender changes
+         */
+        bool_t checkLevel(const LoggerLevel level, const char_t* tag) const;
+
+        /**
+         * Recalculates the threshold from the levels of the logger, its tags and its appenders.
+         * Must be called with mMutex locked.
+         */
+        void updateThreshold() const;
+
+        /**
+         * Counter which is incremented whenever the level of any appender changes
+         */
+        static volatile uint32_t& LevelGeneration();
+
+        struct TagLevel
+        {
+            String tag;
+            LoggerLevel level;
+        };
+
     private:
         int32_t mId;
         Appender* mAppenders[LOGGER_APPENDER_MAX];
         bool_t mOpen;
+        LoggerLevel mLevel;
+        TagLevel mTagLevels[LOGGER_TAG_LEVEL_MAX];
+        uint_t mTagLevelCount;
+
+        // guards the level, the tag levels and the updates of the threshold
+        mutable Mutex mMutex;
+
+        // level below which no message can reach an appender in the lower ThresholdLevelBits bits,
+        // the appender level generation it was calculated for in the upper bits. One word, so
+        // isLevelEnabled reads both with a single atomic operation.
+        mutable volatile uint32_t mThreshold;
+        static const uint32_t ThresholdLevelBits = 8;
+        static const uint32_t ThresholdLevelMask = (1u << ThresholdLevelBits) - 1;
     };
 
     /*
@@ -383,6 +487,23 @@ namespace capu
      * Implementation Logger
      */
 
+    inline volatile uint32_t& Logger::LevelGeneration()
+    {
+        static volatile uint32_t generation = 0;
+        return generation;
+    }
+
+    inline bool_t Logger::isLevelEnabled(const LoggerLevel level, const char_t* tag) const
+    {
+        const uint32_t threshold = AtomicOperation::AtomicAdd32(mThreshold, 0);
+        if (static_cast<uint32_t>(level) < (threshold & ThresholdLevelMask) &&
+            (threshold & ~ThresholdLevelMask) == AtomicOperation::AtomicAdd32(LevelGeneration(), 0) << ThresholdLevelBits)
+        {
+            return false;
+        }
+        return checkLevel(level, tag);
+    }
+
     inline status_t Logger::trace(const char_t* tag, const char_t* file, const int32_t line, const char_t* msgFormat, ...)
     {
         va_list args;
@@ -415,6 +536,7 @@ namespace capu
         va_list args;
         va_start(args, msgFormat);
         status_t status = vlog(CLL_WARN, tag, file, line, msgFormat, args);
+        va_end(args);
         return status;
     }
 
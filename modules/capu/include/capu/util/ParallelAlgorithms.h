@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_PARALLELALGORITHMS_H
+#define CAPU_PARALLELALGORITHMS_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Array.h"
+#include "capu/container/Deque.h"
+#include "capu/os/CondVar.h"
+#include "capu/os/Mutex.h"
+#include "capu/util/Runnable.h"
+#include "capu/util/ScopedLock.h"
+#include "capu/util/SmartPointer.h"
+#include "capu/util/ThreadPool.h"
+
+namespace capu
+{
+    /**
+     * Calls function(rangeBegin, rangeEnd) for disjoint subranges which together cover [begin, end).
+     * The range is split in halves until the pieces are not larger than the grain size,
+     * idle threads take the pieces which are not yet split. The calling thread takes part
+     * in the work and returns when every piece is done, so the function may refer to local data.
+     * Pool threads which start late find no work and return right away.
+     * @param pool the pool whose threads help with the loop
+     * @param begin first index
+     * @param end index after the last one
+     * @param grain maximum number of indices per call of function, 0 picks about eight pieces per thread
+     * @param function functor with operator()(uint_t rangeBegin, uint_t rangeEnd), called concurrently
+     */
+    template<typename F>
+    void parallelFor(ThreadPool& pool, const uint_t begin, const uint_t end, const uint_t grain, F& function);
+
+    /**
+     * Combines the results of function(rangeBegin, rangeEnd) for disjoint subranges of [begin, end)
+     * with reduction(first, second). The ranges are split and run like in parallelFor,
+     * the results are combined in the order in which the pieces finish, so the reduction
+     * has to be associative and commutative.
+     * @param pool the pool whose threads help with the loop
+     * @param begin first index
+     * @param end index after the last one
+     * @param grain maximum number of indices per call of function, 0 picks about eight pieces per thread
+     * @param identity result of an empty range
+     * @param function functor with T operator()(uint_t rangeBegin, uint_t rangeEnd), called concurrently
+     * @param reduction functor with T operator()(const T& first, const T& second)
+     * @return the combined result
+     */
+    template<typename T, typename F, typename R>
+    T parallelReduce(ThreadPool& pool, const uint_t begin, const uint_t end, const uint_t grain, const T& identity, F& function, R& reduction);
+
+    /**
+     * Sets output[i] = function(input[i]) for all elements on the threads of a pool.
+     * Input and output may be the same.
+     * @param pool the pool whose threads help with the loop
+     * @param input the elements to transform
+     * @param output receives the transformed elements
+     * @param count number of elements
+     * @param function functor with U operator()(const T& value), called concurrently
+     */
+    template<typename T, typename U, typename F>
+    void parallelTransform(ThreadPool& pool, const T* input, U* output, const uint_t count, F& function);
+
+    /**
+     * Transforms the elements of an array into another array on the threads of a pool.
+     * @return CAPU_ERANGE if the output array is smaller than the input array
+     *         CAPU_OK otherwise
+     */
+    template<typename T, typename TSTORAGE, typename U, typename USTORAGE, typename F>
+    status_t parallelTransform(ThreadPool& pool, const Array<T, TSTORAGE>& input, Array<U, USTORAGE>& output, F& function);
+
+    namespace internal
+    {
+        /**
+         * Pieces per thread when the grain size is picked automatically
+         */
+        static const uint_t ParallelPiecesPerThread = 8;
+
+        /**
+         * Shared state of one parallel loop. Pieces which still have to be split
+         * are kept in a queue, everybody who runs the loop takes from it.
+         */
+        template<typename F>
+        class ParallelLoop
+        {
+        public:
+            ParallelLoop(const uint_t begin, const uint_t end, const uint_t grain, F& function)
+                : mGrain(grain)
+                , mFunction(function)
+                , mPending(1)
+            {
+                mRanges.push_back(Range(begin, end));
+            }
+
+            /**
+             * Takes pieces until the whole range is done
+             */
+            void participate()
+            {
+                Range range;
+                while (take(range))
+                {
+                    // keep the first half and offer the second one to the others
+                    while (range.end - range.begin > mGrain)
+                    {
+                        const uint_t middle = range.begin + (range.end - range.begin) / 2;
+                        ScopedMutexLock lock(mMutex);
+                        mRanges.push_back(Range(middle, range.end));
+                        ++mPending;
+                        mChanged.signal();
+                        range.end = middle;
+                    }
+
+                    mFunction(range.begin, range.end);
+
+                    ScopedMutexLock lock(mMutex);
+                    if (--mPending == 0)
+                    {
+                        mChanged.broadcast();
+                    }
+                }
+            }
+
+        private:
+            struct Range
+            {
+                Range()
+                    : begin(0)
+                    , end(0)
+                {
+                }
+
+                Range(const uint_t rangeBegin, const uint_t rangeEnd)
+                    : begin(rangeBegin)
+                    , end(rangeEnd)
+                {
+                }
+
+                uint_t begin;
+                uint_t end;
+            };
+
+            bool_t take(Range& range)
+            {
+                ScopedMutexLock lock(mMutex);
+                while (mRanges.empty())
+                {
+                    if (mPending == 0)
+                    {
+                        return false;
+                    }
+                    // pieces are still running and may be split further
+                    mChanged.wait(&mMutex);
+                }
+                range = mRanges.front();
+                mRanges.pop_front();
+                return true;
+            }
+
+            const uint_t mGrain;
+            F& mFunction;
+            Mutex mMutex;
+            CondVar mChanged;
+            Deque<Range> mRanges;
+            uint_t mPending;
+        };
+
+        template<typename F>
+        class ParallelLoopRunnable : public Runnable
+        {
+        public:
+            ParallelLoopRunnable(const SmartPointer<ParallelLoop<F> >& loop)
+                : mLoop(loop)
+            {
+            }
+
+            void run()
+            {
+                mLoop->participate();
+            }
+
+        private:
+            SmartPointer<ParallelLoop<F> > mLoop;
+        };
+
+        template<typename T, typename F, typename R>
+        class ParallelReduceFunction
+        {
+        public:
+            ParallelReduceFunction(const T& identity, F& function, R& reduction)
+                : mResult(identity)
+                , mFunction(function)
+                , mReduction(reduction)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                const T partial = mFunction(begin, end);
+                ScopedMutexLock lock(mMutex);
+                mResult = mReduction(mResult, partial);
+            }
+
+            T mResult;
+
+        private:
+            F& mFunction;
+            R& mReduction;
+            Mutex mMutex;
+        };
+
+        template<typename T, typename U, typename F>
+        class ParallelTransformFunction
+        {
+        public:
+            ParallelTransformFunction(const T* input, U* output, F& function)
+                : mInput(input)
+                , mOutput(output)
+                , mFunction(function)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                for (uint_t i = begin; i < end; ++i)
+                {
+                    mOutput[i] = mFunction(mInput[i]);
+                }
+            }
+
+        private:
+            const T* mInput;
+            U* mOutput;
+            F& mFunction;
+        };
+    }
+
+    template<typename F>
+    void parallelFor(ThreadPool& pool, const uint_t begin, const uint_t end, const uint_t grain, F& function)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        const uint_t helpers = pool.isClosed() ? 0 : pool.getSize();
+        const uint_t count = end - begin;
+        uint_t pieceSize = grain;
+        if (pieceSize == 0)
+        {
+            pieceSize = count / ((helpers + 1) * internal::ParallelPiecesPerThread);
+            if (pieceSize == 0)
+            {
+                pieceSize = 1;
+            }
+        }
+        if (helpers == 0 || count <= pieceSize)
+        {
+            function(begin, end);
+            return;
+        }
+
+        SmartPointer<internal::ParallelLoop<F> > loop = new internal::ParallelLoop<F>(begin, end, pieceSize, function);
+        const uint_t pieces = (count - 1) / pieceSize + 1;
+        for (uint_t i = 0; i < helpers && i + 1 < pieces; ++i)
+        {
+            if (pool.add(new internal::ParallelLoopRunnable<F>(loop)) != CAPU_OK)
+            {
+                break;
+            }
+        }
+        loop->participate();
+    }
+
+    template<typename T, typename F, typename R>
+    T parallelReduce(ThreadPool& pool, const uint_t begin, const uint_t end, const uint_t grain, const T& identity, F& function, R& reduction)
+    {
+        internal::ParallelReduceFunction<T, F, R> reduceFunction(identity, function, reduction);
+        parallelFor(pool, begin, end, grain, reduceFunction);
+        return reduceFunction.mResult;
+    }
+
+    template<typename T, typename U, typename F>
+    inline void parallelTransform(ThreadPool& pool, const T* input, U* output, const uint_t count, F& function)
+    {
+        internal::ParallelTransformFunction<T, U, F> transformFunction(input, output, function);
+        parallelFor(pool, 0, count, 0, transformFunction);
+    }
+
+    template<typename T, typename TSTORAGE, typename U, typename USTORAGE, typename F>
+    inline status_t parallelTransform(ThreadPool& pool, const Array<T, TSTORAGE>& input, Array<U, USTORAGE>& output, F& function)
+    {
+        if (output.size() < input.size())
+        {
+            return CAPU_ERANGE;
+        }
+        parallelTransform(pool, input.getRawData(), output.getRawData(), input.size(), function);
+        return CAPU_OK;
+    }
+}
+
+#endif // CAPU_PARALLELALGORITHMS_H
@@ -19,9 +19,12 @@
 
 #include <capu/Config.h>
 #include <capu/os/Socket.h>
+#include <capu/os/Memory.h>
 #include <capu/container/String.h>
+#include <capu/container/Array.h>
 #include <capu/util/Guid.h>
 #include <capu/util/IInputStream.h>
+#include <capu/util/StreamEncoding.h>
 
 namespace capu
 {
@@ -34,9 +37,9 @@ namespace capu
 
         /**
          * Constructor of SocketInputStream
-         * @param socket to read data from
+         * @param encoding of integers and string lengths, must match the encoding of the sender
          */
-        SocketInputStream();
+        SocketInputStream(const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~SocketInputStream();
 
         /**
@@ -51,6 +54,24 @@ namespace capu
          */
         IInputStream& operator>>(int32_t& value);
 
+        /**
+         * Read an unsigned 64 bit integer from the stream
+         * @param value Reference to variable to store the value read
+         */
+        IInputStream& operator>>(uint64_t& value);
+
+        /**
+         * Read a signed 64 bit integer from the stream
+         * @param value Reference to variable to store the value read
+         */
+        IInputStream& operator>>(int64_t& value);
+
+        /**
+         * Read a double from the stream
+         * @param value Reference to variable to store the value read
+         */
+        IInputStream& operator>>(double_t& value);
+
         /**
          * Read a string from the stream
          * @param value Reference to variable to store the value read
@@ -98,6 +119,12 @@ namespace capu
          */
         void resetState();
 
+        /**
+         * Returns the encoding of integers in the stream
+         * @return the encoding of integers in the stream
+         */
+        StreamEncoding getEncoding() const;
+
     protected:
         /**
          * The state of the input stream
@@ -105,11 +132,34 @@ namespace capu
         status_t mState;
 
     private:
+        /**
+         * Encoding of integers
+         */
+        StreamEncoding mEncoding;
+
+        /**
+         * Receives the characters of strings, kept to avoid an allocation per string
+         */
+        Array<char_t> mStringBuffer;
+
+        /**
+         * Reads a varint byte by byte. Small values need a single read
+         * like a fixed size value, but not more.
+         * @param value Reference to variable to store the value read
+         */
+        void readVarInt(uint64_t& value);
+
+        /**
+         * Reads 8 bytes in network byte order
+         * @param value Reference to variable to store the value read
+         */
+        void readNetworkOrder(uint64_t& value);
     };
 
     inline
-    SocketInputStream::SocketInputStream()
+    SocketInputStream::SocketInputStream(const StreamEncoding encoding)
         : mState(CAPU_OK)
+        , mEncoding(encoding)
     {
     }
 
@@ -118,10 +168,47 @@ namespace capu
     {
     }
 
+    inline
+    void
+    SocketInputStream::readVarInt(uint64_t& value)
+    {
+        value = 0;
+        uint8_t byte = 0x80;
+        for (uint32_t shift = 0; (byte & 0x80) && shift < 7 * VarInt::MAX_LENGTH_64; shift += 7)
+        {
+            read(reinterpret_cast<char_t*>(&byte), 1);
+            if (mState != CAPU_OK)
+            {
+                return;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        }
+    }
+
+    inline
+    void
+    SocketInputStream::readNetworkOrder(uint64_t& value)
+    {
+        uint8_t networkOrder[sizeof(uint64_t)];
+        read(reinterpret_cast<char_t*>(networkOrder), sizeof(uint64_t));
+        value = 0;
+        for (uint32_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            value = (value << 8) | networkOrder[i];
+        }
+    }
+
     inline
     IInputStream&
     SocketInputStream::operator>>(int32_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded = 0;
+            readVarInt(encoded);
+            value = VarInt::UnZigZag(static_cast<uint32_t>(encoded));
+            return *this;
+        }
         read(reinterpret_cast<char_t*>(&value), sizeof(int32_t));
         value = ntohl(value);
         return *this;
@@ -131,12 +218,58 @@ namespace capu
     IInputStream&
     SocketInputStream::operator>>(uint32_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded = 0;
+            readVarInt(encoded);
+            value = static_cast<uint32_t>(encoded);
+            return *this;
+        }
         int32_t tmp;
         operator>>(tmp);
         value = static_cast<uint32_t>(tmp);
         return *this;
     }
 
+    inline
+    IInputStream&
+    SocketInputStream::operator>>(int64_t& value)
+    {
+        uint64_t encoded = 0;
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarInt(encoded);
+            value = VarInt::UnZigZag(encoded);
+            return *this;
+        }
+        readNetworkOrder(encoded);
+        value = static_cast<int64_t>(encoded);
+        return *this;
+    }
+
+    inline
+    IInputStream&
+    SocketInputStream::operator>>(uint64_t& value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarInt(value);
+            return *this;
+        }
+        readNetworkOrder(value);
+        return *this;
+    }
+
+    inline
+    IInputStream&
+    SocketInputStream::operator>>(double_t& value)
+    {
+        uint64_t bits = 0;
+        readNetworkOrder(bits);
+        Memory::Copy(&value, &bits, sizeof(double_t));
+        return *this;
+    }
+
     inline
     IInputStream&
     SocketInputStream::operator>>(bool_t& value)
@@ -148,11 +281,11 @@ namespace capu
     IInputStream&
     SocketInputStream::operator>>(float_t& value)
     {
-        uint32_t tmpValue = 0;
-
-        operator>>(tmpValue);
-        value = *reinterpret_cast<float_t*>(&tmpValue);
-
+        // floats have their full size in every encoding
+        uint32_t bits = 0;
+        read(reinterpret_cast<char_t*>(&bits), sizeof(uint32_t));
+        bits = ntohl(bits);
+        Memory::Copy(&value, &bits, sizeof(float_t));
         return *this;
     }
 
@@ -160,6 +293,13 @@ namespace capu
     IInputStream&
     SocketInputStream::operator>>(uint16_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded = 0;
+            readVarInt(encoded);
+            value = static_cast<uint16_t>(encoded);
+            return *this;
+        }
         read(reinterpret_cast<char_t*>(&value), sizeof(uint16_t));
         value = ntohs(value);
         return *this;
@@ -182,6 +322,13 @@ namespace capu
         mState = CAPU_OK;
     }
 
+    inline
+    StreamEncoding
+    SocketInputStream::getEncoding() const
+    {
+        return mEncoding;
+    }
+
     inline
     status_t
     SocketInputStream::getState() const
@@ -22,20 +22,23 @@
 #include <capu/os/StringUtils.h>
 #include <capu/os/Memory.h>
 #include <capu/util/Guid.h>
+#include <capu/util/StreamEncoding.h>
 
 namespace capu
 {
-    /* The SocketOutputStream writes data to a given socket*/
+    /* The SocketOutputStream writes data to a given socket.
+     * Integers are written in network byte order or as varints with STREAM_ENCODING_VARINT.
+     * Floating point values always take their full size in network byte order. */
     template<uint16_t SNDBUFSIZE = 1450>
     class SocketOutputStream: public IOutputStream
     {
     public:
 
         /**
-         * Constructor with socket to write to
-         * @param socket to write to
+         * Constructor
+         * @param encoding of integers and string lengths
          */
-        SocketOutputStream();
+        SocketOutputStream(const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         virtual ~SocketOutputStream();
 
         /**
@@ -50,6 +53,24 @@ namespace capu
          */
         IOutputStream& operator<<(const uint32_t value);
 
+        /**
+         * Write a 64 bit integer to the stream
+         * @param value Value to write to the stream
+         */
+        IOutputStream& operator<<(const int64_t value);
+
+        /**
+         * Write an unsigned 64 bit integer to the stream
+         * @param value Value to write to the stream
+         */
+        IOutputStream& operator<<(const uint64_t value);
+
+        /**
+         * Write a double to the stream
+         * @param value Value to write to the stream
+         */
+        IOutputStream& operator<<(const double_t value);
+
         /**
          * Write a string to the stream
          * @param value Value to write to the stream
@@ -109,6 +130,12 @@ namespace capu
          */
         void resetState();
 
+        /**
+         * Returns the encoding of integers in the stream
+         * @return the encoding of integers in the stream
+         */
+        StreamEncoding getEncoding() const;
+
     protected:
         virtual status_t writeToSocket(const char_t* buffer, const uint32_t size, int32_t&  numBytes) = 0;
 
@@ -119,16 +146,19 @@ namespace capu
         char_t   mBuffer[SNDBUFSIZE];
         uint16_t mBufferSize;
         status_t m_state;
+        StreamEncoding mEncoding;
 
+        IOutputStream& writeVarInt(const uint64_t value);
         void writeToInternalBuffer(const void* data, const uint32_t size);
         void internalSend(const char_t* data, const uint32_t size);
     };
 
     template<uint16_t SNDBUFSIZE>
     inline
-    SocketOutputStream<SNDBUFSIZE>::SocketOutputStream()
+    SocketOutputStream<SNDBUFSIZE>::SocketOutputStream(const StreamEncoding encoding)
         : mBufferSize(0)
         , m_state(CAPU_OK)
+        , mEncoding(encoding)
     {
     }
     template<uint16_t SNDBUFSIZE>
@@ -145,16 +175,35 @@ namespace capu
         return m_state;
     }
 
+    template<uint16_t SNDBUFSIZE>
+    inline
+    StreamEncoding SocketOutputStream<SNDBUFSIZE>::getEncoding() const
+    {
+        return mEncoding;
+    }
+
     template<uint16_t SNDBUFSIZE>
     inline
     SocketOutputStream<SNDBUFSIZE>::~SocketOutputStream()
     {
     }
 
+    template<uint16_t SNDBUFSIZE>
+    inline
+    IOutputStream& SocketOutputStream<SNDBUFSIZE>::writeVarInt(const uint64_t value)
+    {
+        char_t buffer[VarInt::MAX_LENGTH_64];
+        return write(buffer, VarInt::Encode(value, buffer));
+    }
+
     template<uint16_t SNDBUFSIZE>
     inline
     IOutputStream& SocketOutputStream<SNDBUFSIZE>::operator<<(const int32_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(VarInt::ZigZag(value));
+        }
         const int32_t networkOrder = htonl(value);
         return write(&networkOrder, sizeof(int32_t));
     }
@@ -164,9 +213,60 @@ namespace capu
     IOutputStream&
     SocketOutputStream<SNDBUFSIZE>::operator<<(const uint32_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
         return operator<<(static_cast<int32_t>(value));
     }
 
+    template<uint16_t SNDBUFSIZE>
+    inline
+    IOutputStream&
+    SocketOutputStream<SNDBUFSIZE>::operator<<(const int64_t value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(VarInt::ZigZag(value));
+        }
+        return operator<<(static_cast<uint64_t>(value));
+    }
+
+    template<uint16_t SNDBUFSIZE>
+    inline
+    IOutputStream&
+    SocketOutputStream<SNDBUFSIZE>::operator<<(const uint64_t value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
+
+        // network byte order, most significant byte first
+        uint8_t networkOrder[sizeof(uint64_t)];
+        for (uint32_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            networkOrder[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+        }
+        return write(networkOrder, sizeof(uint64_t));
+    }
+
+    template<uint16_t SNDBUFSIZE>
+    inline
+    IOutputStream&
+    SocketOutputStream<SNDBUFSIZE>::operator<<(const double_t value)
+    {
+        // doubles are always written with their full size, independent of the encoding
+        uint8_t networkOrder[sizeof(double_t)];
+        uint64_t bits;
+        Memory::Copy(&bits, &value, sizeof(double_t));
+        for (uint32_t i = 0; i < sizeof(double_t); ++i)
+        {
+            networkOrder[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+        }
+        return write(networkOrder, sizeof(double_t));
+    }
+
     template<uint16_t SNDBUFSIZE>
     inline
     IOutputStream&
@@ -182,7 +282,7 @@ namespace capu
     IOutputStream&
     SocketOutputStream<SNDBUFSIZE>::operator<<(const char_t* value)
     {
-        const int32_t length = static_cast<uint32_t>(StringUtils::Strlen(value));
+        const uint32_t length = static_cast<uint32_t>(StringUtils::Strlen(value));
         operator<<(length);
         return write(value, length);
     }
@@ -191,6 +291,10 @@ namespace capu
     IOutputStream&
     SocketOutputStream<SNDBUFSIZE>::operator<<(const uint16_t value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarInt(value);
+        }
         const int16_t networkOrder = htons(value);
         return write(&networkOrder, sizeof(int16_t));
     }
@@ -208,11 +312,11 @@ namespace capu
     IOutputStream&
     SocketOutputStream<SNDBUFSIZE>::operator<<(const float_t value)
     {
-        float_t val = value;
-
-        // we assume that a float is 4 bytes long (=uint32_t)
-        const uint32_t converted = *reinterpret_cast<uint32_t*>(&val);
-        return operator<<(converted);
+        // floats are always written with their full size, independent of the encoding
+        uint32_t bits;
+        Memory::Copy(&bits, &value, sizeof(float_t));
+        const uint32_t networkOrder = htonl(bits);
+        return write(&networkOrder, sizeof(uint32_t));
     }
 
     template<uint16_t SNDBUFSIZE>
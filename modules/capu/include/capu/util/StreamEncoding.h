@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_STREAMENCODING_H
+#define CAPU_STREAMENCODING_H
+
+#include "capu/Config.h"
+
+namespace capu
+{
+    /**
+     * Encodings of integers in binary streams
+     */
+    enum StreamEncoding
+    {
+        STREAM_ENCODING_FIXED,  // integers take their full size, the default
+        STREAM_ENCODING_VARINT  // integers and string lengths are LEB128 varints, signed values are zigzag encoded
+    };
+
+    /**
+     * LEB128 variable length encoding of integers. Each byte carries 7 bits of the
+     * value, least significant first, and the high bit marks that another byte follows.
+     * Values below 128 take one byte. Signed values are zigzag encoded first, so
+     * small negative values stay small as well.
+     */
+    class VarInt
+    {
+    public:
+        /**
+         * Maximum encoded length of a 32 bit value
+         */
+        static const uint32_t MAX_LENGTH_32 = 5;
+
+        /**
+         * Maximum encoded length of a 64 bit value
+         */
+        static const uint32_t MAX_LENGTH_64 = 10;
+
+        /**
+         * Maps signed values to unsigned ones: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+         */
+        static uint32_t ZigZag(const int32_t value);
+        static uint64_t ZigZag(const int64_t value);
+
+        /**
+         * Inverse of ZigZag
+         */
+        static int32_t UnZigZag(const uint32_t value);
+        static int64_t UnZigZag(const uint64_t value);
+
+        /**
+         * Returns the number of bytes of the encoded value
+         */
+        static uint32_t GetLength(const uint64_t value);
+
+        /**
+         * Encodes a value
+         * @param value the value to encode
+         * @param output buffer for at least MAX_LENGTH_64 bytes
+         * @return the number of bytes written
+         */
+        static uint32_t Encode(uint64_t value, char_t* output);
+
+        /**
+         * Decodes a value. Reads at most MAX_LENGTH_64 bytes, even if the input is malformed.
+         * @param input the encoded value
+         * @param value the decoded value
+         * @return the number of bytes read
+         */
+        static uint32_t Decode(const char_t* input, uint64_t& value);
+    };
+
+    inline uint32_t VarInt::ZigZag(const int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    inline uint64_t VarInt::ZigZag(const int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int32_t VarInt::UnZigZag(const uint32_t value)
+    {
+        return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1u)));
+    }
+
+    inline int64_t VarInt::UnZigZag(const uint64_t value)
+    {
+        return static_cast<int64_t>((value >> 1) ^ (static_cast<uint64_t>(0) - (value & 1u)));
+    }
+
+    inline uint32_t VarInt::GetLength(const uint64_t value)
+    {
+        uint32_t length = 1;
+        for (uint64_t rest = value >> 7; rest != 0; rest >>= 7)
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    inline uint32_t VarInt::Encode(uint64_t value, char_t* output)
+    {
+        uint8_t* current = reinterpret_cast<uint8_t*>(output);
+        while (value >= 0x80)
+        {
+            *current++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *current++ = static_cast<uint8_t>(value);
+        return static_cast<uint32_t>(current - reinterpret_cast<uint8_t*>(output));
+    }
+
+    inline uint32_t VarInt::Decode(const char_t* input, uint64_t& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(input);
+
+        // most values fit into one byte, keep that path free of loops
+        uint64_t result = bytes[0];
+        if (result < 0x80)
+        {
+            value = result;
+            return 1;
+        }
+
+        result &= 0x7f;
+        uint32_t length = 1;
+        uint8_t byte;
+        do
+        {
+            byte = bytes[length];
+            result |= static_cast<uint64_t>(byte & 0x7f) << (7 * length);
+            ++length;
+        }
+        while ((byte & 0x80) && length < MAX_LENGTH_64);
+
+        value = result;
+        return length;
+    }
+}
+
+#endif // CAPU_STREAMENCODING_H
@@ -41,6 +41,9 @@ namespace capu
         virtual IOutputStream& operator<<(const float_t value);
         virtual IOutputStream& operator<<(const int32_t value);
         virtual IOutputStream& operator<<(const uint32_t value);
+        virtual IOutputStream& operator<<(const int64_t value);
+        virtual IOutputStream& operator<<(const uint64_t value);
+        virtual IOutputStream& operator<<(const double_t value);
         virtual IOutputStream& operator<<(const String& value);
         virtual IOutputStream& operator<<(const bool_t  value);
         virtual IOutputStream& operator<<(const char_t* value);
@@ -89,6 +92,13 @@ namespace capu
          * @param size to request on the stream
          */
         void requestSize(const uint32_t size);
+
+        /**
+         * Writes the decimal digits of a 64 bit value
+         * @param value to write
+         * @param negative if a minus sign is written in front of the value
+         */
+        IOutputStream& writeDecimal(uint64_t value, const bool_t negative);
     };
 
     inline
@@ -132,6 +142,32 @@ namespace capu
         return operator<<(buffer);
     }
 
+    inline
+    IOutputStream&
+    StringOutputStream::operator<<(const int64_t value)
+    {
+        // negate in unsigned arithmetic, which also works for the minimum value
+        const uint64_t magnitude = value < 0 ? static_cast<uint64_t>(0) - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        return writeDecimal(magnitude, value < 0);
+    }
+
+    inline
+    IOutputStream&
+    StringOutputStream::operator<<(const uint64_t value)
+    {
+        return writeDecimal(value, false);
+    }
+
+    inline
+    IOutputStream&
+    StringOutputStream::operator<<(const double_t value)
+    {
+        // large enough for the maximum double with six decimals
+        char_t buffer[320];
+        StringUtils::Sprintf(buffer, sizeof(buffer), "%f", value);
+        return operator<<(buffer);
+    }
+
     inline
     IOutputStream&
     StringOutputStream::operator<<(const String& value)
@@ -25,7 +25,7 @@ namespace capu
     class TcpSocketInputStream: public SocketInputStream
     {
     public:
-        TcpSocketInputStream(TcpSocket& socket);
+        TcpSocketInputStream(TcpSocket& socket, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~TcpSocketInputStream();
 
     protected:
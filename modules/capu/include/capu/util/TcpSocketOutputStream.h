@@ -27,7 +27,7 @@ namespace capu
     class TcpSocketOutputStream: public SocketOutputStream<SNDBUFSIZE>
     {
     public:
-        TcpSocketOutputStream(TcpSocket& socket);
+        TcpSocketOutputStream(TcpSocket& socket, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~TcpSocketOutputStream();
     protected:
 
@@ -38,8 +38,9 @@ namespace capu
 
     template<uint16_t SNDBUFSIZE>
     inline
-    TcpSocketOutputStream<SNDBUFSIZE>::TcpSocketOutputStream(TcpSocket& socket)
-        : m_socket(socket)
+    TcpSocketOutputStream<SNDBUFSIZE>::TcpSocketOutputStream(TcpSocket& socket, const StreamEncoding encoding)
+        : SocketOutputStream<SNDBUFSIZE>(encoding)
+        , m_socket(socket)
     {
     }
 
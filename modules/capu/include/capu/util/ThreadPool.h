@@ -18,16 +18,27 @@
 #define CAPU_THREADPOOL_H
 
 #include "capu/Config.h"
+#include "capu/container/Deque.h"
 #include "capu/container/List.h"
-#include "capu/container/Queue.h"
 #include "capu/os/CondVar.h"
 #include "capu/os/Mutex.h"
 #include "capu/os/Thread.h"
+#include "capu/util/Callable.h"
+#include "capu/util/Future.h"
 #include "capu/util/Runnable.h"
 #include "capu/util/SmartPointer.h"
 
 namespace capu
 {
+    /**
+     * Placement of the threads of a pool on the CPUs
+     */
+    enum ThreadPoolPinning
+    {
+        TPP_NONE,   ///< all workers share the CPU set and may migrate between its CPUs
+        TPP_PER_CPU ///< every worker is pinned to one CPU of the set, going round robin over the CPUs
+    };
+
     /**
      * Represents a set of threads that can be used to run Runnables.
      */
@@ -46,6 +57,17 @@ namespace capu
          */
         ThreadPool(const uint32_t size = 5);
 
+        /**
+         * creates a new threadpool instance with threads started with the given attributes.
+         * Pinning keeps the caches of a worker warm and its profile readable, e.g. one worker
+         * per core with size set to the count of Thread::GetAvailableCpus and TPP_PER_CPU.
+         * @param size amounts of threads.
+         * @param attributes for the threads. A name is a prefix, the workers are called
+         *        <name>-<index>. An empty CPU set means all CPUs available to the process.
+         * @param pinning how the threads are placed on the CPUs of the set
+         */
+        ThreadPool(const uint32_t size, const ThreadAttributes& attributes, const ThreadPoolPinning pinning = TPP_NONE);
+
         /**
          * destructor.
          */
@@ -57,6 +79,16 @@ namespace capu
          */
         status_t add(SmartPointer<Runnable> runnable);
 
+        /**
+         * Adds a callable to the threadpool and returns a future for its result.
+         * The result and the synchronization state are kept in a single allocation.
+         * @param callable The callable which should be executed by the threadpool
+         * @return future for the result. The future is invalid if callable is NULL,
+         *         it reports CAPU_ERROR if the pool is already closed.
+         */
+        template<typename T>
+        Future<T> submit(SmartPointer<Callable<T> > callable);
+
         /**
          * Waits until every thread has been terminated.
          * @param cancelThreads set the cancel flag on all workers before waiting
@@ -76,6 +108,32 @@ namespace capu
         uint_t getSize() const;
 
     private:
+        friend class FutureTask;
+
+        /**
+         * Work item of the pool, either a runnable or the task of a future
+         */
+        struct Job
+        {
+            Job();
+            Job(SmartPointer<Runnable> runnable);
+            Job(FutureTask* task);
+
+            SmartPointer<Runnable> mRunnable;
+            FutureTask* mTask;
+        };
+
+        /**
+         * Adds the task of a future to the queue. Also used for continuations
+         * which become ready while the pool finishes the remaining work on close.
+         * @return CAPU_ERROR if the pool is already closed
+         */
+        status_t enqueue(FutureTask& task);
+
+        /**
+         * Starts the workers, stops at the first one which could not be started
+         */
+        void createWorkers(const uint32_t size, const ThreadAttributes& attributes, const ThreadPoolPinning pinning);
 
         class PoolRunnable : public Runnable
         {
@@ -94,7 +152,7 @@ namespace capu
         class PoolWorker
         {
         public:
-            PoolWorker(ThreadPool& pool);
+            PoolWorker(ThreadPool& pool, const ThreadAttributes& attributes);
             ~PoolWorker();
             status_t join();
             void cancel();
@@ -112,11 +170,45 @@ namespace capu
 
         bool_t mClosed;
         bool_t mCloseRequested;
-        Queue<SmartPointer<Runnable> > mRunnableQueue;
+        Deque<Job> mJobQueue;
         CondVar mCV;
         Mutex mMutex;
         List<PoolWorkerPtr> mWorkerList;
     };
+
+    inline ThreadPool::Job::Job()
+        : mTask(NULL)
+    {
+    }
+
+    inline ThreadPool::Job::Job(SmartPointer<Runnable> runnable)
+        : mRunnable(runnable)
+        , mTask(NULL)
+    {
+    }
+
+    inline ThreadPool::Job::Job(FutureTask* task)
+        : mTask(task)
+    {
+    }
+
+    template<typename T>
+    inline Future<T> ThreadPool::submit(SmartPointer<Callable<T> > callable)
+    {
+        if (callable.get() == NULL)
+        {
+            return Future<T>();
+        }
+
+        CallableTask<T>* task = new CallableTask<T>(callable);
+        Future<T> future(task);
+        if (mClosed || mCloseRequested || enqueue(*task) != CAPU_OK)
+        {
+            // no adding to closed queue
+            task->abandon(CAPU_ERROR);
+        }
+        return future;
+    }
 }
 
 #endif // CAPU_THREADPOOL_H
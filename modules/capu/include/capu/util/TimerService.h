@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CAPU_TIMERSERVICE_H
+#define CAPU_TIMERSERVICE_H
+
+#include "capu/Config.h"
+#include "capu/Error.h"
+#include "capu/container/Vector.h"
+#include "capu/os/CondVar.h"
+#include "capu/os/Mutex.h"
+#include "capu/os/Thread.h"
+#include "capu/util/Runnable.h"
+#include "capu/util/SmartPointer.h"
+#include "capu/util/ThreadPool.h"
+
+namespace capu
+{
+    /**
+     * Runs Runnables after a delay, once or periodically.
+     * Timers are kept in a hierarchical timing wheel of five levels with 64 slots each,
+     * so scheduling and cancelling take constant time regardless of the number of
+     * pending timers. Expiration has a resolution of one tick and never happens early.
+     * Expired runnables run on the thread of the service, or are added to a ThreadPool
+     * if one is given, so long running work does not delay other timers.
+     */
+    class TimerService
+    {
+    public:
+        /**
+         * Identifies a scheduled timer
+         */
+        typedef uint64_t TimerId;
+
+        /**
+         * Id which never identifies a timer
+         */
+        static const TimerId InvalidTimerId;
+
+        /**
+         * Creates the service and starts its thread
+         * @param tickMillis resolution of the timers in milliseconds
+         * @param pool runs the expired runnables if given, the pool must outlive the service
+         */
+        TimerService(const uint32_t tickMillis = 1, ThreadPool* pool = 0);
+
+        /**
+         * Stops the service, pending timers are dropped
+         */
+        ~TimerService();
+
+        /**
+         * Runs a runnable once after a delay
+         * @param runnable the runnable to run
+         * @param delayMillis milliseconds until the runnable runs
+         * @param id receives the id to cancel the timer, may be NULL
+         * @return CAPU_EINVAL if runnable is NULL
+         *         CAPU_ERROR if the service is closed
+         *         CAPU_OK otherwise
+         */
+        status_t schedule(SmartPointer<Runnable> runnable, const uint32_t delayMillis, TimerId* id = 0);
+
+        /**
+         * Runs a runnable repeatedly at a fixed rate until the timer is cancelled.
+         * A run which is late does not shift the following ones.
+         * @param runnable the runnable to run
+         * @param delayMillis milliseconds until the first run
+         * @param periodMillis milliseconds between two runs, at least one tick
+         * @param id receives the id to cancel the timer, may be NULL
+         * @return CAPU_EINVAL if runnable is NULL
+         *         CAPU_ERROR if the service is closed
+         *         CAPU_OK otherwise
+         */
+        status_t schedulePeriodic(SmartPointer<Runnable> runnable, const uint32_t delayMillis, const uint32_t periodMillis, TimerId* id = 0);
+
+        /**
+         * Cancels a timer. A run which has already started is not interrupted.
+         * @param id the id returned when the timer was scheduled
+         * @return CAPU_ERANGE if the timer has already expired, was cancelled or never existed
+         *         CAPU_OK otherwise
+         */
+        status_t cancel(const TimerId id);
+
+        /**
+         * Returns the number of pending timers
+         */
+        uint_t count() const;
+
+        /**
+         * Stops the thread of the service and drops all pending timers.
+         * Runnables which already expired are still run.
+         */
+        status_t close();
+
+        /**
+         * Checks if the service is closed
+         */
+        bool_t isClosed() const;
+
+    private:
+        static const uint32_t SlotBits = 6;
+        static const uint32_t SlotsPerLevel = 1 << SlotBits;
+        static const uint32_t SlotMask = SlotsPerLevel - 1;
+        static const uint32_t Levels = 5;
+        static const uint32_t NoNode = 0xFFFFFFFFu;
+
+        struct TimerNode
+        {
+            TimerNode();
+
+            SmartPointer<Runnable> runnable;
+            uint64_t expiry;
+            uint64_t periodTicks;
+            uint32_t generation;
+            uint32_t next;
+            uint32_t previous;
+            uint32_t slot;
+        };
+
+        class TimerThread : public Runnable
+        {
+        public:
+            TimerThread(TimerService& service);
+            void run();
+
+        private:
+            TimerService& mService;
+        };
+
+        TimerService(const TimerService&);
+        TimerService& operator=(const TimerService&);
+
+        status_t add(SmartPointer<Runnable> runnable, const uint32_t delayMillis, const uint32_t periodMillis, TimerId* id);
+        void runTimers();
+        uint64_t elapsedTicks() const;
+        uint64_t toTicks(const uint32_t millis) const;
+        void advance(Vector<SmartPointer<Runnable> >& expired);
+        void cascade(const uint32_t level);
+        void place(const uint32_t index);
+        void link(const uint32_t index, const uint32_t slot);
+        void unlink(const uint32_t index);
+        uint32_t allocateNode();
+        void freeNode(const uint32_t index);
+
+        const uint32_t mTickMillis;
+        const uint64_t mStartMillis;
+        ThreadPool* mPool;
+        uint64_t mCurrentTick;
+        uint32_t mSlots[Levels * SlotsPerLevel];
+        Vector<TimerNode> mNodes;
+        uint32_t mFreeNode;
+        uint_t mCount;
+        bool_t mCloseRequested;
+        bool_t mClosed;
+        mutable Mutex mMutex;
+        CondVar mCondVar;
+        TimerThread mTimerThread;
+        Thread mThread;
+    };
+}
+
+#endif // CAPU_TIMERSERVICE_H
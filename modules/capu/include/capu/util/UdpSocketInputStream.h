@@ -20,6 +20,7 @@
 #include <capu/util/SocketInputStream.h>
 #include <capu/os/UdpSocket.h>
 #include <capu/util/BinaryInputStream.h>
+#include <capu/container/StringView.h>
 
 namespace capu
 {
@@ -27,7 +28,22 @@ namespace capu
     class UdpSocketInputStream: public SocketInputStream
     {
     public:
-        UdpSocketInputStream(UdpSocket& socket);
+        UdpSocketInputStream(UdpSocket& socket, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
+
+        using SocketInputStream::operator>>;
+
+        /**
+         * Read a string from the received datagram
+         * @param value Reference to variable to store the value read
+         */
+        IInputStream& operator>>(String& value);
+
+        /**
+         * Read a string from the received datagram without copying it. The view
+         * points into the receive buffer and is valid until the next datagram is received.
+         * @param value Reference to variable to store the value read
+         */
+        UdpSocketInputStream& operator>>(StringView& value);
 
         IInputStream& read(char_t* data, const uint32_t size);
 
@@ -41,7 +57,7 @@ namespace capu
         char_t*        m_currentPosition;
         char_t         m_receiveBuffer[RCVBUFSIZE];
 
-        void readDataFromInternalBuffer(char_t* data, const uint32_t size);
+        const char_t* readInPlace(const uint32_t size);
     };
 
     template<uint16_t RCVBUFSIZE>
@@ -53,8 +69,9 @@ namespace capu
     }
 
     template<uint16_t RCVBUFSIZE>
-    UdpSocketInputStream<RCVBUFSIZE>::UdpSocketInputStream(UdpSocket& socket)
-        : m_socket(socket)
+    UdpSocketInputStream<RCVBUFSIZE>::UdpSocketInputStream(UdpSocket& socket, const StreamEncoding encoding)
+        : SocketInputStream(encoding)
+        , m_socket(socket)
         , m_currentLeftDataSize(0)
         , m_currentPosition(m_receiveBuffer)
     {
@@ -64,11 +81,54 @@ namespace capu
     template<uint16_t RCVBUFSIZE>
     IInputStream& UdpSocketInputStream<RCVBUFSIZE>::read(char_t* data, const uint32_t size)
     {
-        if (size <= m_currentLeftDataSize)
+        const char_t* source = readInPlace(size);
+        if (source)
         {
-            readDataFromInternalBuffer(data, size);
+            Memory::Copy(data, source, size);
         }
-        else
+        return *this;
+    }
+
+    template<uint16_t RCVBUFSIZE>
+    IInputStream& UdpSocketInputStream<RCVBUFSIZE>::operator>>(String& value)
+    {
+        uint32_t length = 0;
+        operator>>(length);
+        if (mState != CAPU_OK)
+        {
+            return *this;
+        }
+
+        const char_t* source = readInPlace(length);
+        if (source)
+        {
+            value.assign(source, length);
+        }
+        return *this;
+    }
+
+    template<uint16_t RCVBUFSIZE>
+    UdpSocketInputStream<RCVBUFSIZE>& UdpSocketInputStream<RCVBUFSIZE>::operator>>(StringView& value)
+    {
+        uint32_t length = 0;
+        operator>>(length);
+        if (mState != CAPU_OK)
+        {
+            return *this;
+        }
+
+        const char_t* source = readInPlace(length);
+        if (source)
+        {
+            value = StringView(source, length);
+        }
+        return *this;
+    }
+
+    template<uint16_t RCVBUFSIZE>
+    const char_t* UdpSocketInputStream<RCVBUFSIZE>::readInPlace(const uint32_t size)
+    {
+        if (size > m_currentLeftDataSize)
         {
             int32_t numBytes = 0;
             uint32_t receivedBytes = 0;
@@ -86,22 +146,16 @@ namespace capu
             m_currentLeftDataSize = receivedBytes;
             m_currentPosition = m_receiveBuffer;
 
-            if (mState == CAPU_OK)
+            if (mState != CAPU_OK)
             {
-                readDataFromInternalBuffer(data, size);
+                return 0;
             }
         }
-        return *this;
-    }
 
-    template<uint16_t RCVBUFSIZE>
-    inline
-    void
-    UdpSocketInputStream<RCVBUFSIZE>::readDataFromInternalBuffer(char_t* data, const uint32_t size)
-    {
-        Memory::Copy(data, m_currentPosition, size);
+        const char_t* data = m_currentPosition;
         m_currentPosition += size;
         m_currentLeftDataSize -= size;
+        return data;
     }
 
 }
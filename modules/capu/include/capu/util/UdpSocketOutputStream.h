@@ -26,7 +26,7 @@ namespace capu
     class UdpSocketOutputStream: public SocketOutputStream<SNDBUFSIZE>
     {
     public:
-        UdpSocketOutputStream(UdpSocket& socket, const String& ip, const uint16_t port);
+        UdpSocketOutputStream(UdpSocket& socket, const String& ip, const uint16_t port, const StreamEncoding encoding = STREAM_ENCODING_FIXED);
         ~UdpSocketOutputStream();
 
         SocketAddrInfo& getAddrInfo();
@@ -41,8 +41,9 @@ namespace capu
 
     template<uint16_t SNDBUFSIZE>
     inline
-    UdpSocketOutputStream<SNDBUFSIZE>::UdpSocketOutputStream(UdpSocket& socket, const String& ip, const uint16_t port)
-        : m_socket(socket)
+    UdpSocketOutputStream<SNDBUFSIZE>::UdpSocketOutputStream(UdpSocket& socket, const String& ip, const uint16_t port, const StreamEncoding encoding)
+        : SocketOutputStream<SNDBUFSIZE>(encoding)
+        , m_socket(socket)
     {
         m_addrInfo.addr = ip;
         m_addrInfo.port = port;
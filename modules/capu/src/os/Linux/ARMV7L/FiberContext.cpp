@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "capu/os/FiberContext.h"
+
+#if CAPU_FIBER_VFP_WORDS > 0
+#define CAPU_FIBER_PUSH_VFP "    vpush {d8-d15}\n"
+#define CAPU_FIBER_POP_VFP "    vpop {d8-d15}\n"
+#else
+#define CAPU_FIBER_PUSH_VFP
+#define CAPU_FIBER_POP_VFP
+#endif
+
+// void capu_fiber_switch_armv7l(void** fromStackPointer, void* toStackPointer)
+//
+// Pushes the registers AAPCS requires a function to preserve, stores the stack pointer in
+// *fromStackPointer and pops the same frame from toStackPointer. Popping the saved lr into pc
+// continues wherever the target context called the switch, or in capu_fiber_start_armv7l for a
+// context that has not run yet. Assembled as ARM code, popping into pc switches back to Thumb
+// for callers compiled as Thumb.
+asm(
+    ".text\n"
+    ".syntax unified\n"
+    ".arm\n"
+    ".globl capu_fiber_switch_armv7l\n"
+    ".type capu_fiber_switch_armv7l, %function\n"
+    ".align 2\n"
+    "capu_fiber_switch_armv7l:\n"
+    "    push {r4-r11, lr}\n"
+    CAPU_FIBER_PUSH_VFP
+    "    str sp, [r0]\n"
+    "    mov sp, r1\n"
+    CAPU_FIBER_POP_VFP
+    "    pop {r4-r11, pc}\n"
+    ".size capu_fiber_switch_armv7l, .-capu_fiber_switch_armv7l\n"
+);
+
+// void capu_fiber_start_armv7l()
+//
+// First code a new fiber runs: calls entry(argument) as prepared by FiberContext::init. The entry
+// function never returns, a fiber ends by switching away.
+asm(
+    ".text\n"
+    ".syntax unified\n"
+    ".arm\n"
+    ".globl capu_fiber_start_armv7l\n"
+    ".type capu_fiber_start_armv7l, %function\n"
+    ".align 2\n"
+    "capu_fiber_start_armv7l:\n"
+    "    mov r0, r4\n"
+    "    blx r5\n"
+    "    bkpt #0\n"
+    ".size capu_fiber_start_armv7l, .-capu_fiber_start_armv7l\n"
+);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "capu/os/FiberContext.h"
+
+// void capu_fiber_switch_x86_64(void** fromStackPointer, void* toStackPointer)
+//
+// Pushes the registers the System V ABI requires a function to preserve together with the
+// floating point control words, stores the stack pointer in *fromStackPointer and pops the same
+// frame from toStackPointer. The final ret continues wherever the target context called the
+// switch, or in capu_fiber_start_x86_64 for a context that has not run yet.
+asm(
+    ".text\n"
+    ".globl capu_fiber_switch_x86_64\n"
+    ".type capu_fiber_switch_x86_64, @function\n"
+    ".align 16\n"
+    "capu_fiber_switch_x86_64:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size capu_fiber_switch_x86_64, .-capu_fiber_switch_x86_64\n"
+);
+
+// void capu_fiber_start_x86_64()
+//
+// First code a new fiber runs, entered by the ret above: calls entry(argument) as prepared by
+// FiberContext::init. The entry function never returns, a fiber ends by switching away.
+asm(
+    ".text\n"
+    ".globl capu_fiber_start_x86_64\n"
+    ".type capu_fiber_start_x86_64, @function\n"
+    ".align 16\n"
+    "capu_fiber_start_x86_64:\n"
+    "    movq %r12, %rdi\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+    ".size capu_fiber_start_x86_64, .-capu_fiber_start_x86_64\n"
+);
@@ -16,13 +16,27 @@
 
 #include <capu/util/BinaryInputStream.h>
 #include <capu/os/Memory.h>
+#include <capu/container/Array.h>
+#include <capu/os/NumericLimits.h>
 
 
 namespace capu
 {
-    BinaryInputStream::BinaryInputStream(const char_t* buffer)
+    BinaryInputStream::BinaryInputStream(const char_t* buffer, const StreamEncoding encoding)
         : mBuffer(buffer)
         , mCurrent(mBuffer)
+        , mEnd(0)
+        , mEncoding(encoding)
+        , mState(CAPU_OK)
+    {
+    }
+
+    BinaryInputStream::BinaryInputStream(const char_t* buffer, const uint32_t size, const StreamEncoding encoding)
+        : mBuffer(buffer)
+        , mCurrent(mBuffer)
+        , mEnd(mBuffer + size)
+        , mEncoding(encoding)
+        , mState(CAPU_OK)
     {
     }
 
@@ -32,29 +46,109 @@ namespace capu
 
     IInputStream& BinaryInputStream::operator>>(int32_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded;
+            if (readVarInt(encoded))
+            {
+                value = VarInt::UnZigZag(static_cast<uint32_t>(encoded));
+            }
+            return *this;
+        }
         read(reinterpret_cast<char_t*>(&value), sizeof(int32_t));
         return *this;
     }
 
     IInputStream& BinaryInputStream::operator>>(uint32_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded;
+            if (readVarInt(encoded))
+            {
+                value = static_cast<uint32_t>(encoded);
+            }
+            return *this;
+        }
         read(reinterpret_cast<char_t*>(&value), sizeof(uint32_t));
         return *this;
     }
 
+    IInputStream& BinaryInputStream::operator>>(int64_t& value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded;
+            if (readVarInt(encoded))
+            {
+                value = VarInt::UnZigZag(encoded);
+            }
+            return *this;
+        }
+        read(reinterpret_cast<char_t*>(&value), sizeof(int64_t));
+        return *this;
+    }
+
+    IInputStream& BinaryInputStream::operator>>(uint64_t& value)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded;
+            if (readVarInt(encoded))
+            {
+                value = encoded;
+            }
+            return *this;
+        }
+        read(reinterpret_cast<char_t*>(&value), sizeof(uint64_t));
+        return *this;
+    }
+
     IInputStream& BinaryInputStream::operator>>(String& value)
     {
         uint32_t length = 0;
         operator>>(length); // first read the length of the string
+        if (mState != CAPU_OK)
+        {
+            return *this;
+        }
 
-        char_t* buffer = new char_t[length + 1];
+        if (mBuffer)
+        {
+            // copy straight from the buffer, the string is the only allocation
+            if (checkAvailable(length))
+            {
+                value.assign(mCurrent, length);
+                mCurrent += length;
+            }
+            return *this;
+        }
 
-        read(buffer, length);
-        buffer[length] = 0; // terminate string
+        Array<char_t> buffer(length);
+        read(buffer.getRawData(), length);
+        value.assign(buffer.getRawData(), length);
+        return *this;
+    }
 
-        value = buffer;
+    BinaryInputStream& BinaryInputStream::operator>>(StringView& value)
+    {
+        uint32_t length = 0;
+        operator>>(length);
+        if (mState != CAPU_OK)
+        {
+            return *this;
+        }
 
-        delete[] buffer;
+        if (!mBuffer)
+        {
+            mState = CAPU_ENOT_SUPPORTED;
+            return *this;
+        }
+        if (checkAvailable(length))
+        {
+            value = StringView(mCurrent, length);
+            mCurrent += length;
+        }
         return *this;
     }
 
@@ -70,8 +164,23 @@ namespace capu
         return *this;
     }
 
+    IInputStream& BinaryInputStream::operator>>(double_t& value)
+    {
+        read(reinterpret_cast<char_t*>(&value), sizeof(double_t));
+        return *this;
+    }
+
     IInputStream& BinaryInputStream::operator>>(uint16_t& value)
     {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            uint64_t encoded;
+            if (readVarInt(encoded))
+            {
+                value = static_cast<uint16_t>(encoded);
+            }
+            return *this;
+        }
         read(reinterpret_cast<char_t*>(&value), sizeof(uint16_t));
         return *this;
     }
@@ -80,19 +189,138 @@ namespace capu
     {
         generic_uuid_t fromStream;
         read(reinterpret_cast<char_t*>(&fromStream), sizeof(generic_uuid_t));
-        value = fromStream;
+        if (mState == CAPU_OK)
+        {
+            value = fromStream;
+        }
         return *this;
     }
 
     IInputStream& BinaryInputStream::read(char_t* buffer, const uint32_t size)
     {
-        Memory::Copy(buffer, mCurrent, size);
-        mCurrent += size;
+        if (checkAvailable(size))
+        {
+            Memory::Copy(buffer, mCurrent, size);
+            mCurrent += size;
+        }
         return *this;
     }
 
+    bool_t BinaryInputStream::readVarIntNearEnd(uint64_t& value)
+    {
+        const char_t* current = mCurrent;
+        uint64_t result = 0;
+        for (uint32_t shift = 0; current != mEnd; shift += 7)
+        {
+            const uint8_t byte = static_cast<uint8_t>(*current++);
+            result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                value = result;
+                mCurrent = current;
+                return true;
+            }
+        }
+
+        // the varint is cut off by the end of the buffer
+        mCurrent = mEnd;
+        mState = CAPU_EOF;
+        return false;
+    }
+
+    namespace
+    {
+        // inverse of the unsigned representation in the varint encoding
+        inline void FromVarIntValue(const uint64_t encoded, int32_t& value)
+        {
+            value = VarInt::UnZigZag(static_cast<uint32_t>(encoded));
+        }
+
+        inline void FromVarIntValue(const uint64_t encoded, int64_t& value)
+        {
+            value = VarInt::UnZigZag(encoded);
+        }
+
+        inline void FromVarIntValue(const uint64_t encoded, uint32_t& value)
+        {
+            value = static_cast<uint32_t>(encoded);
+        }
+
+        inline void FromVarIntValue(const uint64_t encoded, uint64_t& value)
+        {
+            value = encoded;
+        }
+    }
+
+    template<typename T>
+    void BinaryInputStream::readVarIntArray(T* values, const uint32_t count)
+    {
+        T* end = values + count;
+        for (; values != end; ++values)
+        {
+            uint64_t encoded;
+            if (!readVarInt(encoded))
+            {
+                return;
+            }
+            FromVarIntValue(encoded, *values);
+        }
+    }
+
+    IInputStream& BinaryInputStream::readArray(int32_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarIntArray(values, count);
+            return *this;
+        }
+        return readFixedArray(reinterpret_cast<char_t*>(values), count, sizeof(int32_t));
+    }
+
+    IInputStream& BinaryInputStream::readArray(uint32_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarIntArray(values, count);
+            return *this;
+        }
+        return readFixedArray(reinterpret_cast<char_t*>(values), count, sizeof(uint32_t));
+    }
+
+    IInputStream& BinaryInputStream::readArray(int64_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarIntArray(values, count);
+            return *this;
+        }
+        return readFixedArray(reinterpret_cast<char_t*>(values), count, sizeof(int64_t));
+    }
+
+    IInputStream& BinaryInputStream::readArray(uint64_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            readVarIntArray(values, count);
+            return *this;
+        }
+        return readFixedArray(reinterpret_cast<char_t*>(values), count, sizeof(uint64_t));
+    }
+
+    IInputStream& BinaryInputStream::readFixedArray(char_t* values, const uint32_t count, const uint32_t elementSize)
+    {
+        const uint64_t size = static_cast<uint64_t>(count) * elementSize;
+        if (size > NumericLimits::Max<uint32_t>())
+        {
+            mState = CAPU_ERANGE;
+            return *this;
+        }
+        return read(values, static_cast<uint32_t>(size));
+    }
+
     void BinaryInputStream::reset()
     {
         mCurrent = mBuffer;
+        mState = CAPU_OK;
     }
 }
@@ -22,8 +22,9 @@
 
 namespace capu
 {
-    BinaryOutputStream::BinaryOutputStream(const uint32_t capacity)
-        : mBuffer(capacity)
+    BinaryOutputStream::BinaryOutputStream(const uint32_t capacity, const StreamEncoding encoding)
+        : mEncoding(encoding)
+        , mBuffer(capacity)
         , mSize(0)
         , mCapacity(capacity)
 
@@ -49,25 +50,116 @@ namespace capu
         return *this;
     }
 
-    void
-    BinaryOutputStream::resize(const uint32_t minSize)
+    namespace
     {
-        while (mCapacity < minSize)
+        // unsigned representation of the values in the varint encoding
+        inline uint64_t VarIntValue(const int32_t value)
         {
-            mCapacity *= 2;
+            return VarInt::ZigZag(value);
         }
 
-        Array<char_t> newBuffer(mCapacity);
-        Memory::Copy(newBuffer.getRawData(), mBuffer.getRawData(), mSize);
-        swap(mBuffer, newBuffer);
+        inline uint64_t VarIntValue(const int64_t value)
+        {
+            return VarInt::ZigZag(value);
+        }
+
+        inline uint64_t VarIntValue(const uint64_t value)
+        {
+            return value;
+        }
+
+        inline uint64_t VarIntValue(const uint32_t value)
+        {
+            return value;
+        }
+    }
+
+    template<typename T>
+    IOutputStream&
+    BinaryOutputStream::writeVarIntArray(const T* values, const uint32_t count)
+    {
+        static const uint32_t BlockSize = 256;
+        char_t buffer[BlockSize * VarInt::MAX_LENGTH_64];
+
+        const T* end = values + count;
+        while (values != end)
+        {
+            const T* blockEnd = (end - values > static_cast<int_t>(BlockSize)) ? values + BlockSize : end;
+            char_t* current = buffer;
+            for (; values != blockEnd; ++values)
+            {
+                current += VarInt::Encode(VarIntValue(*values), current);
+            }
+            write(buffer, static_cast<uint32_t>(current - buffer));
+        }
+        return *this;
+    }
+
+    IOutputStream&
+    BinaryOutputStream::writeArray(const int32_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarIntArray(values, count);
+        }
+        return write(values, count * sizeof(int32_t));
+    }
+
+    IOutputStream&
+    BinaryOutputStream::writeArray(const uint32_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarIntArray(values, count);
+        }
+        return write(values, count * sizeof(uint32_t));
+    }
+
+    IOutputStream&
+    BinaryOutputStream::writeArray(const int64_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarIntArray(values, count);
+        }
+        return write(values, count * sizeof(int64_t));
+    }
+
+    IOutputStream&
+    BinaryOutputStream::writeArray(const uint64_t* values, const uint32_t count)
+    {
+        if (mEncoding == STREAM_ENCODING_VARINT)
+        {
+            return writeVarIntArray(values, count);
+        }
+        return write(values, count * sizeof(uint64_t));
+    }
+
+    uint32_t
+    BinaryOutputStream::release(Array<char_t>& buffer)
+    {
+        const uint32_t size = mSize;
+        Array<char_t> empty;
+        swap(mBuffer, empty);
+        swap(buffer, empty);
+        mSize = 0;
+        mCapacity = 0;
+        return size;
     }
 
     void
-    BinaryOutputStream::requestSize(const uint32_t size)
+    BinaryOutputStream::resize(const uint32_t minSize)
     {
-        if (mSize + size > mCapacity)
+        // a released stream or one without start size has no capacity to double
+        uint32_t newCapacity = mCapacity > 0 ? mCapacity * 2 : 16;
+        while (newCapacity < minSize)
         {
-            resize(mSize + size);
+            newCapacity *= 2;
         }
+
+        Array<char_t> newBuffer(newCapacity);
+        Memory::Copy(newBuffer.getRawData(), mBuffer.getRawData(), mSize);
+        swap(mBuffer, newBuffer);
+        mCapacity = newCapacity;
     }
 }
@@ -0,0 +1,826 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "capu/util/Fiber.h"
+
+#include "capu/container/Array.h"
+#include "capu/os/Time.h"
+#include "capu/util/ScopedLock.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+const capu::uint32_t capu::FiberStackPool::StacksPerMapping = 64;
+
+capu::FiberStackPool::FiberStackPool(const capu::uint_t stackSize, const capu::bool_t guardPages)
+    : mStackSize((stackSize + 4095) & ~static_cast<uint_t>(4095))
+    , mGuardPages(guardPages)
+{
+}
+
+capu::FiberStackPool::~FiberStackPool()
+{
+    const uint_t mappingSize = mGuardPages ? mStackSize : mStackSize * StacksPerMapping;
+    for (uint32_t i = 0; i < mMappings.size(); ++i)
+    {
+        FiberContext::FreeStack(mMappings[i], mappingSize, mGuardPages);
+    }
+}
+
+void* capu::FiberStackPool::acquire()
+{
+    const uint32_t freeStacks = mFreeStacks.size();
+    if (freeStacks > 0)
+    {
+        // the most recently released stack is the most likely one to be still cached
+        void* stack = mFreeStacks[freeStacks - 1];
+        mFreeStacks.resize(freeStacks - 1);
+        return stack;
+    }
+
+    if (mGuardPages)
+    {
+        void* stack = FiberContext::AllocateStack(mStackSize, true);
+        if (stack)
+        {
+            mMappings.push_back(stack);
+        }
+        return stack;
+    }
+
+    char_t* mapping = static_cast<char_t*>(FiberContext::AllocateStack(mStackSize * StacksPerMapping, false));
+    if (!mapping)
+    {
+        return 0;
+    }
+    mMappings.push_back(mapping);
+    for (uint32_t i = StacksPerMapping - 1; i > 0; --i)
+    {
+        mFreeStacks.push_back(mapping + i * mStackSize);
+    }
+    return mapping;
+}
+
+void capu::FiberStackPool::release(void* stack)
+{
+    mFreeStacks.push_back(stack);
+}
+
+capu::uint_t capu::FiberStackPool::getStackSize() const
+{
+    return mStackSize;
+}
+
+capu::Fiber::Fiber(capu::FiberScheduler& scheduler, capu::SmartPointer<capu::Runnable> runnable, void* stack)
+    : mScheduler(scheduler)
+    , mRunnable(runnable)
+    , mStack(stack)
+    , mState(FIBER_READY)
+    , mWakeStatus(CAPU_OK)
+    , mNext(0)
+    , mDeadline(0)
+    , mTimerIndex(FiberScheduler::NoIndex)
+    , mDescriptor(-1)
+    , mPollIndex(FiberScheduler::NoIndex)
+    , mIoPrevious(0)
+    , mIoNext(0)
+{
+    mContext.init(stack, scheduler.mStacks.getStackSize(), &Fiber::Entry, this);
+}
+
+capu::Fiber* capu::Fiber::Current()
+{
+    FiberScheduler::Worker* worker = FiberScheduler::CurrentWorker();
+    return worker ? worker->mFiber : 0;
+}
+
+void capu::Fiber::Yield()
+{
+    FiberScheduler::Worker* worker = FiberScheduler::CurrentWorker();
+    if (!worker)
+    {
+        Thread::Sleep(0);
+        return;
+    }
+    Fiber* fiber = worker->mFiber;
+    worker->mAction = FiberScheduler::WORKER_YIELD;
+    FiberContext::Switch(fiber->mContext, worker->mContext);
+}
+
+capu::status_t capu::Fiber::Sleep(const capu::uint32_t millis)
+{
+    if (!Current())
+    {
+        return Thread::Sleep(millis);
+    }
+    if (millis == 0)
+    {
+        Yield();
+        return CAPU_OK;
+    }
+    SuspendCurrent(0, millis, -1);
+    return CAPU_OK;
+}
+
+capu::status_t capu::Fiber::Suspend(capu::Mutex& lock, const capu::uint32_t timeoutMillis)
+{
+    return SuspendCurrent(&lock, timeoutMillis, -1);
+}
+
+capu::status_t capu::Fiber::SuspendCurrent(capu::Mutex* lock, const capu::uint32_t timeoutMillis, const capu::int32_t descriptor)
+{
+    FiberScheduler::Worker* worker = FiberScheduler::CurrentWorker();
+    if (!worker)
+    {
+        return CAPU_ERROR;
+    }
+    Fiber* fiber = worker->mFiber;
+    fiber->mDeadline = timeoutMillis > 0 ? Time::GetMilliseconds() + timeoutMillis : 0;
+    fiber->mDescriptor = descriptor;
+    fiber->mWakeStatus = CAPU_OK;
+    worker->mAction = FiberScheduler::WORKER_SUSPEND;
+    worker->mLock = lock;
+    FiberContext::Switch(fiber->mContext, worker->mContext);
+
+    // possibly resumed on another thread, worker must not be used anymore
+    if (lock)
+    {
+        lock->lock();
+    }
+    return fiber->mWakeStatus;
+}
+
+capu::status_t capu::Fiber::WaitReadable(const capu::int32_t descriptor, const capu::uint32_t timeoutMillis)
+{
+    struct pollfd request;
+    request.fd = descriptor;
+    request.events = POLLIN;
+    request.revents = 0;
+    if (::poll(&request, 1, 0) > 0)
+    {
+        return CAPU_OK;
+    }
+    return SuspendCurrent(0, timeoutMillis, descriptor);
+}
+
+capu::status_t capu::Fiber::Receive(capu::TcpSocket& socket, capu::char_t* buffer, capu::int32_t length, capu::int32_t& numBytes)
+{
+    const int32_t descriptor = socket.getSocketDescription();
+    if (descriptor >= 0 && buffer != NULL && length >= 0 && Current())
+    {
+        int32_t timeout = 0;
+        if (socket.getTimeout(timeout) != CAPU_OK || timeout < 0)
+        {
+            timeout = 0;
+        }
+        const status_t status = WaitReadable(descriptor, static_cast<uint32_t>(timeout));
+        if (status != CAPU_OK)
+        {
+            numBytes = 0;
+            return status;
+        }
+    }
+    return socket.receive(buffer, length, numBytes);
+}
+
+void capu::Fiber::resume()
+{
+    ScopedMutexLock lock(mScheduler.mMutex);
+    mScheduler.wake(*this, CAPU_OK);
+}
+
+void capu::Fiber::Entry(void* argument)
+{
+    Fiber* fiber = static_cast<Fiber*>(argument);
+    fiber->mRunnable->run();
+    fiber->mRunnable = SmartPointer<Runnable>();
+
+    // the worker releases the stack, the switch never returns
+    FiberScheduler::Worker* worker = FiberScheduler::CurrentWorker();
+    worker->mAction = FiberScheduler::WORKER_FINISH;
+    FiberContext::Switch(fiber->mContext, worker->mContext);
+}
+
+capu::FiberWaitQueue::FiberWaitQueue()
+    : mHead(0)
+    , mTail(0)
+{
+}
+
+capu::status_t capu::FiberWaitQueue::wait(capu::Mutex& lock, const capu::uint32_t timeoutMillis)
+{
+    Waiter waiter;
+    waiter.fiber = Fiber::Current();
+    waiter.notified = false;
+    waiter.previous = mTail;
+    waiter.next = 0;
+    if (mTail)
+    {
+        mTail->next = &waiter;
+    }
+    else
+    {
+        mHead = &waiter;
+    }
+    mTail = &waiter;
+
+    status_t status = CAPU_OK;
+    if (waiter.fiber)
+    {
+        status = Fiber::Suspend(lock, timeoutMillis);
+    }
+    else
+    {
+        // all threads share one condition variable, each one checks its own flag
+        const uint64_t start = Time::GetMilliseconds();
+        while (!waiter.notified)
+        {
+            uint32_t remaining = 0;
+            if (timeoutMillis > 0)
+            {
+                const uint64_t elapsed = Time::GetMilliseconds() - start;
+                if (elapsed >= timeoutMillis)
+                {
+                    status = CAPU_ETIMEOUT;
+                    break;
+                }
+                remaining = static_cast<uint32_t>(timeoutMillis - elapsed);
+            }
+            mThreadWakeup.wait(&lock, remaining);
+        }
+    }
+
+    if (waiter.notified)
+    {
+        // a notification racing with the timeout wins, notifyOne must not get lost
+        return CAPU_OK;
+    }
+    remove(waiter);
+    return status;
+}
+
+capu::bool_t capu::FiberWaitQueue::notifyOne()
+{
+    Waiter* waiter = mHead;
+    if (!waiter)
+    {
+        return false;
+    }
+    remove(*waiter);
+    waiter->notified = true;
+    if (waiter->fiber)
+    {
+        waiter->fiber->resume();
+    }
+    else
+    {
+        mThreadWakeup.broadcast();
+    }
+    return true;
+}
+
+void capu::FiberWaitQueue::notifyAll()
+{
+    while (notifyOne())
+    {
+    }
+}
+
+capu::bool_t capu::FiberWaitQueue::empty() const
+{
+    return mHead == 0;
+}
+
+void capu::FiberWaitQueue::remove(Waiter& waiter)
+{
+    if (waiter.previous)
+    {
+        waiter.previous->next = waiter.next;
+    }
+    else
+    {
+        mHead = waiter.next;
+    }
+    if (waiter.next)
+    {
+        waiter.next->previous = waiter.previous;
+    }
+    else
+    {
+        mTail = waiter.previous;
+    }
+}
+
+const capu::uint_t capu::FiberScheduler::DefaultStackSize = 64 * 1024;
+const capu::uint32_t capu::FiberScheduler::NoIndex = 0xFFFFFFFF;
+
+CAPU_THREAD_LOCAL capu::FiberScheduler::Worker* capu::FiberScheduler::sCurrentWorker = 0;
+
+capu::FiberScheduler::Worker::Worker(capu::FiberScheduler& scheduler)
+    : mScheduler(scheduler)
+    , mFiber(0)
+    , mAction(WORKER_YIELD)
+    , mLock(0)
+{
+}
+
+void capu::FiberScheduler::Worker::run()
+{
+    mScheduler.runWorker(*this);
+}
+
+capu::FiberScheduler::FiberScheduler(const capu::uint32_t threads, const capu::uint_t stackSize, const capu::bool_t guardPages)
+    : mStacks(stackSize, guardPages)
+    , mReadyHead(0)
+    , mReadyTail(0)
+    , mIoWaiters(0)
+    , mIoWaiterCount(0)
+    , mPolling(false)
+    , mWakePending(false)
+    , mIdleWorkers(0)
+    , mDispatches(0)
+    , mFiberCount(0)
+    , mClosing(false)
+    , mClosed(false)
+{
+    // wakes the thread waiting in poll when other work arrives
+    if (::pipe(mWakePipe) != 0)
+    {
+        mWakePipe[0] = -1;
+        mWakePipe[1] = -1;
+        mClosing = true;
+        mClosed = true;
+        return;
+    }
+    ::fcntl(mWakePipe[0], F_SETFL, O_NONBLOCK);
+    ::fcntl(mWakePipe[1], F_SETFL, O_NONBLOCK);
+
+    const uint32_t count = threads > 0 ? threads : 1;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Worker* worker = new Worker(*this);
+        if (worker->mThread.start(*worker) != CAPU_OK)
+        {
+            delete worker;
+            break;
+        }
+        mWorkers.push_back(worker);
+    }
+    if (mWorkers.size() == 0)
+    {
+        mClosing = true;
+        mClosed = true;
+    }
+}
+
+capu::FiberScheduler::~FiberScheduler()
+{
+    close();
+    for (uint32_t i = 0; i < mWorkers.size(); ++i)
+    {
+        delete mWorkers[i];
+    }
+    if (mWakePipe[0] >= 0)
+    {
+        ::close(mWakePipe[0]);
+        ::close(mWakePipe[1]);
+    }
+}
+
+capu::status_t capu::FiberScheduler::spawn(capu::SmartPointer<capu::Runnable> runnable)
+{
+    if (runnable.get() == NULL)
+    {
+        return CAPU_EINVAL;
+    }
+
+    ScopedMutexLock lock(mMutex);
+    // the workers only stop once no fiber is left, until then running fibers may spawn more
+    if (mClosing && mFiberCount == 0)
+    {
+        return CAPU_ERROR;
+    }
+    void* stack = mStacks.acquire();
+    if (!stack)
+    {
+        return CAPU_ENO_MEMORY;
+    }
+    Fiber* fiber = new Fiber(*this, runnable, stack);
+    ++mFiberCount;
+    pushReady(*fiber);
+    return CAPU_OK;
+}
+
+capu::status_t capu::FiberScheduler::close()
+{
+    {
+        ScopedMutexLock lock(mMutex);
+        if (mClosed)
+        {
+            return CAPU_OK;
+        }
+        mClosing = true;
+        mCondVar.broadcast();
+        wakePoller();
+    }
+
+    status_t result = CAPU_OK;
+    for (uint32_t i = 0; i < mWorkers.size(); ++i)
+    {
+        const status_t status = mWorkers[i]->mThread.join();
+        if (status != CAPU_OK)
+        {
+            result = status;
+        }
+    }
+
+    ScopedMutexLock lock(mMutex);
+    mClosed = true;
+    return result;
+}
+
+capu::bool_t capu::FiberScheduler::isClosed() const
+{
+    ScopedMutexLock lock(mMutex);
+    return mClosing;
+}
+
+capu::uint_t capu::FiberScheduler::getFiberCount() const
+{
+    ScopedMutexLock lock(mMutex);
+    return mFiberCount;
+}
+
+capu::uint32_t capu::FiberScheduler::getThreadCount() const
+{
+    return mWorkers.size();
+}
+
+// Never inlined: a fiber can continue on another thread after a switch, and an inlined
+// access could reuse the thread local address computed for the previous thread.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+capu::FiberScheduler::Worker* capu::FiberScheduler::CurrentWorker()
+{
+    return sCurrentWorker;
+}
+
+void capu::FiberScheduler::runWorker(Worker& worker)
+{
+    sCurrentWorker = &worker;
+
+    // the interval in which busy threads also look for sockets that became readable
+    const uint32_t pollInterval = 64;
+
+    mMutex.lock();
+    for (;;)
+    {
+        if (mTimers.size() > 0)
+        {
+            expireTimers();
+        }
+        if (mIoWaiterCount > 0 && !mPolling && (mReadyHead == 0 || ++mDispatches % pollInterval == 0))
+        {
+            pollIo(mReadyHead == 0);
+            continue;
+        }
+
+        Fiber* fiber = popReady();
+        if (!fiber)
+        {
+            if (mClosing && mFiberCount == 0)
+            {
+                break;
+            }
+            const int32_t timeout = millisToNextTimer();
+            ++mIdleWorkers;
+            // CondVar waits infinitely for 0
+            mCondVar.wait(&mMutex, timeout < 0 ? 0 : (timeout > 0 ? timeout : 1));
+            --mIdleWorkers;
+            continue;
+        }
+
+        fiber->mState = Fiber::FIBER_RUNNING;
+        mMutex.unlock();
+
+        worker.mFiber = fiber;
+        worker.mLock = 0;
+        FiberContext::Switch(worker.mContext, fiber->mContext);
+        worker.mFiber = 0;
+
+        finishSwitch(worker, *fiber);
+    }
+    mMutex.unlock();
+
+    // the last worker lets the others stop as well
+    mCondVar.broadcast();
+    sCurrentWorker = 0;
+}
+
+void capu::FiberScheduler::finishSwitch(Worker& worker, Fiber& fiber)
+{
+    switch (worker.mAction)
+    {
+    case WORKER_YIELD:
+        mMutex.lock();
+        fiber.mState = Fiber::FIBER_READY;
+        pushReady(fiber);
+        break;
+    case WORKER_SUSPEND:
+        mMutex.lock();
+        fiber.mState = Fiber::FIBER_SUSPENDED;
+        if (fiber.mDeadline > 0)
+        {
+            addTimer(fiber);
+        }
+        if (fiber.mDescriptor >= 0)
+        {
+            addIoWaiter(fiber);
+        }
+        // the fiber is off its stack now, whoever waits for the lock may resume it
+        if (worker.mLock)
+        {
+            worker.mLock->unlock();
+        }
+        break;
+    case WORKER_FINISH:
+    {
+        void* stack = fiber.mStack;
+        delete &fiber;
+        mMutex.lock();
+        mStacks.release(stack);
+        --mFiberCount;
+        if (mFiberCount == 0 && mClosing)
+        {
+            mCondVar.broadcast();
+            wakePoller();
+        }
+        break;
+    }
+    }
+}
+
+void capu::FiberScheduler::pushReady(Fiber& fiber)
+{
+    fiber.mNext = 0;
+    if (mReadyTail)
+    {
+        mReadyTail->mNext = &fiber;
+    }
+    else
+    {
+        mReadyHead = &fiber;
+    }
+    mReadyTail = &fiber;
+
+    if (mIdleWorkers > 0)
+    {
+        mCondVar.signal();
+    }
+    else
+    {
+        wakePoller();
+    }
+}
+
+capu::Fiber* capu::FiberScheduler::popReady()
+{
+    Fiber* fiber = mReadyHead;
+    if (fiber)
+    {
+        mReadyHead = fiber->mNext;
+        if (!mReadyHead)
+        {
+            mReadyTail = 0;
+        }
+    }
+    return fiber;
+}
+
+void capu::FiberScheduler::wake(Fiber& fiber, const capu::status_t status)
+{
+    if (fiber.mState != Fiber::FIBER_SUSPENDED)
+    {
+        return;
+    }
+    if (fiber.mTimerIndex != NoIndex)
+    {
+        removeTimer(fiber);
+    }
+    if (fiber.mDescriptor >= 0)
+    {
+        removeIoWaiter(fiber);
+    }
+    fiber.mWakeStatus = status;
+    fiber.mState = Fiber::FIBER_READY;
+    pushReady(fiber);
+}
+
+void capu::FiberScheduler::addTimer(Fiber& fiber)
+{
+    // binary min heap on the deadline, every fiber knows its position for removal
+    uint32_t index = mTimers.size();
+    mTimers.push_back(&fiber);
+    while (index > 0)
+    {
+        const uint32_t parent = (index - 1) / 2;
+        if (mTimers[parent]->mDeadline <= fiber.mDeadline)
+        {
+            break;
+        }
+        placeTimer(index, mTimers[parent]);
+        index = parent;
+    }
+    placeTimer(index, &fiber);
+
+    if (index == 0)
+    {
+        // the earliest deadline changed, waiting threads have to recompute their timeout
+        if (mIdleWorkers > 0)
+        {
+            mCondVar.signal();
+        }
+        wakePoller();
+    }
+}
+
+void capu::FiberScheduler::removeTimer(Fiber& fiber)
+{
+    const uint32_t last = mTimers.size() - 1;
+    uint32_t index = fiber.mTimerIndex;
+    fiber.mTimerIndex = NoIndex;
+    Fiber* moved = mTimers[last];
+    mTimers.resize(last);
+    if (index == last)
+    {
+        return;
+    }
+
+    // put the last element into the gap and restore the heap in whichever direction it is violated
+    while (index > 0 && mTimers[(index - 1) / 2]->mDeadline > moved->mDeadline)
+    {
+        const uint32_t parent = (index - 1) / 2;
+        placeTimer(index, mTimers[parent]);
+        index = parent;
+    }
+    for (;;)
+    {
+        uint32_t child = 2 * index + 1;
+        if (child >= last)
+        {
+            break;
+        }
+        if (child + 1 < last && mTimers[child + 1]->mDeadline < mTimers[child]->mDeadline)
+        {
+            ++child;
+        }
+        if (mTimers[child]->mDeadline >= moved->mDeadline)
+        {
+            break;
+        }
+        placeTimer(index, mTimers[child]);
+        index = child;
+    }
+    placeTimer(index, moved);
+}
+
+void capu::FiberScheduler::placeTimer(capu::uint32_t index, Fiber* fiber)
+{
+    mTimers[index] = fiber;
+    fiber->mTimerIndex = index;
+}
+
+void capu::FiberScheduler::expireTimers()
+{
+    const uint64_t now = Time::GetMilliseconds();
+    while (mTimers.size() > 0 && mTimers[0]->mDeadline <= now)
+    {
+        wake(*mTimers[0], CAPU_ETIMEOUT);
+    }
+}
+
+capu::int32_t capu::FiberScheduler::millisToNextTimer() const
+{
+    if (mTimers.size() == 0)
+    {
+        return -1;
+    }
+    const uint64_t now = Time::GetMilliseconds();
+    const uint64_t deadline = mTimers[0]->mDeadline;
+    if (deadline <= now)
+    {
+        return 0;
+    }
+    const uint64_t remaining = deadline - now;
+    return remaining < 0x7FFFFFFF ? static_cast<int32_t>(remaining) : 0x7FFFFFFF;
+}
+
+void capu::FiberScheduler::addIoWaiter(Fiber& fiber)
+{
+    fiber.mPollIndex = NoIndex;
+    fiber.mIoPrevious = 0;
+    fiber.mIoNext = mIoWaiters;
+    if (mIoWaiters)
+    {
+        mIoWaiters->mIoPrevious = &fiber;
+    }
+    mIoWaiters = &fiber;
+    ++mIoWaiterCount;
+
+    // a thread already in poll does not know the new socket yet
+    wakePoller();
+}
+
+void capu::FiberScheduler::removeIoWaiter(Fiber& fiber)
+{
+    if (fiber.mIoPrevious)
+    {
+        fiber.mIoPrevious->mIoNext = fiber.mIoNext;
+    }
+    else
+    {
+        mIoWaiters = fiber.mIoNext;
+    }
+    if (fiber.mIoNext)
+    {
+        fiber.mIoNext->mIoPrevious = fiber.mIoPrevious;
+    }
+    fiber.mDescriptor = -1;
+    --mIoWaiterCount;
+}
+
+void capu::FiberScheduler::pollIo(const capu::bool_t block)
+{
+    // called and returning with the lock held, but polls without it
+    mPolling = true;
+    const uint32_t count = mIoWaiterCount + 1;
+    Array<struct pollfd> requests(count);
+    requests[0].fd = mWakePipe[0];
+    requests[0].events = POLLIN;
+    requests[0].revents = 0;
+    uint32_t index = 1;
+    for (Fiber* fiber = mIoWaiters; fiber; fiber = fiber->mIoNext)
+    {
+        requests[index].fd = fiber->mDescriptor;
+        requests[index].events = POLLIN;
+        requests[index].revents = 0;
+        fiber->mPollIndex = index;
+        ++index;
+    }
+    const int32_t timeout = block ? millisToNextTimer() : 0;
+    mMutex.unlock();
+
+    ::poll(requests.getRawData(), count, timeout);
+    if (requests[0].revents != 0)
+    {
+        char_t drain[64];
+        while (::read(mWakePipe[0], drain, sizeof(drain)) > 0)
+        {
+        }
+    }
+
+    mMutex.lock();
+    mPolling = false;
+    mWakePending = false;
+
+    // fibers which started waiting during the poll have no index and stay
+    Fiber* fiber = mIoWaiters;
+    while (fiber)
+    {
+        Fiber* next = fiber->mIoNext;
+        if (fiber->mPollIndex != NoIndex && requests[fiber->mPollIndex].revents != 0)
+        {
+            wake(*fiber, CAPU_OK);
+        }
+        fiber = next;
+    }
+}
+
+void capu::FiberScheduler::wakePoller()
+{
+    if (mPolling && !mWakePending)
+    {
+        mWakePending = true;
+        const char_t signal = 0;
+        if (::write(mWakePipe[1], &signal, 1) < 0)
+        {
+            // the pipe is full, so poll returns anyway
+        }
+    }
+}
@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "capu/util/FileAppender.h"
+#include "capu/os/Memory.h"
+#include "capu/os/StringUtils.h"
+#include "capu/os/Time.h"
+
+const capu::uint_t capu::FileAppender::DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+namespace
+{
+    const capu::char_t* LevelName(const capu::LoggerLevel level)
+    {
+        switch (level)
+        {
+        case capu::CLL_TRACE:
+            return "TRACE";
+        case capu::CLL_DEBUG:
+            return "DEBUG";
+        case capu::CLL_INFO:
+            return "INFO";
+        case capu::CLL_WARN:
+            return "WARN";
+        case capu::CLL_ERROR:
+            return "ERROR";
+        default:
+            return "";
+        }
+    }
+}
+
+capu::FileAppender::Writer::Writer(FileAppender& appender)
+    : mAppender(appender)
+{
+}
+
+void capu::FileAppender::Writer::run()
+{
+    mAppender.writerLoop();
+}
+
+capu::FileAppender::FileAppender(const String& path)
+    : mPath(path)
+    , mBufferSize(DEFAULT_BUFFER_SIZE)
+    , mFlushInterval(1000)
+    , mSyncInterval(5000)
+    , mMaxFileSize(0)
+    , mMaxFileCount(0)
+    , mFile(NULL)
+    , mFileSize(0)
+    , mLastSync(0)
+    , mUnsynced(false)
+    , mActiveBuffer(NULL)
+    , mActiveSize(0)
+    , mActiveSince(0)
+    , mPendingBuffer(NULL)
+    , mPendingSize(0)
+    , mWrittenGeneration(0)
+    , mPendingGeneration(0)
+    , mWriteStatus(CAPU_OK)
+    , mOpen(false)
+    , mCloseRequested(false)
+    , mWriter(*this)
+{
+}
+
+capu::FileAppender::~FileAppender()
+{
+    close();
+}
+
+void capu::FileAppender::setBufferSize(const uint_t size)
+{
+    // a buffer has to hold at least a line header
+    mBufferSize = size < 256 ? 256 : size;
+}
+
+void capu::FileAppender::setFlushInterval(const uint32_t millis)
+{
+    mFlushInterval = millis;
+}
+
+void capu::FileAppender::setSyncInterval(const uint32_t millis)
+{
+    mSyncInterval = millis;
+}
+
+void capu::FileAppender::setRotation(const uint_t maxFileSize, const uint32_t maxFileCount)
+{
+    mMaxFileSize = maxFileSize;
+    mMaxFileCount = maxFileCount;
+}
+
+capu::status_t capu::FileAppender::open()
+{
+    if (mOpen)
+    {
+        return CAPU_ERROR;
+    }
+
+    if (mMaxFileSize > 0 && File(mPath).exists())
+    {
+        // keep the log of the previous run
+        rotate();
+    }
+    if (openFile() != CAPU_OK)
+    {
+        return CAPU_ERROR;
+    }
+
+    mActiveBuffer = new char_t[mBufferSize];
+    mPendingBuffer = new char_t[mBufferSize];
+    mActiveSize = 0;
+    mPendingSize = 0;
+    mWriteStatus = CAPU_OK;
+    mCloseRequested = false;
+    mLastSync = Time::GetMilliseconds();
+    mUnsynced = false;
+
+    if (mThread.start(mWriter) != CAPU_OK)
+    {
+        mFile->close();
+        delete mFile;
+        mFile = NULL;
+        delete[] mActiveBuffer;
+        delete[] mPendingBuffer;
+        mActiveBuffer = NULL;
+        mPendingBuffer = NULL;
+        return CAPU_ERROR;
+    }
+    mOpen = true;
+    return CAPU_OK;
+}
+
+capu::status_t capu::FileAppender::log(LoggerMessage& message)
+{
+    if (message.getLevel() < mLvl)
+    {
+        return CAPU_OK;
+    }
+
+    // the header is formatted outside of the lock
+    const uint64_t timestamp = message.getTimestamp();
+    char_t header[256];
+    StringUtils::Sprintf(header, sizeof(header), "%u.%03u %s %lu %s:%d %s, ",
+                         static_cast<uint32_t>(timestamp / 1000), static_cast<uint32_t>(timestamp % 1000),
+                         LevelName(message.getLevel()), static_cast<unsigned long>(message.getThreadId()),
+                         message.getFile(), message.getLine(), message.getTag());
+    const uint_t headerLength = StringUtils::Strlen(header);
+    const uint_t messageLength = StringUtils::Strlen(message.getMessage());
+    uint_t lineLength = headerLength + messageLength + 1;
+
+    mMutex.lock();
+    for (;;)
+    {
+        if (!mOpen || mCloseRequested)
+        {
+            mMutex.unlock();
+            return CAPU_ERROR;
+        }
+        if (mActiveSize + lineLength <= mBufferSize)
+        {
+            break;
+        }
+        if (mActiveSize == 0)
+        {
+            // longer than the whole buffer, only the beginning is kept
+            lineLength = mBufferSize;
+            break;
+        }
+
+        // the buffer is full, hand it over to the writer thread
+        if (mPendingSize == 0)
+        {
+            swapBuffers();
+        }
+        else
+        {
+            mBufferFreeCondition.wait(&mMutex);
+        }
+    }
+
+    if (mActiveSize == 0)
+    {
+        mActiveSince = Time::GetMilliseconds();
+        // the writer thread has to start the flush interval
+        mWriterCondition.signal();
+    }
+
+    char_t* line = mActiveBuffer + mActiveSize;
+    const uint_t copiedHeader = headerLength < lineLength - 1 ? headerLength : lineLength - 1;
+    Memory::Copy(line, header, copiedHeader);
+    Memory::Copy(line + copiedHeader, message.getMessage(), lineLength - 1 - copiedHeader);
+    line[lineLength - 1] = '\n';
+    mActiveSize += lineLength;
+
+    mMutex.unlock();
+    return CAPU_OK;
+}
+
+capu::status_t capu::FileAppender::flush()
+{
+    mMutex.lock();
+    if (!mOpen || mCloseRequested)
+    {
+        mMutex.unlock();
+        return CAPU_ERROR;
+    }
+
+    while (mActiveSize > 0 && mPendingSize > 0)
+    {
+        mBufferFreeCondition.wait(&mMutex);
+    }
+    if (mActiveSize > 0)
+    {
+        swapBuffers();
+    }
+
+    const uint64_t generation = mPendingGeneration;
+    while (mWrittenGeneration < generation)
+    {
+        mBufferFreeCondition.wait(&mMutex);
+    }
+    const status_t status = mWriteStatus;
+    mMutex.unlock();
+    return status;
+}
+
+capu::status_t capu::FileAppender::close()
+{
+    mMutex.lock();
+    if (!mOpen || mCloseRequested)
+    {
+        mMutex.unlock();
+        return CAPU_ERROR;
+    }
+    mCloseRequested = true;
+    mWriterCondition.signal();
+    mMutex.unlock();
+
+    // the writer thread writes the remaining messages before it terminates
+    mThread.join();
+
+    mMutex.lock();
+    status_t status = mWriteStatus;
+    if (mFile != NULL)
+    {
+        if (mUnsynced && mFile->sync() != CAPU_OK)
+        {
+            status = CAPU_ERROR;
+        }
+        mFile->close();
+        delete mFile;
+        mFile = NULL;
+    }
+    delete[] mActiveBuffer;
+    delete[] mPendingBuffer;
+    mActiveBuffer = NULL;
+    mPendingBuffer = NULL;
+    mOpen = false;
+    mMutex.unlock();
+    return status;
+}
+
+void capu::FileAppender::swapBuffers()
+{
+    char_t* buffer = mPendingBuffer;
+    mPendingBuffer = mActiveBuffer;
+    mPendingSize = mActiveSize;
+    mActiveBuffer = buffer;
+    mActiveSize = 0;
+    ++mPendingGeneration;
+    mWriterCondition.signal();
+}
+
+void capu::FileAppender::writerLoop()
+{
+    mMutex.lock();
+    for (;;)
+    {
+        if (mPendingSize == 0)
+        {
+            const uint64_t now = Time::GetMilliseconds();
+            const bool_t flushDue = mActiveSize > 0 &&
+                                    (mCloseRequested || (mFlushInterval > 0 && now >= mActiveSince + mFlushInterval));
+            if (flushDue)
+            {
+                swapBuffers();
+            }
+            else if (mUnsynced && now >= mLastSync + mSyncInterval)
+            {
+                // nothing was written since the last sync, catch up now
+                mMutex.unlock();
+                const status_t status = mFile->sync();
+                mMutex.lock();
+                mUnsynced = false;
+                mLastSync = now;
+                if (status != CAPU_OK)
+                {
+                    mWriteStatus = status;
+                }
+                continue;
+            }
+            else if (mCloseRequested)
+            {
+                break;
+            }
+            else
+            {
+                // sleep until the next flush or sync is due or new messages arrive
+                uint64_t timeout = 0;
+                if (mActiveSize > 0 && mFlushInterval > 0)
+                {
+                    timeout = mActiveSince + mFlushInterval - now;
+                }
+                if (mUnsynced)
+                {
+                    const uint64_t syncTimeout = mLastSync + mSyncInterval - now;
+                    if (timeout == 0 || syncTimeout < timeout)
+                    {
+                        timeout = syncTimeout;
+                    }
+                }
+                mWriterCondition.wait(&mMutex, static_cast<uint32_t>(timeout));
+                continue;
+            }
+        }
+
+        // the pending buffer belongs to the writer until mPendingSize is reset
+        const char_t* buffer = mPendingBuffer;
+        const uint_t size = mPendingSize;
+        mMutex.unlock();
+        const status_t status = writeBuffer(buffer, size);
+        mMutex.lock();
+        if (status != CAPU_OK)
+        {
+            mWriteStatus = status;
+        }
+        mPendingSize = 0;
+        mWrittenGeneration = mPendingGeneration;
+        mBufferFreeCondition.broadcast();
+    }
+    mMutex.unlock();
+}
+
+capu::status_t capu::FileAppender::writeBuffer(const char_t* buffer, const uint_t size)
+{
+    status_t status = CAPU_OK;
+    if (mFile != NULL && mMaxFileSize > 0 && mFileSize > 0 && mFileSize + size > mMaxFileSize)
+    {
+        status = rotate();
+        if (status == CAPU_OK)
+        {
+            status = openFile();
+        }
+        if (status != CAPU_OK)
+        {
+            return status;
+        }
+    }
+    if (mFile == NULL)
+    {
+        // reopening after the last rotation failed, try again instead of losing every further message
+        status = openFile();
+        if (status != CAPU_OK)
+        {
+            return status;
+        }
+    }
+
+    status = mFile->write(buffer, size);
+    if (status != CAPU_OK)
+    {
+        return status;
+    }
+    mFileSize += size;
+
+    // hand the data to the operating system right away, but sync only once per interval
+    const uint64_t now = Time::GetMilliseconds();
+    if (now >= mLastSync + mSyncInterval)
+    {
+        mUnsynced = false;
+        mLastSync = now;
+        return mFile->sync();
+    }
+    mUnsynced = true;
+    return mFile->flush();
+}
+
+capu::status_t capu::FileAppender::rotate()
+{
+    if (mFile != NULL)
+    {
+        if (mUnsynced)
+        {
+            mFile->sync();
+            mUnsynced = false;
+        }
+        mFile->close();
+        delete mFile;
+        mFile = NULL;
+    }
+
+    if (mMaxFileCount == 0)
+    {
+        File(mPath).remove();
+        return CAPU_OK;
+    }
+
+    File(getRotatedPath(mMaxFileCount)).remove();
+    for (uint32_t i = mMaxFileCount - 1; i > 0; --i)
+    {
+        File rotated(getRotatedPath(i));
+        if (rotated.exists())
+        {
+            rotated.renameTo(getRotatedPath(i + 1));
+        }
+    }
+    return File(mPath).renameTo(getRotatedPath(1));
+}
+
+capu::status_t capu::FileAppender::openFile()
+{
+    mFile = new File(mPath);
+    mFileSize = 0;
+    const status_t status = mFile->open(READ_WRITE_OVERWRITE_OLD);
+    if (status != CAPU_OK)
+    {
+        delete mFile;
+        mFile = NULL;
+    }
+    return status;
+}
+
+capu::String capu::FileAppender::getRotatedPath(const uint32_t index) const
+{
+    char_t suffix[16];
+    StringUtils::Sprintf(suffix, sizeof(suffix), ".%u", index);
+    return String(mPath) + suffix;
+}
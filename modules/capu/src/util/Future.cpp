@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "capu/util/Future.h"
+
+#include "capu/os/AtomicOperation.h"
+#include "capu/util/ScopedLock.h"
+#include "capu/util/ThreadPool.h"
+
+capu::FutureTask::FutureTask(ThreadPool* pool, const uint32_t dependencies)
+    : mReferenceCount(0)
+    , mDone(0)
+    , mPendingDependencies(dependencies)
+    , mStatus(CAPU_OK)
+    , mDependencyStatus(CAPU_OK)
+    , mWaiters(0)
+    , mDependents(NULL)
+    , mPool(pool)
+{
+}
+
+capu::FutureTask::~FutureTask()
+{
+}
+
+void capu::FutureTask::addReference()
+{
+    AtomicOperation::AtomicInc32(mReferenceCount);
+}
+
+void capu::FutureTask::releaseReference()
+{
+    if (AtomicOperation::AtomicDec32(mReferenceCount) == 1)
+    {
+        delete this;
+    }
+}
+
+capu::bool_t capu::FutureTask::isDone()
+{
+    return AtomicOperation::AtomicAdd32(mDone, 0) != 0;
+}
+
+capu::status_t capu::FutureTask::wait(const uint32_t timeoutMillis)
+{
+    // fast path without locking, the status is written before mDone is set
+    if (isDone())
+    {
+        return mStatus;
+    }
+
+    ScopedMutexLock lock(mMutex);
+    ++mWaiters;
+    status_t result = CAPU_OK;
+    while (!mDone)
+    {
+        result = mCondVar.wait(&mMutex, timeoutMillis);
+        if (result != CAPU_OK)
+        {
+            break;
+        }
+    }
+    --mWaiters;
+    return mDone ? mStatus : result;
+}
+
+void capu::FutureTask::run()
+{
+    finish(execute(mDependencyStatus));
+}
+
+void capu::FutureTask::abandon(const status_t status)
+{
+    finish(status);
+}
+
+void capu::FutureTask::addDependent(Dependency& dependency)
+{
+    dependency.task->addReference();
+    {
+        ScopedMutexLock lock(mMutex);
+        if (!mDone)
+        {
+            dependency.next = mDependents;
+            mDependents = &dependency;
+            return;
+        }
+    }
+    dependency.task->dependencyDone(mStatus);
+}
+
+void capu::FutureTask::finish(const status_t status)
+{
+    Dependency* dependents;
+    {
+        ScopedMutexLock lock(mMutex);
+        mStatus = status;
+        AtomicOperation::AtomicInc32(mDone);
+        dependents = mDependents;
+        mDependents = NULL;
+        if (mWaiters > 0)
+        {
+            // only pay for the wake up if somebody is actually sleeping
+            mCondVar.broadcast();
+        }
+    }
+
+    while (dependents)
+    {
+        // the link belongs to the dependent task which might be deleted by dependencyDone
+        Dependency* next = dependents->next;
+        dependents->task->dependencyDone(status);
+        dependents = next;
+    }
+}
+
+void capu::FutureTask::dependencyDone(const status_t status)
+{
+    if (status != CAPU_OK)
+    {
+        ScopedMutexLock lock(mMutex);
+        if (mDependencyStatus == CAPU_OK)
+        {
+            mDependencyStatus = status;
+        }
+    }
+
+    if (AtomicOperation::AtomicDec32(mPendingDependencies) == 1)
+    {
+        if (!mPool)
+        {
+            run();
+        }
+        else if (mPool->enqueue(*this) != CAPU_OK)
+        {
+            abandon(CAPU_ERROR);
+        }
+    }
+    releaseReference();
+}
@@ -20,6 +20,17 @@
 #include "capu/container/Array.h"
 #include "capu/os/Time.h"
 #include "capu/os/Thread.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/util/ScopedLock.h"
+
+// va_copy is C99/C++11, older compilers only know the gnu spelling or use plain pointers
+#if defined(va_copy)
+#define LOGGER_VA_COPY(dst, src) va_copy(dst, src)
+#elif defined(__va_copy)
+#define LOGGER_VA_COPY(dst, src) __va_copy(dst, src)
+#else
+#define LOGGER_VA_COPY(dst, src) ((dst) = (src))
+#endif
 
 namespace capu
 {
@@ -50,8 +61,14 @@ namespace capu
     Logger::Logger(int32_t id)
         : mId(id)
         , mOpen(false)
+        , mLevel(CLL_TRACE)
+        , mTagLevelCount(0)
+        , mMutex()
+        , mThreshold(0)
     {
         Memory::Set(mAppenders, 0, sizeof(Appender*) * LOGGER_APPENDER_MAX);
+        ScopedMutexLock lock(mMutex);
+        updateThreshold();
     }
 
     Logger::~Logger()
@@ -69,6 +86,8 @@ namespace capu
             if (mAppenders[i] == NULL)
             {
                 mAppenders[i] = &appender;
+                ScopedMutexLock lock(mMutex);
+                updateThreshold();
                 return CAPU_OK;
             }
         }
@@ -82,6 +101,8 @@ namespace capu
             if (mAppenders[i] == &appender)
             {
                 mAppenders[i] = NULL;
+                ScopedMutexLock lock(mMutex);
+                updateThreshold();
                 return CAPU_OK;
             }
         }
@@ -101,8 +122,126 @@ namespace capu
         return CAPU_OK;
     }
 
+    void Logger::setLoggingLevel(const LoggerLevel level)
+    {
+        ScopedMutexLock lock(mMutex);
+        mLevel = level;
+        updateThreshold();
+    }
+
+    status_t Logger::setTagLoggingLevel(const char_t* tag, const LoggerLevel level)
+    {
+        if (tag == NULL)
+        {
+            return CAPU_EINVAL;
+        }
+
+        // logging threads look up the tags under the same lock
+        ScopedMutexLock lock(mMutex);
+        for (uint_t i = 0; i < mTagLevelCount; i++)
+        {
+            if (StringUtils::Strcmp(mTagLevels[i].tag.c_str(), tag) == 0)
+            {
+                if (level == CLL_INVALID)
+                {
+                    // remove by moving the last entry into the gap
+                    --mTagLevelCount;
+                    mTagLevels[i] = mTagLevels[mTagLevelCount];
+                    mTagLevels[mTagLevelCount].tag = "";
+                }
+                else
+                {
+                    mTagLevels[i].level = level;
+                }
+                updateThreshold();
+                return CAPU_OK;
+            }
+        }
+
+        if (level == CLL_INVALID)
+        {
+            return CAPU_OK;
+        }
+        if (mTagLevelCount == LOGGER_TAG_LEVEL_MAX)
+        {
+            return CAPU_ERROR;
+        }
+        mTagLevels[mTagLevelCount].tag = tag;
+        mTagLevels[mTagLevelCount].level = level;
+        ++mTagLevelCount;
+        updateThreshold();
+        return CAPU_OK;
+    }
+
+    void Logger::AppenderLevelChanged()
+    {
+        AtomicOperation::AtomicInc32(LevelGeneration());
+    }
+
+    void Logger::updateThreshold() const
+    {
+        const uint32_t generation = AtomicOperation::AtomicAdd32(LevelGeneration(), 0);
+
+        // the lowest level an appender accepts
+        uint32_t appenderLevel = CLL_ERROR + 1;
+        for (int i = 0; i < LOGGER_APPENDER_MAX; i++)
+        {
+            if (mAppenders[i] != NULL && static_cast<uint32_t>(mAppenders[i]->getLoggingLevel()) < appenderLevel)
+            {
+                appenderLevel = mAppenders[i]->getLoggingLevel();
+            }
+        }
+
+        // the lowest level the logger or one of its tags accepts
+        uint32_t loggerLevel = mLevel;
+        for (uint_t i = 0; i < mTagLevelCount; i++)
+        {
+            if (static_cast<uint32_t>(mTagLevels[i].level) < loggerLevel)
+            {
+                loggerLevel = mTagLevels[i].level;
+            }
+        }
+
+        // only holders of mMutex write the threshold, adding the difference stores it atomically
+        const uint32_t level = appenderLevel > loggerLevel ? appenderLevel : loggerLevel;
+        const uint32_t threshold = (generation << ThresholdLevelBits) | level;
+        const uint32_t current = AtomicOperation::AtomicAdd32(mThreshold, 0);
+        AtomicOperation::AtomicAdd32(mThreshold, threshold - current);
+    }
+
+    bool_t Logger::checkLevel(const LoggerLevel level, const char_t* tag) const
+    {
+        ScopedMutexLock lock(mMutex);
+        const uint32_t generation = AtomicOperation::AtomicAdd32(LevelGeneration(), 0) << ThresholdLevelBits;
+        if ((AtomicOperation::AtomicAdd32(mThreshold, 0) & ~ThresholdLevelMask) != generation)
+        {
+            updateThreshold();
+        }
+        if (static_cast<uint32_t>(level) < (AtomicOperation::AtomicAdd32(mThreshold, 0) & ThresholdLevelMask))
+        {
+            return false;
+        }
+
+        if (tag != NULL)
+        {
+            for (uint_t i = 0; i < mTagLevelCount; i++)
+            {
+                if (StringUtils::Strcmp(mTagLevels[i].tag.c_str(), tag) == 0)
+                {
+                    return level >= mTagLevels[i].level;
+                }
+            }
+        }
+        return level >= mLevel;
+    }
+
     status_t Logger::vlog(const LoggerLevel level, const char_t* tag, const char_t* file, const int32_t line, const char_t* msgFormat, va_list args)
     {
+        if (!isLevelEnabled(level, tag))
+        {
+            return CAPU_OK;
+        }
+
         LoggerMessage msg;
         msg.setId(mId);
         msg.setTimestamp(Time::GetMilliseconds());
@@ -112,15 +251,19 @@ namespace capu
         msg.setFile(file);
         msg.setLine(line);
 
+        // the arguments are consumed twice, once for measuring and once for formatting
+        va_list formatArgs;
+        LOGGER_VA_COPY(formatArgs, args);
         const int32_t size = StringUtils::Vscprintf(msgFormat, args);
         Array<char_t> buffer(size + 1);
-        StringUtils::Vsprintf(buffer.getRawData(), size + 1, msgFormat, args);
+        StringUtils::Vsprintf(buffer.getRawData(), size + 1, msgFormat, formatArgs);
+        va_end(formatArgs);
         msg.setMessage(buffer.getRawData());
 
         // log message
         for (int i = 0; i < LOGGER_APPENDER_MAX; i++)
         {
-            if (mAppenders[i] != NULL)
+            if (mAppenders[i] != NULL && level >= mAppenders[i]->getLoggingLevel())
             {
                 mAppenders[i]->log(msg);
             }
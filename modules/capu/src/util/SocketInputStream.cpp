@@ -26,12 +26,21 @@ namespace capu
         uint32_t strLen = 0;
 
         operator>>(strLen);
-        Array<char_t> buffer(strLen + 1);
+        if (mState != CAPU_OK)
+        {
+            return *this;
+        }
 
-        read(buffer.getRawData(), strLen);
-        buffer[strLen] = 0;
+        if (mStringBuffer.size() < strLen)
+        {
+            mStringBuffer.setSize(strLen > 2 * mStringBuffer.size() ? strLen : 2 * mStringBuffer.size());
+        }
 
-        value = buffer.getRawData();
+        read(mStringBuffer.getRawData(), strLen);
+        if (mState == CAPU_OK)
+        {
+            value.assign(mStringBuffer.getRawData(), strLen);
+        }
 
         return *this;
     }
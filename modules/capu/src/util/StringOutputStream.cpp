@@ -50,4 +50,24 @@ namespace capu
         }
     }
 
+    IOutputStream&
+    StringOutputStream::writeDecimal(uint64_t value, const bool_t negative)
+    {
+        // 20 digits of the maximum uint64_t and the sign, filled from the end
+        char_t buffer[21];
+        char_t* current = buffer + sizeof(buffer);
+        do
+        {
+            *--current = static_cast<char_t>('0' + value % 10);
+            value /= 10;
+        }
+        while (value != 0);
+
+        if (negative)
+        {
+            *--current = '-';
+        }
+        return write(current, static_cast<uint32_t>(buffer + sizeof(buffer) - current));
+    }
+
 }
\ No newline at end of file
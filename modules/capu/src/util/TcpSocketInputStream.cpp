@@ -18,8 +18,9 @@
 
 namespace capu
 {
-    TcpSocketInputStream::TcpSocketInputStream(TcpSocket& socket)
-        : m_socket(socket)
+    TcpSocketInputStream::TcpSocketInputStream(TcpSocket& socket, const StreamEncoding encoding)
+        : SocketInputStream(encoding)
+        , m_socket(socket)
     {
     }
 
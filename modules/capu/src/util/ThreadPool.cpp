@@ -17,19 +17,57 @@
 #include "capu/util/ThreadPool.h"
 
 #include "capu/util/ScopedLock.h"
+#include "capu/os/StringUtils.h"
 
 const capu::uint32_t capu::ThreadPool::MAX_THREAD_POOL_THREADS = 64;
 
 capu::ThreadPool::ThreadPool(const capu::uint32_t size)
     : mClosed(false)
     , mCloseRequested(false)
+{
+    createWorkers(size, capu::ThreadAttributes(), capu::TPP_NONE);
+}
+
+capu::ThreadPool::ThreadPool(const capu::uint32_t size, const capu::ThreadAttributes& attributes, const capu::ThreadPoolPinning pinning)
+    : mClosed(false)
+    , mCloseRequested(false)
+{
+    createWorkers(size, attributes, pinning);
+}
+
+void capu::ThreadPool::createWorkers(const capu::uint32_t size, const capu::ThreadAttributes& attributes, const capu::ThreadPoolPinning pinning)
 {
     const capu::uint32_t poolSize = size < MAX_THREAD_POOL_THREADS ? size : MAX_THREAD_POOL_THREADS;
 
+    capu::CpuSet cpus = attributes.getCpuSet();
+    if (pinning == capu::TPP_PER_CPU && cpus.empty())
+    {
+        capu::Thread::GetAvailableCpus(cpus);
+    }
+    const capu::uint32_t cpuCount = cpus.count();
+
     // create the workers
     for (capu::uint32_t i = 0; i < poolSize; i++)
     {
-        capu::ThreadPool::PoolWorkerPtr t(new capu::ThreadPool::PoolWorker(*this));
+        capu::ThreadAttributes workerAttributes(attributes);
+        if (attributes.getName()[0] != 0)
+        {
+            // cut the prefix rather than the index, the index tells the workers apart
+            capu::char_t suffix[capu::ThreadAttributes::MaxNameLength + 1];
+            capu::StringUtils::Sprintf(suffix, sizeof(suffix), "-%u", i);
+            const capu::int32_t prefixLength = static_cast<capu::int32_t>(capu::ThreadAttributes::MaxNameLength - capu::StringUtils::Strlen(suffix));
+            capu::char_t name[capu::ThreadAttributes::MaxNameLength + 1];
+            capu::StringUtils::Sprintf(name, sizeof(name), "%.*s%s", prefixLength, attributes.getName(), suffix);
+            workerAttributes.setName(name);
+        }
+        if (pinning == capu::TPP_PER_CPU && cpuCount > 0)
+        {
+            capu::CpuSet cpu;
+            cpu.add(cpus.get(i % cpuCount));
+            workerAttributes.setCpuSet(cpu);
+        }
+
+        capu::ThreadPool::PoolWorkerPtr t(new capu::ThreadPool::PoolWorker(*this, workerAttributes));
         if (t->isValid())
         {
             mWorkerList.insert(t);
@@ -57,7 +95,25 @@ capu::status_t capu::ThreadPool::add(capu::SmartPointer<capu::Runnable> runnable
     }
 
     ScopedMutexLock lock(mMutex);
-    status_t result = mRunnableQueue.push(runnable);
+    status_t result = mJobQueue.push_back(Job(runnable));
+    mCV.signal();
+    return result;
+}
+
+capu::status_t capu::ThreadPool::enqueue(FutureTask& task)
+{
+    ScopedMutexLock lock(mMutex);
+    if (mClosed)
+    {
+        return CAPU_ERROR;
+    }
+    task.addReference();
+    status_t result = mJobQueue.push_back(Job(&task));
+    if (result != CAPU_OK)
+    {
+        task.releaseReference();
+        return result;
+    }
     mCV.signal();
     return result;
 }
@@ -100,6 +156,27 @@ capu::status_t capu::ThreadPool::close(bool_t cancelThreads)
         ++it;
     }
     mClosed = true;
+
+    // futures of jobs which were not executed must not block forever
+    for (;;)
+    {
+        Job job;
+        {
+            ScopedMutexLock lock(mMutex);
+            if (mJobQueue.empty())
+            {
+                break;
+            }
+            job = mJobQueue.front();
+            mJobQueue.pop_front();
+        }
+        if (job.mTask)
+        {
+            // abandoning outside of the lock, dependent tasks try to enqueue themselves
+            job.mTask->abandon(CAPU_ERROR);
+            job.mTask->releaseReference();
+        }
+    }
     return result;
 }
 
@@ -139,10 +216,10 @@ void capu::ThreadPool::PoolRunnable::run()
     while (!isCancelRequested())
     {
         status_t result;
-        SmartPointer<Runnable> r = NULL;
+        Job job;
         {
             ScopedMutexLock lock(mPool.mMutex);
-            while (mPool.mRunnableQueue.empty() && !mPool.isClosed())
+            while (mPool.mJobQueue.empty() && !mPool.isClosed())
             {
                 if (mPool.mCloseRequested)
                 {
@@ -157,12 +234,13 @@ void capu::ThreadPool::PoolRunnable::run()
             {
                 break;
             }
-            result = mPool.mRunnableQueue.pop(&r);
+            job = mPool.mJobQueue.front();
+            result = mPool.mJobQueue.pop_front();
         }
         if (result == CAPU_OK)
         {
             mCurrentRunnableMutex.lock();
-            mCurrentRunnable = r.get();
+            mCurrentRunnable = job.mTask ? job.mTask : job.mRunnable.get();
             mCurrentRunnableMutex.unlock();
             if (mCurrentRunnable != NULL)
             {
@@ -171,15 +249,19 @@ void capu::ThreadPool::PoolRunnable::run()
                 mCurrentRunnable = NULL;
                 mCurrentRunnableMutex.unlock();
             }
+            if (job.mTask)
+            {
+                job.mTask->releaseReference();
+            }
         }
     }
 }
 
-capu::ThreadPool::PoolWorker::PoolWorker(capu::ThreadPool& pool)
+capu::ThreadPool::PoolWorker::PoolWorker(capu::ThreadPool& pool, const capu::ThreadAttributes& attributes)
     : mPool(pool)
     , mPoolRunnable(mPool)
 {
-    mValid = mThread.start(mPoolRunnable) == CAPU_OK;
+    mValid = mThread.start(mPoolRunnable, attributes) == CAPU_OK;
 }
 
 capu::ThreadPool::PoolWorker::~PoolWorker()
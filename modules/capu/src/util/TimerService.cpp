@@ -0,0 +1,355 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "capu/util/TimerService.h"
+
+#include "capu/os/Time.h"
+#include "capu/util/ScopedLock.h"
+
+const capu::TimerService::TimerId capu::TimerService::InvalidTimerId = 0;
+
+capu::TimerService::TimerNode::TimerNode()
+    : expiry(0)
+    , periodTicks(0)
+    , generation(1)
+    , next(NoNode)
+    , previous(NoNode)
+    , slot(NoNode)
+{
+}
+
+capu::TimerService::TimerThread::TimerThread(TimerService& service)
+    : mService(service)
+{
+}
+
+void capu::TimerService::TimerThread::run()
+{
+    mService.runTimers();
+}
+
+capu::TimerService::TimerService(const capu::uint32_t tickMillis, capu::ThreadPool* pool)
+    : mTickMillis(tickMillis > 0 ? tickMillis : 1)
+    , mStartMillis(Time::GetMilliseconds())
+    , mPool(pool)
+    , mCurrentTick(0)
+    , mFreeNode(NoNode)
+    , mCount(0)
+    , mCloseRequested(false)
+    , mClosed(false)
+    , mTimerThread(*this)
+{
+    for (uint32_t i = 0; i < Levels * SlotsPerLevel; ++i)
+    {
+        mSlots[i] = NoNode;
+    }
+    if (mThread.start(mTimerThread) != CAPU_OK)
+    {
+        mClosed = true;
+    }
+}
+
+capu::TimerService::~TimerService()
+{
+    close();
+}
+
+capu::status_t capu::TimerService::schedule(capu::SmartPointer<capu::Runnable> runnable, const capu::uint32_t delayMillis, TimerId* id)
+{
+    return add(runnable, delayMillis, 0, id);
+}
+
+capu::status_t capu::TimerService::schedulePeriodic(capu::SmartPointer<capu::Runnable> runnable, const capu::uint32_t delayMillis, const capu::uint32_t periodMillis, TimerId* id)
+{
+    return add(runnable, delayMillis, periodMillis > 0 ? periodMillis : 1, id);
+}
+
+capu::status_t capu::TimerService::add(capu::SmartPointer<capu::Runnable> runnable, const capu::uint32_t delayMillis, const capu::uint32_t periodMillis, TimerId* id)
+{
+    if (runnable.get() == NULL)
+    {
+        return CAPU_EINVAL;
+    }
+
+    ScopedMutexLock lock(mMutex);
+    if (mClosed || mCloseRequested)
+    {
+        return CAPU_ERROR;
+    }
+
+    if (mCount == 0)
+    {
+        // the wheel is empty and may have stopped turning, catch up with the clock
+        mCurrentTick = elapsedTicks();
+        mCondVar.signal();
+    }
+
+    const uint32_t index = allocateNode();
+    TimerNode& node = mNodes[index];
+    node.runnable = runnable;
+    // the current tick has already partly passed, one more keeps the timer from expiring early
+    node.expiry = mCurrentTick + toTicks(delayMillis) + 1;
+    node.periodTicks = periodMillis > 0 ? toTicks(periodMillis) : 0;
+    if (periodMillis > 0 && node.periodTicks == 0)
+    {
+        node.periodTicks = 1;
+    }
+    place(index);
+
+    if (id)
+    {
+        *id = (static_cast<uint64_t>(node.generation) << 32) | index;
+    }
+    return CAPU_OK;
+}
+
+capu::status_t capu::TimerService::cancel(const TimerId id)
+{
+    const uint32_t index = static_cast<uint32_t>(id);
+    const uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+    ScopedMutexLock lock(mMutex);
+    if (index >= mNodes.size() || mNodes[index].generation != generation || mNodes[index].slot == NoNode)
+    {
+        return CAPU_ERANGE;
+    }
+    unlink(index);
+    freeNode(index);
+    return CAPU_OK;
+}
+
+capu::uint_t capu::TimerService::count() const
+{
+    ScopedMutexLock lock(mMutex);
+    return mCount;
+}
+
+capu::status_t capu::TimerService::close()
+{
+    {
+        ScopedMutexLock lock(mMutex);
+        if (mClosed)
+        {
+            return CAPU_OK;
+        }
+        mCloseRequested = true;
+        mCondVar.signal();
+    }
+
+    const status_t result = mThread.join();
+
+    ScopedMutexLock lock(mMutex);
+    for (uint32_t i = 0; i < Levels * SlotsPerLevel; ++i)
+    {
+        mSlots[i] = NoNode;
+    }
+    mNodes.clear();
+    mFreeNode = NoNode;
+    mCount = 0;
+    mClosed = true;
+    return result;
+}
+
+capu::bool_t capu::TimerService::isClosed() const
+{
+    ScopedMutexLock lock(mMutex);
+    return mClosed || mCloseRequested;
+}
+
+void capu::TimerService::runTimers()
+{
+    Vector<SmartPointer<Runnable> > expired;
+
+    mMutex.lock();
+    while (!mCloseRequested)
+    {
+        const uint64_t targetTick = elapsedTicks();
+        if (mCount == 0)
+        {
+            // nothing to expire, no need to turn the wheel tick by tick
+            mCurrentTick = targetTick;
+        }
+        while (mCurrentTick < targetTick && !mCloseRequested)
+        {
+            advance(expired);
+            if (expired.size() > 0)
+            {
+                // run without the lock, runnables may schedule and cancel timers
+                mMutex.unlock();
+                for (uint32_t i = 0; i < expired.size(); ++i)
+                {
+                    if (!mPool || mPool->add(expired[i]) != CAPU_OK)
+                    {
+                        expired[i]->run();
+                    }
+                }
+                expired.clear();
+                mMutex.lock();
+            }
+        }
+
+        if (!mCloseRequested)
+        {
+            // sleep until the next tick, or until the first timer is scheduled
+            mCondVar.wait(&mMutex, mCount > 0 ? mTickMillis : 0);
+        }
+    }
+    mMutex.unlock();
+}
+
+capu::uint64_t capu::TimerService::elapsedTicks() const
+{
+    return (Time::GetMilliseconds() - mStartMillis) / mTickMillis;
+}
+
+capu::uint64_t capu::TimerService::toTicks(const capu::uint32_t millis) const
+{
+    return (static_cast<uint64_t>(millis) + mTickMillis - 1) / mTickMillis;
+}
+
+void capu::TimerService::advance(capu::Vector<capu::SmartPointer<capu::Runnable> >& expired)
+{
+    ++mCurrentTick;
+
+    // whenever a level wraps around, the next slot of the level above is spread over the lower levels
+    for (uint32_t level = 1; level < Levels; ++level)
+    {
+        if ((mCurrentTick & ((static_cast<uint64_t>(1) << (SlotBits * level)) - 1)) != 0)
+        {
+            break;
+        }
+        cascade(level);
+    }
+
+    // every timer in the current slot of the lowest level expires now
+    const uint32_t slot = static_cast<uint32_t>(mCurrentTick & SlotMask);
+    uint32_t index = mSlots[slot];
+    mSlots[slot] = NoNode;
+    while (index != NoNode)
+    {
+        TimerNode& node = mNodes[index];
+        const uint32_t next = node.next;
+        node.slot = NoNode;
+        expired.push_back(node.runnable);
+        if (node.periodTicks > 0)
+        {
+            node.expiry += node.periodTicks;
+            if (node.expiry <= mCurrentTick)
+            {
+                node.expiry = mCurrentTick + 1;
+            }
+            place(index);
+        }
+        else
+        {
+            freeNode(index);
+        }
+        index = next;
+    }
+}
+
+void capu::TimerService::cascade(const capu::uint32_t level)
+{
+    const uint32_t slot = level * SlotsPerLevel + static_cast<uint32_t>((mCurrentTick >> (SlotBits * level)) & SlotMask);
+    uint32_t index = mSlots[slot];
+    mSlots[slot] = NoNode;
+    while (index != NoNode)
+    {
+        const uint32_t next = mNodes[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+void capu::TimerService::place(const capu::uint32_t index)
+{
+    const uint64_t expiry = mNodes[index].expiry;
+    const uint64_t delta = expiry > mCurrentTick ? expiry - mCurrentTick : 0;
+
+    uint32_t level = 0;
+    while (level + 1 < Levels && delta >= (static_cast<uint64_t>(1) << (SlotBits * (level + 1))))
+    {
+        ++level;
+    }
+
+    uint64_t slotTick = expiry;
+    if (delta >= (static_cast<uint64_t>(1) << (SlotBits * Levels)))
+    {
+        // beyond the range of the wheel, park in the top slot which comes around last and place again then
+        slotTick = mCurrentTick - (static_cast<uint64_t>(1) << (SlotBits * level));
+    }
+    link(index, level * SlotsPerLevel + static_cast<uint32_t>((slotTick >> (SlotBits * level)) & SlotMask));
+}
+
+void capu::TimerService::link(const capu::uint32_t index, const capu::uint32_t slot)
+{
+    TimerNode& node = mNodes[index];
+    node.slot = slot;
+    node.previous = NoNode;
+    node.next = mSlots[slot];
+    if (node.next != NoNode)
+    {
+        mNodes[node.next].previous = index;
+    }
+    mSlots[slot] = index;
+}
+
+void capu::TimerService::unlink(const capu::uint32_t index)
+{
+    TimerNode& node = mNodes[index];
+    if (node.previous != NoNode)
+    {
+        mNodes[node.previous].next = node.next;
+    }
+    else
+    {
+        mSlots[node.slot] = node.next;
+    }
+    if (node.next != NoNode)
+    {
+        mNodes[node.next].previous = node.previous;
+    }
+    node.slot = NoNode;
+}
+
+capu::uint32_t capu::TimerService::allocateNode()
+{
+    ++mCount;
+    if (mFreeNode != NoNode)
+    {
+        const uint32_t index = mFreeNode;
+        mFreeNode = mNodes[index].next;
+        return index;
+    }
+    mNodes.push_back(TimerNode());
+    return mNodes.size() - 1;
+}
+
+void capu::TimerService::freeNode(const capu::uint32_t index)
+{
+    TimerNode& node = mNodes[index];
+    node.runnable = SmartPointer<Runnable>();
+    node.slot = NoNode;
+    // ids of the old timer become invalid, 0 is skipped so no id equals InvalidTimerId
+    if (++node.generation == 0)
+    {
+        node.generation = 1;
+    }
+    node.next = mFreeNode;
+    mFreeNode = index;
+    --mCount;
+}
@@ -19,6 +19,8 @@
 #include "capu/Error.h"
 #include "capu/Config.h"
 #include "capu/util/Swap.h"
+#include "capu/os/NumericLimits.h"
+#include "capu/container/String.h"
 
 class ComplexCopyable
 {
@@ -458,3 +460,80 @@ TEST(Array, SetRawData)
     EXPECT_EQ(0u, array[1]);
     EXPECT_EQ(0u, array[2]);
 }
+
+TEST(Array, AlignedStorage)
+{
+    capu::Array<capu::uint32_t, capu::AlignedArrayStorage<capu::uint32_t> > array(100, 5);
+    EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(array.getRawData()) % CAPU_CACHE_LINE_SIZE);
+    EXPECT_EQ(100u, array.size());
+    EXPECT_EQ(5u, array[99]);
+
+    capu::Array<capu::uint32_t, capu::AlignedArrayStorage<capu::uint32_t, 4096> > pageAligned(10);
+    EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(pageAligned.getRawData()) % 4096);
+
+    capu::Array<capu::uint32_t, capu::AlignedArrayStorage<capu::uint32_t> > copy(array);
+    EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(copy.getRawData()) % CAPU_CACHE_LINE_SIZE);
+    EXPECT_EQ(5u, copy[50]);
+
+    copy.setSize(1000);
+    EXPECT_EQ(1000u, copy.size());
+    EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(copy.getRawData()) % CAPU_CACHE_LINE_SIZE);
+}
+
+TEST(Array, AlignedStorageWithObjects)
+{
+    capu::Array<ComplexCopyable, capu::AlignedArrayStorage<ComplexCopyable> > array(10, ComplexCopyable(42));
+    EXPECT_EQ(42, array[9].getValueByPtr());
+
+    capu::Array<ComplexCopyable, capu::AlignedArrayStorage<ComplexCopyable> > other;
+    other = array;
+    EXPECT_EQ(10u, other.size());
+    EXPECT_EQ(42, other[3].getValueByPtr());
+}
+
+TEST(Array, HugePageStorage)
+{
+    const capu::uint_t size = 1024 * 1024;
+    capu::Array<capu::uint32_t, capu::HugePageArrayStorage<capu::uint32_t> > array(size, 3);
+    EXPECT_EQ(size, array.size());
+    EXPECT_EQ(3u, array[0]);
+    EXPECT_EQ(3u, array[size - 1]);
+
+    capu::Array<capu::uint32_t, capu::HugePageArrayStorage<capu::uint32_t> > empty;
+    EXPECT_EQ(0u, empty.size());
+    empty.swap(array);
+    EXPECT_EQ(size, empty.size());
+    EXPECT_EQ(0u, array.size());
+}
+
+
+TEST(Array, FailedAllocationLeavesArrayEmpty)
+{
+    // far beyond any address space, the storage returns no memory
+    const capu::uint_t size = capu::NumericLimits::Max<capu::uint_t>() / 2;
+
+    capu::Array<capu::uint8_t, capu::AlignedArrayStorage<capu::uint8_t> > aligned(size, 7);
+    EXPECT_EQ(0u, aligned.size());
+    EXPECT_TRUE(aligned.getRawData() == NULL);
+
+    capu::Array<capu::uint8_t, capu::HugePageArrayStorage<capu::uint8_t> > huge(size);
+    EXPECT_EQ(0u, huge.size());
+    EXPECT_TRUE(huge.getRawData() == NULL);
+
+    capu::Array<capu::uint8_t, capu::HugePageArrayStorage<capu::uint8_t> > copy(huge);
+    EXPECT_EQ(0u, copy.size());
+}
+
+TEST(Array, AllocationSizeOverflowLeavesArrayEmpty)
+{
+    // the byte count of this many elements wraps around to a small allocation
+    const capu::uint_t size = capu::NumericLimits::Max<capu::uint_t>() / sizeof(capu::String) + 2;
+
+    capu::Array<capu::String, capu::AlignedArrayStorage<capu::String> > aligned(size);
+    EXPECT_EQ(0u, aligned.size());
+    EXPECT_TRUE(aligned.getRawData() == NULL);
+
+    capu::Array<capu::String, capu::HugePageArrayStorage<capu::String> > huge(size);
+    EXPECT_EQ(0u, huge.size());
+    EXPECT_TRUE(huge.getRawData() == NULL);
+}
@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/container/BTreeMap.h"
+#include "capu/container/HashTable.h"
+#include "capu/container/String.h"
+#include "capu/os/Time.h"
+#include "capu/util/StaticAllocator.h"
+#include <algorithm>
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        typedef BTreeMap<uint32_t, uint32_t> UInt32Map;
+
+        uint32_t NextRandom(uint32_t& random)
+        {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return random;
+        }
+
+        // checks the order of the map and that it holds exactly the keys marked in contained
+        void ExpectContent(const UInt32Map& map, const bool_t* contained, const uint32_t range)
+        {
+            uint32_t expectedCount = 0;
+            for (uint32_t key = 0; key < range; ++key)
+            {
+                if (contained[key])
+                {
+                    ++expectedCount;
+                }
+                ASSERT_EQ(contained[key], map.contains(key));
+            }
+            ASSERT_EQ(expectedCount, map.count());
+
+            uint32_t iterated = 0;
+            uint32_t previous = 0;
+            for (UInt32Map::ConstIterator it = map.begin(); it != map.end(); ++it)
+            {
+                if (iterated > 0)
+                {
+                    ASSERT_LT(previous, it->key);
+                }
+                ASSERT_EQ(it->key * 3, it->value);
+                previous = it->key;
+                ++iterated;
+            }
+            ASSERT_EQ(expectedCount, iterated);
+        }
+    }
+
+    TEST(BTreeMap, empty)
+    {
+        UInt32Map map;
+        EXPECT_EQ(0u, map.count());
+        EXPECT_TRUE(map.begin() == map.end());
+        EXPECT_TRUE(map.lowerBound(1) == map.end());
+        EXPECT_TRUE(map.find(1) == map.end());
+        EXPECT_FALSE(map.contains(1));
+        EXPECT_EQ(CAPU_ERANGE, map.remove(1));
+
+        status_t result = CAPU_OK;
+        EXPECT_EQ(0u, map.at(1, &result));
+        EXPECT_EQ(CAPU_ENOT_EXIST, result);
+    }
+
+    TEST(BTreeMap, putAtRemove)
+    {
+        UInt32Map map;
+        EXPECT_EQ(CAPU_OK, map.put(5, 50));
+        EXPECT_EQ(CAPU_OK, map.put(3, 30));
+
+        uint32_t oldValue = 0;
+        EXPECT_EQ(CAPU_OK, map.put(5, 51, &oldValue));
+        EXPECT_EQ(50u, oldValue);
+        EXPECT_EQ(2u, map.count());
+
+        status_t result = CAPU_ERROR;
+        EXPECT_EQ(51u, map.at(5, &result));
+        EXPECT_EQ(CAPU_OK, result);
+        map.at(3) = 31;
+        EXPECT_EQ(31u, map.find(3)->value);
+
+        EXPECT_EQ(CAPU_OK, map.remove(3, &oldValue));
+        EXPECT_EQ(31u, oldValue);
+        EXPECT_FALSE(map.contains(3));
+        EXPECT_EQ(CAPU_ERANGE, map.remove(3));
+        EXPECT_EQ(CAPU_OK, map.remove(5));
+        EXPECT_TRUE(map.begin() == map.end());
+    }
+
+    TEST(BTreeMap, constAccess)
+    {
+        UInt32Map map;
+        EXPECT_EQ(CAPU_OK, map.put(3, 30));
+        EXPECT_EQ(CAPU_OK, map.put(7, 70));
+
+        const UInt32Map& constMap = map;
+        const uint32_t& value = constMap.at(3);
+        EXPECT_EQ(30u, value);
+        EXPECT_EQ(30u, constMap.find(3)->value);
+        EXPECT_EQ(70u, constMap.lowerBound(4)->value);
+
+        // a const iterator can be compared with an iterator after conversion
+        UInt32Map::ConstIterator it = map.begin();
+        EXPECT_TRUE(it == constMap.begin());
+        ++it;
+        EXPECT_EQ(7u, it->key);
+        EXPECT_TRUE(++it == constMap.end());
+    }
+
+    TEST(BTreeMap, writingMissingValueDoesNotChangeMap)
+    {
+        UInt32Map map;
+        status_t result = CAPU_OK;
+        map.at(4, &result) = 40;
+        EXPECT_EQ(CAPU_ENOT_EXIST, result);
+        EXPECT_FALSE(map.contains(4));
+        EXPECT_EQ(0u, map.at(4));
+
+        const UInt32Map& constMap = map;
+        EXPECT_EQ(0u, constMap.at(5));
+    }
+
+    TEST(BTreeMap, randomPutAndRemove)
+    {
+        const uint32_t range = 5000;
+        bool_t contained[range] = {};
+        UInt32Map map;
+        uint32_t random = 7;
+
+        for (uint32_t round = 0; round < 4; ++round)
+        {
+            // grow to several levels, then shrink to a few entries again
+            for (uint32_t i = 0; i < 20000; ++i)
+            {
+                const uint32_t key = NextRandom(random) % range;
+                const bool_t insert = NextRandom(random) % 4 != 0;
+                if (insert)
+                {
+                    EXPECT_EQ(CAPU_OK, map.put(key, key * 3));
+                    contained[key] = true;
+                }
+                else
+                {
+                    EXPECT_EQ(contained[key] ? CAPU_OK : CAPU_ERANGE, map.remove(key));
+                    contained[key] = false;
+                }
+            }
+            ExpectContent(map, contained, range);
+
+            for (uint32_t key = 0; key < range; ++key)
+            {
+                if (contained[key] && key % 50 != 0)
+                {
+                    EXPECT_EQ(CAPU_OK, map.remove(key));
+                    contained[key] = false;
+                }
+            }
+            ExpectContent(map, contained, range);
+        }
+    }
+
+    TEST(BTreeMap, bounds)
+    {
+        UInt32Map map;
+        for (uint32_t key = 0; key < 10000; key += 10)
+        {
+            map.put(key, key * 3);
+        }
+
+        EXPECT_EQ(0u, map.lowerBound(0)->key);
+        EXPECT_EQ(10u, map.upperBound(0)->key);
+        EXPECT_EQ(2510u, map.lowerBound(2501)->key);
+        EXPECT_EQ(2510u, map.lowerBound(2510)->key);
+        EXPECT_EQ(2520u, map.upperBound(2510)->key);
+        EXPECT_TRUE(map.lowerBound(9991) == map.end());
+        EXPECT_TRUE(map.upperBound(9990) == map.end());
+
+        // all keys in [1000, 2000]
+        uint32_t count = 0;
+        UInt32Map::Iterator end = map.upperBound(2000);
+        for (UInt32Map::Iterator it = map.lowerBound(1000); it != end; it++)
+        {
+            EXPECT_EQ(1000u + count * 10, it->key);
+            ++count;
+        }
+        EXPECT_EQ(101u, count);
+    }
+
+    TEST(BTreeMap, load)
+    {
+        const uint32_t count = 3000;
+        uint32_t keys[count];
+        uint32_t values[count];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            keys[i] = i * 2;
+            values[i] = i * 6;
+        }
+
+        UInt32Map map;
+        map.put(1, 3);
+        EXPECT_EQ(CAPU_OK, map.load(keys, values, count));
+        bool_t contained[2 * count] = {};
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            contained[i * 2] = true;
+        }
+        ExpectContent(map, contained, 2 * count);
+
+        // the loaded tree can be changed like any other
+        for (uint32_t i = 0; i < 2 * count; ++i)
+        {
+            if (i % 3 == 0)
+            {
+                map.put(i, i * 3);
+                contained[i] = true;
+            }
+            else if (contained[i] && i % 4 == 0)
+            {
+                map.remove(i);
+                contained[i] = false;
+            }
+        }
+        ExpectContent(map, contained, 2 * count);
+
+        // keys must be strictly ascending
+        keys[10] = keys[9];
+        EXPECT_EQ(CAPU_EINVAL, map.load(keys, values, count));
+        ExpectContent(map, contained, 2 * count);
+
+        EXPECT_EQ(CAPU_OK, map.load(keys, values, 0));
+        EXPECT_EQ(0u, map.count());
+    }
+
+    TEST(BTreeMap, copy)
+    {
+        UInt32Map map;
+        for (uint32_t key = 0; key < 1000; ++key)
+        {
+            map.put(key, key * 3);
+        }
+        UInt32Map copy(map);
+        map.remove(5);
+        EXPECT_TRUE(copy.contains(5));
+        EXPECT_EQ(1000u, copy.count());
+
+        UInt32Map assigned;
+        assigned.put(2000, 6000);
+        assigned = map;
+        EXPECT_FALSE(assigned.contains(2000));
+        EXPECT_FALSE(assigned.contains(5));
+        EXPECT_EQ(999u, assigned.count());
+    }
+
+    TEST(BTreeMap, stringKeys)
+    {
+        BTreeMap<String, int32_t> map;
+        map.put("pear", 3);
+        map.put("apple", 1);
+        map.put("banana", 2);
+
+        BTreeMap<String, int32_t>::Iterator it = map.begin();
+        EXPECT_STREQ("apple", it->key.c_str());
+        ++it;
+        EXPECT_STREQ("banana", it->key.c_str());
+        ++it;
+        EXPECT_STREQ("pear", it->key.c_str());
+        EXPECT_STREQ("banana", map.lowerBound("b")->key.c_str());
+    }
+
+    TEST(BTreeMap, staticAllocator)
+    {
+        typedef BTreeMap<uint32_t, uint32_t, LessComparator,
+            StaticAllocator<BTreeLeafNode<uint32_t, uint32_t>, 4>,
+            StaticAllocator<BTreeInnerNode<uint32_t>, 1> > StaticMap;
+        StaticMap map;
+
+        // the nodes run out at some point, the map stays usable
+        uint32_t key = 0;
+        while (map.put(key, key * 3) == CAPU_OK)
+        {
+            ++key;
+        }
+        const uint32_t leafCapacity = BTreeLeafNode<uint32_t, uint32_t>::Capacity;
+        EXPECT_GT(key, leafCapacity);
+        EXPECT_EQ(key, map.count());
+        for (uint32_t i = 0; i < key; ++i)
+        {
+            EXPECT_EQ(i * 3, map.at(i));
+        }
+        EXPECT_FALSE(map.contains(key));
+    }
+
+    TEST(BTreeMap, performanceLookupCompareWithHashTable)
+    {
+        const uint32_t count = 1000000;
+        const uint32_t lookups = 5000000;
+
+        HashTable<uint32_t, uint32_t> table;
+        UInt32Map map;
+        uint32_t random = 1;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t key = NextRandom(random);
+            table.put(key, i);
+            map.put(key, i);
+        }
+
+        random = 1;
+        uint64_t start = Time::GetMilliseconds();
+        uint32_t tableSum = 0;
+        for (uint32_t i = 0; i < lookups; ++i)
+        {
+            tableSum += table.at(NextRandom(random) % 2 == 0 ? random : random + 1);
+        }
+        const uint64_t tableTime = Time::GetMilliseconds() - start;
+
+        random = 1;
+        start = Time::GetMilliseconds();
+        uint32_t mapSum = 0;
+        for (uint32_t i = 0; i < lookups; ++i)
+        {
+            mapSum += map.at(NextRandom(random) % 2 == 0 ? random : random + 1);
+        }
+        const uint64_t mapTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(tableSum, mapSum);
+
+        printf("%u point lookups in %u entries: HashTable %u ms, BTreeMap %u ms\n",
+            lookups, count, static_cast<uint32_t>(tableTime), static_cast<uint32_t>(mapTime));
+    }
+
+    TEST(BTreeMap, performanceRangeScanCompareWithSorting)
+    {
+        // a table which changes between the scans, so sorted data can not be kept
+        const uint32_t count = 200000;
+        const uint32_t scans = 100;
+        const uint32_t range = 0x00100000; // about 1/4000 of the key space
+
+        HashTable<uint32_t, uint32_t> table;
+        UInt32Map map;
+        uint32_t random = 1;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t key = NextRandom(random);
+            table.put(key, i);
+            map.put(key, i);
+        }
+
+        uint64_t start = Time::GetMilliseconds();
+        uint32_t sortedSum = 0;
+        uint32_t* keys = new uint32_t[count + scans];
+        for (uint32_t scan = 0; scan < scans; ++scan)
+        {
+            const uint32_t from = scan * (0xFFFFFFFFu / scans);
+            table.put(from, scan);
+            uint32_t size = 0;
+            for (HashTable<uint32_t, uint32_t>::Iterator it = table.begin(); it != table.end(); ++it)
+            {
+                keys[size++] = it->key;
+            }
+            std::sort(keys, keys + size);
+            for (uint32_t* current = std::lower_bound(keys, keys + size, from); current != keys + size && *current <= from + range; ++current)
+            {
+                sortedSum += table.at(*current);
+            }
+        }
+        delete[] keys;
+        const uint64_t sortedTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        uint32_t mapSum = 0;
+        for (uint32_t scan = 0; scan < scans; ++scan)
+        {
+            const uint32_t from = scan * (0xFFFFFFFFu / scans);
+            map.put(from, scan);
+            const UInt32Map::Iterator end = map.upperBound(from + range);
+            for (UInt32Map::Iterator it = map.lowerBound(from); it != end; ++it)
+            {
+                mapSum += it->value;
+            }
+        }
+        const uint64_t mapTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(sortedSum, mapSum);
+
+        printf("%u range scans in %u entries: copying and sorting a HashTable %u ms, BTreeMap %u ms\n",
+            scans, count, static_cast<uint32_t>(sortedTime), static_cast<uint32_t>(mapTime));
+    }
+
+    TEST(BTreeMap, performanceLoadCompareWithPut)
+    {
+        const uint32_t count = 1000000;
+        uint32_t* keys = new uint32_t[count];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            keys[i] = i * 7;
+        }
+
+        uint64_t start = Time::GetMilliseconds();
+        UInt32Map putMap;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            putMap.put(keys[i], keys[i]);
+        }
+        const uint64_t putTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        UInt32Map loadMap;
+        EXPECT_EQ(CAPU_OK, loadMap.load(keys, keys, count));
+        const uint64_t loadTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(count, loadMap.count());
+        delete[] keys;
+
+        printf("%u sorted entries: put one by one %u ms, load %u ms\n",
+            count, static_cast<uint32_t>(putTime), static_cast<uint32_t>(loadTime));
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/container/BTreeSet.h"
+#include "capu/container/String.h"
+
+namespace capu
+{
+    TEST(BTreeSet, putRemoveHasElement)
+    {
+        BTreeSet<int32_t> set;
+        EXPECT_EQ(CAPU_OK, set.put(3));
+        EXPECT_EQ(CAPU_OK, set.put(-1));
+        EXPECT_EQ(CAPU_ERROR, set.put(3));
+        EXPECT_EQ(2u, set.count());
+        EXPECT_TRUE(set.hasElement(-1));
+        EXPECT_FALSE(set.hasElement(0));
+
+        EXPECT_EQ(CAPU_OK, set.remove(-1));
+        EXPECT_EQ(CAPU_ERANGE, set.remove(-1));
+        EXPECT_EQ(1u, set.count());
+
+        set.clear();
+        EXPECT_EQ(0u, set.count());
+        EXPECT_TRUE(set.begin() == set.end());
+    }
+
+    TEST(BTreeSet, sortedIteration)
+    {
+        BTreeSet<uint32_t> set;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            set.put((i * 7919) % 1000);
+        }
+
+        uint32_t expected = 0;
+        for (BTreeSet<uint32_t>::Iterator it = set.begin(); it != set.end(); ++it)
+        {
+            EXPECT_EQ(expected, *it);
+            ++expected;
+        }
+        EXPECT_EQ(1000u, expected);
+    }
+
+    TEST(BTreeSet, bounds)
+    {
+        BTreeSet<String> set;
+        set.put("b");
+        set.put("d");
+        set.put("f");
+
+        EXPECT_STREQ("d", set.lowerBound("c")->c_str());
+        EXPECT_STREQ("d", set.lowerBound("d")->c_str());
+        EXPECT_STREQ("f", set.upperBound("d")->c_str());
+        EXPECT_TRUE(set.upperBound("f") == set.end());
+    }
+
+    TEST(BTreeSet, load)
+    {
+        uint32_t values[500];
+        for (uint32_t i = 0; i < 500; ++i)
+        {
+            values[i] = i * 2;
+        }
+
+        BTreeSet<uint32_t> set;
+        EXPECT_EQ(CAPU_OK, set.load(values, 500));
+        EXPECT_EQ(500u, set.count());
+        EXPECT_TRUE(set.hasElement(998));
+        EXPECT_FALSE(set.hasElement(999));
+        EXPECT_EQ(100u, *set.lowerBound(99));
+
+        values[1] = 0;
+        EXPECT_EQ(CAPU_EINVAL, set.load(values, 500));
+        EXPECT_EQ(500u, set.count());
+    }
+}
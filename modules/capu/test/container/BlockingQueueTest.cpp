@@ -168,3 +168,19 @@ TEST(BlockingQueue, StaticMemory)
     EXPECT_EQ(capu::CAPU_ENO_MEMORY, queue.push(4));
     EXPECT_EQ(3, queue.size());
 }
+
+TEST(BlockingQueue, DequeStorage)
+{
+    capu::BlockingQueue<capu::int32_t, capu::Allocator<capu::GenericListNode<capu::int32_t> >, capu::Comparator, capu::Deque<capu::int32_t> > queue;
+    EXPECT_TRUE(queue.empty());
+    queue.push(3);
+    queue.push(4);
+    EXPECT_EQ(2u, queue.size());
+
+    capu::int32_t val = 0;
+    EXPECT_EQ(capu::CAPU_OK, queue.pop(&val));
+    EXPECT_EQ(3, val);
+    EXPECT_EQ(capu::CAPU_OK, queue.pop(&val));
+    EXPECT_EQ(4, val);
+    EXPECT_EQ(capu::CAPU_ETIMEOUT, queue.pop(&val, 10));
+}
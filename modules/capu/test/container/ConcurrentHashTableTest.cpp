@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/container/ConcurrentHashTable.h"
+#include "capu/container/String.h"
+#include "capu/os/Thread.h"
+#include "capu/os/Time.h"
+#include "capu/util/Runnable.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        typedef ConcurrentHashTable<uint32_t, uint32_t> Table;
+
+        struct Increment
+        {
+            bool_t operator()(uint32_t& value)
+            {
+                ++value;
+                return true;
+            }
+        };
+
+        struct RemoveOdd
+        {
+            bool_t operator()(uint32_t& value)
+            {
+                return value % 2 == 0;
+            }
+        };
+
+        class Incrementer: public Runnable
+        {
+        public:
+            Incrementer()
+                : table(0)
+                , count(0)
+            {
+            }
+
+            void run()
+            {
+                Increment increment;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const uint32_t key = i % 100;
+                    if (table->putIfAbsent(key, 1) != CAPU_OK)
+                    {
+                        table->computeIfPresent(key, increment);
+                    }
+                }
+            }
+
+            Table* table;
+            uint32_t count;
+        };
+
+        // a HashTable behind one lock, which is what ConcurrentHashTable replaces
+        class LockedTable
+        {
+        public:
+            status_t get(const uint32_t key, uint32_t& value)
+            {
+                ScopedMutexLock lock(mMutex);
+                status_t result = CAPU_OK;
+                value = mTable.at(key, &result);
+                return result;
+            }
+
+            status_t put(const uint32_t key, const uint32_t value)
+            {
+                ScopedMutexLock lock(mMutex);
+                return mTable.put(key, value);
+            }
+
+        private:
+            Mutex mMutex;
+            HashTable<uint32_t, uint32_t> mTable;
+        };
+
+        template <class TABLE>
+        class MixedWorker: public Runnable
+        {
+        public:
+            MixedWorker()
+                : table(0)
+                , seed(0)
+                , operations(0)
+                , found(0)
+            {
+            }
+
+            void run()
+            {
+                uint32_t random = seed;
+                for (uint32_t i = 0; i < operations; ++i)
+                {
+                    random ^= random << 13;
+                    random ^= random >> 17;
+                    random ^= random << 5;
+                    const uint32_t key = random % 100000;
+                    uint32_t value = 0;
+                    if (random % 10 == 0)
+                    {
+                        // one write for nine reads
+                        table->put(key, i);
+                    }
+                    else if (table->get(key, value) == CAPU_OK)
+                    {
+                        ++found;
+                    }
+                }
+            }
+
+            TABLE* table;
+            uint32_t seed;
+            uint32_t operations;
+            uint32_t found;
+        };
+
+        template <class TABLE>
+        uint64_t RunMixed(TABLE& table, const uint32_t threadCount, const uint32_t operations)
+        {
+            MixedWorker<TABLE>* workers = new MixedWorker<TABLE>[threadCount];
+            Thread* threads = new Thread[threadCount];
+
+            const uint64_t start = Time::GetMilliseconds();
+            for (uint32_t i = 0; i < threadCount; ++i)
+            {
+                workers[i].table = &table;
+                workers[i].seed = 2463534242u + i * 7919;
+                workers[i].operations = operations;
+                threads[i].start(workers[i]);
+            }
+            for (uint32_t i = 0; i < threadCount; ++i)
+            {
+                threads[i].join();
+            }
+            const uint64_t time = Time::GetMilliseconds() - start;
+
+            delete[] threads;
+            delete[] workers;
+            return time;
+        }
+    }
+
+    TEST(ConcurrentHashTable, putGetRemove)
+    {
+        Table table;
+        EXPECT_EQ(0u, table.count());
+        EXPECT_EQ(CAPU_OK, table.put(1, 10));
+        EXPECT_EQ(CAPU_OK, table.put(2, 20));
+
+        uint32_t value = 0;
+        EXPECT_EQ(CAPU_OK, table.get(1, value));
+        EXPECT_EQ(10u, value);
+        EXPECT_EQ(CAPU_ENOT_EXIST, table.get(3, value));
+        EXPECT_TRUE(table.contains(2));
+        EXPECT_FALSE(table.contains(3));
+
+        EXPECT_EQ(CAPU_OK, table.put(1, 11, &value));
+        EXPECT_EQ(10u, value);
+        EXPECT_EQ(2u, table.count());
+
+        EXPECT_EQ(CAPU_OK, table.remove(1, &value));
+        EXPECT_EQ(11u, value);
+        EXPECT_EQ(CAPU_ERANGE, table.remove(1));
+        EXPECT_FALSE(table.contains(1));
+
+        table.clear();
+        EXPECT_EQ(0u, table.count());
+        EXPECT_FALSE(table.contains(2));
+    }
+
+    TEST(ConcurrentHashTable, putIfAbsent)
+    {
+        ConcurrentHashTable<String, uint32_t> table;
+        EXPECT_EQ(CAPU_OK, table.putIfAbsent("one", 1));
+
+        uint32_t existing = 0;
+        EXPECT_EQ(CAPU_ERROR, table.putIfAbsent("one", 2, &existing));
+        EXPECT_EQ(1u, existing);
+
+        uint32_t value = 0;
+        EXPECT_EQ(CAPU_OK, table.get("one", value));
+        EXPECT_EQ(1u, value);
+    }
+
+    TEST(ConcurrentHashTable, computeIfPresent)
+    {
+        Table table(0); // a single segment works as well
+        Increment increment;
+        EXPECT_EQ(CAPU_ENOT_EXIST, table.computeIfPresent(1, increment));
+
+        table.put(1, 1);
+        table.put(2, 2);
+        EXPECT_EQ(CAPU_OK, table.computeIfPresent(1, increment));
+        uint32_t value = 0;
+        table.get(1, value);
+        EXPECT_EQ(2u, value);
+
+        // returning false removes the entry
+        RemoveOdd removeOdd;
+        table.put(3, 3);
+        EXPECT_EQ(CAPU_OK, table.computeIfPresent(3, removeOdd));
+        EXPECT_FALSE(table.contains(3));
+        EXPECT_EQ(CAPU_OK, table.computeIfPresent(2, removeOdd));
+        EXPECT_TRUE(table.contains(2));
+    }
+
+    TEST(ConcurrentHashTable, iterator)
+    {
+        Table table;
+        EXPECT_TRUE(table.begin() == table.end());
+
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            table.put(i, i * 2);
+        }
+
+        uint32_t iterated = 0;
+        bool_t seen[1000] = {};
+        for (Table::Iterator it = table.begin(); it != table.end(); ++it)
+        {
+            // keys put while iterating may or may not be returned
+            if (it->key >= 1000)
+            {
+                continue;
+            }
+            EXPECT_EQ(it->key * 2, (*it).value);
+            EXPECT_FALSE(seen[it->key]);
+            seen[it->key] = true;
+            ++iterated;
+
+            // changes while iterating do not break the iteration
+            table.remove(it->key);
+            table.put(it->key + 1000, 0);
+        }
+        EXPECT_EQ(1000u, iterated);
+        EXPECT_EQ(1000u, table.count());
+    }
+
+    TEST(ConcurrentHashTable, concurrentUpdates)
+    {
+        Table table;
+        const uint32_t threadCount = 8;
+        Incrementer incrementers[threadCount];
+        Thread threads[threadCount];
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            incrementers[i].table = &table;
+            incrementers[i].count = 10000;
+            threads[i].start(incrementers[i]);
+        }
+        for (uint32_t i = 0; i < threadCount; ++i)
+        {
+            threads[i].join();
+        }
+
+        // no increment got lost
+        EXPECT_EQ(100u, table.count());
+        for (uint32_t key = 0; key < 100; ++key)
+        {
+            uint32_t value = 0;
+            EXPECT_EQ(CAPU_OK, table.get(key, value));
+            EXPECT_EQ(threadCount * 100u, value);
+        }
+    }
+
+    TEST(ConcurrentHashTable, performanceScaling)
+    {
+        const uint32_t operations = 50000;
+        for (uint32_t threadCount = 1; threadCount <= 64; threadCount *= 2)
+        {
+            LockedTable lockedTable;
+            Table concurrentTable(6);
+            for (uint32_t key = 0; key < 100000; key += 2)
+            {
+                lockedTable.put(key, key);
+                concurrentTable.put(key, key);
+            }
+
+            const uint64_t lockedTime = RunMixed(lockedTable, threadCount, operations);
+            const uint64_t concurrentTime = RunMixed(concurrentTable, threadCount, operations);
+            printf("%2u threads with %u operations each, 10%% writes: HashTable with Mutex %u ms, ConcurrentHashTable %u ms\n",
+                threadCount, operations, static_cast<uint32_t>(lockedTime), static_cast<uint32_t>(concurrentTime));
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "capu/container/Deque.h"
+#include "capu/container/Queue.h"
+#include "capu/container/String.h"
+
+TEST(Deque, Constructor)
+{
+    capu::Deque<capu::int32_t> deque;
+    EXPECT_TRUE(deque.isEmpty());
+    EXPECT_TRUE(deque.empty());
+    EXPECT_EQ(0u, deque.size());
+}
+
+TEST(Deque, PushBackPopFront)
+{
+    capu::Deque<capu::uint32_t, 4> deque;
+    for (capu::uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, deque.push_back(i));
+        EXPECT_EQ(i, deque.back());
+        EXPECT_EQ(0u, deque.front());
+    }
+    EXPECT_EQ(100u, deque.size());
+
+    for (capu::uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, deque.front());
+        EXPECT_EQ(capu::CAPU_OK, deque.pop_front());
+    }
+    EXPECT_TRUE(deque.isEmpty());
+    EXPECT_EQ(capu::CAPU_EINVAL, deque.pop_front());
+}
+
+TEST(Deque, PushFrontPopBack)
+{
+    capu::Deque<capu::uint32_t, 4> deque;
+    for (capu::uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, deque.push_front(i));
+        EXPECT_EQ(i, deque.front());
+        EXPECT_EQ(0u, deque.back());
+    }
+    EXPECT_EQ(100u, deque.size());
+
+    for (capu::uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, deque.back());
+        EXPECT_EQ(capu::CAPU_OK, deque.pop_back());
+    }
+    EXPECT_TRUE(deque.isEmpty());
+    EXPECT_EQ(capu::CAPU_EINVAL, deque.pop_back());
+}
+
+TEST(Deque, MixedEnds)
+{
+    capu::Deque<capu::int32_t, 3> deque;
+    for (capu::int32_t i = 1; i <= 20; ++i)
+    {
+        deque.push_back(i);
+        deque.push_front(-i);
+    }
+    EXPECT_EQ(40u, deque.size());
+    for (capu::int32_t i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(-20 + i, deque[i]);
+        EXPECT_EQ(i + 1, deque[20 + i]);
+    }
+
+    // drain from the back across the middle and refill from the front
+    for (capu::int32_t i = 0; i < 30; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, deque.pop_back());
+    }
+    EXPECT_EQ(-11, deque.back());
+    for (capu::int32_t i = 0; i < 30; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, deque.push_front(100 + i));
+    }
+    EXPECT_EQ(40u, deque.size());
+    EXPECT_EQ(129, deque.front());
+    EXPECT_EQ(-11, deque.back());
+}
+
+TEST(Deque, SteadyLevel)
+{
+    // the same chunks are recycled while the fill level stays constant
+    capu::Deque<capu::uint32_t, 8> deque;
+    for (capu::uint32_t i = 0; i < 5; ++i)
+    {
+        deque.push_back(i);
+    }
+    for (capu::uint32_t i = 5; i < 1000; ++i)
+    {
+        EXPECT_EQ(i - 5, deque.front());
+        deque.pop_front();
+        deque.push_back(i);
+    }
+    EXPECT_EQ(5u, deque.size());
+    EXPECT_EQ(995u, deque.front());
+    EXPECT_EQ(999u, deque.back());
+}
+
+TEST(Deque, Clear)
+{
+    capu::Deque<capu::String, 4> deque;
+    deque.push_back("a");
+    deque.push_back("b");
+    deque.push_front("c");
+    deque.clear();
+    EXPECT_TRUE(deque.isEmpty());
+
+    deque.push_back("d");
+    EXPECT_EQ(capu::String("d"), deque.front());
+    EXPECT_EQ(1u, deque.size());
+}
+
+TEST(Deque, CopyAndAssign)
+{
+    capu::Deque<capu::String, 2> deque;
+    deque.push_back("one");
+    deque.push_back("two");
+    deque.push_front("zero");
+
+    capu::Deque<capu::String, 2> copy(deque);
+    EXPECT_EQ(3u, copy.size());
+    EXPECT_EQ(capu::String("zero"), copy[0]);
+    EXPECT_EQ(capu::String("one"), copy[1]);
+    EXPECT_EQ(capu::String("two"), copy[2]);
+
+    capu::Deque<capu::String, 2> assigned;
+    assigned.push_back("old");
+    assigned = deque;
+    EXPECT_EQ(3u, assigned.size());
+    EXPECT_EQ(capu::String("zero"), assigned.front());
+    EXPECT_EQ(capu::String("two"), assigned.back());
+
+    deque.clear();
+    EXPECT_EQ(3u, copy.size());
+    EXPECT_EQ(3u, assigned.size());
+}
+
+#define DEQUE_PERFORMANCE_COUNT 1000000
+
+TEST(Deque, performanceQueueWithDeque)
+{
+    capu::Queue<capu::uint32_t, capu::Allocator<capu::GenericListNode<capu::uint32_t> >, capu::Comparator, capu::Deque<capu::uint32_t> > queue;
+    capu::uint32_t value = 0;
+    for (capu::uint32_t i = 0; i < DEQUE_PERFORMANCE_COUNT; ++i)
+    {
+        queue.push(i);
+        queue.push(i);
+        queue.pop(&value);
+    }
+    while (queue.pop(&value) == capu::CAPU_OK)
+    {
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(Deque, performanceQueueWithList)
+{
+    capu::Queue<capu::uint32_t> queue;
+    capu::uint32_t value = 0;
+    for (capu::uint32_t i = 0; i < DEQUE_PERFORMANCE_COUNT; ++i)
+    {
+        queue.push(i);
+        queue.push(i);
+        queue.pop(&value);
+    }
+    while (queue.pop(&value) == capu::CAPU_OK)
+    {
+    }
+    EXPECT_TRUE(queue.empty());
+}
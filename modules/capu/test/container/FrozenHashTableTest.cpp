@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <gtest/gtest.h>
+#include "capu/container/FrozenHashTable.h"
+#include "capu/container/String.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        const uint_t BenchmarkKeys = 100000;
+        const uint_t BenchmarkLookups = 10000000;
+
+        uint_t HashTableMemoryUsage(const uint_t count)
+        {
+            // a HashTable doubles until its threshold of 80% holds all entries
+            uint_t size = 16;
+            while (static_cast<uint_t>(size * 0.8f) < count)
+            {
+                size *= 2;
+            }
+            const uint_t entries = static_cast<uint_t>(size * 0.8f) + 1;
+            return size * sizeof(void*) + entries * sizeof(HashTable<uint32_t, uint32_t>::HashTableEntry);
+        }
+    }
+
+    TEST(FrozenHashTable, empty)
+    {
+        FrozenHashTable<uint32_t, uint32_t> table;
+        EXPECT_EQ(0u, table.count());
+        EXPECT_FALSE(table.contains(0));
+        status_t status = CAPU_OK;
+        EXPECT_EQ(0u, table.at(0, &status));
+        EXPECT_EQ(CAPU_ENOT_EXIST, status);
+        EXPECT_EQ(table.begin(), table.end());
+
+        EXPECT_EQ(CAPU_OK, table.build(0, 0, 0));
+        EXPECT_EQ(0u, table.count());
+        EXPECT_FALSE(table.contains(0));
+    }
+
+    TEST(FrozenHashTable, buildFromArrays)
+    {
+        uint32_t keys[1000];
+        uint64_t values[1000];
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            keys[i] = i * 7919;
+            values[i] = static_cast<uint64_t>(i) << 33;
+        }
+
+        FrozenHashTable<uint32_t, uint64_t> table;
+        ASSERT_EQ(CAPU_OK, table.build(keys, values, 1000));
+        EXPECT_EQ(1000u, table.count());
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            status_t status = CAPU_ERROR;
+            EXPECT_EQ(values[i], table.at(keys[i], &status));
+            EXPECT_EQ(CAPU_OK, status);
+            EXPECT_FALSE(table.contains(keys[i] + 1));
+        }
+    }
+
+    TEST(FrozenHashTable, buildMillionKeys)
+    {
+        const uint32_t count = 1000000;
+        Array<uint32_t> keys(count);
+        Array<uint32_t> values(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            keys[i] = i * 2654435761u;
+            values[i] = i;
+        }
+
+        FrozenHashTable<uint32_t, uint32_t> table;
+        ASSERT_EQ(CAPU_OK, table.build(keys.getRawData(), values.getRawData(), count));
+        EXPECT_EQ(count, table.count());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(i, table.at(keys[i]));
+        }
+        // every key got its own slot
+        uint_t entries = 0;
+        for (const FrozenHashTable<uint32_t, uint32_t>::Entry* entry = table.begin(); entry != table.end(); ++entry)
+        {
+            ASSERT_EQ(keys[entry->value], entry->key);
+            ++entries;
+        }
+        EXPECT_EQ(count, entries);
+    }
+
+    TEST(FrozenHashTable, buildFromHashTable)
+    {
+        HashTable<String, int32_t> source;
+        source.put("error", 1);
+        source.put("warning", 2);
+        source.put("info", 3);
+        source.put("debug", 4);
+        source.put("trace", 5);
+
+        FrozenHashTable<String, int32_t> table;
+        ASSERT_EQ(CAPU_OK, table.build(source));
+        EXPECT_EQ(5u, table.count());
+        EXPECT_EQ(1, table.at("error"));
+        EXPECT_EQ(5, table.at("trace"));
+        EXPECT_FALSE(table.contains("fatal"));
+
+        int32_t sum = 0;
+        for (const FrozenHashTable<String, int32_t>::Entry* entry = table.begin(); entry != table.end(); ++entry)
+        {
+            EXPECT_EQ(source.at(entry->key), entry->value);
+            sum += entry->value;
+        }
+        EXPECT_EQ(15, sum);
+    }
+
+    TEST(FrozenHashTable, rebuildReplacesContents)
+    {
+        const int32_t keys1[] = {1, 2, 3};
+        const int32_t keys2[] = {4, 5};
+        const int32_t values[] = {10, 20, 30};
+
+        FrozenHashTable<int32_t, int32_t> table;
+        ASSERT_EQ(CAPU_OK, table.build(keys1, values, 3));
+        ASSERT_EQ(CAPU_OK, table.build(keys2, values, 2));
+        EXPECT_EQ(2u, table.count());
+        EXPECT_FALSE(table.contains(1));
+        EXPECT_EQ(20, table.at(5));
+    }
+
+    TEST(FrozenHashTable, duplicateKeys)
+    {
+        const int32_t keys[] = {1, 2, 1};
+        const int32_t values[] = {10, 20, 30};
+
+        FrozenHashTable<int32_t, int32_t> table;
+        EXPECT_EQ(CAPU_EINVAL, table.build(keys, values, 3));
+        EXPECT_EQ(0u, table.count());
+        EXPECT_FALSE(table.contains(1));
+    }
+
+    TEST(FrozenHashTable, performanceLookup)
+    {
+        HashTable<uint32_t, uint32_t> hashTable;
+        Array<uint32_t> keys(BenchmarkKeys);
+        for (uint32_t i = 0; i < BenchmarkKeys; ++i)
+        {
+            keys[i] = i * 2654435761u;
+            hashTable.put(keys[i], i);
+        }
+
+        uint64_t start = Time::GetMilliseconds();
+        FrozenHashTable<uint32_t, uint32_t> frozenTable;
+        ASSERT_EQ(CAPU_OK, frozenTable.build(hashTable));
+        const uint64_t buildTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        uint64_t hashTableSum = 0;
+        for (uint_t i = 0; i < BenchmarkLookups; ++i)
+        {
+            hashTableSum += hashTable.at(keys[(i * 7) % BenchmarkKeys]);
+        }
+        const uint64_t hashTableTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        uint64_t frozenSum = 0;
+        for (uint_t i = 0; i < BenchmarkLookups; ++i)
+        {
+            frozenSum += frozenTable.at(keys[(i * 7) % BenchmarkKeys]);
+        }
+        const uint64_t frozenTime = Time::GetMilliseconds() - start;
+
+        EXPECT_EQ(hashTableSum, frozenSum);
+        printf("%u lookups in %u keys: HashTable %u ms, FrozenHashTable %u ms (built in %u ms)\n",
+            static_cast<uint32_t>(BenchmarkLookups), static_cast<uint32_t>(BenchmarkKeys),
+            static_cast<uint32_t>(hashTableTime), static_cast<uint32_t>(frozenTime), static_cast<uint32_t>(buildTime));
+        printf("memory for %u entries of uint32_t -> uint32_t: HashTable %u bytes, FrozenHashTable %u bytes\n",
+            static_cast<uint32_t>(BenchmarkKeys), static_cast<uint32_t>(HashTableMemoryUsage(BenchmarkKeys)),
+            static_cast<uint32_t>(frozenTable.getMemoryUsage()));
+    }
+}
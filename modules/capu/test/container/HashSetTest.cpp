@@ -18,6 +18,9 @@
 #include "capu/container/HashSet.h"
 #include "capu/Error.h"
 #include "capu/Config.h"
+#include "capu/container/String.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
 
 TEST(HashSet, Constructor_Default)
 {
@@ -216,6 +219,155 @@ TEST(HashSetIterator, next)
     delete h1;
 }
 
+TEST(HashSet, assignment)
+{
+    capu::HashSet<capu::int32_t> set1;
+    set1.put(1);
+    capu::HashSet<capu::int32_t> set2;
+    set2.put(2);
+
+    set2 = set1;
+    set1.put(3);
+    EXPECT_TRUE(set2.hasElement(1));
+    EXPECT_FALSE(set2.hasElement(2));
+    EXPECT_FALSE(set2.hasElement(3));
+    EXPECT_EQ(1u, set2.count());
+}
+
+TEST(HashSet, removeKeepsCollidingValuesReachable)
+{
+    // a small set without growing has long probe sequences which wrap around
+    capu::HashSet<capu::uint32_t> set(4);
+    for (capu::uint32_t round = 0; round < 100; ++round)
+    {
+        for (capu::uint32_t i = 0; i < 11; ++i)
+        {
+            EXPECT_EQ(capu::CAPU_OK, set.put(round * 11 + i));
+        }
+        for (capu::uint32_t i = 0; i < 11; i += 2)
+        {
+            EXPECT_EQ(capu::CAPU_OK, set.remove(round * 11 + i));
+        }
+        for (capu::uint32_t i = 0; i < 11; ++i)
+        {
+            EXPECT_EQ(i % 2 == 1, set.hasElement(round * 11 + i));
+        }
+        for (capu::uint32_t i = 1; i < 11; i += 2)
+        {
+            EXPECT_EQ(capu::CAPU_OK, set.remove(round * 11 + i));
+        }
+        EXPECT_EQ(0u, set.count());
+        EXPECT_TRUE(set.begin() == set.end());
+    }
+}
+
+TEST(HashSet, manyValues)
+{
+    capu::HashSet<capu::uint32_t> set;
+    for (capu::uint32_t i = 0; i < 10000; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, set.put(i * 3));
+    }
+    for (capu::uint32_t i = 0; i < 10000; i += 2)
+    {
+        EXPECT_EQ(capu::CAPU_OK, set.remove(i * 3));
+    }
+    EXPECT_EQ(5000u, set.count());
+
+    capu::uint32_t iterated = 0;
+    for (capu::HashSet<capu::uint32_t>::Iterator it = set.begin(); it != set.end(); ++it)
+    {
+        EXPECT_EQ(3u, (*it / 3) % 2 * 3);
+        ++iterated;
+    }
+    EXPECT_EQ(5000u, iterated);
+    for (capu::uint32_t i = 0; i < 30000; ++i)
+    {
+        EXPECT_EQ(i % 6 == 3, set.hasElement(i));
+    }
+}
+
+TEST(HashSet, strings)
+{
+    capu::HashSet<capu::String> set;
+    EXPECT_EQ(capu::CAPU_OK, set.put("one"));
+    EXPECT_EQ(capu::CAPU_OK, set.put("two"));
+    EXPECT_EQ(capu::CAPU_ERROR, set.put("one"));
+    EXPECT_TRUE(set.hasElement("two"));
+    EXPECT_EQ(capu::CAPU_OK, set.remove("one"));
+    EXPECT_FALSE(set.hasElement("one"));
+    EXPECT_STREQ("two", set.begin()->c_str());
+}
+
+TEST(HashSet, reserve)
+{
+    capu::HashSet<capu::uint32_t> set;
+    set.put(7);
+    set.reserve(1000);
+    const capu::uint_t memory = set.getMemoryUsage();
+    for (capu::uint32_t i = 0; i < 1000; ++i)
+    {
+        set.put(i);
+    }
+    EXPECT_EQ(memory, set.getMemoryUsage());
+    EXPECT_EQ(1000u, set.count());
+}
+
+TEST(HashSet, performanceCompareWithHashTable)
+{
+    const capu::uint32_t count = 1000000;
+    const capu::uint32_t lookups = 10000000;
+
+    capu::uint64_t start = capu::Time::GetMilliseconds();
+    capu::HashTable<capu::uint32_t, capu::char_t> table;
+    for (capu::uint32_t i = 0; i < count; ++i)
+    {
+        table.put(i * 2654435761u, 0);
+    }
+    const capu::uint64_t tablePutTime = capu::Time::GetMilliseconds() - start;
+
+    start = capu::Time::GetMilliseconds();
+    capu::HashSet<capu::uint32_t> set;
+    for (capu::uint32_t i = 0; i < count; ++i)
+    {
+        set.put(i * 2654435761u);
+    }
+    const capu::uint64_t setPutTime = capu::Time::GetMilliseconds() - start;
+
+    // every second lookup misses
+    start = capu::Time::GetMilliseconds();
+    capu::uint32_t tableHits = 0;
+    for (capu::uint32_t i = 0; i < lookups; ++i)
+    {
+        tableHits += table.contains((i % (2 * count)) * 2654435761u) ? 1 : 0;
+    }
+    const capu::uint64_t tableLookupTime = capu::Time::GetMilliseconds() - start;
+
+    start = capu::Time::GetMilliseconds();
+    capu::uint32_t setHits = 0;
+    for (capu::uint32_t i = 0; i < lookups; ++i)
+    {
+        setHits += set.hasElement((i % (2 * count)) * 2654435761u) ? 1 : 0;
+    }
+    const capu::uint64_t setLookupTime = capu::Time::GetMilliseconds() - start;
+    EXPECT_EQ(tableHits, setHits);
+
+    // buckets and entries of a HashTable which grew to count entries
+    capu::uint_t tableSize = 16;
+    while (static_cast<capu::uint_t>(tableSize * 0.8f) < count)
+    {
+        tableSize *= 2;
+    }
+    const capu::uint_t tableMemory = tableSize * sizeof(void*) +
+        (static_cast<capu::uint_t>(tableSize * 0.8f) + 1) * sizeof(capu::HashTable<capu::uint32_t, capu::char_t>::HashTableEntry);
+
+    printf("%u uint32_t values: put HashTable %u ms, HashSet %u ms; %u lookups HashTable %u ms, HashSet %u ms; "
+        "bytes per value HashTable %.1f, HashSet %.1f\n",
+        count, static_cast<capu::uint32_t>(tablePutTime), static_cast<capu::uint32_t>(setPutTime),
+        lookups, static_cast<capu::uint32_t>(tableLookupTime), static_cast<capu::uint32_t>(setLookupTime),
+        static_cast<double>(tableMemory) / count, static_cast<double>(set.getMemoryUsage()) / count);
+}
+
 #define COUNT 500000
 
 capu::HashSet<capu::uint32_t> set;
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <gtest/gtest.h>
+#include "capu/container/HashTableSnapshot.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        struct Record
+        {
+            uint64_t id;
+            double_t value;
+            uint32_t flags;
+            uint32_t reserved;
+        };
+
+        Record MakeRecord(const uint64_t id)
+        {
+            Record record;
+            record.id = id;
+            record.value = id * 0.5;
+            record.flags = static_cast<uint32_t>(id % 7);
+            record.reserved = 0;
+            return record;
+        }
+
+        const char_t* const SnapshotPath = "snapshot.bin";
+        const uint32_t RecordCount = 1000000;
+
+        void WriteUInt32Snapshot(File& file, const uint32_t count)
+        {
+            HashTable<uint32_t, uint32_t> table;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                table.put(i, i);
+            }
+            ASSERT_EQ(CAPU_OK, (HashTableSnapshot<uint32_t, uint32_t>::Write(table, file)));
+        }
+
+        void ReadFileContent(File& file, Array<char_t>& content)
+        {
+            const char_t* data = 0;
+            uint_t size = 0;
+            ASSERT_EQ(CAPU_OK, file.mapReadOnly(data, size));
+            content.setSize(size);
+            Memory::Copy(content.getRawData(), data, size);
+            file.unmap();
+        }
+
+        void WriteFileContent(File& file, const Array<char_t>& content)
+        {
+            file.open(WRITE_EXISTING_BINARY);
+            file.write(content.getRawData(), content.size());
+            file.close();
+        }
+    }
+
+    TEST(HashTableSnapshot, writeAndFind)
+    {
+        HashTable<uint64_t, Record> table;
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            table.put(i * 3, MakeRecord(i * 3));
+        }
+
+        File file(SnapshotPath);
+        ASSERT_EQ(CAPU_OK, (HashTableSnapshot<uint64_t, Record>::Write(table, file)));
+
+        HashTableSnapshot<uint64_t, Record> snapshot;
+        ASSERT_EQ(CAPU_OK, snapshot.open(file));
+        EXPECT_EQ(1000u, snapshot.count());
+        for (uint64_t i = 0; i < 3000; ++i)
+        {
+            const Record* record = snapshot.find(i);
+            if (i % 3 == 0)
+            {
+                ASSERT_TRUE(record != 0);
+                EXPECT_EQ(i, record->id);
+                EXPECT_EQ(i * 0.5, record->value);
+                EXPECT_TRUE(snapshot.contains(i));
+            }
+            else
+            {
+                EXPECT_TRUE(record == 0);
+                EXPECT_FALSE(snapshot.contains(i));
+            }
+        }
+
+        EXPECT_EQ(CAPU_OK, file.unmap());
+        EXPECT_EQ(CAPU_OK, file.remove());
+    }
+
+    TEST(HashTableSnapshot, emptyTable)
+    {
+        HashTable<int32_t, int32_t> table;
+        File file(SnapshotPath);
+        ASSERT_EQ(CAPU_OK, (HashTableSnapshot<int32_t, int32_t>::Write(table, file)));
+
+        HashTableSnapshot<int32_t, int32_t> snapshot;
+        ASSERT_EQ(CAPU_OK, snapshot.open(file));
+        EXPECT_EQ(0u, snapshot.count());
+        EXPECT_FALSE(snapshot.contains(0));
+        EXPECT_TRUE(snapshot.find(0) == 0);
+
+        file.unmap();
+        file.remove();
+    }
+
+    TEST(HashTableSnapshot, notOpened)
+    {
+        HashTableSnapshot<int32_t, int32_t> snapshot;
+        EXPECT_EQ(0u, snapshot.count());
+        EXPECT_FALSE(snapshot.contains(1));
+
+        File missing("missing.bin");
+        EXPECT_EQ(CAPU_ENOT_EXIST, snapshot.open(missing));
+    }
+
+    TEST(HashTableSnapshot, rejectsOtherTypes)
+    {
+        HashTable<uint32_t, uint32_t> table;
+        table.put(1, 2);
+        File file(SnapshotPath);
+        ASSERT_EQ(CAPU_OK, (HashTableSnapshot<uint32_t, uint32_t>::Write(table, file)));
+
+        HashTableSnapshot<uint32_t, uint64_t> otherValue;
+        EXPECT_EQ(CAPU_EINVAL, otherValue.open(file));
+        HashTableSnapshot<uint64_t, uint32_t> otherKey;
+        EXPECT_EQ(CAPU_EINVAL, otherKey.open(file));
+        HashSetSnapshot<uint32_t> set;
+        EXPECT_EQ(CAPU_EINVAL, set.open(file));
+        file.unmap();
+
+        const char_t garbage[] = "no snapshot";
+        file.open(WRITE_EXISTING_BINARY);
+        file.write(garbage, sizeof(garbage));
+        file.close();
+        HashTableSnapshot<uint32_t, uint32_t> snapshot;
+        EXPECT_EQ(CAPU_EINVAL, snapshot.open(file));
+
+        file.unmap();
+        file.remove();
+    }
+
+    TEST(HashTableSnapshot, rejectsCorruptBuckets)
+    {
+        File file(SnapshotPath);
+        WriteUInt32Snapshot(file, 100);
+        Array<char_t> content;
+        ReadFileContent(file, content);
+
+        // let the first bucket end behind the last key
+        uint32_t* buckets = reinterpret_cast<uint32_t*>(content.getRawData() + sizeof(HashSnapshotHeader));
+        buckets[1] = 1000;
+        WriteFileContent(file, content);
+
+        HashTableSnapshot<uint32_t, uint32_t> snapshot;
+        EXPECT_EQ(CAPU_EINVAL, snapshot.open(file));
+        EXPECT_EQ(0u, snapshot.count());
+
+        file.unmap();
+        file.remove();
+    }
+
+    TEST(HashTableSnapshot, rejectsCorruptOffsets)
+    {
+        File file(SnapshotPath);
+        WriteUInt32Snapshot(file, 100);
+        Array<char_t> original;
+        ReadFileContent(file, original);
+
+        // offsets whose section ends wrap around
+        Array<char_t> content(original);
+        HashSnapshotHeader* header = reinterpret_cast<HashSnapshotHeader*>(content.getRawData());
+        header->valuesOffset = 0 - static_cast<uint64_t>(16);
+        WriteFileContent(file, content);
+        HashTableSnapshot<uint32_t, uint32_t> snapshot;
+        EXPECT_EQ(CAPU_EINVAL, snapshot.open(file));
+        file.unmap();
+
+        content = original;
+        header = reinterpret_cast<HashSnapshotHeader*>(content.getRawData());
+        header->keysOffset = 0 - static_cast<uint64_t>(64);
+        header->valuesOffset = header->keysOffset;
+        WriteFileContent(file, content);
+        EXPECT_EQ(CAPU_EINVAL, snapshot.open(file));
+        file.unmap();
+
+        // keys which are not aligned
+        content = original;
+        header = reinterpret_cast<HashSnapshotHeader*>(content.getRawData());
+        header->keysOffset += 4;
+        WriteFileContent(file, content);
+        EXPECT_EQ(CAPU_EINVAL, snapshot.open(file));
+        file.unmap();
+
+        // the unchanged file is still accepted
+        WriteFileContent(file, original);
+        EXPECT_EQ(CAPU_OK, snapshot.open(file));
+        EXPECT_EQ(100u, snapshot.count());
+
+        file.unmap();
+        file.remove();
+    }
+
+    TEST(HashSetSnapshot, writeAndContains)
+    {
+        HashSet<int32_t> set;
+        for (int32_t i = -500; i < 500; i += 2)
+        {
+            set.put(i);
+        }
+
+        File file(SnapshotPath);
+        ASSERT_EQ(CAPU_OK, HashSetSnapshot<int32_t>::Write(set, file));
+
+        HashSetSnapshot<int32_t> snapshot;
+        ASSERT_EQ(CAPU_OK, snapshot.open(file));
+        EXPECT_EQ(500u, snapshot.count());
+        for (int32_t i = -500; i < 500; ++i)
+        {
+            EXPECT_EQ(i % 2 == 0, snapshot.contains(i));
+        }
+
+        file.unmap();
+        file.remove();
+    }
+
+    TEST(HashTableSnapshot, performanceColdStart)
+    {
+        HashTable<uint64_t, Record> table;
+        table.reserve(RecordCount);
+        for (uint64_t i = 0; i < RecordCount; ++i)
+        {
+            const uint64_t id = i * 2654435761u;
+            table.put(id, MakeRecord(id));
+        }
+
+        // a flat dump of the records is what has to be rebuilt into a table at startup
+        File dump("records.bin");
+        ASSERT_EQ(CAPU_OK, dump.open(WRITE_EXISTING_BINARY));
+        Array<Record> records(RecordCount);
+        uint32_t index = 0;
+        for (HashTable<uint64_t, Record>::Iterator current = table.begin(); current != table.end(); ++current)
+        {
+            records[index++] = current->value;
+        }
+        ASSERT_EQ(CAPU_OK, dump.write(reinterpret_cast<const char_t*>(records.getRawData()), RecordCount * sizeof(Record)));
+        dump.close();
+
+        File file(SnapshotPath);
+        ASSERT_EQ(CAPU_OK, (HashTableSnapshot<uint64_t, Record>::Write(table, file)));
+
+        uint64_t start = Time::GetMilliseconds();
+        ASSERT_EQ(CAPU_OK, dump.open(READ_EXISTING_BINARY));
+        Array<Record> loaded(RecordCount);
+        uint_t bytesRead = 0;
+        ASSERT_EQ(CAPU_OK, dump.read(reinterpret_cast<char_t*>(loaded.getRawData()), RecordCount * sizeof(Record), bytesRead));
+        dump.close();
+        HashTable<uint64_t, Record> rebuilt;
+        rebuilt.reserve(RecordCount);
+        for (uint32_t i = 0; i < RecordCount; ++i)
+        {
+            rebuilt.put(loaded[i].id, loaded[i]);
+        }
+        const uint64_t rebuildTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        HashTableSnapshot<uint64_t, Record> snapshot;
+        ASSERT_EQ(CAPU_OK, snapshot.open(file));
+        const uint64_t openTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        uint64_t tableSum = 0;
+        for (uint64_t i = 0; i < RecordCount; ++i)
+        {
+            tableSum += rebuilt.at(i * 2654435761u).flags;
+        }
+        const uint64_t tableLookupTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        uint64_t snapshotSum = 0;
+        for (uint64_t i = 0; i < RecordCount; ++i)
+        {
+            snapshotSum += snapshot.find(i * 2654435761u)->flags;
+        }
+        const uint64_t snapshotLookupTime = Time::GetMilliseconds() - start;
+
+        EXPECT_EQ(tableSum, snapshotSum);
+        printf("startup with %u records: rebuild HashTable %u ms, open snapshot %u ms; %u lookups: HashTable %u ms, snapshot %u ms\n",
+            RecordCount, static_cast<uint32_t>(rebuildTime), static_cast<uint32_t>(openTime),
+            RecordCount, static_cast<uint32_t>(tableLookupTime), static_cast<uint32_t>(snapshotLookupTime));
+
+        file.unmap();
+        file.remove();
+        dump.remove();
+    }
+}
@@ -17,8 +17,11 @@
 #include <gtest/gtest.h>
 #include "capu/container/HashTable.h"
 #include "capu/container/HashSet.h"
+#include "capu/container/Vector.h"
 #include "capu/Error.h"
 #include "capu/os/Time.h"
+#include "capu/os/StringUtils.h"
+#include <stdio.h>
 
 #include <container/HashTableTest.h>
 
@@ -661,6 +664,45 @@ TEST_F(HashTableTest, TestForbidRehashing)
     EXPECT_EQ(static_cast<capu::uint32_t>(3), newmap.count());
 }
 
+TEST_F(HashTableTest, Reserve)
+{
+    Int32HashMap newmap(2, true);
+    for (int i = 0; i < 3; i++)
+    {
+        newmap.put(i, i * 10);
+    }
+    newmap.remove(1); // leaves a gap in the entries
+
+    EXPECT_EQ(capu::CAPU_OK, newmap.reserve(1000));
+    EXPECT_EQ(static_cast<capu::uint32_t>(2), newmap.count());
+    EXPECT_EQ(0, newmap.at(0));
+    EXPECT_EQ(20, newmap.at(2));
+    EXPECT_FALSE(newmap.contains(1));
+
+    for (int i = 3; i < 1000; i++)
+    {
+        EXPECT_EQ(capu::CAPU_OK, newmap.put(i, i * 10));
+    }
+    EXPECT_EQ(static_cast<capu::uint32_t>(999), newmap.count());
+    EXPECT_EQ(9990, newmap.at(999));
+
+    capu::uint32_t iterated = 0;
+    for (Int32HashMap::Iterator iter = newmap.begin(); iter != newmap.end(); ++iter)
+    {
+        EXPECT_EQ(iter->key * 10, iter->value);
+        ++iterated;
+    }
+    EXPECT_EQ(static_cast<capu::uint32_t>(999), iterated);
+}
+
+TEST_F(HashTableTest, ReserveNotResizeable)
+{
+    Int32HashMap newmap(2, false); // only 3 entries
+
+    EXPECT_EQ(capu::CAPU_OK, newmap.reserve(3));
+    EXPECT_EQ(capu::CAPU_ENO_MEMORY, newmap.reserve(4));
+}
+
 TEST_F(HashTableTest, TestWildRemoving)
 {
     Int32HashMap newmap;
@@ -691,3 +733,168 @@ TEST_F(HashTableTest, TestWildRemoving)
     newmap.put(2000, 2000); // TODO how to check that everything worked?
     EXPECT_EQ(static_cast<capu::uint32_t>(1001), newmap.count());
 }
+
+struct FewDigestsHashFunction
+{
+    // only three different digests, so the buckets hold long chains of colliding keys
+    static capu::uint_t Digest(const capu::int32_t key, const capu::uint8_t = sizeof(capu::uint_t) * 8)
+    {
+        return static_cast<capu::uint_t>(key % 3) << 20;
+    }
+};
+
+TEST_F(HashTableTest, CollidingDigests)
+{
+    capu::HashTable<capu::int32_t, capu::int32_t, capu::Comparator, FewDigestsHashFunction> map;
+    for (capu::int32_t i = 0; i < 300; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, map.put(i, i * 10));
+    }
+    for (capu::int32_t i = 0; i < 300; i += 2)
+    {
+        EXPECT_EQ(capu::CAPU_OK, map.remove(i));
+    }
+    for (capu::int32_t i = 0; i < 300; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, map.contains(i));
+    }
+    map.reserve(1000);
+    for (capu::int32_t i = 1; i < 300; i += 2)
+    {
+        EXPECT_EQ(i * 10, map.at(i));
+    }
+    EXPECT_EQ(150u, map.count());
+}
+
+TEST_F(HashTableTest, performanceStringKeys)
+{
+    const capu::uint32_t count = 200000;
+    const capu::uint32_t rounds = 10;
+
+    // keys with a long common prefix make every comparator call expensive
+    capu::Vector<capu::String> keys;
+    keys.resize(count);
+    capu::char_t buffer[64];
+    for (capu::uint32_t i = 0; i < count; ++i)
+    {
+        capu::StringUtils::Sprintf(buffer, sizeof(buffer), "/resources/textures/environment/%u", i);
+        keys[i] = buffer;
+    }
+
+    capu::uint64_t start = capu::Time::GetMilliseconds();
+    capu::HashTable<capu::String, capu::uint32_t> map;
+    for (capu::uint32_t i = 0; i < count; ++i)
+    {
+        map.put(keys[i], i);
+    }
+    const capu::uint64_t putTime = capu::Time::GetMilliseconds() - start;
+
+    start = capu::Time::GetMilliseconds();
+    capu::uint32_t found = 0;
+    for (capu::uint32_t round = 0; round < rounds; ++round)
+    {
+        for (capu::uint32_t i = 0; i < count; ++i)
+        {
+            found += map.contains(keys[i]) ? 1 : 0;
+        }
+    }
+    const capu::uint64_t lookupTime = capu::Time::GetMilliseconds() - start;
+    EXPECT_EQ(count * rounds, found);
+
+    printf("%u String keys: put %u ms, %u lookups %u ms, %u bytes per entry\n",
+        count, static_cast<capu::uint32_t>(putTime), count * rounds, static_cast<capu::uint32_t>(lookupTime),
+        static_cast<capu::uint32_t>(sizeof(capu::HashTable<capu::String, capu::uint32_t>::HashTableEntry)));
+}
+
+TEST_F(HashTableTest, FindMany)
+{
+    Int32HashMap map;
+    for (capu::int32_t i = 0; i < 100; ++i)
+    {
+        map.put(i * 2, i);
+    }
+
+    capu::int32_t keys[70];
+    capu::int32_t* results[70];
+    for (capu::int32_t i = 0; i < 70; ++i)
+    {
+        keys[i] = i * 3;
+    }
+    EXPECT_EQ(34u, map.findMany(keys, 70, results));
+    for (capu::int32_t i = 0; i < 70; ++i)
+    {
+        if (keys[i] % 2 == 0 && keys[i] < 200)
+        {
+            ASSERT_TRUE(results[i] != 0);
+            EXPECT_EQ(keys[i] / 2, *results[i]);
+        }
+        else
+        {
+            EXPECT_TRUE(results[i] == 0);
+        }
+    }
+
+    // values can be changed through the results
+    *results[0] = 42;
+    EXPECT_EQ(42, map.at(0));
+    EXPECT_EQ(0u, map.findMany(keys, 0, results));
+}
+
+TEST_F(HashTableTest, performanceFindMany)
+{
+    // a table far bigger than the last level cache
+    const capu::uint32_t count = 2000000;
+    const capu::uint32_t requests = 20000;
+    const capu::uint32_t keysPerRequest = 128;
+
+    capu::HashTable<capu::uint32_t, capu::uint32_t> map;
+    map.reserve(count);
+    for (capu::uint32_t i = 0; i < count; ++i)
+    {
+        map.put(i * 2654435761u, i);
+    }
+
+    capu::Vector<capu::uint32_t> keys;
+    keys.resize(requests * keysPerRequest);
+    capu::uint32_t random = 12345;
+    for (capu::uint32_t i = 0; i < keys.size(); ++i)
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        keys[i] = (random % (2 * count)) * 2654435761u; // every second key misses
+    }
+
+    capu::uint64_t start = capu::Time::GetMilliseconds();
+    capu::uint32_t sumFind = 0;
+    for (capu::uint32_t i = 0; i < keys.size(); ++i)
+    {
+        capu::HashTable<capu::uint32_t, capu::uint32_t>::Iterator it = map.find(keys[i]);
+        if (it != map.end())
+        {
+            sumFind += it->value;
+        }
+    }
+    const capu::uint64_t findTime = capu::Time::GetMilliseconds() - start;
+
+    start = capu::Time::GetMilliseconds();
+    capu::uint32_t sumFindMany = 0;
+    capu::uint32_t* results[keysPerRequest];
+    for (capu::uint32_t request = 0; request < requests; ++request)
+    {
+        map.findMany(&keys[request * keysPerRequest], keysPerRequest, results);
+        for (capu::uint32_t i = 0; i < keysPerRequest; ++i)
+        {
+            if (results[i])
+            {
+                sumFindMany += *results[i];
+            }
+        }
+    }
+    const capu::uint64_t findManyTime = capu::Time::GetMilliseconds() - start;
+    EXPECT_EQ(sumFind, sumFindMany);
+
+    printf("%u lookups in a table of %u entries: find %u ms, findMany with %u keys %u ms\n",
+        requests * keysPerRequest, count, static_cast<capu::uint32_t>(findTime), keysPerRequest,
+        static_cast<capu::uint32_t>(findManyTime));
+}
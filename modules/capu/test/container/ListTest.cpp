@@ -917,3 +917,88 @@ TEST(ListIterator, loopInserting)
         i++;
     }
 }
+
+namespace
+{
+    struct SortItem
+    {
+        capu::int32_t key;
+        capu::int32_t order;
+    };
+
+    struct SortItemLess
+    {
+        capu::bool_t operator()(const SortItem& x, const SortItem& y) const
+        {
+            return x.key < y.key;
+        }
+    };
+}
+
+TEST(List, sort)
+{
+    capu::List<capu::int32_t> list;
+    list.sort();
+    EXPECT_EQ(0u, list.size());
+
+    for (capu::int32_t i = 0; i < 1000; ++i)
+    {
+        list.push_back((i * 7919) % 1000 - 500);
+    }
+    capu::List<capu::int32_t>::Iterator minimum = list.find(-500);
+    list.sort();
+
+    EXPECT_EQ(1000u, list.size());
+    capu::int32_t expected = -500;
+    for (capu::List<capu::int32_t>::Iterator it = list.begin(); it != list.end(); ++it)
+    {
+        EXPECT_EQ(expected, *it);
+        ++expected;
+    }
+    EXPECT_EQ(500, expected);
+    EXPECT_EQ(-500, list.front());
+    EXPECT_EQ(499, list.back());
+
+    // nodes are relinked, the element of an iterator stays the same
+    EXPECT_EQ(-500, *minimum);
+
+    // the ring is intact in both directions
+    list.pop_back();
+    list.push_front(-501);
+    EXPECT_EQ(-501, list.front());
+    EXPECT_EQ(498, list.back());
+}
+
+TEST(List, sortIsStable)
+{
+    capu::List<SortItem> list;
+    for (capu::int32_t i = 0; i < 500; ++i)
+    {
+        SortItem item = {(i * 31) % 7, i};
+        list.push_back(item);
+    }
+    list.sort(SortItemLess());
+
+    SortItem previous = {-1, -1};
+    for (capu::List<SortItem>::Iterator it = list.begin(); it != list.end(); ++it)
+    {
+        EXPECT_LE(previous.key, it->key);
+        if (previous.key == it->key)
+        {
+            EXPECT_LT(previous.order, it->order);
+        }
+        previous = *it;
+    }
+}
+
+TEST(List, sortStrings)
+{
+    capu::List<capu::String> list;
+    list.push_back("pear");
+    list.push_back("apple");
+    list.push_back("fig");
+    list.sort();
+    EXPECT_STREQ("apple", list.get(0).c_str());
+    EXPECT_STREQ("fig", list.get(1).c_str());
+    EXPECT_STREQ("pear", list.get(2).c_str());
+}
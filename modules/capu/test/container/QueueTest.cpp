@@ -280,3 +280,32 @@ TEST(Queue, StaticMemory)
     EXPECT_EQ(capu::CAPU_ENO_MEMORY, queue.push(4));
     EXPECT_EQ(3, queue.size());
 }
+
+TEST(Queue, DequeStorage)
+{
+    capu::Queue<capu::int32_t, capu::Allocator<capu::GenericListNode<capu::int32_t> >, capu::Comparator, capu::Deque<capu::int32_t, 4> > queue;
+    capu::int32_t val = 0;
+    EXPECT_EQ(capu::CAPU_EINVAL, queue.pop(&val));
+    EXPECT_EQ(capu::CAPU_EINVAL, queue.peek(val));
+
+    for (capu::int32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, queue.push(i));
+    }
+    EXPECT_EQ(10u, queue.size());
+    EXPECT_EQ(0, queue.front());
+    EXPECT_EQ(9, queue.back());
+
+    for (capu::int32_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, queue.pop(&val));
+        EXPECT_EQ(i, val);
+    }
+
+    capu::List<capu::int32_t> list;
+    EXPECT_EQ(capu::CAPU_OK, queue.popAll(list));
+    EXPECT_EQ(5u, list.size());
+    EXPECT_EQ(5, list.get(0));
+    EXPECT_EQ(9, list.get(4));
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/container/Sort.h"
+#include "capu/container/List.h"
+#include "capu/container/String.h"
+#include "capu/os/Time.h"
+#include <algorithm>
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        uint32_t NextRandom(uint32_t& random)
+        {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return random;
+        }
+
+        class GreaterComparator
+        {
+        public:
+            bool_t operator()(const int32_t x, const int32_t y) const
+            {
+                return x > y;
+            }
+        };
+
+        template<typename T>
+        void ExpectSameAsStdSort(T* data, const uint_t count)
+        {
+            Array<T> expected(data, count);
+            std::sort(expected.getRawData(), expected.getRawData() + count);
+            sort(data, count);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                ASSERT_EQ(expected[i], data[i]);
+            }
+        }
+    }
+
+    TEST(Sort, patterns)
+    {
+        const uint_t count = 10000;
+        Array<int32_t> data(count);
+        uint32_t random = 3;
+
+        for (uint_t i = 0; i < count; ++i)
+        {
+            data[i] = static_cast<int32_t>(NextRandom(random));
+        }
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        // already sorted
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        for (uint_t i = 0; i < count; ++i)
+        {
+            data[i] = static_cast<int32_t>(count - i);
+        }
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        data.set(42);
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        for (uint_t i = 0; i < count; ++i)
+        {
+            data[i] = NextRandom(random) % 3;
+        }
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        // organ pipe
+        for (uint_t i = 0; i < count; ++i)
+        {
+            data[i] = static_cast<int32_t>(i < count / 2 ? i : count - i);
+        }
+        ExpectSameAsStdSort(data.getRawData(), count);
+
+        for (uint_t size = 0; size < 40; ++size)
+        {
+            for (uint_t i = 0; i < size; ++i)
+            {
+                data[i] = NextRandom(random) % 10;
+            }
+            ExpectSameAsStdSort(data.getRawData(), size);
+        }
+    }
+
+    TEST(Sort, comparator)
+    {
+        int32_t data[] = {3, 9, -1, 4, 4, 0};
+        sort(data, 6, GreaterComparator());
+        EXPECT_EQ(9, data[0]);
+        EXPECT_EQ(4, data[1]);
+        EXPECT_EQ(4, data[2]);
+        EXPECT_EQ(3, data[3]);
+        EXPECT_EQ(0, data[4]);
+        EXPECT_EQ(-1, data[5]);
+    }
+
+    TEST(Sort, strings)
+    {
+        const char_t* names[] = {"pear", "apple", "fig"};
+        sort(names, 3);
+        EXPECT_STREQ("apple", names[0]);
+        EXPECT_STREQ("fig", names[1]);
+        EXPECT_STREQ("pear", names[2]);
+
+        Vector<String> strings;
+        strings.push_back("pear");
+        strings.push_back("apple");
+        strings.push_back("fig");
+        sort(strings);
+        EXPECT_STREQ("apple", strings[0].c_str());
+        EXPECT_STREQ("fig", strings[1].c_str());
+        EXPECT_STREQ("pear", strings[2].c_str());
+    }
+
+    TEST(Sort, arrayAndVector)
+    {
+        Array<uint32_t> array(100);
+        Vector<uint32_t> vector;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            array[i] = 99 - i;
+            vector.push_back(99 - i);
+        }
+        sort(array);
+        sort(vector);
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(i, array[i]);
+            EXPECT_EQ(i, vector[i]);
+        }
+
+        Vector<uint32_t> empty;
+        sort(empty);
+        radixSort(empty);
+        EXPECT_EQ(0u, empty.size());
+    }
+
+    TEST(Sort, radixSort)
+    {
+        const uint_t count = 5000;
+        uint32_t random = 5;
+
+        Array<int32_t> signedData(count);
+        Array<uint64_t> unsignedData(count);
+        Array<int16_t> shortData(count);
+        Array<int64_t> longData(count);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            signedData[i] = static_cast<int32_t>(NextRandom(random));
+            unsignedData[i] = (static_cast<uint64_t>(NextRandom(random)) << 32) | NextRandom(random);
+            shortData[i] = static_cast<int16_t>(NextRandom(random));
+            longData[i] = static_cast<int64_t>(unsignedData[i]);
+        }
+
+        Array<int32_t> expectedSigned(signedData);
+        Array<uint64_t> expectedUnsigned(unsignedData);
+        Array<int16_t> expectedShort(shortData);
+        Array<int64_t> expectedLong(longData);
+        std::sort(expectedSigned.getRawData(), expectedSigned.getRawData() + count);
+        std::sort(expectedUnsigned.getRawData(), expectedUnsigned.getRawData() + count);
+        std::sort(expectedShort.getRawData(), expectedShort.getRawData() + count);
+        std::sort(expectedLong.getRawData(), expectedLong.getRawData() + count);
+
+        radixSort(signedData);
+        radixSort(unsignedData);
+        radixSort(shortData);
+        radixSort(longData);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(expectedSigned[i], signedData[i]);
+            ASSERT_EQ(expectedUnsigned[i], unsignedData[i]);
+            ASSERT_EQ(expectedShort[i], shortData[i]);
+            ASSERT_EQ(expectedLong[i], longData[i]);
+        }
+    }
+
+    TEST(Sort, radixSortSkipsEqualBytes)
+    {
+        // only the lowest byte differs, an odd number of passes ends in the buffer
+        uint32_t data[] = {0x12345603, 0x12345601, 0x12345602};
+        radixSort(data, 3);
+        EXPECT_EQ(0x12345601u, data[0]);
+        EXPECT_EQ(0x12345602u, data[1]);
+        EXPECT_EQ(0x12345603u, data[2]);
+
+        char_t characters[] = {'c', 'a', 'b'};
+        radixSort(characters, 3);
+        EXPECT_EQ('a', characters[0]);
+        EXPECT_EQ('b', characters[1]);
+        EXPECT_EQ('c', characters[2]);
+    }
+
+    TEST(Sort, parallelSort)
+    {
+        ThreadPool pool(3);
+        uint32_t random = 11;
+        const uint_t sizes[] = {0, 1, 100, 16383, 16384, 100001, 1000000};
+        for (uint_t size = 0; size < sizeof(sizes) / sizeof(sizes[0]); ++size)
+        {
+            const uint_t count = sizes[size];
+            Array<uint32_t> data(count);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                data[i] = NextRandom(random) % 1000;
+            }
+            Array<uint32_t> expected(data);
+            std::sort(expected.getRawData(), expected.getRawData() + count);
+
+            parallelSort(pool, data);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                ASSERT_EQ(expected[i], data[i]);
+            }
+        }
+    }
+
+    TEST(Sort, parallelSortWithComparatorOnVector)
+    {
+        ThreadPool pool(2);
+        Vector<int32_t> vector;
+        for (int32_t i = 0; i < 50000; ++i)
+        {
+            vector.push_back((i * 7919) % 50000);
+        }
+        parallelSort(pool, vector, GreaterComparator());
+        for (int32_t i = 0; i < 50000; ++i)
+        {
+            ASSERT_EQ(49999 - i, vector[i]);
+        }
+    }
+
+    TEST(Sort, parallelSortOnClosedPool)
+    {
+        ThreadPool pool(2);
+        pool.close();
+
+        Array<uint32_t> data(50000);
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            data[i] = 50000 - i;
+        }
+        parallelSort(pool, data);
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            ASSERT_EQ(i + 1, data[i]);
+        }
+    }
+
+    TEST(Sort, performanceCompareAlgorithms)
+    {
+        ThreadPool pool(3);
+        const uint_t counts[] = {1000000, 10000000};
+        for (uint_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            const uint_t count = counts[c];
+            Array<uint32_t> input(count);
+            uint32_t random = 1;
+            for (uint_t i = 0; i < count; ++i)
+            {
+                input[i] = NextRandom(random);
+            }
+
+            Array<uint32_t> data(input);
+            uint64_t start = Time::GetMilliseconds();
+            std::sort(data.getRawData(), data.getRawData() + count);
+            const uint64_t stdTime = Time::GetMilliseconds() - start;
+            const Array<uint32_t> expected(data);
+
+            data = input;
+            start = Time::GetMilliseconds();
+            sort(data);
+            const uint64_t introTime = Time::GetMilliseconds() - start;
+            EXPECT_EQ(0, Memory::Compare(expected.getRawData(), data.getRawData(), count * sizeof(uint32_t)));
+
+            data = input;
+            start = Time::GetMilliseconds();
+            radixSort(data);
+            const uint64_t radixTime = Time::GetMilliseconds() - start;
+            EXPECT_EQ(0, Memory::Compare(expected.getRawData(), data.getRawData(), count * sizeof(uint32_t)));
+
+            data = input;
+            start = Time::GetMilliseconds();
+            parallelSort(pool, data);
+            const uint64_t parallelTime = Time::GetMilliseconds() - start;
+            EXPECT_EQ(0, Memory::Compare(expected.getRawData(), data.getRawData(), count * sizeof(uint32_t)));
+
+            printf("%u uint32: std::sort %u ms, sort %u ms, radixSort %u ms, parallelSort with 4 threads %u ms\n",
+                static_cast<uint32_t>(count), static_cast<uint32_t>(stdTime), static_cast<uint32_t>(introTime),
+                static_cast<uint32_t>(radixTime), static_cast<uint32_t>(parallelTime));
+        }
+    }
+
+    TEST(Sort, performanceList)
+    {
+        const uint32_t count = 1000000;
+        List<uint32_t> list;
+        uint32_t random = 1;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            list.push_back(NextRandom(random));
+        }
+
+        const uint64_t start = Time::GetMilliseconds();
+        list.sort();
+        const uint64_t sortTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(count, list.size());
+
+        printf("%u uint32 in a List: sort %u ms\n", count, static_cast<uint32_t>(sortTime));
+    }
+}
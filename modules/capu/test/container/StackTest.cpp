@@ -100,3 +100,24 @@ TEST(Stack, StaticMemory)
     EXPECT_EQ(capu::CAPU_ENO_MEMORY, stack.push(4));
     EXPECT_EQ(3u, stack.size());
  }
+
+TEST(Stack, DequeStorage)
+{
+    capu::Stack<capu::uint32_t, capu::Allocator<capu::GenericListNode<capu::uint32_t> >, capu::Comparator, capu::Deque<capu::uint32_t, 4> > stack;
+    EXPECT_EQ(capu::CAPU_EINVAL, stack.pop());
+    for (capu::uint32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, stack.push(i));
+    }
+    EXPECT_EQ(10, stack.size());
+
+    capu::uint32_t val = 0;
+    EXPECT_EQ(capu::CAPU_OK, stack.peek(val));
+    EXPECT_EQ(9u, val);
+    for (capu::uint32_t i = 10; i > 0; --i)
+    {
+        EXPECT_EQ(capu::CAPU_OK, stack.pop(&val));
+        EXPECT_EQ(i - 1, val);
+    }
+    EXPECT_TRUE(stack.isEmpty());
+}
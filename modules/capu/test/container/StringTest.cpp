@@ -446,3 +446,27 @@ TEST(String, GetSubstring)
     capu::String substr7 = str1.substr(str1.getLength(), 4);
     EXPECT_STREQ("", substr7.c_str());
 }
+
+TEST(String, Assign)
+{
+    capu::String str("previous content");
+    const capu::char_t* buffer = str.c_str();
+
+    // not terminated characters, the buffer is large enough to be reused
+    str.assign("hello world", 5);
+    EXPECT_STREQ("hello", str.c_str());
+    EXPECT_EQ(5u, str.getLength());
+    EXPECT_EQ(buffer, str.c_str());
+
+    str.assign("a longer string than before", 27);
+    EXPECT_STREQ("a longer string than before", str.c_str());
+    EXPECT_EQ(27u, str.getLength());
+
+    str.assign("", 0);
+    EXPECT_STREQ("", str.c_str());
+    EXPECT_EQ(0u, str.getLength());
+
+    capu::String empty;
+    empty.assign("abc", 3);
+    EXPECT_STREQ("abc", empty.c_str());
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/container/StringView.h"
+
+namespace capu
+{
+    TEST(StringView, Empty)
+    {
+        StringView view;
+        EXPECT_TRUE(view.empty());
+        EXPECT_EQ(0u, view.length());
+        EXPECT_TRUE(view == StringView(""));
+        EXPECT_TRUE(view == StringView(static_cast<const char_t*>(0)));
+    }
+
+    TEST(StringView, RefersToCharacters)
+    {
+        const char_t* text = "Hello World";
+        StringView view(text + 6, 3);
+
+        EXPECT_EQ(text + 6, view.data());
+        EXPECT_EQ(3u, view.length());
+        EXPECT_FALSE(view.empty());
+        EXPECT_STREQ("Wor", view.toString().c_str());
+    }
+
+    TEST(StringView, FromString)
+    {
+        String str("Hello");
+        StringView view(str);
+
+        EXPECT_EQ(str.c_str(), view.data());
+        EXPECT_EQ(5u, view.length());
+    }
+
+    TEST(StringView, Compare)
+    {
+        const char_t* text = "abcabd";
+        EXPECT_TRUE(StringView(text, 2) == StringView(text + 3, 2));
+        EXPECT_FALSE(StringView(text, 3) == StringView(text + 3, 3));
+        EXPECT_TRUE(StringView(text, 3) != StringView(text + 3, 3));
+        EXPECT_TRUE(StringView(text, 2) != StringView(text, 3));
+        EXPECT_TRUE(StringView(text, 3) == StringView("abc"));
+    }
+}
@@ -15,6 +15,7 @@
  */
 
 #include <container/VectorTest.h>
+#include "capu/container/String.h"
 
 namespace capu
 {
@@ -115,4 +116,75 @@ namespace capu
         EXPECT_EQ(47u, vector2[0]);
         EXPECT_EQ(8u, vector2[1]);
     }
-}
\ No newline at end of file
+
+    TEST_F(VectorTest, PushBackWithoutCapacity)
+    {
+        Vector<uint32_t> vector(0);
+        vector.push_back(1u);
+        vector.push_back(2u);
+
+        EXPECT_EQ(2u, vector.size());
+        EXPECT_EQ(2u, vector[1]);
+    }
+
+    TEST_F(VectorTest, Reserve)
+    {
+        Vector<uint32_t> vector(1);
+        vector.push_back(42u);
+        vector.reserve(100);
+
+        EXPECT_EQ(1u, vector.size());
+        EXPECT_EQ(42u, vector[0]);
+
+        uint32_t* data = &vector[0];
+        for (uint32_t i = 1; i < 100; ++i)
+        {
+            vector.push_back(i);
+        }
+        EXPECT_EQ(data, &vector[0]);
+    }
+
+    TEST_F(VectorTest, Resize)
+    {
+        Vector<uint32_t> vector;
+        vector.push_back(42u);
+        vector.resize(40);
+
+        EXPECT_EQ(40u, vector.size());
+        EXPECT_EQ(42u, vector[0]);
+        EXPECT_EQ(0u, vector[39]);
+
+        vector[1] = 7u;
+        vector.resize(1);
+        EXPECT_EQ(1u, vector.size());
+        vector.resize(2);
+        EXPECT_EQ(0u, vector[1]);
+    }
+
+    TEST_F(VectorTest, ResizeEmptyVectorOfObjects)
+    {
+        Vector<String> vector(0);
+        vector.resize(3);
+
+        EXPECT_EQ(3u, vector.size());
+        EXPECT_EQ(String(), vector[2]);
+        vector[0] = "first";
+        vector.resize(20);
+        EXPECT_EQ(String("first"), vector[0]);
+    }
+
+    TEST_F(VectorTest, Clear)
+    {
+        Vector<uint32_t> vector;
+        vector.push_back(1u);
+        vector.push_back(2u);
+        uint32_t* data = &vector[0];
+        vector.clear();
+
+        EXPECT_EQ(0u, vector.size());
+        EXPECT_EQ(0u, data[0]);
+        vector.push_back(3u);
+        EXPECT_EQ(data, &vector[0]);
+        EXPECT_EQ(3u, vector[0]);
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/os/FiberContext.h"
+#include "capu/os/Time.h"
+
+namespace capu
+{
+    namespace
+    {
+        struct PingPong
+        {
+            FiberContext caller;
+            FiberContext fiber;
+            uint32_t counter;
+            double_t value;
+        };
+
+        void CountForever(void* argument)
+        {
+            PingPong* pingPong = static_cast<PingPong*>(argument);
+            for (;;)
+            {
+                ++pingPong->counter;
+                // floating point work across switches, the caller checks the result
+                pingPong->value = pingPong->value * 0.5 + 1.0;
+                FiberContext::Switch(pingPong->fiber, pingPong->caller);
+            }
+        }
+    }
+
+    TEST(FiberContext, allocateStack)
+    {
+        const uint_t size = 16 * 1024;
+        char_t* stack = static_cast<char_t*>(FiberContext::AllocateStack(size, true));
+        ASSERT_TRUE(stack != NULL);
+        stack[0] = 1;
+        stack[size - 1] = 2;
+        EXPECT_EQ(1, stack[0]);
+        EXPECT_EQ(2, stack[size - 1]);
+        FiberContext::FreeStack(stack, size, true);
+
+        stack = static_cast<char_t*>(FiberContext::AllocateStack(size, false));
+        ASSERT_TRUE(stack != NULL);
+        stack[0] = 1;
+        stack[size - 1] = 2;
+        FiberContext::FreeStack(stack, size, false);
+
+        EXPECT_TRUE(FiberContext::AllocateStack(0, true) == NULL);
+    }
+
+    TEST(FiberContext, switchBackAndForth)
+    {
+        const uint_t size = 64 * 1024;
+        void* stack = FiberContext::AllocateStack(size, true);
+        ASSERT_TRUE(stack != NULL);
+
+        PingPong pingPong;
+        pingPong.counter = 0;
+        pingPong.value = 0.0;
+        pingPong.fiber.init(stack, size, &CountForever, &pingPong);
+
+        double_t expected = 0.0;
+        for (uint32_t i = 1; i <= 100; ++i)
+        {
+            FiberContext::Switch(pingPong.caller, pingPong.fiber);
+            EXPECT_EQ(i, pingPong.counter);
+            expected = expected * 0.5 + 1.0;
+            EXPECT_DOUBLE_EQ(expected, pingPong.value);
+        }
+        FiberContext::FreeStack(stack, size, true);
+    }
+
+    TEST(FiberContext, independentContexts)
+    {
+        const uint_t size = 64 * 1024;
+        void* stack1 = FiberContext::AllocateStack(size, false);
+        void* stack2 = FiberContext::AllocateStack(size, false);
+        ASSERT_TRUE(stack1 != NULL);
+        ASSERT_TRUE(stack2 != NULL);
+
+        PingPong first;
+        first.counter = 0;
+        first.value = 0.0;
+        first.fiber.init(stack1, size, &CountForever, &first);
+        PingPong second;
+        second.counter = 100;
+        second.value = 0.0;
+        second.fiber.init(stack2, size, &CountForever, &second);
+
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            FiberContext::Switch(first.caller, first.fiber);
+            FiberContext::Switch(second.caller, second.fiber);
+            FiberContext::Switch(second.caller, second.fiber);
+        }
+        EXPECT_EQ(10u, first.counter);
+        EXPECT_EQ(120u, second.counter);
+
+        FiberContext::FreeStack(stack1, size, false);
+        FiberContext::FreeStack(stack2, size, false);
+    }
+
+    TEST(FiberContext, performanceSwitch)
+    {
+        const uint_t size = 64 * 1024;
+        void* stack = FiberContext::AllocateStack(size, true);
+        ASSERT_TRUE(stack != NULL);
+
+        PingPong pingPong;
+        pingPong.counter = 0;
+        pingPong.value = 0.0;
+        pingPong.fiber.init(stack, size, &CountForever, &pingPong);
+
+        const uint32_t roundTrips = 10000000;
+        const uint64_t start = Time::GetMilliseconds();
+        for (uint32_t i = 0; i < roundTrips; ++i)
+        {
+            FiberContext::Switch(pingPong.caller, pingPong.fiber);
+        }
+        const uint64_t time = Time::GetMilliseconds() - start;
+        EXPECT_EQ(roundTrips, pingPong.counter);
+
+        // two switches per round trip
+        printf("%u context switches: %u ms, %.1f ns per switch\n", 2 * roundTrips, static_cast<uint32_t>(time),
+               time * 1000000.0 / (2.0 * roundTrips));
+        FiberContext::FreeStack(stack, size, true);
+    }
+}
@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 #include "capu/Config.h"
 #include "capu/os/File.h"
+#include "capu/os/Memory.h"
+#include "capu/os/Time.h"
 
 TEST(File, ConstructorTest)
 {
@@ -84,6 +86,53 @@ TEST(File, WriteTest)
     delete f1;
 }
 
+TEST(File, SyncTest)
+{
+    capu::char_t buf1[15] = "This is a test";
+
+    capu::File f1("test.txt");
+    EXPECT_EQ(capu::CAPU_ERROR, f1.sync());
+    EXPECT_EQ(capu::CAPU_OK, f1.open(capu::READ_WRITE_OVERWRITE_OLD));
+    EXPECT_EQ(capu::CAPU_OK, f1.write(buf1, sizeof(buf1) - 1));
+    EXPECT_EQ(capu::CAPU_OK, f1.sync());
+
+    capu::uint_t size = 0;
+    EXPECT_EQ(capu::CAPU_OK, f1.getSizeInBytes(size));
+    EXPECT_EQ(sizeof(buf1) - 1, size);
+
+    EXPECT_EQ(capu::CAPU_OK, f1.close());
+    EXPECT_EQ(capu::CAPU_OK, f1.remove());
+}
+
+TEST(File, MapReadOnly)
+{
+    capu::char_t buf1[15] = "This is a test";
+    const capu::char_t* data = 0;
+    capu::uint_t size = 0;
+
+    capu::File f1("test.txt");
+    EXPECT_EQ(capu::CAPU_ERROR, f1.unmap());
+    EXPECT_EQ(capu::CAPU_OK, f1.open(capu::READ_WRITE_OVERWRITE_OLD));
+    EXPECT_EQ(capu::CAPU_EINVAL, f1.mapReadOnly(data, size));
+    EXPECT_EQ(capu::CAPU_OK, f1.write(buf1, sizeof(buf1) - 1));
+    EXPECT_EQ(capu::CAPU_OK, f1.close());
+
+    EXPECT_EQ(capu::CAPU_OK, f1.mapReadOnly(data, size));
+    ASSERT_EQ(sizeof(buf1) - 1, size);
+    EXPECT_EQ(0, capu::Memory::Compare(buf1, data, size));
+
+    // mapping again returns the same memory
+    const capu::char_t* data2 = 0;
+    EXPECT_EQ(capu::CAPU_OK, f1.mapReadOnly(data2, size));
+    EXPECT_EQ(data, data2);
+
+    EXPECT_EQ(capu::CAPU_OK, f1.unmap());
+    EXPECT_EQ(capu::CAPU_OK, f1.remove());
+
+    capu::File missing("missing.txt");
+    EXPECT_EQ(capu::CAPU_ENOT_EXIST, missing.mapReadOnly(data, size));
+}
+
 TEST(File, WriteSubstring)
 {
     capu::char_t bufWrite[40] = "This is a substring. This is a postfix.";
@@ -348,6 +397,189 @@ TEST(File, TestCopyOnNotExistingSourceFile)
     fileDest.remove();
 }
 
+class CopyListener : public capu::IFileCopyListener
+{
+public:
+    CopyListener(capu::uint32_t cancelAfter = 0)
+        : calls(0)
+        , copiedBytes(0)
+        , totalBytes(0)
+        , mCancelAfter(cancelAfter)
+    {
+    }
+
+    capu::status_t copyProgress(const capu::uint64_t copied, const capu::uint64_t total)
+    {
+        ++calls;
+        EXPECT_LT(copiedBytes, copied);
+        copiedBytes = copied;
+        totalBytes = total;
+        return (mCancelAfter > 0 && calls >= mCancelAfter) ? capu::CAPU_ETIMEOUT : capu::CAPU_OK;
+    }
+
+    capu::uint32_t calls;
+    capu::uint64_t copiedBytes;
+    capu::uint64_t totalBytes;
+
+private:
+    capu::uint32_t mCancelAfter;
+};
+
+static void createPatternFile(const capu::String& path, capu::uint_t size)
+{
+    capu::File file(path);
+    file.open(capu::READ_WRITE_OVERWRITE_OLD);
+    capu::char_t buffer[4096];
+    for (capu::uint_t i = 0; i < sizeof(buffer); i++)
+    {
+        buffer[i] = static_cast<capu::char_t>(i * 7);
+    }
+    for (capu::uint_t written = 0; written < size; written += sizeof(buffer))
+    {
+        file.write(buffer, size - written < sizeof(buffer) ? size - written : sizeof(buffer));
+    }
+    file.close();
+}
+
+static bool sameContent(const capu::String& path1, const capu::String& path2)
+{
+    capu::File file1(path1);
+    capu::File file2(path2);
+    if (file1.open(capu::READ_ONLY) != capu::CAPU_OK || file2.open(capu::READ_ONLY) != capu::CAPU_OK)
+    {
+        return false;
+    }
+    capu::char_t buffer1[4096];
+    capu::char_t buffer2[4096];
+    for (;;)
+    {
+        capu::uint_t read1 = 0;
+        capu::uint_t read2 = 0;
+        capu::status_t status1 = file1.read(buffer1, sizeof(buffer1), read1);
+        capu::status_t status2 = file2.read(buffer2, sizeof(buffer2), read2);
+        if (read1 != read2 || status1 != status2 || capu::Memory::Compare(buffer1, buffer2, read1) != 0)
+        {
+            return false;
+        }
+        if (status1 != capu::CAPU_OK)
+        {
+            return status1 == capu::CAPU_EOF;
+        }
+    }
+}
+
+TEST(File, TestCopyContent)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    createPatternFile(file.getPath(), 3 * 1024 * 1024 + 123);
+
+    EXPECT_EQ(capu::CAPU_OK, file.copyTo(fileDest.getPath()));
+    EXPECT_TRUE(sameContent(file.getPath(), fileDest.getPath()));
+
+    file.remove();
+    fileDest.remove();
+}
+
+TEST(File, TestCopyProgress)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    const capu::uint_t size = 3 * 1024 * 1024 + 123;
+    createPatternFile(file.getPath(), size);
+
+    CopyListener listener;
+    EXPECT_EQ(capu::CAPU_OK, file.copyTo(fileDest.getPath(), &listener));
+    EXPECT_LT(0u, listener.calls);
+    EXPECT_EQ(size, listener.copiedBytes);
+    EXPECT_EQ(size, listener.totalBytes);
+    EXPECT_TRUE(sameContent(file.getPath(), fileDest.getPath()));
+
+    file.remove();
+    fileDest.remove();
+}
+
+TEST(File, TestCopyEmptyFileWithProgress)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    EXPECT_EQ(capu::CAPU_OK, file.createFile());
+
+    CopyListener listener;
+    EXPECT_EQ(capu::CAPU_OK, file.copyTo(fileDest.getPath(), &listener));
+    EXPECT_TRUE(fileDest.exists());
+    EXPECT_EQ(0u, listener.copiedBytes);
+
+    file.remove();
+    fileDest.remove();
+}
+
+TEST(File, TestCopyCancel)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    createPatternFile(file.getPath(), 3 * 1024 * 1024);
+
+    CopyListener listener(1);
+    EXPECT_EQ(capu::CAPU_ETIMEOUT, file.copyTo(fileDest.getPath(), &listener));
+    EXPECT_EQ(1u, listener.calls);
+    EXPECT_FALSE(fileDest.exists());
+
+    file.remove();
+}
+
+static capu::status_t copySmallBuffer(const capu::String& from, const capu::String& to)
+{
+    // the former implementation of copyTo
+    FILE* handleFrom = fopen(from.c_str(), "r");
+    FILE* handleTo = fopen(to.c_str(), "w");
+    capu::char_t copybuffer[1024];
+    size_t bytesRead = 0;
+    while ((bytesRead = fread(copybuffer, sizeof(capu::char_t), sizeof(copybuffer), handleFrom)) > 0)
+    {
+        fwrite(copybuffer, sizeof(capu::char_t), bytesRead, handleTo);
+    }
+    fclose(handleFrom);
+    fclose(handleTo);
+    return capu::CAPU_OK;
+}
+
+TEST(File, performanceCopySmallBuffer)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    createPatternFile(file.getPath(), 256 * 1024 * 1024);
+
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(capu::CAPU_OK, copySmallBuffer(file.getPath(), fileDest.getPath()));
+    }
+    const capu::uint64_t duration = capu::Time::GetMilliseconds() - start;
+    printf("[File] - copying 1 GiB with a 1 KiB buffer takes %u ms\n", static_cast<capu::uint32_t>(duration));
+
+    file.remove();
+    fileDest.remove();
+}
+
+TEST(File, performanceCopyTo)
+{
+    capu::File file("something2");
+    capu::File fileDest("something3");
+    createPatternFile(file.getPath(), 256 * 1024 * 1024);
+
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(capu::CAPU_OK, file.copyTo(fileDest.getPath()));
+    }
+    const capu::uint64_t duration = capu::Time::GetMilliseconds() - start;
+    printf("[File] - copying 1 GiB with copyTo takes %u ms\n", static_cast<capu::uint32_t>(duration));
+
+    file.remove();
+    fileDest.remove();
+}
+
 TEST(File, TestGetFilename)
 {
     capu::File f1("filename");
@@ -118,6 +118,19 @@ TEST(Memory, copyWithStrings)
     EXPECT_EQ("hello world", othervals[5]);
 }
 
+TEST(Memory, copyObjectWithClassTypeNoElements)
+{
+    SomeTestClass vals[12];
+    SomeTestClass othervals[12];
+
+    // must not touch any element, not even the ones before the pointers
+    capu::Memory::CopyObject(othervals + 11, vals + 11, 0);
+    for (capu::uint32_t i = 0; i < 12; i++)
+    {
+        EXPECT_FALSE(othervals[i].assignmentOperatorCalled);
+    }
+}
+
 TEST(Memory, moveOjectWithClassTypeNoOverlap)
 {
     SomeTestClass vals[10];
@@ -174,3 +187,98 @@ TEST(Memory, usedMemoryTest)
     EXPECT_GE(memUsageAfter, memUsage);
     delete[] someMem;
 }
+
+TEST(Memory, allocateAligned)
+{
+    const capu::uint_t alignments[] = {sizeof(void*), 16, CAPU_CACHE_LINE_SIZE, 4096};
+    for (capu::uint_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); ++i)
+    {
+        void* mem = capu::Memory::AllocateAligned(100, alignments[i]);
+        ASSERT_TRUE(mem != NULL);
+        EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(mem) % alignments[i]);
+        capu::Memory::Set(mem, 0xAB, 100);
+        capu::Memory::FreeAligned(mem);
+    }
+}
+
+TEST(Memory, allocateAlignedInvalid)
+{
+    EXPECT_TRUE(NULL == capu::Memory::AllocateAligned(0, 16));
+    EXPECT_TRUE(NULL == capu::Memory::AllocateAligned(100, 24));
+    capu::Memory::FreeAligned(NULL);
+}
+
+TEST(Memory, allocateLarge)
+{
+    const capu::uint_t size = 4 * 1024 * 1024;
+    capu::char_t* mem = static_cast<capu::char_t*>(capu::Memory::AllocateLarge(size));
+    ASSERT_TRUE(mem != NULL);
+    EXPECT_EQ(0u, reinterpret_cast<capu::uint_t>(mem) % 4096);
+    capu::Memory::Set(mem, 1, size);
+    EXPECT_EQ(1, mem[size - 1]);
+    capu::Memory::FreeLarge(mem, size);
+
+    EXPECT_TRUE(NULL == capu::Memory::AllocateLarge(0));
+    capu::Memory::FreeLarge(NULL, 0);
+}
+
+TEST(Memory, prefetch)
+{
+    capu::uint32_t values[16] = {0};
+    capu::Memory::Prefetch(&values[8]);
+    EXPECT_EQ(0u, values[8]);
+}
+
+TEST(Memory, copyNonTemporal)
+{
+    // sizes below and above the streaming threshold and an unaligned destination
+    const capu::uint_t sizes[] = {0, 1, 100, 300 * 1024, 1024 * 1024 + 13};
+    for (capu::uint_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        const capu::uint_t size = sizes[i];
+        capu::char_t* src = new capu::char_t[size + 1];
+        capu::char_t* dst = new capu::char_t[size + 4];
+        for (capu::uint_t j = 0; j < size; ++j)
+        {
+            src[j] = static_cast<capu::char_t>(j * 7);
+        }
+        capu::Memory::CopyNonTemporal(dst + 3, src, size);
+        EXPECT_EQ(0, capu::Memory::Compare(dst + 3, src, size));
+        delete[] src;
+        delete[] dst;
+    }
+}
+
+TEST(Memory, performanceCopy)
+{
+    const capu::uint_t size = 64 * 1024 * 1024;
+    capu::char_t* src = static_cast<capu::char_t*>(capu::Memory::AllocateLarge(size));
+    capu::char_t* dst = static_cast<capu::char_t*>(capu::Memory::AllocateLarge(size));
+    ASSERT_TRUE(src != NULL && dst != NULL);
+    capu::Memory::Set(src, 1, size);
+    capu::Memory::Set(dst, 0, size);
+    for (capu::uint_t i = 0; i < 4; ++i)
+    {
+        capu::Memory::Copy(dst, src, size);
+    }
+    EXPECT_EQ(1, dst[size - 1]);
+    capu::Memory::FreeLarge(src, size);
+    capu::Memory::FreeLarge(dst, size);
+}
+
+TEST(Memory, performanceCopyNonTemporal)
+{
+    const capu::uint_t size = 64 * 1024 * 1024;
+    capu::char_t* src = static_cast<capu::char_t*>(capu::Memory::AllocateLarge(size));
+    capu::char_t* dst = static_cast<capu::char_t*>(capu::Memory::AllocateLarge(size));
+    ASSERT_TRUE(src != NULL && dst != NULL);
+    capu::Memory::Set(src, 1, size);
+    capu::Memory::Set(dst, 0, size);
+    for (capu::uint_t i = 0; i < 4; ++i)
+    {
+        capu::Memory::CopyNonTemporal(dst, src, size);
+    }
+    EXPECT_EQ(1, dst[size - 1]);
+    capu::Memory::FreeLarge(src, size);
+    capu::Memory::FreeLarge(dst, size);
+}
@@ -58,3 +58,51 @@ TEST(Random, TestUInt32)
     EXPECT_TRUE(i1 != i2);
 }
 
+
+TEST(Random, TestUInt64)
+{
+    capu::Random rand;
+    capu::uint64_t i1 = rand.nextUInt64();
+    capu::uint64_t i2 = rand.nextUInt64();
+    EXPECT_TRUE(i1 != i2);
+}
+
+TEST(Random, InstancesAreIndependent)
+{
+    capu::Random rand1;
+    capu::Random rand2;
+    EXPECT_TRUE(rand1.nextUInt64() != rand2.nextUInt64());
+}
+
+TEST(Random, Fill)
+{
+    capu::Random rand;
+
+    // odd length to cover the tail which is not a multiple of 8 bytes
+    capu::uint8_t buffer[37];
+    capu::Memory::Set(buffer, 0, sizeof(buffer));
+    rand.fill(buffer, 35);
+
+    capu::uint32_t zeroBytes = 0;
+    for (capu::uint32_t i = 0; i < 35; ++i)
+    {
+        if (buffer[i] == 0)
+        {
+            ++zeroBytes;
+        }
+    }
+    EXPECT_GT(10u, zeroBytes);
+
+    // bytes after the requested length are untouched
+    EXPECT_EQ(0u, buffer[35]);
+    EXPECT_EQ(0u, buffer[36]);
+}
+
+TEST(Random, FillThreadLocal)
+{
+    capu::uint64_t value1 = 0;
+    capu::uint64_t value2 = 0;
+    capu::Random::FillThreadLocal(&value1, sizeof(value1));
+    capu::Random::FillThreadLocal(&value2, sizeof(value2));
+    EXPECT_TRUE(value1 != value2);
+}
@@ -134,4 +134,107 @@ TEST(StringUtils, IndexOf2)
     EXPECT_EQ(6, capu::StringUtils::IndexOf("Hello World", "World"));
     EXPECT_EQ(-1, capu::StringUtils::IndexOf("Hello World", "WORLD"));
 
-}
\ No newline at end of file
+}
+
+TEST(StringUtils, IndexOfWithLength)
+{
+    EXPECT_EQ(6, capu::StringUtils::IndexOf("Hello World", 11, "World", 5));
+    EXPECT_EQ(0, capu::StringUtils::IndexOf("Hello World", 11, "", 0));
+    EXPECT_EQ(-1, capu::StringUtils::IndexOf("Hello", 5, "Hello World", 11));
+    EXPECT_EQ(4, capu::StringUtils::IndexOf("Hello World", 11, "o", 1));
+    EXPECT_EQ(-1, capu::StringUtils::IndexOf("Hello World", 11, "x", 1));
+    EXPECT_EQ(-1, capu::StringUtils::IndexOf("Hello World", 11, "Wold", 4));
+}
+
+TEST(StringUtils, IndexOfAcrossBlocks)
+{
+    // move the match and the string length over several 16 and 32 byte boundaries
+    const capu::uint_t maxLength = 100;
+    capu::char_t buffer[maxLength + 1];
+    const capu::char_t* pattern = "abcab";
+
+    for (capu::uint_t length = 5; length <= maxLength; ++length)
+    {
+        for (capu::uint_t position = 0; position + 5 <= length; position += 3)
+        {
+            capu::Memory::Set(buffer, 'a', length);
+            buffer[length] = 0;
+            // near misses which only match the first and the last character
+            buffer[0] = 'a';
+            if (length > 9)
+            {
+                buffer[length - 5] = 'a';
+                buffer[length - 1] = 'b';
+            }
+            capu::Memory::Copy(buffer + position, pattern, 5);
+
+            EXPECT_EQ(static_cast<capu::int_t>(position), capu::StringUtils::IndexOf(buffer, length, pattern, 5));
+            EXPECT_EQ(static_cast<capu::int_t>(position), capu::StringUtils::IndexOf(buffer, pattern));
+        }
+
+        capu::Memory::Set(buffer, 'a', length);
+        buffer[length - 1] = 'b';
+        EXPECT_EQ(-1, capu::StringUtils::IndexOf(buffer, length, pattern, 5));
+    }
+}
+
+TEST(StringUtils, ToUpperCase)
+{
+    capu::char_t text[] = "Some text with 1234 numbers, UPPER and lower case characters and \xe4 \xc4 umlauts";
+    capu::char_t expected[] = "SOME TEXT WITH 1234 NUMBERS, UPPER AND LOWER CASE CHARACTERS AND \xe4 \xc4 UMLAUTS";
+    capu::StringUtils::ToUpperCase(text, sizeof(text) - 1);
+    EXPECT_STREQ(expected, text);
+}
+
+TEST(StringUtils, ToLowerCase)
+{
+    capu::char_t text[] = "Some text with 1234 numbers, UPPER and lower case characters and \xe4 \xc4 umlauts@[`{";
+    capu::char_t expected[] = "some text with 1234 numbers, upper and lower case characters and \xe4 \xc4 umlauts@[`{";
+    capu::StringUtils::ToLowerCase(text, sizeof(text) - 1);
+    EXPECT_STREQ(expected, text);
+}
+
+TEST(StringUtils, ToUpperCasePartial)
+{
+    capu::char_t text[] = "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz";
+    capu::StringUtils::ToUpperCase(text, 40);
+    EXPECT_STREQ("ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMNopqrstuvwxyz", text);
+}
+
+TEST(StringUtils, performanceIndexOf)
+{
+    const capu::uint_t length = 1024 * 1024;
+    capu::char_t* buffer = new capu::char_t[length + 1];
+    for (capu::uint_t i = 0; i < length; ++i)
+    {
+        buffer[i] = 'a' + static_cast<capu::char_t>(i % 7);
+    }
+    buffer[length] = 0;
+    const capu::char_t* pattern = "abcdefgx";
+
+    capu::int_t result = 0;
+    for (capu::uint_t i = 0; i < 100; ++i)
+    {
+        result += capu::StringUtils::IndexOf(buffer, length, pattern, 8);
+    }
+    EXPECT_EQ(-100, result);
+    delete[] buffer;
+}
+
+TEST(StringUtils, performanceToUpperCase)
+{
+    const capu::uint_t length = 1024 * 1024;
+    capu::char_t* buffer = new capu::char_t[length];
+    for (capu::uint_t i = 0; i < length; ++i)
+    {
+        buffer[i] = static_cast<capu::char_t>(32 + i % 95);
+    }
+
+    for (capu::uint_t i = 0; i < 100; ++i)
+    {
+        capu::StringUtils::ToUpperCase(buffer, length);
+        capu::StringUtils::ToLowerCase(buffer, length);
+    }
+    EXPECT_EQ('a', buffer[65 - 32]);
+    delete[] buffer;
+}
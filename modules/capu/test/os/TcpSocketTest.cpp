@@ -20,6 +20,11 @@
 #include "capu/os/TcpSocket.h"
 #include "capu/os/Mutex.h"
 #include "capu/os/CondVar.h"
+#include "capu/os/File.h"
+#include "capu/os/Memory.h"
+#include "capu/os/Time.h"
+#include "capu/util/BinaryFileInputStream.h"
+#include "capu/util/TcpSocketOutputStream.h"
 
 capu::Mutex mutex;
 capu::CondVar cv;
@@ -548,3 +553,219 @@ TEST(SocketAndTcpServerSocket, ReceiveReturnsOkOnClose)
     EXPECT_EQ(0, server.receivedLength);
 }
 
+
+class SinkServer : public capu::Runnable
+{
+public:
+    SinkServer(capu::char_t* data = NULL, capu::uint_t capacity = 0)
+        : received(0)
+        , mData(data)
+        , mCapacity(capacity)
+    {
+        server.bind(0, "127.0.0.1");
+        port = server.port();
+        server.listen(1);
+        mThread.start(*this);
+    }
+
+    void waitForClose()
+    {
+        mThread.join();
+    }
+
+    void run()
+    {
+        capu::TcpSocket* client = server.accept();
+        capu::char_t buffer[65536];
+        capu::int32_t length = 0;
+        while (client->receive(buffer, sizeof(buffer), length) == capu::CAPU_OK && length > 0)
+        {
+            if (mData && received + length <= mCapacity)
+            {
+                capu::Memory::Copy(mData + received, buffer, length);
+            }
+            received += length;
+        }
+        delete client;
+    }
+
+    capu::TcpServerSocket server;
+    capu::uint16_t port;
+    capu::uint_t received;
+
+private:
+    capu::char_t* mData;
+    capu::uint_t mCapacity;
+    capu::Thread mThread;
+};
+
+static void writeTestFile(const capu::char_t* path, capu::char_t* data, capu::uint_t size)
+{
+    for (capu::uint_t i = 0; i < size; i++)
+    {
+        data[i] = static_cast<capu::char_t>(i * 13 + (i >> 12));
+    }
+    capu::File file(path);
+    file.open(capu::READ_WRITE_OVERWRITE_OLD);
+    file.write(data, size);
+    file.close();
+}
+
+static capu::status_t sendWholeFile(capu::TcpSocket& socket, const capu::File& file, capu::uint64_t offset, capu::uint_t length)
+{
+    while (length > 0)
+    {
+        capu::uint_t sent = 0;
+        const capu::status_t status = socket.sendFile(file, offset, length, sent);
+        if (status != capu::CAPU_OK)
+        {
+            return status;
+        }
+        offset += sent;
+        length -= sent;
+    }
+    return capu::CAPU_OK;
+}
+
+TEST(TcpSocket, SendFile)
+{
+    const capu::uint_t size = 3 * 1024 * 1024 + 17;
+    capu::char_t* data = new capu::char_t[size];
+    capu::char_t* received = new capu::char_t[size];
+    writeTestFile("sendfile.bin", data, size);
+
+    SinkServer server(received, size);
+    capu::TcpSocket socket;
+    ASSERT_EQ(capu::CAPU_OK, socket.connect("127.0.0.1", server.port));
+
+    capu::File file("sendfile.bin");
+    ASSERT_EQ(capu::CAPU_OK, file.open(capu::READ_ONLY));
+    EXPECT_EQ(capu::CAPU_OK, sendWholeFile(socket, file, 0, size));
+    socket.close();
+    server.waitForClose();
+
+    EXPECT_EQ(size, server.received);
+    EXPECT_EQ(0, capu::Memory::Compare(data, received, size));
+
+    file.close();
+    file.remove();
+    delete[] data;
+    delete[] received;
+}
+
+TEST(TcpSocket, SendFilePart)
+{
+    const capu::uint_t size = 100000;
+    capu::char_t* data = new capu::char_t[size];
+    capu::char_t received[1000];
+    writeTestFile("sendfile.bin", data, size);
+
+    SinkServer server(received, sizeof(received));
+    capu::TcpSocket socket;
+    ASSERT_EQ(capu::CAPU_OK, socket.connect("127.0.0.1", server.port));
+
+    capu::File file("sendfile.bin");
+    ASSERT_EQ(capu::CAPU_OK, file.open(capu::READ_ONLY));
+    EXPECT_EQ(capu::CAPU_OK, sendWholeFile(socket, file, 50000, sizeof(received)));
+
+    // nothing left to send at the end of the file
+    capu::uint_t sent = 1;
+    EXPECT_EQ(capu::CAPU_EOF, socket.sendFile(file, size, 10, sent));
+    EXPECT_EQ(0u, sent);
+    EXPECT_EQ(capu::CAPU_OK, socket.sendFile(file, 0, 0, sent));
+    EXPECT_EQ(0u, sent);
+
+    socket.close();
+    server.waitForClose();
+
+    EXPECT_EQ(sizeof(received), server.received);
+    EXPECT_EQ(0, capu::Memory::Compare(data + 50000, received, sizeof(received)));
+
+    // sending did not move the read position of the file
+    capu::char_t start[16];
+    capu::uint_t readBytes = 0;
+    EXPECT_EQ(capu::CAPU_OK, file.read(start, sizeof(start), readBytes));
+    EXPECT_EQ(sizeof(start), readBytes);
+    EXPECT_EQ(0, capu::Memory::Compare(data, start, sizeof(start)));
+
+    file.close();
+    file.remove();
+    delete[] data;
+}
+
+TEST(TcpSocket, SendFileErrors)
+{
+    capu::File file("sendfile.bin");
+    capu::TcpSocket socket;
+    capu::uint_t sent = 0;
+    EXPECT_EQ(capu::CAPU_EINVAL, socket.sendFile(file, 0, 10, sent));
+
+    ASSERT_EQ(capu::CAPU_OK, file.open(capu::READ_WRITE_OVERWRITE_OLD));
+    EXPECT_EQ(capu::CAPU_SOCKET_ESOCKET, socket.sendFile(file, 0, 10, sent));
+    file.close();
+    file.remove();
+}
+
+TEST(TcpSocket, performanceSendFile)
+{
+    const capu::uint_t size = 64 * 1024 * 1024;
+    capu::char_t* data = new capu::char_t[size];
+    writeTestFile("sendfile.bin", data, size);
+    delete[] data;
+
+    SinkServer server;
+    capu::TcpSocket socket;
+    ASSERT_EQ(capu::CAPU_OK, socket.connect("127.0.0.1", server.port));
+    capu::File file("sendfile.bin");
+    ASSERT_EQ(capu::CAPU_OK, file.open(capu::READ_ONLY));
+
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    for (capu::uint32_t i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(capu::CAPU_OK, sendWholeFile(socket, file, 0, size));
+    }
+    socket.close();
+    server.waitForClose();
+    const capu::uint64_t duration = capu::Time::GetMilliseconds() - start;
+    printf("[TcpSocket] - sending 512 MiB with sendFile takes %u ms\n", static_cast<capu::uint32_t>(duration));
+    EXPECT_EQ(8 * size, server.received);
+
+    file.close();
+    file.remove();
+}
+
+TEST(TcpSocket, performanceSendFileThroughStreams)
+{
+    const capu::uint_t size = 64 * 1024 * 1024;
+    capu::char_t* data = new capu::char_t[size];
+    writeTestFile("sendfile.bin", data, size);
+    delete[] data;
+
+    SinkServer server;
+    capu::TcpSocket socket;
+    ASSERT_EQ(capu::CAPU_OK, socket.connect("127.0.0.1", server.port));
+
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    // chunks which go through the stream buffer as in typical serving code
+    capu::char_t buffer[1024];
+    for (capu::uint32_t i = 0; i < 8; i++)
+    {
+        capu::File file("sendfile.bin");
+        capu::BinaryFileInputStream input(file);
+        capu::TcpSocketOutputStream<> output(socket);
+        for (capu::uint_t offset = 0; offset < size; offset += sizeof(buffer))
+        {
+            input.read(buffer, sizeof(buffer));
+            output.write(buffer, sizeof(buffer));
+        }
+        EXPECT_EQ(capu::CAPU_OK, output.flush());
+        file.close();
+    }
+    socket.close();
+    server.waitForClose();
+    const capu::uint64_t duration = capu::Time::GetMilliseconds() - start;
+    printf("[TcpSocket] - sending 512 MiB through BinaryFileInputStream and TcpSocketOutputStream takes %u ms\n", static_cast<capu::uint32_t>(duration));
+    EXPECT_EQ(8 * size, server.received);
+
+    capu::File("sendfile.bin").remove();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2013 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/os/ThreadAttributes.h"
+#include "capu/os/StringUtils.h"
+
+namespace capu
+{
+    TEST(CpuSet, emptyByDefault)
+    {
+        CpuSet cpus;
+        EXPECT_TRUE(cpus.empty());
+        EXPECT_EQ(0u, cpus.count());
+        EXPECT_FALSE(cpus.contains(0));
+    }
+
+    TEST(CpuSet, addRemoveContains)
+    {
+        CpuSet cpus;
+        EXPECT_EQ(CAPU_OK, cpus.add(0));
+        EXPECT_EQ(CAPU_OK, cpus.add(63));
+        EXPECT_EQ(CAPU_OK, cpus.add(64));
+        EXPECT_EQ(CAPU_OK, cpus.add(255));
+        EXPECT_EQ(CAPU_OK, cpus.add(64));
+        EXPECT_FALSE(cpus.empty());
+        EXPECT_EQ(4u, cpus.count());
+        EXPECT_TRUE(cpus.contains(0));
+        EXPECT_TRUE(cpus.contains(63));
+        EXPECT_TRUE(cpus.contains(64));
+        EXPECT_TRUE(cpus.contains(255));
+        EXPECT_FALSE(cpus.contains(1));
+
+        cpus.remove(63);
+        EXPECT_FALSE(cpus.contains(63));
+        EXPECT_EQ(3u, cpus.count());
+
+        cpus.clear();
+        EXPECT_TRUE(cpus.empty());
+    }
+
+    TEST(CpuSet, outOfRange)
+    {
+        CpuSet cpus;
+        EXPECT_EQ(CAPU_ERANGE, cpus.add(256));
+        EXPECT_FALSE(cpus.contains(256));
+        cpus.remove(256);
+        EXPECT_TRUE(cpus.empty());
+    }
+
+    TEST(CpuSet, getByPosition)
+    {
+        CpuSet cpus;
+        cpus.add(3);
+        cpus.add(70);
+        cpus.add(130);
+        EXPECT_EQ(3u, cpus.get(0));
+        EXPECT_EQ(70u, cpus.get(1));
+        EXPECT_EQ(130u, cpus.get(2));
+        EXPECT_EQ(256u, cpus.get(3));
+    }
+
+    TEST(ThreadAttributes, defaults)
+    {
+        ThreadAttributes attributes;
+        EXPECT_TRUE(attributes.getCpuSet().empty());
+        EXPECT_EQ(0u, attributes.getStackSize());
+        EXPECT_EQ(TSP_DEFAULT, attributes.getSchedulingPolicy());
+        EXPECT_EQ(0, attributes.getPriority());
+        EXPECT_STREQ("", attributes.getName());
+    }
+
+    TEST(ThreadAttributes, setters)
+    {
+        CpuSet cpus;
+        cpus.add(2);
+        ThreadAttributes attributes;
+        attributes.setCpuSet(cpus);
+        attributes.setStackSize(1024 * 1024);
+        attributes.setScheduling(TSP_ROUND_ROBIN, 10);
+        attributes.setName("worker");
+
+        EXPECT_TRUE(attributes.getCpuSet().contains(2));
+        EXPECT_EQ(1u, attributes.getCpuSet().count());
+        EXPECT_EQ(1024u * 1024u, attributes.getStackSize());
+        EXPECT_EQ(TSP_ROUND_ROBIN, attributes.getSchedulingPolicy());
+        EXPECT_EQ(10, attributes.getPriority());
+        EXPECT_STREQ("worker", attributes.getName());
+    }
+
+    TEST(ThreadAttributes, nameIsCut)
+    {
+        ThreadAttributes attributes;
+        attributes.setName("a name which is far too long");
+        EXPECT_STREQ("a name which is", attributes.getName());
+        EXPECT_EQ(15u, StringUtils::Strlen(attributes.getName()));
+
+        attributes.setName(NULL);
+        EXPECT_STREQ("", attributes.getName());
+    }
+}
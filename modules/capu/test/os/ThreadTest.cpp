@@ -289,3 +289,84 @@ TEST(Thread, cancelWithoutRunnable)
 
     // no test as just no crash is expected
 }
+
+class AttributesTester : public capu::Runnable
+{
+public:
+    capu::char_t m_name[16];
+    capu::int32_t m_cpu;
+
+    AttributesTester()
+        : m_cpu(-1)
+    {
+        m_name[0] = 0;
+    }
+
+    void run()
+    {
+#ifdef __linux__
+        pthread_getname_np(pthread_self(), m_name, sizeof(m_name));
+        m_cpu = sched_getcpu();
+#endif
+    }
+};
+
+TEST(Thread, getAvailableCpus)
+{
+    capu::CpuSet cpus;
+    EXPECT_EQ(capu::CAPU_OK, capu::Thread::GetAvailableCpus(cpus));
+    EXPECT_LE(1u, cpus.count());
+}
+
+TEST(Thread, startWithAttributes)
+{
+    capu::ThreadAttributes attributes;
+    attributes.setStackSize(512 * 1024);
+    attributes.setScheduling(capu::TSP_OTHER, 0);
+    attributes.setName("capuWorker");
+
+    AttributesTester tester;
+    capu::Thread thread;
+    EXPECT_EQ(capu::CAPU_OK, thread.start(tester, attributes));
+    EXPECT_EQ(capu::CAPU_ERROR, thread.start(tester, attributes));
+    EXPECT_EQ(capu::CAPU_OK, thread.join());
+    EXPECT_EQ(capu::TS_TERMINATED, thread.getState());
+#ifdef __linux__
+    EXPECT_STREQ("capuWorker", tester.m_name);
+#endif
+}
+
+TEST(Thread, startWithInvalidPriority)
+{
+    capu::ThreadAttributes attributes;
+    attributes.setScheduling(capu::TSP_OTHER, 1000);
+
+    AttributesTester tester;
+    capu::Thread thread;
+    EXPECT_EQ(capu::CAPU_EINVAL, thread.start(tester, attributes));
+    EXPECT_EQ(capu::TS_NEW, thread.getState());
+
+    // the thread can still be started
+    EXPECT_EQ(capu::CAPU_OK, thread.start(tester));
+    EXPECT_EQ(capu::CAPU_OK, thread.join());
+}
+
+TEST(Thread, startPinnedToCpu)
+{
+    capu::CpuSet available;
+    EXPECT_EQ(capu::CAPU_OK, capu::Thread::GetAvailableCpus(available));
+    const capu::uint32_t lastCpu = available.get(available.count() - 1);
+
+    capu::CpuSet cpus;
+    cpus.add(lastCpu);
+    capu::ThreadAttributes attributes;
+    attributes.setCpuSet(cpus);
+
+    AttributesTester tester;
+    capu::Thread thread;
+    EXPECT_EQ(capu::CAPU_OK, thread.start(tester, attributes));
+    EXPECT_EQ(capu::CAPU_OK, thread.join());
+#ifdef __linux__
+    EXPECT_EQ(static_cast<capu::int32_t>(lastCpu), tester.m_cpu);
+#endif
+}
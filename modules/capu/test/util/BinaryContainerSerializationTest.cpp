@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <gtest/gtest.h>
+#include "capu/util/BinaryContainerSerialization.h"
+#include "capu/container/String.h"
+#include "capu/os/NumericLimits.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        template<typename CONTAINER>
+        void RoundTrip(const CONTAINER& values, CONTAINER& result, const StreamEncoding encoding = STREAM_ENCODING_FIXED)
+        {
+            BinaryOutputStream outStream(16, encoding);
+            outStream << values;
+
+            BinaryInputStream inStream(outStream.getData(), outStream.getSize(), encoding);
+            inStream >> result;
+            EXPECT_EQ(CAPU_OK, inStream.getState());
+        }
+
+        const uint32_t ElementCount = 1000000;
+        const uint32_t EntryCount = 200000;
+    }
+
+    TEST(BinaryContainerSerialization, arrayOfPrimitivesIsOneBlock)
+    {
+        Array<double_t> values(100);
+        for (uint32_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = i * 0.25;
+        }
+
+        BinaryOutputStream outStream;
+        outStream << values;
+        ASSERT_EQ(sizeof(uint32_t) + 100 * sizeof(double_t), outStream.getSize());
+        EXPECT_EQ(0, Memory::Compare(outStream.getData() + sizeof(uint32_t), values.getRawData(), 100 * sizeof(double_t)));
+
+        Array<double_t> result(3);
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        inStream >> result;
+        ASSERT_EQ(100u, result.size());
+        EXPECT_EQ(0, Memory::Compare(values.getRawData(), result.getRawData(), 100 * sizeof(double_t)));
+    }
+
+    TEST(BinaryContainerSerialization, emptyContainers)
+    {
+        Array<int32_t> array;
+        Vector<String> vector;
+        List<int32_t> list;
+        HashTable<int32_t, int32_t> table;
+
+        BinaryOutputStream outStream;
+        outStream << array << vector << list << table;
+        EXPECT_EQ(4 * sizeof(uint32_t), outStream.getSize());
+
+        Array<int32_t> arrayResult(2);
+        Vector<String> vectorResult;
+        vectorResult.push_back("old");
+        List<int32_t> listResult;
+        listResult.push_back(1);
+        HashTable<int32_t, int32_t> tableResult;
+        tableResult.put(1, 1);
+
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        inStream >> arrayResult >> vectorResult >> listResult >> tableResult;
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(0u, arrayResult.size());
+        EXPECT_EQ(0u, vectorResult.size());
+        EXPECT_EQ(0u, listResult.size());
+        EXPECT_EQ(0u, tableResult.count());
+    }
+
+    TEST(BinaryContainerSerialization, vectorOfPrimitives)
+    {
+        Vector<int64_t> values;
+        for (int64_t i = -50; i < 50; ++i)
+        {
+            values.push_back(i * 1000000000);
+        }
+        values.push_back(NumericLimits::Min<int64_t>());
+
+        Vector<int64_t> fixedResult;
+        RoundTrip(values, fixedResult);
+        Vector<int64_t> varIntResult;
+        RoundTrip(values, varIntResult, STREAM_ENCODING_VARINT);
+
+        ASSERT_EQ(values.size(), fixedResult.size());
+        ASSERT_EQ(values.size(), varIntResult.size());
+        for (uint32_t i = 0; i < values.size(); ++i)
+        {
+            EXPECT_EQ(values[i], fixedResult[i]);
+            EXPECT_EQ(values[i], varIntResult[i]);
+        }
+    }
+
+    TEST(BinaryContainerSerialization, varIntUsesCompactElements)
+    {
+        Vector<uint32_t> values;
+        Vector<uint16_t> shortValues;
+        Vector<uint8_t> bytes;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            values.push_back(i);
+            shortValues.push_back(static_cast<uint16_t>(i));
+            bytes.push_back(static_cast<uint8_t>(i));
+        }
+
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << values << shortValues << bytes;
+        EXPECT_EQ(3u + 300u, outStream.getSize());
+
+        Vector<uint32_t> valuesResult;
+        Vector<uint16_t> shortValuesResult;
+        Vector<uint8_t> bytesResult;
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize(), STREAM_ENCODING_VARINT);
+        inStream >> valuesResult >> shortValuesResult >> bytesResult;
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        ASSERT_EQ(100u, bytesResult.size());
+        EXPECT_EQ(99u, valuesResult[99]);
+        EXPECT_EQ(99u, shortValuesResult[99]);
+        EXPECT_EQ(99u, bytesResult[99]);
+    }
+
+    TEST(BinaryContainerSerialization, vectorOfStrings)
+    {
+        Vector<String> values;
+        values.push_back("first");
+        values.push_back("");
+        values.push_back("third");
+
+        Vector<String> result;
+        RoundTrip(values, result);
+        ASSERT_EQ(3u, result.size());
+        EXPECT_STREQ("first", result[0].c_str());
+        EXPECT_STREQ("", result[1].c_str());
+        EXPECT_STREQ("third", result[2].c_str());
+    }
+
+    TEST(BinaryContainerSerialization, list)
+    {
+        List<String> values;
+        values.push_back("a");
+        values.push_back("bc");
+        values.push_back("def");
+
+        List<String> result;
+        result.push_back("old");
+        RoundTrip(values, result, STREAM_ENCODING_VARINT);
+        ASSERT_EQ(3u, result.size());
+        EXPECT_STREQ("a", result.get(0).c_str());
+        EXPECT_STREQ("bc", result.get(1).c_str());
+        EXPECT_STREQ("def", result.get(2).c_str());
+    }
+
+    TEST(BinaryContainerSerialization, hashTable)
+    {
+        HashTable<uint32_t, String> values;
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            values.put(i, String(i % 2 ? "odd" : "even"));
+        }
+
+        HashTable<uint32_t, String> result;
+        result.put(5000, "old");
+        RoundTrip(values, result);
+        ASSERT_EQ(1000u, result.count());
+        EXPECT_FALSE(result.contains(5000));
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            EXPECT_STREQ(i % 2 ? "odd" : "even", result.at(i).c_str());
+        }
+    }
+
+    TEST(BinaryContainerSerialization, hashTableWithStringKeys)
+    {
+        HashTable<String, int32_t> values;
+        values.put("minus", -1);
+        values.put("zero", 0);
+        values.put("max", NumericLimits::Max<int32_t>());
+
+        HashTable<String, int32_t> result;
+        RoundTrip(values, result, STREAM_ENCODING_VARINT);
+        ASSERT_EQ(3u, result.count());
+        EXPECT_EQ(-1, result.at("minus"));
+        EXPECT_EQ(0, result.at("zero"));
+        EXPECT_EQ(NumericLimits::Max<int32_t>(), result.at("max"));
+    }
+
+    TEST(BinaryContainerSerialization, nestedContainers)
+    {
+        Vector<Vector<int32_t> > values;
+        for (int32_t i = 0; i < 10; ++i)
+        {
+            Vector<int32_t> inner;
+            for (int32_t j = 0; j < i; ++j)
+            {
+                inner.push_back(i * j);
+            }
+            values.push_back(inner);
+        }
+
+        Vector<Vector<int32_t> > result;
+        RoundTrip(values, result);
+        ASSERT_EQ(10u, result.size());
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            ASSERT_EQ(i, result[i].size());
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                EXPECT_EQ(static_cast<int32_t>(i * j), result[i][j]);
+            }
+        }
+    }
+
+    TEST(BinaryContainerSerialization, truncatedStream)
+    {
+        Vector<uint64_t> values;
+        values.push_back(1);
+        values.push_back(2);
+        // values longer than their minimum size, so that the count passes the size check
+        HashTable<int32_t, String> table;
+        table.put(1, "one");
+        table.put(3, "three");
+
+        BinaryOutputStream outStream;
+        outStream << values;
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize() - 1);
+        Vector<uint64_t> result;
+        inStream >> result;
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+
+        BinaryOutputStream tableStream;
+        tableStream << table;
+        BinaryInputStream tableInStream(tableStream.getData(), tableStream.getSize() - 1);
+        HashTable<int32_t, String> tableResult;
+        tableInStream >> tableResult;
+        EXPECT_EQ(CAPU_EOF, tableInStream.getState());
+        EXPECT_EQ(1u, tableResult.count());
+    }
+
+    TEST(BinaryContainerSerialization, hugeCountIsRejected)
+    {
+        // a corrupt count followed by a few bytes must not size the containers for it
+        BinaryOutputStream outStream;
+        outStream << static_cast<uint32_t>(0xFFFFFFF0u);
+        outStream << static_cast<uint32_t>(1);
+        outStream << static_cast<uint32_t>(2);
+
+        Vector<uint32_t> vector;
+        BinaryInputStream vectorStream(outStream.getData(), outStream.getSize());
+        vectorStream >> vector;
+        EXPECT_EQ(CAPU_EOF, vectorStream.getState());
+        EXPECT_EQ(0u, vector.size());
+
+        Array<uint64_t> array;
+        BinaryInputStream arrayStream(outStream.getData(), outStream.getSize());
+        arrayStream >> array;
+        EXPECT_EQ(CAPU_EOF, arrayStream.getState());
+        EXPECT_EQ(0u, array.size());
+
+        Vector<String> strings;
+        BinaryInputStream stringStream(outStream.getData(), outStream.getSize());
+        stringStream >> strings;
+        EXPECT_EQ(CAPU_EOF, stringStream.getState());
+        EXPECT_EQ(0u, strings.size());
+
+        HashTable<int32_t, int32_t> table;
+        BinaryInputStream tableStream(outStream.getData(), outStream.getSize());
+        tableStream >> table;
+        EXPECT_EQ(CAPU_EOF, tableStream.getState());
+        EXPECT_EQ(0u, table.count());
+
+        List<int32_t> list;
+        BinaryInputStream listStream(outStream.getData(), outStream.getSize());
+        listStream >> list;
+        EXPECT_EQ(CAPU_EOF, listStream.getState());
+        EXPECT_EQ(0u, list.size());
+    }
+
+    TEST(BinaryContainerSerialization, countFillingTheBufferIsAccepted)
+    {
+        // eight bytes are left after the count, exactly two uint32_t elements
+        BinaryOutputStream outStream;
+        outStream << static_cast<uint32_t>(2);
+        outStream << static_cast<uint32_t>(1);
+        outStream << static_cast<uint32_t>(2);
+
+        Vector<uint32_t> vector;
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        inStream >> vector;
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        ASSERT_EQ(2u, vector.size());
+        EXPECT_EQ(2u, vector[1]);
+    }
+
+    TEST(BinaryContainerSerialization, performanceVector)
+    {
+        Vector<uint32_t> values(ElementCount);
+        for (uint32_t i = 0; i < ElementCount; ++i)
+        {
+            values.push_back(i * 7);
+        }
+
+        uint64_t start = Time::GetMilliseconds();
+        BinaryOutputStream elementStream;
+        elementStream << values.size();
+        for (uint32_t i = 0; i < values.size(); ++i)
+        {
+            elementStream << values[i];
+        }
+        BinaryInputStream elementInStream(elementStream.getData(), elementStream.getSize());
+        uint32_t count = 0;
+        elementInStream >> count;
+        Vector<uint32_t> elementResult;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t value = 0;
+            elementInStream >> value;
+            elementResult.push_back(value);
+        }
+        const uint64_t elementTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        BinaryOutputStream bulkStream;
+        bulkStream << values;
+        BinaryInputStream bulkInStream(bulkStream.getData(), bulkStream.getSize());
+        Vector<uint32_t> bulkResult;
+        bulkInStream >> bulkResult;
+        const uint64_t bulkTime = Time::GetMilliseconds() - start;
+
+        ASSERT_EQ(elementStream.getSize(), bulkStream.getSize());
+        EXPECT_EQ(0, Memory::Compare(elementStream.getData(), bulkStream.getData(), bulkStream.getSize()));
+        ASSERT_EQ(ElementCount, bulkResult.size());
+        EXPECT_EQ(elementResult[ElementCount - 1], bulkResult[ElementCount - 1]);
+        printf("Vector<uint32_t> round trip: element by element %u ms, container operators %u ms for %u elements\n",
+            static_cast<uint32_t>(elementTime), static_cast<uint32_t>(bulkTime), ElementCount);
+    }
+
+    TEST(BinaryContainerSerialization, performanceHashTable)
+    {
+        HashTable<uint32_t, uint64_t> values;
+        for (uint32_t i = 0; i < EntryCount; ++i)
+        {
+            values.put(i, static_cast<uint64_t>(i) << 20);
+        }
+        BinaryOutputStream outStream;
+        outStream << values;
+
+        uint64_t start = Time::GetMilliseconds();
+        BinaryInputStream elementInStream(outStream.getData(), outStream.getSize());
+        uint32_t count = 0;
+        elementInStream >> count;
+        HashTable<uint32_t, uint64_t> elementResult;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t key = 0;
+            uint64_t value = 0;
+            elementInStream >> key >> value;
+            elementResult.put(key, value);
+        }
+        const uint64_t elementTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        BinaryInputStream bulkInStream(outStream.getData(), outStream.getSize());
+        HashTable<uint32_t, uint64_t> bulkResult;
+        bulkInStream >> bulkResult;
+        const uint64_t bulkTime = Time::GetMilliseconds() - start;
+
+        ASSERT_EQ(EntryCount, elementResult.count());
+        ASSERT_EQ(EntryCount, bulkResult.count());
+        EXPECT_EQ(static_cast<uint64_t>(EntryCount - 1) << 20, bulkResult.at(EntryCount - 1));
+        printf("HashTable load: growing %u ms, presized %u ms for %u entries\n",
+            static_cast<uint32_t>(elementTime), static_cast<uint32_t>(bulkTime), EntryCount);
+    }
+}
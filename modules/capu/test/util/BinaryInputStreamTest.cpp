@@ -17,6 +17,9 @@
 #include "BinaryInputStreamTest.h"
 #include <capu/util/BinaryOutputStream.h>
 #include <capu/os/Memory.h>
+#include <capu/os/NumericLimits.h>
+#include <capu/os/Time.h>
+#include <stdio.h>
 
 namespace capu
 {
@@ -172,4 +175,292 @@ namespace capu
         EXPECT_EQ(value1, result3);
     }
 
+    TEST_F(BinaryInputStreamTest, ReadInt64Value)
+    {
+        char buffer[16];
+        const int64_t value1 = -5;
+        const uint64_t value2 = 5;
+        Memory::Copy(buffer, &value1, sizeof(int64_t));
+        Memory::Copy(buffer + sizeof(int64_t), &value2, sizeof(uint64_t));
+
+        BinaryInputStream inStream(buffer);
+
+        int64_t result1 = 0;
+        uint64_t result2 = 0;
+        inStream >> result1 >> result2;
+
+        EXPECT_EQ(value1, result1);
+        EXPECT_EQ(value2, result2);
+    }
+
+    TEST_F(BinaryInputStreamTest, ReadDoubleValue)
+    {
+        char buffer[8];
+        double_t value = 47.11;
+        Memory::Copy(buffer, &value, sizeof(double_t));
+
+        BinaryInputStream inStream(buffer, STREAM_ENCODING_VARINT);
+
+        inStream >> value;
+
+        EXPECT_EQ(47.11, value);
+    }
+
+    TEST_F(BinaryInputStreamTest, ReadVarIntValue)
+    {
+        // 300 and -2 as zigzag varint
+        const uint8_t buffer[] = {0xac, 0x02, 0x03};
+
+        BinaryInputStream inStream(reinterpret_cast<const char_t*>(buffer), STREAM_ENCODING_VARINT);
+        EXPECT_EQ(STREAM_ENCODING_VARINT, inStream.getEncoding());
+
+        uint32_t value1 = 0;
+        int32_t value2 = 0;
+        inStream >> value1 >> value2;
+
+        EXPECT_EQ(300u, value1);
+        EXPECT_EQ(-2, value2);
+    }
+
+    TEST_F(BinaryInputStreamTest, ReadMalformedVarInt)
+    {
+        // a varint never takes more than 10 bytes, even if every byte claims a successor
+        uint8_t buffer[12];
+        Memory::Set(buffer, 0xff, sizeof(buffer));
+        buffer[10] = 0x01;
+
+        BinaryInputStream inStream(reinterpret_cast<const char_t*>(buffer), STREAM_ENCODING_VARINT);
+
+        uint64_t value = 0;
+        uint32_t next = 0;
+        inStream >> value >> next;
+
+        EXPECT_EQ(1u, next);
+    }
+
+    TEST_F(BinaryInputStreamTest, ReadStringView)
+    {
+        BinaryOutputStream outStream;
+        outStream << "Hello" << 5 << String("World");
+
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+
+        StringView hello;
+        StringView world;
+        int32_t value = 0;
+        inStream >> hello;
+        inStream >> value;
+        inStream >> world;
+
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(outStream.getData() + sizeof(uint32_t), hello.data());
+        EXPECT_TRUE(StringView("Hello") == hello);
+        EXPECT_EQ(5, value);
+        EXPECT_TRUE(StringView("World") == world);
+    }
+
+    TEST_F(BinaryInputStreamTest, SizedBuffer)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << 1 << NumericLimits::Max<uint64_t>() << "text";
+
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize(), STREAM_ENCODING_VARINT);
+
+        int32_t int32Value = 0;
+        uint64_t uint64Value = 0;
+        String stringValue;
+        inStream >> int32Value >> uint64Value >> stringValue;
+
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(1, int32Value);
+        EXPECT_EQ(NumericLimits::Max<uint64_t>(), uint64Value);
+        EXPECT_STREQ("text", stringValue.c_str());
+
+        // the buffer is completely read
+        bool_t boolValue = false;
+        inStream >> boolValue;
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+        EXPECT_FALSE(boolValue);
+    }
+
+    TEST_F(BinaryInputStreamTest, SizedBufferReadPastEnd)
+    {
+        const char_t buffer[] = {1, 0, 0, 0, 2, 0, 0};
+
+        BinaryInputStream inStream(buffer, sizeof(buffer));
+
+        int32_t value1 = 0;
+        int32_t value2 = 42;
+        inStream >> value1 >> value2;
+        EXPECT_EQ(1, value1);
+        EXPECT_EQ(42, value2);
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+
+        // nothing can be read after a failure
+        bool_t boolValue = false;
+        inStream >> boolValue;
+        EXPECT_FALSE(boolValue);
+
+        inStream.reset();
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        inStream >> value2;
+        EXPECT_EQ(1, value2);
+    }
+
+    TEST_F(BinaryInputStreamTest, SizedBufferStringTooLong)
+    {
+        BinaryOutputStream outStream;
+        outStream << "Hello World";
+
+        // the string is cut off
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize() - 1);
+
+        String value("unchanged");
+        inStream >> value;
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+        EXPECT_STREQ("unchanged", value.c_str());
+
+        BinaryInputStream viewStream(outStream.getData(), outStream.getSize() - 1);
+        StringView view("unchanged");
+        viewStream >> view;
+        EXPECT_EQ(CAPU_EOF, viewStream.getState());
+        EXPECT_TRUE(StringView("unchanged") == view);
+    }
+
+    TEST_F(BinaryInputStreamTest, SizedBufferVarIntCutOff)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << 7u << NumericLimits::Max<uint32_t>();
+
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize() - 1, STREAM_ENCODING_VARINT);
+
+        uint32_t value1 = 0;
+        uint32_t value2 = 42;
+        inStream >> value1 >> value2;
+        EXPECT_EQ(7u, value1);
+        EXPECT_EQ(42u, value2);
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+    }
+
+    TEST_F(BinaryInputStreamTest, SizedBufferArray)
+    {
+        const int32_t values[] = {1, 2, 3};
+        BinaryOutputStream outStream;
+        outStream.writeArray(values, 3);
+
+        int32_t result[4] = {0, 0, 0, 0};
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        inStream.readArray(result, 4);
+        EXPECT_EQ(CAPU_EOF, inStream.getState());
+        EXPECT_EQ(0, result[0]);
+
+        inStream.reset();
+        inStream.readArray(result, 3);
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(0, Memory::Compare(values, result, sizeof(values)));
+    }
+
+    TEST_F(BinaryInputStreamTest, ArrayTooLargeForOneRead)
+    {
+        // the byte count of this many values does not fit into 32 bits
+        const int32_t values[] = {1, 2};
+        BinaryOutputStream outStream;
+        outStream.writeArray(values, 2);
+
+        int32_t result[2] = {0, 0};
+        BinaryInputStream inStream(outStream.getData());
+        inStream.readArray(result, 0x40000001u);
+        EXPECT_EQ(CAPU_ERANGE, inStream.getState());
+        EXPECT_EQ(0, result[0]);
+    }
+
+    TEST_F(BinaryInputStreamTest, StringViewAllocatesNothing)
+    {
+        BinaryOutputStream outStream;
+        outStream << "a string which is long enough for any small string optimization";
+
+        // the view points into the buffer of the stream instead of a copy
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        StringView view;
+        inStream >> view;
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_TRUE(view.data() >= outStream.getData());
+        EXPECT_TRUE(view.data() + view.length() <= outStream.getData() + outStream.getSize());
+    }
+
+    TEST_F(BinaryInputStreamTest, ReusedStringKeepsItsBuffer)
+    {
+        BinaryOutputStream outStream;
+        outStream << "the first and longer string" << "a shorter one";
+
+        BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+        String value;
+        inStream >> value;
+        const char_t* buffer = value.c_str();
+        inStream >> value;
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(String("a shorter one"), value);
+        EXPECT_EQ(buffer, value.c_str());
+    }
+
+    namespace
+    {
+        const uint32_t MessageCount = 100000;
+
+        // a message with two strings
+        void WriteMessage(BinaryOutputStream& outStream, const uint32_t i)
+        {
+            outStream << i << "sender name" << static_cast<uint64_t>(i) * 1000 << "payload of the message";
+        }
+
+        template<typename STRING>
+        uint64_t DecodeMessages(const BinaryOutputStream& outStream, const bool_t reuseStrings)
+        {
+            const uint64_t start = Time::GetMilliseconds();
+            BinaryInputStream inStream(outStream.getData(), outStream.getSize());
+
+            uint32_t id;
+            uint64_t timestamp;
+            STRING sender;
+            STRING payload;
+            for (uint32_t i = 0; i < MessageCount; ++i)
+            {
+                if (reuseStrings)
+                {
+                    inStream >> id;
+                    inStream >> sender;
+                    inStream >> timestamp;
+                    inStream >> payload;
+                }
+                else
+                {
+                    STRING newSender;
+                    STRING newPayload;
+                    inStream >> id;
+                    inStream >> newSender;
+                    inStream >> timestamp;
+                    inStream >> newPayload;
+                }
+            }
+            EXPECT_EQ(CAPU_OK, inStream.getState());
+
+            return Time::GetMilliseconds() - start;
+        }
+    }
+
+    TEST_F(BinaryInputStreamTest, performanceDecodeMessages)
+    {
+        BinaryOutputStream outStream;
+        for (uint32_t i = 0; i < MessageCount; ++i)
+        {
+            WriteMessage(outStream, i);
+        }
+
+        const uint64_t newStrings = DecodeMessages<String>(outStream, false);
+        const uint64_t reusedStrings = DecodeMessages<String>(outStream, true);
+        const uint64_t views = DecodeMessages<StringView>(outStream, false);
+
+        printf("%u messages with two strings: new String %u ms, reused String %u ms, StringView %u ms\n", MessageCount,
+            static_cast<uint32_t>(newStrings), static_cast<uint32_t>(reusedStrings), static_cast<uint32_t>(views));
+    }
 }
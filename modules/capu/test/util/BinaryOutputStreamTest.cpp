@@ -18,6 +18,8 @@
 #include "capu/util/Guid.h"
 #include "capu/util/BinaryInputStream.h"
 #include "capu/os/NumericLimits.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
 
 namespace capu
 {
@@ -170,5 +172,300 @@ namespace capu
 
         delete buffer;
     }
-}
 
+    TEST_F(BinaryOutputStreamTest, Reserve)
+    {
+        BinaryOutputStream outStream;
+        outStream << 1;
+        outStream.reserve(1000);
+
+        const uint32_t capacity = outStream.getCapacity();
+        EXPECT_LE(1004u, capacity);
+        for (int32_t i = 0; i < 250; ++i)
+        {
+            outStream << i;
+        }
+        EXPECT_EQ(capacity, outStream.getCapacity());
+    }
+
+    TEST_F(BinaryOutputStreamTest, Release)
+    {
+        BinaryOutputStream outStream;
+        outStream << 5 << 6;
+
+        Array<char_t> buffer(3);
+        EXPECT_EQ(2 * sizeof(int32_t), outStream.release(buffer));
+        EXPECT_EQ(16u, buffer.size());
+        EXPECT_EQ(5, *reinterpret_cast<const int32_t*>(buffer.getRawData()));
+        EXPECT_EQ(0u, outStream.getSize());
+        EXPECT_EQ(0u, outStream.getCapacity());
+
+        outStream << 7;
+        EXPECT_EQ(sizeof(int32_t), outStream.getSize());
+        EXPECT_EQ(7, *reinterpret_cast<const int32_t*>(outStream.getData()));
+    }
+
+    TEST_F(BinaryOutputStreamTest, ZeroCapacity)
+    {
+        BinaryOutputStream outStream(0);
+        outStream << "grows from nothing";
+        EXPECT_EQ(22u, outStream.getSize());
+        EXPECT_LE(22u, outStream.getCapacity());
+    }
+
+    TEST_F(BinaryOutputStreamTest, InsertInt64)
+    {
+        BinaryOutputStream outStream;
+        outStream << NumericLimits::Min<int64_t>() << static_cast<uint64_t>(5) << NumericLimits::Max<uint64_t>();
+
+        const char_t* data = outStream.getData();
+        EXPECT_EQ(3 * sizeof(uint64_t), outStream.getSize());
+        EXPECT_EQ(NumericLimits::Min<int64_t>(), *reinterpret_cast<const int64_t*>(data));
+        data += sizeof(int64_t);
+        EXPECT_EQ(5u, *reinterpret_cast<const uint64_t*>(data));
+        data += sizeof(uint64_t);
+        EXPECT_EQ(NumericLimits::Max<uint64_t>(), *reinterpret_cast<const uint64_t*>(data));
+    }
+
+    TEST_F(BinaryOutputStreamTest, InsertDouble)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << 5.5 << -1.0e300;
+
+        // doubles keep their size with every encoding
+        const char_t* data = outStream.getData();
+        EXPECT_EQ(2 * sizeof(double_t), outStream.getSize());
+        EXPECT_EQ(5.5, *reinterpret_cast<const double_t*>(data));
+        data += sizeof(double_t);
+        EXPECT_EQ(-1.0e300, *reinterpret_cast<const double_t*>(data));
+    }
+
+    TEST_F(BinaryOutputStreamTest, Encoding)
+    {
+        EXPECT_EQ(STREAM_ENCODING_FIXED, BinaryOutputStream().getEncoding());
+        EXPECT_EQ(STREAM_ENCODING_VARINT, BinaryOutputStream(16, STREAM_ENCODING_VARINT).getEncoding());
+    }
+
+    TEST_F(BinaryOutputStreamTest, VarIntLength)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+
+        outStream << 0u;
+        EXPECT_EQ(1u, outStream.getSize());
+        outStream << 127u;
+        EXPECT_EQ(2u, outStream.getSize());
+        outStream << 128u;
+        EXPECT_EQ(4u, outStream.getSize());
+        outStream << NumericLimits::Max<uint32_t>();
+        EXPECT_EQ(9u, outStream.getSize());
+        outStream << NumericLimits::Max<uint64_t>();
+        EXPECT_EQ(19u, outStream.getSize());
+
+        // zigzag keeps small negative values small
+        outStream.clear();
+        outStream << -1 << 63 << -64 << static_cast<int64_t>(-64);
+        EXPECT_EQ(4u, outStream.getSize());
+        outStream << 64;
+        EXPECT_EQ(6u, outStream.getSize());
+    }
+
+    TEST_F(BinaryOutputStreamTest, VarIntBytes)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << 300u << -2;
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(outStream.getData());
+        ASSERT_EQ(3u, outStream.getSize());
+        EXPECT_EQ(0xac, data[0]);
+        EXPECT_EQ(0x02, data[1]);
+        EXPECT_EQ(0x03, data[2]);
+    }
+
+    TEST_F(BinaryOutputStreamTest, VarIntStringLength)
+    {
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        outStream << "Hello" << String("World");
+
+        EXPECT_EQ(12u, outStream.getSize());
+        EXPECT_EQ(5, outStream.getData()[0]);
+        EXPECT_EQ(0, Memory::Compare("Hello", outStream.getData() + 1, 5));
+    }
+
+    TEST_F(BinaryOutputStreamTest, VarIntRoundTrip)
+    {
+        const int32_t int32Values[] = {0, 1, -1, 63, -64, 64, -65, NumericLimits::Max<int32_t>(), NumericLimits::Min<int32_t>()};
+        const int64_t int64Values[] = {0, -1, NumericLimits::Max<int64_t>(), NumericLimits::Min<int64_t>(), static_cast<int64_t>(NumericLimits::Min<int32_t>()) - 1};
+        const uint64_t uint64Values[] = {0, 127, 128, NumericLimits::Max<uint32_t>(), static_cast<uint64_t>(NumericLimits::Max<uint32_t>()) + 1, NumericLimits::Max<uint64_t>()};
+
+        BinaryOutputStream outStream(16, STREAM_ENCODING_VARINT);
+        for (uint32_t i = 0; i < sizeof(int32Values) / sizeof(int32_t); ++i)
+        {
+            outStream << int32Values[i];
+        }
+        for (uint32_t i = 0; i < sizeof(int64Values) / sizeof(int64_t); ++i)
+        {
+            outStream << int64Values[i];
+        }
+        for (uint32_t i = 0; i < sizeof(uint64Values) / sizeof(uint64_t); ++i)
+        {
+            outStream << uint64Values[i];
+        }
+        outStream << static_cast<uint16_t>(65535) << NumericLimits::Max<uint32_t>() << "text" << 2.5 << true;
+
+        BinaryInputStream inStream(outStream.getData(), STREAM_ENCODING_VARINT);
+        for (uint32_t i = 0; i < sizeof(int32Values) / sizeof(int32_t); ++i)
+        {
+            int32_t value = 0;
+            inStream >> value;
+            EXPECT_EQ(int32Values[i], value);
+        }
+        for (uint32_t i = 0; i < sizeof(int64Values) / sizeof(int64_t); ++i)
+        {
+            int64_t value = 0;
+            inStream >> value;
+            EXPECT_EQ(int64Values[i], value);
+        }
+        for (uint32_t i = 0; i < sizeof(uint64Values) / sizeof(uint64_t); ++i)
+        {
+            uint64_t value = 0;
+            inStream >> value;
+            EXPECT_EQ(uint64Values[i], value);
+        }
+
+        uint16_t uint16Value = 0;
+        uint32_t uint32Value = 0;
+        String stringValue;
+        double_t doubleValue = 0;
+        bool_t boolValue = false;
+        inStream >> uint16Value >> uint32Value >> stringValue >> doubleValue >> boolValue;
+        EXPECT_EQ(65535, uint16Value);
+        EXPECT_EQ(NumericLimits::Max<uint32_t>(), uint32Value);
+        EXPECT_STREQ("text", stringValue.c_str());
+        EXPECT_EQ(2.5, doubleValue);
+        EXPECT_TRUE(boolValue);
+    }
+
+    TEST_F(BinaryOutputStreamTest, WriteArray)
+    {
+        int32_t int32Values[1000];
+        uint64_t uint64Values[1000];
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            int32Values[i] = (i % 2) ? -i * i : i * i;
+            uint64Values[i] = static_cast<uint64_t>(i) << (i % 57);
+        }
+
+        for (uint32_t encoding = STREAM_ENCODING_FIXED; encoding <= STREAM_ENCODING_VARINT; ++encoding)
+        {
+            BinaryOutputStream outStream(16, static_cast<StreamEncoding>(encoding));
+            outStream.writeArray(int32Values, 1000);
+            outStream.writeArray(uint64Values, 1000);
+            outStream << 42;
+
+            int32_t int32Result[1000];
+            uint64_t uint64Result[1000];
+            int32_t last = 0;
+            BinaryInputStream inStream(outStream.getData(), static_cast<StreamEncoding>(encoding));
+            inStream.readArray(int32Result, 1000);
+            inStream.readArray(uint64Result, 1000);
+            inStream >> last;
+
+            EXPECT_EQ(0, Memory::Compare(int32Values, int32Result, sizeof(int32Values)));
+            EXPECT_EQ(0, Memory::Compare(uint64Values, uint64Result, sizeof(uint64Values)));
+            EXPECT_EQ(42, last);
+        }
+    }
+
+    namespace
+    {
+        // a typical message, mostly small integers
+        void WriteMessage(BinaryOutputStream& outStream, const uint32_t i)
+        {
+            outStream << (i & 0xff) << static_cast<int32_t>(i % 200) - 100 << static_cast<uint16_t>(i & 0x3) << static_cast<uint64_t>(i) * 1000 << "name" << static_cast<int32_t>(i & 1) << 0.5;
+        }
+
+        void ReadMessage(BinaryInputStream& inStream, uint64_t& checksum)
+        {
+            uint32_t id;
+            int32_t delta;
+            uint16_t type;
+            uint64_t timestamp;
+            String name;
+            int32_t flags;
+            double_t value;
+            inStream >> id >> delta >> type >> timestamp >> name >> flags >> value;
+            checksum += id + delta + type + timestamp + flags;
+        }
+
+        void MeasureEncoding(const StreamEncoding encoding, const char_t* name)
+        {
+            const uint32_t messageCount = 1000000;
+
+            BinaryOutputStream outStream(64, encoding);
+            uint64_t start = Time::GetMilliseconds();
+            for (uint32_t i = 0; i < messageCount; ++i)
+            {
+                WriteMessage(outStream, i);
+            }
+            const uint64_t encodeTime = Time::GetMilliseconds() - start;
+
+            uint64_t checksum = 0;
+            BinaryInputStream inStream(outStream.getData(), encoding);
+            start = Time::GetMilliseconds();
+            for (uint32_t i = 0; i < messageCount; ++i)
+            {
+                ReadMessage(inStream, checksum);
+            }
+            const uint64_t decodeTime = Time::GetMilliseconds() - start;
+
+            printf("%s: %.1f bytes per message, encode %u ms, decode %u ms for %u messages (checksum %u)\n",
+                name, static_cast<double_t>(outStream.getSize()) / messageCount,
+                static_cast<uint32_t>(encodeTime), static_cast<uint32_t>(decodeTime), messageCount, static_cast<uint32_t>(checksum));
+        }
+    }
+
+    TEST_F(BinaryOutputStreamTest, performanceEncoding)
+    {
+        MeasureEncoding(STREAM_ENCODING_FIXED, "fixed");
+        MeasureEncoding(STREAM_ENCODING_VARINT, "varint");
+    }
+
+    TEST_F(BinaryOutputStreamTest, performanceWriteArray)
+    {
+        const uint32_t count = 1000000;
+        uint32_t* values = new uint32_t[count];
+        uint32_t* result = new uint32_t[count];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            values[i] = i % 1000;
+        }
+
+        for (uint32_t encoding = STREAM_ENCODING_FIXED; encoding <= STREAM_ENCODING_VARINT; ++encoding)
+        {
+            BinaryOutputStream outStream(64, static_cast<StreamEncoding>(encoding));
+            uint64_t start = Time::GetMilliseconds();
+            for (uint32_t i = 0; i < 10; ++i)
+            {
+                outStream.clear();
+                outStream.writeArray(values, count);
+            }
+            const uint64_t encodeTime = Time::GetMilliseconds() - start;
+
+            start = Time::GetMilliseconds();
+            for (uint32_t i = 0; i < 10; ++i)
+            {
+                BinaryInputStream inStream(outStream.getData(), static_cast<StreamEncoding>(encoding));
+                inStream.readArray(result, count);
+            }
+            const uint64_t decodeTime = Time::GetMilliseconds() - start;
+
+            EXPECT_EQ(0, Memory::Compare(values, result, count * sizeof(uint32_t)));
+            printf("%s array: %u bytes, encode %u ms, decode %u ms for 10 x %u values\n",
+                encoding == STREAM_ENCODING_FIXED ? "fixed" : "varint", outStream.getSize(),
+                static_cast<uint32_t>(encodeTime), static_cast<uint32_t>(decodeTime), count);
+        }
+
+        delete[] values;
+        delete[] result;
+    }
+}
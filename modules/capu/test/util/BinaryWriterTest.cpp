@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/BinaryWriter.h"
+#include "capu/util/BinaryInputStream.h"
+#include "capu/os/NumericLimits.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        struct Record
+        {
+            uint32_t id;
+            int32_t delta;
+            uint64_t timestamp;
+            double_t value;
+            bool_t valid;
+        };
+
+        // size of a record with the fixed encoding
+        const uint32_t FixedRecordSize = 2 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(double_t) + sizeof(bool_t);
+
+        Record MakeRecord(const uint32_t i)
+        {
+            Record record;
+            record.id = i;
+            record.delta = static_cast<int32_t>(i % 200) - 100;
+            record.timestamp = static_cast<uint64_t>(i) * 1000;
+            record.value = i * 0.5;
+            record.valid = (i & 1) != 0;
+            return record;
+        }
+
+        void WriteRecord(IOutputStream& stream, const Record& record)
+        {
+            stream << record.id << record.delta << record.timestamp << record.value << record.valid;
+        }
+
+        template<StreamEncoding ENCODING>
+        void WriteRecord(BinaryWriter<ENCODING>& writer, const Record& record)
+        {
+            writer << record.id << record.delta << record.timestamp << record.value << record.valid;
+        }
+
+        void ExpectRecord(BinaryInputStream& inStream, const Record& expected)
+        {
+            Record record;
+            inStream >> record.id >> record.delta >> record.timestamp >> record.value >> record.valid;
+            EXPECT_EQ(expected.id, record.id);
+            EXPECT_EQ(expected.delta, record.delta);
+            EXPECT_EQ(expected.timestamp, record.timestamp);
+            EXPECT_EQ(expected.value, record.value);
+            EXPECT_EQ(expected.valid, record.valid);
+        }
+
+        template<StreamEncoding ENCODING>
+        void ExpectSameDataAsStream()
+        {
+            const int32_t values[] = {0, -1, 1000, NumericLimits::Min<int32_t>()};
+            Guid guid;
+
+            BinaryOutputStream expected(16, ENCODING);
+            expected << 5 << 7u << NumericLimits::Min<int64_t>() << NumericLimits::Max<uint64_t>() << static_cast<uint16_t>(300)
+                     << 1.5f << 2.5 << true << "text" << String("string") << guid;
+            expected.writeArray(values, 4);
+
+            BinaryOutputStream stream;
+            BinaryWriter<ENCODING> writer(stream);
+            writer << 5 << 7u << NumericLimits::Min<int64_t>() << NumericLimits::Max<uint64_t>() << static_cast<uint16_t>(300)
+                   << 1.5f << 2.5 << true << "text" << String("string") << guid;
+            writer.writeArray(values, 4);
+
+            ASSERT_EQ(expected.getSize(), stream.getSize());
+            EXPECT_EQ(0, Memory::Compare(expected.getData(), stream.getData(), stream.getSize()));
+        }
+    }
+
+    TEST(BinaryWriter, sameDataAsStreamFixed)
+    {
+        ExpectSameDataAsStream<STREAM_ENCODING_FIXED>();
+    }
+
+    TEST(BinaryWriter, sameDataAsStreamVarInt)
+    {
+        ExpectSameDataAsStream<STREAM_ENCODING_VARINT>();
+    }
+
+    TEST(BinaryWriter, appendsToStream)
+    {
+        BinaryOutputStream stream;
+        stream << 1;
+
+        BinaryWriter<> writer(stream);
+        EXPECT_EQ(&stream, &writer.getStream());
+        writer << 2;
+        stream << 3;
+
+        BinaryInputStream inStream(stream.getData());
+        int32_t values[3];
+        inStream.readArray(values, 3);
+        EXPECT_EQ(1, values[0]);
+        EXPECT_EQ(2, values[1]);
+        EXPECT_EQ(3, values[2]);
+    }
+
+    TEST(BinaryWriter, readRecords)
+    {
+        BinaryOutputStream stream(16, STREAM_ENCODING_VARINT);
+        BinaryWriter<STREAM_ENCODING_VARINT> writer(stream);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            WriteRecord(writer, MakeRecord(i));
+        }
+
+        BinaryInputStream inStream(stream.getData(), STREAM_ENCODING_VARINT);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            ExpectRecord(inStream, MakeRecord(i));
+        }
+    }
+
+    TEST(BinaryWriter, reserve)
+    {
+        BinaryOutputStream stream;
+        BinaryWriter<> writer(stream);
+        writer << 1;
+
+        writer.reserve(100 * FixedRecordSize);
+        const uint32_t capacity = stream.getCapacity();
+        EXPECT_LE(100 * FixedRecordSize + sizeof(int32_t), capacity);
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            WriteRecord(writer, MakeRecord(i));
+        }
+        EXPECT_EQ(capacity, stream.getCapacity());
+        EXPECT_EQ(100 * FixedRecordSize + sizeof(int32_t), stream.getSize());
+    }
+
+    TEST(BinaryWriter, growsGeometrically)
+    {
+        BinaryOutputStream stream(1);
+        BinaryWriter<> writer(stream);
+
+        uint32_t resizes = 0;
+        uint32_t capacity = stream.getCapacity();
+        for (uint32_t i = 0; i < 1000000; ++i)
+        {
+            writer << true;
+            if (stream.getCapacity() != capacity)
+            {
+                EXPECT_LE(2 * capacity, stream.getCapacity());
+                capacity = stream.getCapacity();
+                ++resizes;
+            }
+        }
+        EXPECT_EQ(20u, resizes);
+    }
+
+    TEST(BinaryWriter, releaseBuffer)
+    {
+        BinaryOutputStream stream;
+        BinaryWriter<> writer(stream);
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            WriteRecord(writer, MakeRecord(i));
+        }
+
+        const char_t* data = stream.getData();
+        Array<char_t> buffer;
+        EXPECT_EQ(100 * FixedRecordSize, stream.release(buffer));
+
+        // the buffer is handed over, not copied
+        EXPECT_EQ(data, buffer.getRawData());
+        EXPECT_EQ(0u, stream.getSize());
+        EXPECT_EQ(0u, stream.getCapacity());
+
+        BinaryInputStream inStream(buffer.getRawData());
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            ExpectRecord(inStream, MakeRecord(i));
+        }
+
+        // the stream starts from scratch
+        writer << 42;
+        EXPECT_EQ(sizeof(int32_t), stream.getSize());
+        EXPECT_EQ(42, *reinterpret_cast<const int32_t*>(stream.getData()));
+    }
+
+    namespace
+    {
+        const uint32_t RecordCount = 1000000;
+
+        uint64_t SerializeWithStream(const StreamEncoding encoding, Array<char_t>& result)
+        {
+            const uint64_t start = Time::GetMilliseconds();
+            BinaryOutputStream stream(16, encoding);
+            IOutputStream& outStream = stream;
+            for (uint32_t i = 0; i < RecordCount; ++i)
+            {
+                WriteRecord(outStream, MakeRecord(i));
+            }
+            stream.release(result);
+            return Time::GetMilliseconds() - start;
+        }
+
+        template<StreamEncoding ENCODING>
+        uint64_t SerializeWithWriter(const bool_t reserve, Array<char_t>& result)
+        {
+            const uint64_t start = Time::GetMilliseconds();
+            BinaryOutputStream stream(16, ENCODING);
+            BinaryWriter<ENCODING> writer(stream);
+            if (reserve)
+            {
+                writer.reserve(RecordCount * FixedRecordSize);
+            }
+            for (uint32_t i = 0; i < RecordCount; ++i)
+            {
+                WriteRecord(writer, MakeRecord(i));
+            }
+            stream.release(result);
+            return Time::GetMilliseconds() - start;
+        }
+    }
+
+    TEST(BinaryWriter, performanceSerializeRecords)
+    {
+        Array<char_t> streamResult;
+        Array<char_t> writerResult;
+        Array<char_t> reservedResult;
+
+        const uint64_t streamTime = SerializeWithStream(STREAM_ENCODING_FIXED, streamResult);
+        const uint64_t writerTime = SerializeWithWriter<STREAM_ENCODING_FIXED>(false, writerResult);
+        const uint64_t reservedTime = SerializeWithWriter<STREAM_ENCODING_FIXED>(true, reservedResult);
+        EXPECT_EQ(0, Memory::Compare(streamResult.getRawData(), writerResult.getRawData(), RecordCount * FixedRecordSize));
+        EXPECT_EQ(0, Memory::Compare(streamResult.getRawData(), reservedResult.getRawData(), RecordCount * FixedRecordSize));
+        printf("fixed: IOutputStream %u ms, BinaryWriter %u ms, BinaryWriter with reserve %u ms for %u records\n",
+            static_cast<uint32_t>(streamTime), static_cast<uint32_t>(writerTime), static_cast<uint32_t>(reservedTime), RecordCount);
+
+        const uint64_t varIntStreamTime = SerializeWithStream(STREAM_ENCODING_VARINT, streamResult);
+        const uint64_t varIntWriterTime = SerializeWithWriter<STREAM_ENCODING_VARINT>(false, writerResult);
+        printf("varint: IOutputStream %u ms, BinaryWriter %u ms for %u records\n",
+            static_cast<uint32_t>(varIntStreamTime), static_cast<uint32_t>(varIntWriterTime), RecordCount);
+    }
+}
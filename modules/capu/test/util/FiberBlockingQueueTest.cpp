@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/FiberBlockingQueue.h"
+#include "capu/container/BlockingQueue.h"
+#include "capu/os/Thread.h"
+#include "capu/os/Time.h"
+
+namespace capu
+{
+    namespace
+    {
+        class Producer: public Runnable
+        {
+        public:
+            Producer(FiberBlockingQueue<uint32_t>& queue, const uint32_t count)
+                : mQueue(queue)
+                , mCount(count)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < mCount; ++i)
+                {
+                    mQueue.push(i);
+                }
+            }
+
+        private:
+            FiberBlockingQueue<uint32_t>& mQueue;
+            uint32_t mCount;
+        };
+
+        class Consumer: public Runnable
+        {
+        public:
+            Consumer(FiberBlockingQueue<uint32_t>& queue, const uint32_t count)
+                : sum(0)
+                , mQueue(queue)
+                , mCount(count)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < mCount; ++i)
+                {
+                    uint32_t value = 0;
+                    mQueue.pop(&value);
+                    sum += value;
+                }
+            }
+
+            uint64_t sum;
+
+        private:
+            FiberBlockingQueue<uint32_t>& mQueue;
+            uint32_t mCount;
+        };
+
+        class TimedConsumer: public Runnable
+        {
+        public:
+            TimedConsumer(FiberBlockingQueue<uint32_t>& queue)
+                : result(CAPU_ERROR)
+                , mQueue(queue)
+            {
+            }
+
+            void run()
+            {
+                result = mQueue.pop(0, 20);
+            }
+
+            status_t result;
+
+        private:
+            FiberBlockingQueue<uint32_t>& mQueue;
+        };
+
+        template<class Q>
+        class PingPong: public Runnable
+        {
+        public:
+            PingPong(Q& in, Q& out, const uint32_t rounds, const bool_t serve)
+                : mIn(in)
+                , mOut(out)
+                , mRounds(rounds)
+                , mServe(serve)
+            {
+            }
+
+            void run()
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < mRounds; ++i)
+                {
+                    if (mServe)
+                    {
+                        mOut.push(i);
+                        mIn.pop(&value);
+                    }
+                    else
+                    {
+                        mIn.pop(&value);
+                        mOut.push(value);
+                    }
+                }
+            }
+
+        private:
+            Q& mIn;
+            Q& mOut;
+            uint32_t mRounds;
+            bool_t mServe;
+        };
+    }
+
+    TEST(FiberBlockingQueue, pushAndPop)
+    {
+        FiberBlockingQueue<uint32_t> queue;
+        EXPECT_TRUE(queue.empty());
+        queue.push(1);
+        queue.push(2);
+        EXPECT_EQ(2u, queue.size());
+        uint32_t value = 0;
+        EXPECT_EQ(CAPU_OK, queue.pop(&value));
+        EXPECT_EQ(1u, value);
+        queue.clear();
+        EXPECT_TRUE(queue.empty());
+        EXPECT_EQ(CAPU_ETIMEOUT, queue.pop(&value, 10));
+    }
+
+    TEST(FiberBlockingQueue, consumersAndProducerOnOneThread)
+    {
+        FiberBlockingQueue<uint32_t> queue;
+        SmartPointer<Consumer> first = new Consumer(queue, 500);
+        SmartPointer<Consumer> second = new Consumer(queue, 500);
+        {
+            FiberScheduler scheduler(1);
+            // the consumers start first and have to wait without blocking the producer
+            scheduler.spawn(first);
+            scheduler.spawn(second);
+            scheduler.spawn(new Producer(queue, 1000));
+        }
+        EXPECT_EQ(999u * 1000u / 2u, first->sum + second->sum);
+    }
+
+    TEST(FiberBlockingQueue, producerThread)
+    {
+        FiberBlockingQueue<uint32_t> queue;
+        SmartPointer<Consumer> consumer = new Consumer(queue, 1000);
+        Producer producer(queue, 1000);
+        Thread thread;
+        {
+            FiberScheduler scheduler(2);
+            scheduler.spawn(consumer);
+            thread.start(producer);
+            thread.join();
+        }
+        EXPECT_EQ(999u * 1000u / 2u, consumer->sum);
+    }
+
+    TEST(FiberBlockingQueue, popTimesOut)
+    {
+        FiberBlockingQueue<uint32_t> queue;
+        SmartPointer<TimedConsumer> consumer = new TimedConsumer(queue);
+        {
+            FiberScheduler scheduler(1);
+            scheduler.spawn(consumer);
+        }
+        EXPECT_EQ(CAPU_ETIMEOUT, consumer->result);
+    }
+
+    TEST(FiberBlockingQueue, performancePingPong)
+    {
+        const uint32_t rounds = 100000;
+
+        FiberBlockingQueue<uint32_t> fiberPing;
+        FiberBlockingQueue<uint32_t> fiberPong;
+        uint64_t start = Time::GetMilliseconds();
+        {
+            FiberScheduler scheduler(1);
+            scheduler.spawn(new PingPong<FiberBlockingQueue<uint32_t> >(fiberPong, fiberPing, rounds, true));
+            scheduler.spawn(new PingPong<FiberBlockingQueue<uint32_t> >(fiberPing, fiberPong, rounds, false));
+        }
+        const uint64_t fiberTime = Time::GetMilliseconds() - start;
+
+        BlockingQueue<uint32_t> threadPing;
+        BlockingQueue<uint32_t> threadPong;
+        PingPong<BlockingQueue<uint32_t> > serving(threadPong, threadPing, rounds, true);
+        PingPong<BlockingQueue<uint32_t> > answering(threadPing, threadPong, rounds, false);
+        Thread servingThread;
+        Thread answeringThread;
+        start = Time::GetMilliseconds();
+        servingThread.start(serving);
+        answeringThread.start(answering);
+        servingThread.join();
+        answeringThread.join();
+        const uint64_t threadTime = Time::GetMilliseconds() - start;
+
+        printf("%u round trips between fibers: %u ms, %.2f us per hand over\n", rounds, static_cast<uint32_t>(fiberTime),
+               fiberTime * 1000.0 / (2.0 * rounds));
+        printf("%u round trips between threads: %u ms, %.2f us per hand over\n", rounds, static_cast<uint32_t>(threadTime),
+               threadTime * 1000.0 / (2.0 * rounds));
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/FiberCondVar.h"
+#include "capu/os/Thread.h"
+#include "capu/os/Time.h"
+
+namespace capu
+{
+    namespace
+    {
+        struct SharedState
+        {
+            SharedState()
+                : ready(false)
+                , waiting(0)
+                , woken(0)
+            {
+            }
+
+            FiberMutex mutex;
+            FiberCondVar condVar;
+            bool_t ready;
+            uint32_t waiting;
+            uint32_t woken;
+        };
+
+        class WaitingRunnable: public Runnable
+        {
+        public:
+            WaitingRunnable(SharedState& state)
+                : mState(state)
+            {
+            }
+
+            void run()
+            {
+                ScopedFiberMutexLock lock(mState.mutex);
+                ++mState.waiting;
+                while (!mState.ready)
+                {
+                    mState.condVar.wait(&mState.mutex);
+                }
+                ++mState.woken;
+            }
+
+        private:
+            SharedState& mState;
+        };
+
+        class TimedWaitingFiber: public Runnable
+        {
+        public:
+            TimedWaitingFiber()
+                : result(CAPU_ERROR)
+            {
+            }
+
+            void run()
+            {
+                ScopedFiberMutexLock lock(mutex);
+                result = condVar.wait(&mutex, 20);
+            }
+
+            FiberMutex mutex;
+            FiberCondVar condVar;
+            status_t result;
+        };
+
+        uint32_t WaitingCount(SharedState& state)
+        {
+            ScopedFiberMutexLock lock(state.mutex);
+            return state.waiting;
+        }
+    }
+
+    TEST(FiberCondVar, waitWithoutMutex)
+    {
+        FiberCondVar condVar;
+        EXPECT_EQ(CAPU_EINVAL, condVar.wait(NULL));
+    }
+
+    TEST(FiberCondVar, broadcastWakesAllFibers)
+    {
+        SharedState state;
+        FiberScheduler scheduler(1);
+        for (uint32_t i = 0; i < 50; ++i)
+        {
+            scheduler.spawn(new WaitingRunnable(state));
+        }
+        while (WaitingCount(state) < 50)
+        {
+            Thread::Sleep(1);
+        }
+        EXPECT_EQ(50u, scheduler.getFiberCount());
+
+        state.mutex.lock();
+        state.ready = true;
+        state.condVar.broadcast();
+        state.mutex.unlock();
+        scheduler.close();
+        EXPECT_EQ(50u, state.woken);
+    }
+
+    TEST(FiberCondVar, signalWakesFibersAndThreads)
+    {
+        SharedState state;
+        WaitingRunnable waitingThread(state);
+        Thread thread;
+        thread.start(waitingThread);
+
+        FiberScheduler scheduler(1);
+        scheduler.spawn(new WaitingRunnable(state));
+        while (WaitingCount(state) < 2)
+        {
+            Thread::Sleep(1);
+        }
+
+        state.mutex.lock();
+        state.ready = true;
+        state.condVar.signal();
+        state.condVar.signal();
+        state.mutex.unlock();
+        thread.join();
+        scheduler.close();
+        EXPECT_EQ(2u, state.woken);
+    }
+
+    TEST(FiberCondVar, waitTimesOut)
+    {
+        FiberScheduler scheduler(1);
+        SmartPointer<TimedWaitingFiber> waiting = new TimedWaitingFiber();
+        const uint64_t start = Time::GetMilliseconds();
+        scheduler.spawn(waiting);
+        scheduler.close();
+        EXPECT_EQ(CAPU_ETIMEOUT, waiting->result);
+        EXPECT_GE(Time::GetMilliseconds() - start, 20u);
+
+        // threads time out as well
+        FiberMutex mutex;
+        FiberCondVar condVar;
+        mutex.lock();
+        EXPECT_EQ(CAPU_ETIMEOUT, condVar.wait(&mutex, 10));
+        mutex.unlock();
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/FiberMutex.h"
+#include "capu/os/Thread.h"
+
+namespace capu
+{
+    namespace
+    {
+        class IncrementingFiber: public Runnable
+        {
+        public:
+            IncrementingFiber(FiberMutex& mutex, uint32_t& counter)
+                : mMutex(mutex)
+                , mCounter(counter)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < 10; ++i)
+                {
+                    ScopedFiberMutexLock lock(mMutex);
+                    // other fibers run while the lock is held and have to wait for it
+                    const uint32_t value = mCounter;
+                    Fiber::Yield();
+                    mCounter = value + 1;
+                }
+            }
+
+        private:
+            FiberMutex& mMutex;
+            uint32_t& mCounter;
+        };
+
+        class IncrementingThread: public Runnable
+        {
+        public:
+            IncrementingThread(FiberMutex& mutex, uint32_t& counter)
+                : mMutex(mutex)
+                , mCounter(counter)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < 1000; ++i)
+                {
+                    ScopedFiberMutexLock lock(mMutex);
+                    ++mCounter;
+                }
+            }
+
+        private:
+            FiberMutex& mMutex;
+            uint32_t& mCounter;
+        };
+    }
+
+    TEST(FiberMutex, lockAndTrylock)
+    {
+        FiberMutex mutex;
+        EXPECT_EQ(CAPU_OK, mutex.lock());
+        EXPECT_FALSE(mutex.trylock());
+        EXPECT_EQ(CAPU_OK, mutex.unlock());
+        EXPECT_TRUE(mutex.trylock());
+        EXPECT_EQ(CAPU_OK, mutex.unlock());
+    }
+
+    TEST(FiberMutex, mutualExclusionOfFibers)
+    {
+        FiberMutex mutex;
+        uint32_t counter = 0;
+        {
+            FiberScheduler scheduler(2);
+            for (uint32_t i = 0; i < 100; ++i)
+            {
+                scheduler.spawn(new IncrementingFiber(mutex, counter));
+            }
+        }
+        EXPECT_EQ(1000u, counter);
+    }
+
+    TEST(FiberMutex, mutualExclusionOfFibersAndThreads)
+    {
+        FiberMutex mutex;
+        uint32_t counter = 0;
+        IncrementingThread incrementing(mutex, counter);
+        Thread thread;
+        {
+            FiberScheduler scheduler(1);
+            for (uint32_t i = 0; i < 100; ++i)
+            {
+                scheduler.spawn(new IncrementingFiber(mutex, counter));
+            }
+            thread.start(incrementing);
+            thread.join();
+        }
+        EXPECT_EQ(2000u, counter);
+    }
+}
@@ -0,0 +1,474 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/Fiber.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/os/TcpServerSocket.h"
+#include "capu/os/Time.h"
+#include "capu/util/CountDownLatch.h"
+#include "capu/util/ScopedLock.h"
+
+namespace capu
+{
+    namespace
+    {
+        class CountingFiber: public Runnable
+        {
+        public:
+            CountingFiber(volatile uint32_t& counter, const uint32_t yields = 0)
+                : mCounter(counter)
+                , mYields(yields)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < mYields; ++i)
+                {
+                    Fiber::Yield();
+                }
+                AtomicOperation::AtomicInc32(mCounter);
+            }
+
+        private:
+            volatile uint32_t& mCounter;
+            uint32_t mYields;
+        };
+
+        class SpawningFiber: public Runnable
+        {
+        public:
+            SpawningFiber(FiberScheduler& scheduler, volatile uint32_t& counter)
+                : result(CAPU_ERROR)
+                , mScheduler(scheduler)
+                , mCounter(counter)
+            {
+            }
+
+            void run()
+            {
+                // wait until the scheduler is closing
+                while (!mScheduler.isClosed())
+                {
+                    Fiber::Sleep(1);
+                }
+                result = mScheduler.spawn(new CountingFiber(mCounter));
+            }
+
+            status_t result;
+
+        private:
+            FiberScheduler& mScheduler;
+            volatile uint32_t& mCounter;
+        };
+
+        class LoggingFiber: public Runnable
+        {
+        public:
+            LoggingFiber(Vector<uint32_t>& log, const uint32_t id)
+                : mLog(log)
+                , mId(id)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    mLog.push_back(mId);
+                    Fiber::Yield();
+                }
+            }
+
+        private:
+            Vector<uint32_t>& mLog;
+            uint32_t mId;
+        };
+
+        class SleepingFiber: public Runnable
+        {
+        public:
+            SleepingFiber(const uint32_t millis, uint64_t& slept)
+                : mMillis(millis)
+                , mSlept(slept)
+            {
+            }
+
+            void run()
+            {
+                const uint64_t start = Time::GetMilliseconds();
+                Fiber::Sleep(mMillis);
+                mSlept = Time::GetMilliseconds() - start;
+            }
+
+        private:
+            uint32_t mMillis;
+            uint64_t& mSlept;
+        };
+
+        class SuspendingFiber: public Runnable
+        {
+        public:
+            SuspendingFiber(const uint32_t timeout)
+                : fiber(0)
+                , result(CAPU_ERROR)
+                , mTimeout(timeout)
+            {
+            }
+
+            void run()
+            {
+                ScopedMutexLock lock(mutex);
+                fiber = Fiber::Current();
+                result = Fiber::Suspend(mutex, mTimeout);
+            }
+
+            Mutex mutex;
+            Fiber* fiber;
+            status_t result;
+
+        private:
+            uint32_t mTimeout;
+        };
+
+        class WaitingFiber: public Runnable
+        {
+        public:
+            WaitingFiber(Mutex& mutex, FiberWaitQueue& queue, bool_t& released, uint32_t& waiting, CountDownLatch& latch)
+                : mMutex(mutex)
+                , mQueue(queue)
+                , mReleased(released)
+                , mWaiting(waiting)
+                , mLatch(latch)
+            {
+            }
+
+            void run()
+            {
+                ScopedMutexLock lock(mMutex);
+                ++mWaiting;
+                mLatch.countDown();
+                while (!mReleased)
+                {
+                    mQueue.wait(mMutex);
+                }
+                --mWaiting;
+            }
+
+        private:
+            Mutex& mMutex;
+            FiberWaitQueue& mQueue;
+            bool_t& mReleased;
+            uint32_t& mWaiting;
+            CountDownLatch& mLatch;
+        };
+
+        class ReceivingFiber: public Runnable
+        {
+        public:
+            ReceivingFiber(TcpSocket& socket)
+                : result(CAPU_ERROR)
+                , received(0)
+                , mSocket(socket)
+            {
+                buffer[0] = 0;
+            }
+
+            void run()
+            {
+                result = Fiber::Receive(mSocket, buffer, sizeof(buffer), received);
+            }
+
+            status_t result;
+            int32_t received;
+            char_t buffer[16];
+
+        private:
+            TcpSocket& mSocket;
+        };
+
+        class YieldingFiber: public Runnable
+        {
+        public:
+            YieldingFiber(const uint32_t yields)
+                : mYields(yields)
+            {
+            }
+
+            void run()
+            {
+                for (uint32_t i = 0; i < mYields; ++i)
+                {
+                    Fiber::Yield();
+                }
+            }
+
+        private:
+            uint32_t mYields;
+        };
+
+        class SocketPair
+        {
+        public:
+            SocketPair()
+                : server(0)
+            {
+                listener.bind(0, "127.0.0.1");
+                listener.listen(1);
+                client.connect("127.0.0.1", listener.port());
+                server = listener.accept(1000);
+            }
+
+            ~SocketPair()
+            {
+                delete server;
+            }
+
+            TcpServerSocket listener;
+            TcpSocket client;
+            TcpSocket* server;
+        };
+    }
+
+    TEST(Fiber, currentIsNullOnThread)
+    {
+        Mutex mutex;
+        EXPECT_TRUE(Fiber::Current() == NULL);
+        EXPECT_EQ(CAPU_ERROR, Fiber::Suspend(mutex, 1));
+    }
+
+    TEST(Fiber, spawnRunsRunnables)
+    {
+        volatile uint32_t counter = 0;
+        FiberScheduler scheduler;
+        EXPECT_EQ(1u, scheduler.getThreadCount());
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            EXPECT_EQ(CAPU_OK, scheduler.spawn(new CountingFiber(counter)));
+        }
+        EXPECT_EQ(CAPU_OK, scheduler.close());
+        EXPECT_EQ(10u, counter);
+        EXPECT_EQ(0u, scheduler.getFiberCount());
+    }
+
+    TEST(Fiber, spawnFailsWhenClosedOrNull)
+    {
+        volatile uint32_t counter = 0;
+        FiberScheduler scheduler;
+        EXPECT_EQ(CAPU_EINVAL, scheduler.spawn(SmartPointer<Runnable>()));
+        EXPECT_FALSE(scheduler.isClosed());
+        scheduler.close();
+        EXPECT_TRUE(scheduler.isClosed());
+        EXPECT_EQ(CAPU_ERROR, scheduler.spawn(new CountingFiber(counter)));
+        EXPECT_EQ(0u, counter);
+    }
+
+    TEST(Fiber, fibersSpawnWhileClosing)
+    {
+        volatile uint32_t counter = 0;
+        FiberScheduler scheduler(1);
+        SmartPointer<SpawningFiber> spawning = new SpawningFiber(scheduler, counter);
+        EXPECT_EQ(CAPU_OK, scheduler.spawn(spawning));
+        EXPECT_EQ(CAPU_OK, scheduler.close());
+        EXPECT_EQ(CAPU_OK, spawning->result);
+        EXPECT_EQ(1u, counter);
+        EXPECT_EQ(CAPU_ERROR, scheduler.spawn(new CountingFiber(counter)));
+    }
+
+    TEST(Fiber, yieldInterleavesFibers)
+    {
+        Vector<uint32_t> log;
+        FiberScheduler scheduler(1);
+        scheduler.spawn(new LoggingFiber(log, 1));
+        scheduler.spawn(new LoggingFiber(log, 2));
+        scheduler.close();
+
+        ASSERT_EQ(6u, log.size());
+        for (uint32_t i = 0; i < log.size(); ++i)
+        {
+            EXPECT_EQ(i % 2 + 1, log[i]);
+        }
+    }
+
+    TEST(Fiber, sleepLetsOtherFibersRun)
+    {
+        volatile uint32_t counter = 0;
+        uint64_t slept = 0;
+        FiberScheduler scheduler(1);
+        scheduler.spawn(new SleepingFiber(50, slept));
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            scheduler.spawn(new CountingFiber(counter, 10));
+        }
+        // the counting fibers do not wait for the sleeping one
+        while (counter < 100)
+        {
+            Thread::Sleep(1);
+        }
+        EXPECT_EQ(1u, scheduler.getFiberCount());
+        scheduler.close();
+        EXPECT_GE(slept, 50u);
+    }
+
+    TEST(Fiber, suspendAndResume)
+    {
+        FiberScheduler scheduler(1);
+        SmartPointer<SuspendingFiber> suspending = new SuspendingFiber(0);
+        scheduler.spawn(suspending);
+
+        Fiber* fiber = 0;
+        while (!fiber)
+        {
+            Thread::Sleep(1);
+            ScopedMutexLock lock(suspending->mutex);
+            fiber = suspending->fiber;
+        }
+        {
+            // the fiber is suspended once the lock is free
+            ScopedMutexLock lock(suspending->mutex);
+            fiber->resume();
+        }
+        scheduler.close();
+        EXPECT_EQ(CAPU_OK, suspending->result);
+    }
+
+    TEST(Fiber, suspendTimesOut)
+    {
+        FiberScheduler scheduler(1);
+        SmartPointer<SuspendingFiber> suspending = new SuspendingFiber(20);
+        const uint64_t start = Time::GetMilliseconds();
+        scheduler.spawn(suspending);
+        scheduler.close();
+        EXPECT_EQ(CAPU_ETIMEOUT, suspending->result);
+        EXPECT_GE(Time::GetMilliseconds() - start, 20u);
+    }
+
+    TEST(Fiber, manyThreads)
+    {
+        volatile uint32_t counter = 0;
+        FiberScheduler scheduler(4);
+        EXPECT_EQ(4u, scheduler.getThreadCount());
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            scheduler.spawn(new CountingFiber(counter, 10));
+        }
+        scheduler.close();
+        EXPECT_EQ(1000u, counter);
+    }
+
+    TEST(Fiber, stackPoolReusesStacks)
+    {
+        FiberStackPool guarded(10000, true);
+        EXPECT_EQ(12288u, guarded.getStackSize());
+        void* stack = guarded.acquire();
+        ASSERT_TRUE(stack != NULL);
+        guarded.release(stack);
+        EXPECT_EQ(stack, guarded.acquire());
+
+        FiberStackPool shared(16 * 1024, false);
+        char_t* first = static_cast<char_t*>(shared.acquire());
+        char_t* second = static_cast<char_t*>(shared.acquire());
+        ASSERT_TRUE(first != NULL);
+        EXPECT_EQ(first + 16 * 1024, second);
+        shared.release(second);
+        EXPECT_EQ(second, shared.acquire());
+    }
+
+    TEST(Fiber, hundredThousandFibers)
+    {
+        const uint32_t count = 100000;
+        Mutex mutex;
+        FiberWaitQueue queue;
+        bool_t released = false;
+        uint32_t waiting = 0;
+        CountDownLatch latch(count);
+
+        // without guard pages, guarded stacks would exceed the number of mappings a process may have
+        FiberScheduler scheduler(2, 16 * 1024, false);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(CAPU_OK, scheduler.spawn(new WaitingFiber(mutex, queue, released, waiting, latch)));
+        }
+        EXPECT_EQ(CAPU_OK, latch.await());
+        {
+            ScopedMutexLock lock(mutex);
+            EXPECT_EQ(count, waiting);
+            EXPECT_EQ(count, scheduler.getFiberCount());
+            released = true;
+            queue.notifyAll();
+        }
+        scheduler.close();
+        EXPECT_EQ(0u, waiting);
+        EXPECT_EQ(0u, scheduler.getFiberCount());
+    }
+
+    TEST(Fiber, receiveSuspendsFiberOnly)
+    {
+        SocketPair sockets;
+        ASSERT_TRUE(sockets.server != NULL);
+
+        volatile uint32_t counter = 0;
+        FiberScheduler scheduler(1);
+        SmartPointer<ReceivingFiber> receiving = new ReceivingFiber(*sockets.server);
+        scheduler.spawn(receiving);
+        scheduler.spawn(new CountingFiber(counter, 10));
+
+        // the single thread keeps running other fibers while the receiving one waits
+        while (counter < 1)
+        {
+            Thread::Sleep(1);
+        }
+        EXPECT_EQ(1u, scheduler.getFiberCount());
+
+        int32_t sent = 0;
+        EXPECT_EQ(CAPU_OK, sockets.client.send("fiber", 6, sent));
+        scheduler.close();
+        EXPECT_EQ(CAPU_OK, receiving->result);
+        EXPECT_EQ(6, receiving->received);
+        EXPECT_STREQ("fiber", receiving->buffer);
+    }
+
+    TEST(Fiber, receiveTimesOut)
+    {
+        SocketPair sockets;
+        ASSERT_TRUE(sockets.server != NULL);
+        sockets.server->setTimeout(20);
+
+        FiberScheduler scheduler(1);
+        SmartPointer<ReceivingFiber> receiving = new ReceivingFiber(*sockets.server);
+        scheduler.spawn(receiving);
+        scheduler.close();
+        EXPECT_EQ(CAPU_ETIMEOUT, receiving->result);
+        EXPECT_EQ(0, receiving->received);
+    }
+
+    TEST(Fiber, performanceYield)
+    {
+        const uint32_t yields = 1000000;
+        FiberScheduler scheduler(1);
+        const uint64_t start = Time::GetMilliseconds();
+        scheduler.spawn(new YieldingFiber(yields));
+        scheduler.spawn(new YieldingFiber(yields));
+        scheduler.close();
+        const uint64_t time = Time::GetMilliseconds() - start;
+
+        // every yield switches to the scheduler and into the other fiber
+        printf("%u yields between two fibers: %u ms, %.1f ns per yield\n", 2 * yields, static_cast<uint32_t>(time),
+               time * 1000000.0 / (2.0 * yields));
+    }
+}
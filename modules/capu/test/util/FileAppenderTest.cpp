@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/FileAppender.h"
+#include "capu/util/Logger.h"
+#include "capu/os/File.h"
+#include "capu/os/Thread.h"
+#include "capu/os/Time.h"
+
+namespace
+{
+    const capu::char_t* LogPath = "FileAppenderTest.log";
+
+    capu::String readFile(const capu::String& path)
+    {
+        capu::File file(path);
+        capu::uint_t size = 0;
+        if (file.getSizeInBytes(size) != capu::CAPU_OK || file.open(capu::READ_ONLY) != capu::CAPU_OK)
+        {
+            return "";
+        }
+        capu::char_t* buffer = new capu::char_t[size + 1];
+        capu::uint_t read = 0;
+        file.read(buffer, size, read);
+        buffer[read] = 0;
+        capu::String content(buffer);
+        delete[] buffer;
+        return content;
+    }
+
+    capu::uint_t countLines(const capu::String& content)
+    {
+        capu::uint_t lines = 0;
+        for (capu::uint_t i = 0; i < content.getLength(); i++)
+        {
+            if (content[i] == '\n')
+            {
+                ++lines;
+            }
+        }
+        return lines;
+    }
+
+    capu::String rotatedPath(capu::uint32_t index)
+    {
+        capu::char_t path[64];
+        capu::StringUtils::Sprintf(path, sizeof(path), "%s.%u", LogPath, index);
+        return path;
+    }
+
+    void removeLogFiles()
+    {
+        capu::File(LogPath).remove();
+        for (capu::uint32_t i = 1; i < 10; i++)
+        {
+            capu::File(rotatedPath(i)).remove();
+        }
+    }
+}
+
+TEST(FileAppender, openAndClose)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    EXPECT_EQ(capu::CAPU_ERROR, appender.close());
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+    EXPECT_EQ(capu::CAPU_ERROR, appender.open());
+    EXPECT_TRUE(capu::File(LogPath).exists());
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    EXPECT_EQ(capu::CAPU_ERROR, appender.close());
+
+    // can be reopened
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    removeLogFiles();
+}
+
+TEST(FileAppender, openInMissingDirectory)
+{
+    capu::FileAppender appender("FileAppenderTestMissingDir/test.log");
+    EXPECT_EQ(capu::CAPU_ERROR, appender.open());
+    EXPECT_EQ(capu::CAPU_ERROR, appender.open());
+    EXPECT_EQ(capu::CAPU_ERROR, appender.close());
+}
+
+TEST(FileAppender, writesMessages)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    CAPU_LOG_INFO(logger, "TAG", "first message %d", 1);
+    CAPU_LOG_ERROR(logger, "OTHER", "second message");
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    capu::String content = readFile(LogPath);
+    EXPECT_EQ(2u, countLines(content));
+    EXPECT_LT(0, content.find("INFO"));
+    EXPECT_LT(0, content.find("TAG, first message 1\n"));
+    EXPECT_LT(0, content.find("ERROR"));
+    EXPECT_LT(0, content.find("OTHER, second message\n"));
+    EXPECT_LT(content.find("first message"), content.find("second message"));
+    removeLogFiles();
+}
+
+TEST(FileAppender, logWhenClosed)
+{
+    capu::FileAppender appender(LogPath);
+    capu::LoggerMessage message;
+    message.setLevel(capu::CLL_INFO);
+    message.setMessage("message");
+    EXPECT_EQ(capu::CAPU_ERROR, appender.log(message));
+    EXPECT_EQ(capu::CAPU_ERROR, appender.flush());
+}
+
+TEST(FileAppender, appenderLevel)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setLoggingLevel(capu::CLL_WARN);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    CAPU_LOG_INFO(logger, "TAG", "info");
+    CAPU_LOG_WARN(logger, "TAG", "warn");
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    EXPECT_EQ(1u, countLines(readFile(LogPath)));
+    removeLogFiles();
+}
+
+TEST(FileAppender, flush)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setFlushInterval(0);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    CAPU_LOG_INFO(logger, "TAG", "message");
+    EXPECT_EQ(capu::CAPU_OK, appender.flush());
+    EXPECT_EQ(1u, countLines(readFile(LogPath)));
+
+    // nothing buffered
+    EXPECT_EQ(capu::CAPU_OK, appender.flush());
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    removeLogFiles();
+}
+
+TEST(FileAppender, flushByTime)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setFlushInterval(20);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    CAPU_LOG_INFO(logger, "TAG", "message");
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    while (countLines(readFile(LogPath)) == 0 && capu::Time::GetMilliseconds() - start < 5000)
+    {
+        capu::Thread::Sleep(5);
+    }
+    EXPECT_EQ(1u, countLines(readFile(LogPath)));
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    removeLogFiles();
+}
+
+TEST(FileAppender, flushBySize)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setBufferSize(1024);
+    appender.setFlushInterval(0);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    for (capu::uint32_t i = 0; i < 100; i++)
+    {
+        CAPU_LOG_INFO(logger, "TAG", "message %u", i);
+    }
+    // at least one full buffer has been handed to the writer
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    while (countLines(readFile(LogPath)) == 0 && capu::Time::GetMilliseconds() - start < 5000)
+    {
+        capu::Thread::Sleep(5);
+    }
+    EXPECT_LT(0u, countLines(readFile(LogPath)));
+
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    EXPECT_EQ(100u, countLines(readFile(LogPath)));
+    removeLogFiles();
+}
+
+TEST(FileAppender, truncatesLongMessages)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setBufferSize(256);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    capu::char_t text[1024];
+    capu::Memory::Set(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = 0;
+    capu::LoggerMessage message;
+    message.setLevel(capu::CLL_INFO);
+    message.setTag("TAG");
+    message.setFile("file");
+    message.setMessage(text);
+    EXPECT_EQ(capu::CAPU_OK, appender.log(message));
+    EXPECT_EQ(capu::CAPU_OK, appender.log(message));
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    capu::String content = readFile(LogPath);
+    EXPECT_EQ(512u, content.getLength());
+    EXPECT_EQ(2u, countLines(content));
+    removeLogFiles();
+}
+
+TEST(FileAppender, rotation)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setBufferSize(256);
+    appender.setFlushInterval(0);
+    appender.setRotation(1024, 3);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    for (capu::uint32_t i = 0; i < 1000; i++)
+    {
+        CAPU_LOG_INFO(logger, "TAG", "message %u", i);
+    }
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    EXPECT_TRUE(capu::File(LogPath).exists());
+    EXPECT_TRUE(capu::File(rotatedPath(1)).exists());
+    EXPECT_TRUE(capu::File(rotatedPath(2)).exists());
+    EXPECT_TRUE(capu::File(rotatedPath(3)).exists());
+    EXPECT_FALSE(capu::File(rotatedPath(4)).exists());
+
+    for (capu::uint32_t i = 0; i <= 3; i++)
+    {
+        capu::uint_t size = 0;
+        capu::File file(i == 0 ? capu::String(LogPath) : rotatedPath(i));
+        EXPECT_EQ(capu::CAPU_OK, file.getSizeInBytes(size));
+        EXPECT_GE(1024u, size);
+        EXPECT_LT(0u, size);
+    }
+
+    // the newest messages are in the current file, older ones were rotated
+    EXPECT_LT(0, readFile(LogPath).find("message 999\n"));
+    EXPECT_GT(0, readFile(rotatedPath(1)).find("message 999\n"));
+    EXPECT_GT(0, readFile(rotatedPath(3)).find("message 0\n"));
+    removeLogFiles();
+}
+
+TEST(FileAppender, rotationOnOpen)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setRotation(1024 * 1024, 2);
+    capu::Logger logger;
+    logger.setAppender(appender);
+
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+    CAPU_LOG_INFO(logger, "TAG", "first run");
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+    CAPU_LOG_INFO(logger, "TAG", "second run");
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+
+    EXPECT_LT(0, readFile(LogPath).find("second run"));
+    EXPECT_LT(0, readFile(rotatedPath(1)).find("first run"));
+    removeLogFiles();
+}
+
+class FileAppenderLogRunnable : public capu::Runnable
+{
+public:
+    FileAppenderLogRunnable(capu::Logger& logger, capu::uint32_t count)
+        : mLogger(logger)
+        , mCount(count)
+    {
+    }
+
+    void run()
+    {
+        for (capu::uint32_t i = 0; i < mCount; i++)
+        {
+            CAPU_LOG_INFO(mLogger, "TAG", "message %u from a thread with a typical length of a log line", i);
+        }
+    }
+
+private:
+    capu::Logger& mLogger;
+    capu::uint32_t mCount;
+};
+
+TEST(FileAppender, concurrentLogging)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setBufferSize(4096);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    FileAppenderLogRunnable runnable(logger, 2000);
+    capu::Thread threads[4];
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        threads[i].start(runnable);
+    }
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        threads[i].join();
+    }
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    EXPECT_EQ(8000u, countLines(readFile(LogPath)));
+    removeLogFiles();
+}
+
+TEST(FileAppender, performanceSustainedMessages)
+{
+    removeLogFiles();
+    capu::FileAppender appender(LogPath);
+    appender.setRotation(64 * 1024 * 1024, 1);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+
+    const capu::uint32_t count = 1000000;
+    FileAppenderLogRunnable runnable(logger, count / 4);
+    capu::Thread threads[4];
+    const capu::uint64_t start = capu::Time::GetMilliseconds();
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        threads[i].start(runnable);
+    }
+    for (capu::uint32_t i = 0; i < 4; i++)
+    {
+        threads[i].join();
+    }
+    EXPECT_EQ(capu::CAPU_OK, appender.close());
+    const capu::uint64_t duration = capu::Time::GetMilliseconds() - start;
+
+    printf("[FileAppender] - %u messages from 4 threads take %u ms (%u messages/s)\n", count,
+           static_cast<capu::uint32_t>(duration), static_cast<capu::uint32_t>(count * 1000ull / (duration + 1)));
+    removeLogFiles();
+}
+
+#ifndef OS_WINDOWS
+TEST(FileAppender, reopenAfterFailedRotation)
+{
+    // the open log file and its directory can be removed, so rotation and reopening fail
+    capu::File directory("FileAppenderTestDir");
+    const capu::String path = "FileAppenderTestDir/rotating.log";
+    directory.createDirectory();
+    capu::FileAppender appender(path);
+    appender.setBufferSize(256);
+    appender.setFlushInterval(0);
+    appender.setRotation(1024, 2);
+    capu::Logger logger;
+    logger.setAppender(appender);
+    EXPECT_EQ(capu::CAPU_OK, appender.open());
+    capu::File(path).remove();
+    directory.remove();
+
+    for (capu::uint32_t i = 0; i < 100; i++)
+    {
+        CAPU_LOG_INFO(logger, "TAG", "lost message %u", i);
+    }
+    EXPECT_NE(capu::CAPU_OK, appender.flush());
+
+    // writing resumes as soon as the file can be opened again
+    EXPECT_EQ(capu::CAPU_OK, directory.createDirectory());
+    CAPU_LOG_INFO(logger, "TAG", "kept message");
+    appender.flush();
+    appender.close();
+    EXPECT_LT(0, readFile(path).find("kept message\n"));
+
+    capu::File(path).remove();
+    capu::File(path + ".1").remove();
+    capu::File(path + ".2").remove();
+    directory.remove();
+}
+#endif
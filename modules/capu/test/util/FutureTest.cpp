@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "capu/util/Future.h"
+#include "capu/util/ThreadPool.h"
+#include "capu/util/CountDownLatch.h"
+#include "capu/container/String.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/os/Semaphore.h"
+
+class Square : public capu::Callable<capu::uint32_t>
+{
+public:
+    Square(capu::uint32_t value)
+        : mValue(value)
+    {
+    }
+
+    capu::uint32_t call()
+    {
+        return mValue * mValue;
+    }
+
+private:
+    capu::uint32_t mValue;
+};
+
+class BlockedCallable : public capu::Callable<capu::uint32_t>
+{
+public:
+    BlockedCallable(capu::Semaphore& semaphore)
+        : mSemaphore(semaphore)
+    {
+    }
+
+    capu::uint32_t call()
+    {
+        mSemaphore.aquire();
+        return 42;
+    }
+
+private:
+    capu::Semaphore& mSemaphore;
+};
+
+class AddOne : public capu::Continuation<capu::uint32_t, capu::uint32_t>
+{
+public:
+    capu::uint32_t call(const capu::uint32_t& value)
+    {
+        return value + 1;
+    }
+};
+
+class ToString : public capu::Continuation<capu::uint32_t, capu::String>
+{
+public:
+    capu::String call(const capu::uint32_t& value)
+    {
+        capu::char_t buffer[16];
+        capu::StringUtils::Sprintf(buffer, sizeof(buffer), "%u", value);
+        return buffer;
+    }
+};
+
+TEST(Future, InvalidFuture)
+{
+    capu::Future<capu::uint32_t> future;
+    EXPECT_FALSE(future.isValid());
+    EXPECT_FALSE(future.isReady());
+    EXPECT_EQ(capu::CAPU_EINVAL, future.wait());
+
+    capu::ThreadPool pool(1);
+    capu::Future<capu::uint32_t> next = future.then(pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::uint32_t> >(new AddOne()));
+    EXPECT_FALSE(next.isValid());
+
+    EXPECT_FALSE(pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >()).isValid());
+}
+
+TEST(Future, SubmitAndGet)
+{
+    capu::ThreadPool pool(2);
+    capu::Future<capu::uint32_t> future = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(7)));
+    EXPECT_TRUE(future.isValid());
+    EXPECT_EQ(capu::CAPU_OK, future.wait());
+    EXPECT_TRUE(future.isReady());
+    EXPECT_EQ(49u, future.get());
+
+    // copies share the result
+    capu::Future<capu::uint32_t> copy = future;
+    EXPECT_EQ(49u, copy.get());
+}
+
+TEST(Future, WaitTimeout)
+{
+    capu::Semaphore semaphore;
+    capu::ThreadPool pool(1);
+    capu::Future<capu::uint32_t> future = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new BlockedCallable(semaphore)));
+    EXPECT_EQ(capu::CAPU_ETIMEOUT, future.wait(20));
+    EXPECT_FALSE(future.isReady());
+
+    semaphore.release();
+    EXPECT_EQ(capu::CAPU_OK, future.wait());
+    EXPECT_EQ(42u, future.get());
+}
+
+TEST(Future, SubmitToClosedPool)
+{
+    capu::ThreadPool pool(1);
+    pool.close();
+    capu::Future<capu::uint32_t> future = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(2)));
+    EXPECT_TRUE(future.isValid());
+    EXPECT_EQ(capu::CAPU_ERROR, future.wait());
+}
+
+TEST(Future, AbandonedOnCancel)
+{
+    capu::Semaphore semaphore;
+    capu::ThreadPool* pool = new capu::ThreadPool(1);
+    capu::Future<capu::uint32_t> running = pool->submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new BlockedCallable(semaphore)));
+    capu::Future<capu::uint32_t> queued = pool->submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(3)));
+    capu::Future<capu::uint32_t> continued = queued.then(*pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::uint32_t> >(new AddOne()));
+
+    semaphore.release();
+    EXPECT_EQ(capu::CAPU_OK, running.wait());
+    delete pool;
+
+    // either executed before the pool was closed or abandoned, but never blocking
+    EXPECT_TRUE(queued.isReady());
+    EXPECT_TRUE(continued.isReady());
+}
+
+TEST(Future, Then)
+{
+    capu::ThreadPool pool(2);
+    capu::Future<capu::uint32_t> future = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(3)));
+    capu::Future<capu::uint32_t> plusOne = future.then(pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::uint32_t> >(new AddOne()));
+    capu::Future<capu::String> text = plusOne.then(pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::String> >(new ToString()));
+
+    EXPECT_EQ(capu::CAPU_OK, text.wait());
+    EXPECT_STREQ("10", text.get().c_str());
+    EXPECT_EQ(10u, plusOne.get());
+}
+
+TEST(Future, ThenOnFinishedFuture)
+{
+    capu::ThreadPool pool(1);
+    capu::Future<capu::uint32_t> future = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(4)));
+    EXPECT_EQ(capu::CAPU_OK, future.wait());
+
+    capu::Future<capu::uint32_t> plusOne = future.then(pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::uint32_t> >(new AddOne()));
+    EXPECT_EQ(17u, plusOne.get());
+}
+
+TEST(Future, ThenPropagatesError)
+{
+    capu::ThreadPool pool(1);
+    capu::ThreadPool closedPool(1);
+    closedPool.close();
+    capu::Future<capu::uint32_t> failed = closedPool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(4)));
+    capu::Future<capu::uint32_t> plusOne = failed.then(pool, capu::SmartPointer<capu::Continuation<capu::uint32_t, capu::uint32_t> >(new AddOne()));
+    EXPECT_EQ(capu::CAPU_ERROR, plusOne.wait());
+    EXPECT_EQ(0u, plusOne.get());
+}
+
+TEST(Future, WhenAll)
+{
+    capu::ThreadPool pool(4);
+    const capu::uint_t count = 100;
+    capu::Future<capu::uint32_t> futures[count];
+    for (capu::uint_t i = 0; i < count; ++i)
+    {
+        futures[i] = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(static_cast<capu::uint32_t>(i))));
+    }
+
+    capu::Future<capu::status_t> all = capu::whenAll(futures, count);
+    EXPECT_EQ(capu::CAPU_OK, all.wait());
+    EXPECT_EQ(capu::CAPU_OK, all.get());
+    for (capu::uint_t i = 0; i < count; ++i)
+    {
+        EXPECT_TRUE(futures[i].isReady());
+        EXPECT_EQ(i * i, futures[i].get());
+    }
+}
+
+TEST(Future, WhenAllEmptyAndFailed)
+{
+    capu::Future<capu::status_t> none = capu::whenAll(static_cast<capu::Future<capu::uint32_t>*>(NULL), 0);
+    EXPECT_TRUE(none.isReady());
+    EXPECT_EQ(capu::CAPU_OK, none.wait());
+
+    capu::ThreadPool pool(1);
+    capu::ThreadPool closedPool(1);
+    closedPool.close();
+    capu::Future<capu::uint32_t> futures[2];
+    futures[0] = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(2)));
+    futures[1] = closedPool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(3)));
+    capu::Future<capu::status_t> all = capu::whenAll(futures, 2);
+    EXPECT_EQ(capu::CAPU_ERROR, all.wait());
+    EXPECT_EQ(capu::CAPU_ERROR, all.get());
+}
+
+struct SharedResult
+{
+    SharedResult()
+        : value(0)
+        , latch(1)
+    {
+    }
+
+    capu::uint32_t value;
+    capu::CountDownLatch latch;
+};
+
+class LatchedSquare : public capu::Runnable
+{
+public:
+    LatchedSquare(capu::uint32_t value, capu::SmartPointer<SharedResult> result)
+        : mValue(value)
+        , mResult(result)
+    {
+    }
+
+    void run()
+    {
+        mResult->value = mValue * mValue;
+        mResult->latch.countDown();
+    }
+
+private:
+    capu::uint32_t mValue;
+    capu::SmartPointer<SharedResult> mResult;
+};
+
+static const capu::uint_t FanOutRounds = 200;
+static const capu::uint_t FanOutWidth = 64;
+
+TEST(Future, performanceFanOutFanIn)
+{
+    capu::ThreadPool pool(4);
+    capu::uint64_t sum = 0;
+    for (capu::uint_t round = 0; round < FanOutRounds; ++round)
+    {
+        capu::Future<capu::uint32_t> futures[FanOutWidth];
+        for (capu::uint_t i = 0; i < FanOutWidth; ++i)
+        {
+            futures[i] = pool.submit(capu::SmartPointer<capu::Callable<capu::uint32_t> >(new Square(static_cast<capu::uint32_t>(i))));
+        }
+        capu::whenAll(futures, FanOutWidth).wait();
+        for (capu::uint_t i = 0; i < FanOutWidth; ++i)
+        {
+            sum += futures[i].get();
+        }
+    }
+    EXPECT_EQ(FanOutRounds * 85344u, sum);
+}
+
+TEST(Future, performanceFanOutFanInWithLatch)
+{
+    // the hand made shared state per job which the futures replace
+    capu::ThreadPool pool(4);
+    capu::uint64_t sum = 0;
+    for (capu::uint_t round = 0; round < FanOutRounds; ++round)
+    {
+        capu::SmartPointer<SharedResult> results[FanOutWidth];
+        for (capu::uint_t i = 0; i < FanOutWidth; ++i)
+        {
+            results[i] = new SharedResult();
+            pool.add(capu::SmartPointer<capu::Runnable>(new LatchedSquare(static_cast<capu::uint32_t>(i), results[i])));
+        }
+        for (capu::uint_t i = 0; i < FanOutWidth; ++i)
+        {
+            results[i]->latch.await();
+            sum += results[i]->value;
+        }
+    }
+    EXPECT_EQ(FanOutRounds * 85344u, sum);
+}
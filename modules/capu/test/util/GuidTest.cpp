@@ -16,6 +16,7 @@
 
 #include "gmock/gmock.h"
 #include "capu/util/Guid.h"
+#include "capu/os/Thread.h"
 
 TEST(GuidTest, TestNewAreNotEqual)
 {
@@ -122,3 +123,70 @@ TEST(GuidTest, CopyConstructor)
 
     EXPECT_STREQ(id1.toString(), id2.toString());
 }
+
+class GuidCreator : public capu::Runnable
+{
+public:
+    GuidCreator()
+        : mCount(0)
+        , mLast()
+        , mRepeated(false)
+    {
+    }
+
+    void setCount(capu::uint32_t count)
+    {
+        mCount = count;
+    }
+
+    void run()
+    {
+        for (capu::uint32_t i = 0; i < mCount; ++i)
+        {
+            capu::Guid guid;
+            mRepeated = mRepeated || guid == mLast;
+            mLast = guid;
+        }
+    }
+
+    capu::uint32_t mCount;
+    capu::Guid mLast;
+    capu::bool_t mRepeated;
+};
+
+TEST(GuidTest, ThreadsCreateDifferentGuids)
+{
+    GuidCreator creators[4];
+    capu::Thread threads[4];
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        creators[i].setCount(1000);
+        threads[i].start(creators[i]);
+    }
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        threads[i].join();
+        EXPECT_FALSE(creators[i].mRepeated);
+        EXPECT_EQ('4', creators[i].mLast.toString().c_str()[14]);
+    }
+    for (capu::uint32_t i = 1; i < 4; ++i)
+    {
+        EXPECT_FALSE(creators[0].mLast == creators[i].mLast);
+    }
+}
+
+TEST(GuidTest, performanceCreateMultiThreaded)
+{
+    // 4 threads creating 1M guids in total
+    GuidCreator creators[4];
+    capu::Thread threads[4];
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        creators[i].setCount(250000);
+        threads[i].start(creators[i]);
+    }
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        threads[i].join();
+    }
+}
@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 #include "capu/util/Logger.h"
 #include "capu/util/Appender.h"
+#include "capu/container/String.h"
+#include "capu/os/Thread.h"
 
 class DummyAppender : public capu::Appender
 {
@@ -37,6 +39,66 @@ public:
     }
 };
 
+class RecordingAppender : public capu::Appender
+{
+public:
+    RecordingAppender()
+        : count(0)
+    {
+    }
+
+    capu::status_t open()
+    {
+        return capu::CAPU_OK;
+    }
+
+    capu::status_t log(capu::LoggerMessage& message)
+    {
+        ++count;
+        lastMessage = message.getMessage();
+        lastTag = message.getTag();
+        return capu::CAPU_OK;
+    }
+
+    capu::status_t close()
+    {
+        return capu::CAPU_OK;
+    }
+
+    capu::uint32_t count;
+    capu::String lastMessage;
+    capu::String lastTag;
+};
+
+class TagLevelChanger : public capu::Runnable
+{
+public:
+    TagLevelChanger(capu::Logger& logger)
+        : mLogger(logger)
+    {
+    }
+
+    void run()
+    {
+        // long tags so removing one frees its string storage
+        const capu::char_t* const tags[] = {"A_TAG_WHICH_IS_LONG_ENOUGH_TO_BE_ALLOCATED_0", "A_TAG_WHICH_IS_LONG_ENOUGH_TO_BE_ALLOCATED_1"};
+        for (capu::uint32_t i = 0; i < 20000; i++)
+        {
+            mLogger.setTagLoggingLevel(tags[i % 2], (i / 2) % 2 == 0 ? capu::CLL_TRACE : capu::CLL_INVALID);
+        }
+    }
+
+private:
+    capu::Logger& mLogger;
+};
+
+static capu::uint32_t EvaluationCount = 0;
+
+static capu::int32_t countEvaluation()
+{
+    return static_cast<capu::int32_t>(++EvaluationCount);
+}
+
 TEST(Logger, Constructor_Default)
 {
     capu::Logger* log1 = new capu::Logger();
@@ -135,3 +197,218 @@ TEST(Logger, log)
     EXPECT_EQ(capu::CAPU_OK, status);
 }
 
+TEST(Logger, formatsArguments)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+
+    CAPU_LOG_INFO(logger, "TAG", "value %d and %s", 1234, "text");
+    EXPECT_EQ(1u, appender.count);
+    EXPECT_STREQ("value 1234 and text", appender.lastMessage.c_str());
+    EXPECT_STREQ("TAG", appender.lastTag.c_str());
+}
+
+TEST(Logger, appenderLevel)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    appender.setLoggingLevel(capu::CLL_WARN);
+    logger.setAppender(appender);
+
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_INFO, "TAG"));
+    EXPECT_TRUE(logger.isLevelEnabled(capu::CLL_WARN, "TAG"));
+
+    CAPU_LOG_DEBUG(logger, "TAG", "debug");
+    logger.info("TAG", __FILE__, __LINE__, "info");
+    CAPU_LOG_ERROR(logger, "TAG", "error");
+    EXPECT_EQ(1u, appender.count);
+    EXPECT_STREQ("error", appender.lastMessage.c_str());
+
+    // the logger notices level changes of attached appenders
+    appender.setLoggingLevel(capu::CLL_TRACE);
+    EXPECT_TRUE(logger.isLevelEnabled(capu::CLL_TRACE, "TAG"));
+    CAPU_LOG_TRACE(logger, "TAG", "trace");
+    EXPECT_EQ(2u, appender.count);
+
+    appender.setLoggingLevel(capu::CLL_ERROR);
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_WARN, "TAG"));
+}
+
+TEST(Logger, appendersWithDifferentLevels)
+{
+    capu::Logger logger;
+    RecordingAppender verbose;
+    RecordingAppender quiet;
+    verbose.setLoggingLevel(capu::CLL_DEBUG);
+    quiet.setLoggingLevel(capu::CLL_ERROR);
+    logger.setAppender(verbose);
+    logger.setAppender(quiet);
+
+    CAPU_LOG_TRACE(logger, "TAG", "trace");
+    CAPU_LOG_INFO(logger, "TAG", "info");
+    CAPU_LOG_ERROR(logger, "TAG", "error");
+    EXPECT_EQ(2u, verbose.count);
+    EXPECT_EQ(1u, quiet.count);
+
+    logger.removeAppender(verbose);
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_INFO, "TAG"));
+}
+
+TEST(Logger, noAppender)
+{
+    capu::Logger logger;
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_ERROR, "TAG"));
+}
+
+TEST(Logger, loggerLevel)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+    logger.setLoggingLevel(capu::CLL_INFO);
+
+    CAPU_LOG_DEBUG(logger, "TAG", "debug");
+    CAPU_LOG_INFO(logger, "TAG", "info");
+    EXPECT_EQ(1u, appender.count);
+    EXPECT_STREQ("info", appender.lastMessage.c_str());
+}
+
+TEST(Logger, tagLevels)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+    logger.setLoggingLevel(capu::CLL_WARN);
+    EXPECT_EQ(capu::CAPU_OK, logger.setTagLoggingLevel("NETWORK", capu::CLL_TRACE));
+    EXPECT_EQ(capu::CAPU_OK, logger.setTagLoggingLevel("NOISY", capu::CLL_ERROR));
+
+    CAPU_LOG_DEBUG(logger, "NETWORK", "network debug");
+    CAPU_LOG_DEBUG(logger, "OTHER", "other debug");
+    CAPU_LOG_WARN(logger, "NOISY", "noisy warn");
+    CAPU_LOG_WARN(logger, "OTHER", "other warn");
+    EXPECT_EQ(2u, appender.count);
+    EXPECT_STREQ("other warn", appender.lastMessage.c_str());
+
+    // remove the tag specific level
+    EXPECT_EQ(capu::CAPU_OK, logger.setTagLoggingLevel("NETWORK", capu::CLL_INVALID));
+    CAPU_LOG_DEBUG(logger, "NETWORK", "network debug");
+    EXPECT_EQ(2u, appender.count);
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_DEBUG, "NETWORK"));
+
+    EXPECT_EQ(capu::CAPU_EINVAL, logger.setTagLoggingLevel(NULL, capu::CLL_INFO));
+}
+
+TEST(Logger, tagLevelsChangeWhileLogging)
+{
+    capu::Logger logger;
+    DummyAppender appender;
+    logger.setAppender(appender);
+    logger.setLoggingLevel(capu::CLL_WARN);
+
+    TagLevelChanger changer(logger);
+    capu::Thread thread;
+    thread.start(changer);
+    for (capu::uint32_t i = 0; i < 20000; i++)
+    {
+        logger.isLevelEnabled(capu::CLL_DEBUG, "A_TAG_WHICH_IS_LONG_ENOUGH_TO_BE_ALLOCATED_1");
+        EXPECT_TRUE(logger.isLevelEnabled(capu::CLL_WARN, "OTHER"));
+    }
+    thread.join();
+
+    // after the last change neither tag has an own level
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_DEBUG, "A_TAG_WHICH_IS_LONG_ENOUGH_TO_BE_ALLOCATED_0"));
+    EXPECT_FALSE(logger.isLevelEnabled(capu::CLL_DEBUG, "A_TAG_WHICH_IS_LONG_ENOUGH_TO_BE_ALLOCATED_1"));
+}
+
+TEST(Logger, tooManyTagLevels)
+{
+    capu::Logger logger;
+    capu::char_t tag[16];
+    for (capu::int32_t i = 0; i < LOGGER_TAG_LEVEL_MAX; i++)
+    {
+        capu::StringUtils::Sprintf(tag, sizeof(tag), "TAG%d", i);
+        EXPECT_EQ(capu::CAPU_OK, logger.setTagLoggingLevel(tag, capu::CLL_INFO));
+    }
+    EXPECT_EQ(capu::CAPU_ERROR, logger.setTagLoggingLevel("ONE_MORE", capu::CLL_INFO));
+    // changing an existing tag still works
+    EXPECT_EQ(capu::CAPU_OK, logger.setTagLoggingLevel("TAG3", capu::CLL_DEBUG));
+}
+
+TEST(Logger, disabledMacroDoesNotEvaluateArguments)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    appender.setLoggingLevel(capu::CLL_INFO);
+    logger.setAppender(appender);
+
+    EvaluationCount = 0;
+    CAPU_LOG_TRACE(logger, "TAG", "value %d", countEvaluation());
+    CAPU_LOG(logger, capu::CLL_DEBUG, "TAG", "value %d", countEvaluation());
+    EXPECT_EQ(0u, EvaluationCount);
+
+    CAPU_LOG_INFO(logger, "TAG", "value %d", countEvaluation());
+    EXPECT_EQ(1u, EvaluationCount);
+    EXPECT_STREQ("value 1", appender.lastMessage.c_str());
+}
+
+TEST(Logger, macroInIfElse)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+
+    bool condition = false;
+    if (condition)
+        CAPU_LOG_INFO(logger, "TAG", "if");
+    else
+        CAPU_LOG_INFO(logger, "TAG", "else");
+    EXPECT_STREQ("else", appender.lastMessage.c_str());
+}
+
+TEST(Logger, performanceDisabledLog)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    appender.setLoggingLevel(capu::CLL_ERROR);
+    logger.setAppender(appender);
+
+    for (capu::uint32_t i = 0; i < 10000000; i++)
+    {
+        CAPU_LOG_TRACE(logger, "TAG", "iteration %u of %s", i, "loop");
+    }
+    EXPECT_EQ(0u, appender.count);
+}
+
+TEST(Logger, performanceDisabledLogWithTagLevels)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+    logger.setLoggingLevel(capu::CLL_WARN);
+    logger.setTagLoggingLevel("NETWORK", capu::CLL_DEBUG);
+
+    // trace stays below the threshold of all tags, debug needs the tag lookup
+    for (capu::uint32_t i = 0; i < 10000000; i++)
+    {
+        CAPU_LOG_TRACE(logger, "TAG", "iteration %u of %s", i, "loop");
+    }
+    for (capu::uint32_t i = 0; i < 1000000; i++)
+    {
+        CAPU_LOG_DEBUG(logger, "TAG", "iteration %u of %s", i, "loop");
+    }
+    EXPECT_EQ(0u, appender.count);
+}
+
+TEST(Logger, performanceEnabledLog)
+{
+    capu::Logger logger;
+    RecordingAppender appender;
+    logger.setAppender(appender);
+
+    for (capu::uint32_t i = 0; i < 100000; i++)
+    {
+        CAPU_LOG_TRACE(logger, "TAG", "iteration %u of %s", i, "loop");
+    }
+    EXPECT_EQ(100000u, appender.count);
+}
@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/ParallelAlgorithms.h"
+#include "capu/util/CountDownLatch.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/os/Math.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        class MarkFunction
+        {
+        public:
+            MarkFunction(Array<uint32_t>& marks)
+                : mMarks(marks)
+                , mCalls(0)
+                , mLargestRange(0)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                for (uint_t i = begin; i < end; ++i)
+                {
+                    AtomicOperation::AtomicInc32(mMarks[i]);
+                }
+                ScopedMutexLock lock(mMutex);
+                ++mCalls;
+                if (end - begin > mLargestRange)
+                {
+                    mLargestRange = end - begin;
+                }
+            }
+
+            Array<uint32_t>& mMarks;
+            Mutex mMutex;
+            uint_t mCalls;
+            uint_t mLargestRange;
+        };
+
+        class SumFunction
+        {
+        public:
+            SumFunction(const uint32_t* data)
+                : mData(data)
+            {
+            }
+
+            uint64_t operator()(const uint_t begin, const uint_t end)
+            {
+                uint64_t sum = 0;
+                for (uint_t i = begin; i < end; ++i)
+                {
+                    sum += mData[i];
+                }
+                return sum;
+            }
+
+        private:
+            const uint32_t* mData;
+        };
+
+        class Add
+        {
+        public:
+            uint64_t operator()(const uint64_t first, const uint64_t second)
+            {
+                return first + second;
+            }
+        };
+
+        class Square
+        {
+        public:
+            uint64_t operator()(const uint32_t value)
+            {
+                return static_cast<uint64_t>(value) * value;
+            }
+        };
+
+        class Root
+        {
+        public:
+            double_t operator()(const double_t value)
+            {
+                // newton iterations, enough arithmetic per element to be compute bound
+                double_t x = value > 1.0 ? value : 1.0;
+                for (uint32_t i = 0; i < 40; ++i)
+                {
+                    x = 0.5 * (x + value / x);
+                }
+                return x;
+            }
+        };
+
+        class NestedFunction
+        {
+        public:
+            NestedFunction(ThreadPool& pool, Array<uint32_t>& marks)
+                : mPool(pool)
+                , mMarks(marks)
+            {
+            }
+
+            void operator()(const uint_t begin, const uint_t end)
+            {
+                for (uint_t i = begin; i < end; ++i)
+                {
+                    MarkFunction inner(mMarks);
+                    parallelFor(mPool, i * 100, (i + 1) * 100, 7, inner);
+                }
+            }
+
+        private:
+            ThreadPool& mPool;
+            Array<uint32_t>& mMarks;
+        };
+
+        // the old way: one runnable per chunk joined with a latch
+        class SumRunnable : public Runnable
+        {
+        public:
+            SumRunnable(const uint32_t* data, const uint_t begin, const uint_t end, uint64_t& result, CountDownLatch& latch)
+                : mData(data)
+                , mBegin(begin)
+                , mEnd(end)
+                , mResult(result)
+                , mLatch(latch)
+            {
+            }
+
+            void run()
+            {
+                SumFunction sum(mData);
+                mResult = sum(mBegin, mEnd);
+                mLatch.countDown();
+            }
+
+        private:
+            const uint32_t* mData;
+            const uint_t mBegin;
+            const uint_t mEnd;
+            uint64_t& mResult;
+            CountDownLatch& mLatch;
+        };
+    }
+
+    TEST(ParallelAlgorithms, forCoversRangeOnce)
+    {
+        ThreadPool pool(4);
+        Array<uint32_t> marks(10000, 0);
+
+        MarkFunction function(marks);
+        parallelFor(pool, 100, 9900, 64, function);
+        for (uint_t i = 0; i < 10000; ++i)
+        {
+            ASSERT_EQ(i >= 100 && i < 9900 ? 1u : 0u, marks[i]);
+        }
+        EXPECT_LE(function.mLargestRange, 64u);
+        EXPECT_GE(function.mCalls, 9800u / 64);
+    }
+
+    TEST(ParallelAlgorithms, forAutomaticGrain)
+    {
+        ThreadPool pool(3);
+        Array<uint32_t> marks(100000, 0);
+
+        MarkFunction function(marks);
+        parallelFor(pool, 0, 100000, 0, function);
+        for (uint_t i = 0; i < 100000; ++i)
+        {
+            ASSERT_EQ(1u, marks[i]);
+        }
+        // about eight pieces per thread
+        EXPECT_GE(function.mCalls, 32u);
+        EXPECT_LE(function.mCalls, 64u);
+    }
+
+    TEST(ParallelAlgorithms, forEmptyAndTinyRanges)
+    {
+        ThreadPool pool(2);
+        Array<uint32_t> marks(10, 0);
+
+        MarkFunction function(marks);
+        parallelFor(pool, 5, 5, 0, function);
+        parallelFor(pool, 6, 5, 0, function);
+        EXPECT_EQ(0u, function.mCalls);
+
+        parallelFor(pool, 3, 4, 0, function);
+        EXPECT_EQ(1u, function.mCalls);
+        EXPECT_EQ(1u, marks[3]);
+    }
+
+    TEST(ParallelAlgorithms, forOnClosedPoolRunsOnCaller)
+    {
+        ThreadPool pool(2);
+        pool.close();
+        Array<uint32_t> marks(1000, 0);
+
+        MarkFunction function(marks);
+        parallelFor(pool, 0, 1000, 10, function);
+        for (uint_t i = 0; i < 1000; ++i)
+        {
+            ASSERT_EQ(1u, marks[i]);
+        }
+    }
+
+    TEST(ParallelAlgorithms, forNestedInPoolThreads)
+    {
+        // inner loops run on pool threads, the callers do the work if nobody is free
+        ThreadPool pool(2);
+        Array<uint32_t> marks(2000, 0);
+
+        NestedFunction function(pool, marks);
+        parallelFor(pool, 0, 20, 1, function);
+        for (uint_t i = 0; i < 2000; ++i)
+        {
+            ASSERT_EQ(1u, marks[i]);
+        }
+    }
+
+    TEST(ParallelAlgorithms, reduce)
+    {
+        ThreadPool pool(4);
+        Array<uint32_t> data(100000);
+        uint64_t expected = 0;
+        for (uint32_t i = 0; i < 100000; ++i)
+        {
+            data[i] = i * 7;
+            expected += i * 7;
+        }
+
+        SumFunction sum(data.getRawData());
+        Add add;
+        EXPECT_EQ(expected, parallelReduce(pool, 0, 100000, 0, static_cast<uint64_t>(0), sum, add));
+        EXPECT_EQ(0u, parallelReduce(pool, 10, 10, 0, static_cast<uint64_t>(0), sum, add));
+        EXPECT_EQ(7u + 14u, parallelReduce(pool, 1, 3, 1, static_cast<uint64_t>(0), sum, add));
+    }
+
+    TEST(ParallelAlgorithms, transform)
+    {
+        ThreadPool pool(4);
+        Array<uint32_t> input(50000);
+        Array<uint64_t> output(50000);
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            input[i] = i;
+        }
+
+        Square square;
+        EXPECT_EQ(CAPU_OK, parallelTransform(pool, input, output, square));
+        for (uint32_t i = 0; i < 50000; ++i)
+        {
+            ASSERT_EQ(static_cast<uint64_t>(i) * i, output[i]);
+        }
+
+        Array<uint64_t> tooSmall(10);
+        EXPECT_EQ(CAPU_ERANGE, parallelTransform(pool, input, tooSmall, square));
+    }
+
+    TEST(ParallelAlgorithms, transformInPlace)
+    {
+        ThreadPool pool(2);
+        Array<double_t> values(1000);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            values[i] = static_cast<double_t>(i) * i;
+        }
+
+        Root root;
+        parallelTransform(pool, values.getRawData(), values.getRawData(), 1000, root);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            ASSERT_NEAR(static_cast<double_t>(i), values[i], 1e-6);
+        }
+    }
+
+    TEST(ParallelAlgorithms, performanceScaling)
+    {
+        const uint_t count = 20000000;
+        Array<uint32_t> data(count);
+        for (uint_t i = 0; i < count; ++i)
+        {
+            data[i] = static_cast<uint32_t>(i);
+        }
+        const uint_t computeCount = 2000000;
+        Array<double_t> computeInput(computeCount);
+        Array<double_t> computeOutput(computeCount);
+        for (uint_t i = 0; i < computeCount; ++i)
+        {
+            computeInput[i] = static_cast<double_t>(i);
+        }
+
+        SumFunction sum(data.getRawData());
+        Add add;
+        Root root;
+        const uint32_t threadCounts[] = {0, 1, 3, 7};
+        for (uint_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t)
+        {
+            ThreadPool pool(threadCounts[t]);
+
+            uint64_t start = Time::GetMilliseconds();
+            const uint64_t total = parallelReduce(pool, 0, count, 0, static_cast<uint64_t>(0), sum, add);
+            const uint64_t memoryTime = Time::GetMilliseconds() - start;
+            EXPECT_EQ(static_cast<uint64_t>(count) * (count - 1) / 2, total);
+
+            start = Time::GetMilliseconds();
+            parallelTransform(pool, computeInput, computeOutput, root);
+            const uint64_t computeTime = Time::GetMilliseconds() - start;
+
+            printf("%u threads: memory bound sum of %u uint32 %u ms, compute bound transform of %u doubles %u ms\n",
+                threadCounts[t] + 1, static_cast<uint32_t>(count), static_cast<uint32_t>(memoryTime),
+                static_cast<uint32_t>(computeCount), static_cast<uint32_t>(computeTime));
+        }
+    }
+
+    TEST(ParallelAlgorithms, performanceCompareWithRunnablePerChunk)
+    {
+        // many small chunks show the overhead per chunk
+        const uint_t count = 4000000;
+        const uint_t chunk = 1000;
+        Array<uint32_t> data(count, 1);
+        ThreadPool pool(3);
+
+        uint64_t start = Time::GetMilliseconds();
+        const uint_t chunks = count / chunk;
+        Array<uint64_t> results(chunks, 0);
+        CountDownLatch latch(chunks);
+        for (uint_t i = 0; i < chunks; ++i)
+        {
+            pool.add(new SumRunnable(data.getRawData(), i * chunk, (i + 1) * chunk, results[i], latch));
+        }
+        latch.await();
+        uint64_t runnableTotal = 0;
+        for (uint_t i = 0; i < chunks; ++i)
+        {
+            runnableTotal += results[i];
+        }
+        const uint64_t runnableTime = Time::GetMilliseconds() - start;
+
+        start = Time::GetMilliseconds();
+        SumFunction sum(data.getRawData());
+        Add add;
+        const uint64_t reduceTotal = parallelReduce(pool, 0, count, chunk, static_cast<uint64_t>(0), sum, add);
+        const uint64_t reduceTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(runnableTotal, reduceTotal);
+
+        printf("sum of %u uint32 in chunks of %u: runnable per chunk %u ms, parallelReduce %u ms\n",
+            static_cast<uint32_t>(count), static_cast<uint32_t>(chunk),
+            static_cast<uint32_t>(runnableTime), static_cast<uint32_t>(reduceTime));
+    }
+}
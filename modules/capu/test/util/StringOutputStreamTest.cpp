@@ -15,6 +15,7 @@
  */
 
 #include "StringOutputStreamTest.h"
+#include "capu/os/NumericLimits.h"
 
 namespace capu
 {
@@ -58,6 +59,28 @@ namespace capu
         EXPECT_EQ(4U, outputStream.length());
     }
 
+    TEST_F(StringOutputStreamTest, WriteInt64)
+    {
+        outputStream << NumericLimits::Min<int64_t>() << " " << static_cast<int64_t>(0) << " " << static_cast<int64_t>(-4711);
+        outputStream.flush();
+        EXPECT_STREQ("-9223372036854775808 0 -4711", outputStream.c_str());
+    }
+
+    TEST_F(StringOutputStreamTest, WriteUInt64)
+    {
+        outputStream << NumericLimits::Max<uint64_t>();
+        outputStream.flush();
+        EXPECT_STREQ("18446744073709551615", outputStream.c_str());
+        EXPECT_EQ(20U, outputStream.length());
+    }
+
+    TEST_F(StringOutputStreamTest, WriteDouble)
+    {
+        outputStream << 47.11;
+        outputStream.flush();
+        EXPECT_STREQ("47.110000", outputStream.c_str());
+    }
+
     TEST_F(StringOutputStreamTest, WriteString)
     {
         outputStream << String("Hello World");
@@ -20,6 +20,7 @@
 #include <capu/os/Thread.h>
 #include <capu/os/Math.h>
 #include <capu/os/NumericLimits.h>
+#include <capu/util/TcpSocketOutputStream.h>
 
 namespace capu
 {
@@ -62,6 +63,25 @@ namespace capu
         }
     };
 
+    struct TcpUInt64TestSender: public TestTcpSocketSender
+    {
+        typedef uint64_t VALUE_TYPE;
+        static void Send(TcpSocket& socket, const uint64_t& data)
+        {
+            const uint32_t tmp[] = {htonl(static_cast<uint32_t>(data >> 32)), htonl(static_cast<uint32_t>(data))};
+            SendToSocket(socket, reinterpret_cast<const char_t*>(tmp), sizeof(uint64_t));
+        }
+    };
+
+    struct TcpDoubleTestSender: public TestTcpSocketSender
+    {
+        typedef double_t VALUE_TYPE;
+        static void Send(TcpSocket& socket, const double_t& data)
+        {
+            TcpUInt64TestSender::Send(socket, *reinterpret_cast<const uint64_t*>(&data));
+        }
+    };
+
     struct TcpBoolTestSender: public TestTcpSocketSender
     {
         typedef bool_t VALUE_TYPE;
@@ -154,6 +174,27 @@ namespace capu
         uint16_t mPort;
     };
 
+    class TestTcpVarIntSender: public Runnable
+    {
+    public:
+        TestTcpVarIntSender(const uint16_t port)
+            : mPort(port)
+        {
+        }
+
+        void run()
+        {
+            TcpSocket socket;
+            socket.connect("127.0.0.1", mPort);
+
+            TcpSocketOutputStream<> outStream(socket, STREAM_ENCODING_VARINT);
+            outStream << -1 << 300u << NumericLimits::Min<int64_t>() << NumericLimits::Max<uint64_t>() << static_cast<uint16_t>(7) << "Hello World" << 0.25 << 1.5f << 1.5f;
+            outStream.flush();
+        }
+    private:
+        uint16_t mPort;
+    };
+
     TcpSocketInputStreamTest::TcpSocketInputStreamTest()
     {
     }
@@ -232,6 +273,65 @@ namespace capu
         EXPECT_EQ(guid, TcpSocketInputStreamTestExecutor::Execute<TcpGuidTestSender>(guid));
     }
 
+    TEST_F(TcpSocketInputStreamTest, ReceiveUInt64)
+    {
+        EXPECT_EQ(5u, TcpSocketInputStreamTestExecutor::Execute<TcpUInt64TestSender>(5u));
+        EXPECT_EQ(NumericLimits::Max<uint64_t>(), TcpSocketInputStreamTestExecutor::Execute<TcpUInt64TestSender>(NumericLimits::Max<uint64_t>()));
+    }
+
+    TEST_F(TcpSocketInputStreamTest, ReceiveDouble)
+    {
+        EXPECT_EQ(-47.11, TcpSocketInputStreamTestExecutor::Execute<TcpDoubleTestSender>(-47.11));
+    }
+
+    TEST_F(TcpSocketInputStreamTest, ReceiveVarInt)
+    {
+        TcpServerSocket serverSocket;
+        serverSocket.bind(0);
+        serverSocket.listen(10);
+
+        TestTcpVarIntSender sender(serverSocket.port());
+        Thread thread;
+        thread.start(sender);
+
+        TcpSocket* socket = serverSocket.accept();
+
+        TcpSocketInputStream inStream(*socket, STREAM_ENCODING_VARINT);
+
+        int32_t int32Result = 0;
+        uint32_t uint32Result = 0;
+        int64_t int64Result = 0;
+        uint64_t uint64Result = 0;
+        uint16_t uint16Result = 0;
+        String stringResult;
+        double_t doubleResult = 0;
+        float_t floatResult = 0;
+        inStream >> int32Result >> uint32Result >> int64Result >> uint64Result >> uint16Result >> stringResult >> doubleResult >> floatResult;
+
+        // floats keep their fixed size in network byte order
+        uint8_t floatBytes[4] = {};
+        IInputStream& rawStream = inStream;
+        rawStream.read(reinterpret_cast<char_t*>(floatBytes), sizeof(floatBytes));
+
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(-1, int32Result);
+        EXPECT_EQ(300u, uint32Result);
+        EXPECT_EQ(NumericLimits::Min<int64_t>(), int64Result);
+        EXPECT_EQ(NumericLimits::Max<uint64_t>(), uint64Result);
+        EXPECT_EQ(7u, uint16Result);
+        EXPECT_STREQ("Hello World", stringResult.c_str());
+        EXPECT_EQ(0.25, doubleResult);
+        EXPECT_EQ(1.5f, floatResult);
+        EXPECT_EQ(0x3f, floatBytes[0]);
+        EXPECT_EQ(0xc0, floatBytes[1]);
+        EXPECT_EQ(0x00, floatBytes[2]);
+        EXPECT_EQ(0x00, floatBytes[3]);
+
+        thread.join();
+        delete socket;
+        serverSocket.close();
+    }
+
     TEST_F(TcpSocketInputStreamTest, ReceiveUInt16)
     {
         EXPECT_EQ(4, TcpSocketInputStreamTestExecutor::Execute<TcpUInt16TestSender>(4));
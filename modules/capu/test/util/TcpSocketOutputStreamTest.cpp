@@ -80,6 +80,28 @@ namespace capu
             return *this;
         }
 
+        IInputStream& operator>>(uint64_t& value)
+        {
+            uint8_t networkOrder[sizeof(uint64_t)];
+            receiveFromSocket(reinterpret_cast<char_t*>(networkOrder), sizeof(uint64_t));
+            value = 0;
+            for (uint32_t i = 0; i < sizeof(uint64_t); ++i)
+            {
+                value = (value << 8) | networkOrder[i];
+            }
+            return *this;
+        }
+
+        IInputStream& operator>>(int64_t& value)
+        {
+            return operator>>(reinterpret_cast<uint64_t&>(value));
+        }
+
+        IInputStream& operator>>(double_t& value)
+        {
+            return operator>>(reinterpret_cast<uint64_t&>(value));
+        }
+
         IInputStream& operator>>(String& value)
         {
             int32_t strLen = 0;
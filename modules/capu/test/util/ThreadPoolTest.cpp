@@ -20,6 +20,8 @@
 #include "capu/os/Mutex.h"
 #include "capu/os/Semaphore.h"
 #include "capu/os/AtomicOperation.h"
+#include "capu/os/StringUtils.h"
+#include "capu/os/Time.h"
 
 class Globals
 {
@@ -167,3 +169,150 @@ TEST(ThreadPool, CloseTest)
 
     EXPECT_TRUE(pool.isClosed());
 }
+
+class WorkerRecorder : public capu::Runnable
+{
+public:
+    capu::char_t m_name[16];
+    capu::int32_t m_cpu;
+
+    WorkerRecorder()
+        : m_cpu(-1)
+    {
+        m_name[0] = 0;
+    }
+
+    void run()
+    {
+#ifdef __linux__
+        pthread_getname_np(pthread_self(), m_name, sizeof(m_name));
+        m_cpu = sched_getcpu();
+#endif
+    }
+};
+
+TEST(ThreadPool, AttributesTest)
+{
+    Globals::var = 0;
+    capu::ThreadAttributes attributes;
+    attributes.setName("capuPool");
+    capu::ThreadPool pool(3, attributes, capu::TPP_PER_CPU);
+    EXPECT_EQ(3u, pool.getSize());
+
+    capu::SmartPointer<WorkerRecorder> recorder(new WorkerRecorder());
+    pool.add(recorder);
+    for (capu::uint32_t i = 0; i < 6; ++i)
+    {
+        pool.add(new WorkToDo());
+    }
+    EXPECT_EQ(capu::CAPU_OK, pool.close());
+    EXPECT_EQ(30u, Globals::var);
+#ifdef __linux__
+    EXPECT_TRUE(capu::StringUtils::StartsWith(recorder->m_name, "capuPool-"));
+#endif
+}
+
+TEST(ThreadPool, LongNameKeepsIndexTest)
+{
+    capu::ThreadAttributes attributes;
+    attributes.setName("averylongpoolname");
+    capu::ThreadPool pool(1, attributes);
+
+    capu::SmartPointer<WorkerRecorder> recorder(new WorkerRecorder());
+    pool.add(recorder);
+    EXPECT_EQ(capu::CAPU_OK, pool.close());
+#ifdef __linux__
+    EXPECT_STREQ("averylongpool-0", recorder->m_name);
+#endif
+}
+
+TEST(ThreadPool, SpreadOverCpuListTest)
+{
+    capu::CpuSet available;
+    EXPECT_EQ(capu::CAPU_OK, capu::Thread::GetAvailableCpus(available));
+    const capu::uint32_t cpu = available.get(0);
+
+    capu::CpuSet cpus;
+    cpus.add(cpu);
+    capu::ThreadAttributes attributes;
+    attributes.setCpuSet(cpus);
+    capu::ThreadPool pool(2, attributes, capu::TPP_PER_CPU);
+    EXPECT_EQ(2u, pool.getSize());
+
+    capu::SmartPointer<WorkerRecorder> recorders[4];
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        recorders[i] = new WorkerRecorder();
+        pool.add(recorders[i]);
+    }
+    EXPECT_EQ(capu::CAPU_OK, pool.close());
+#ifdef __linux__
+    for (capu::uint32_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(static_cast<capu::int32_t>(cpu), recorders[i]->m_cpu);
+    }
+#endif
+}
+
+class CacheSweep : public capu::Runnable
+{
+public:
+    CacheSweep(capu::uint32_t& checksum)
+        : m_checksum(checksum)
+    {
+    }
+
+    void run()
+    {
+        // about the size of a private L2 cache, it stays warm as long as the thread does not migrate
+        const capu::uint_t count = 256 * 1024 / sizeof(capu::uint32_t);
+        capu::uint32_t* data = new capu::uint32_t[count];
+        for (capu::uint_t i = 0; i < count; ++i)
+        {
+            data[i] = static_cast<capu::uint32_t>(i);
+        }
+        capu::uint32_t sum = 0;
+        for (capu::uint32_t pass = 0; pass < 4000; ++pass)
+        {
+            // one access per cache line
+            for (capu::uint_t i = 0; i < count; i += 16)
+            {
+                data[i] += pass;
+                sum += data[i];
+            }
+        }
+        delete[] data;
+        capu::AtomicOperation::AtomicAdd32(m_checksum, sum);
+    }
+
+private:
+    capu::uint32_t& m_checksum;
+};
+
+TEST(ThreadPool, performancePinning)
+{
+    capu::CpuSet cpus;
+    capu::Thread::GetAvailableCpus(cpus);
+    // at least two workers, so that they compete for a core if there is only one
+    const capu::uint32_t workers = cpus.count() > 1 ? cpus.count() : 2;
+
+    const capu::ThreadPoolPinning pinnings[] = {capu::TPP_NONE, capu::TPP_PER_CPU};
+    capu::uint32_t checksums[2];
+    for (capu::uint32_t p = 0; p < 2; ++p)
+    {
+        capu::ThreadPool pool(workers, capu::ThreadAttributes(), pinnings[p]);
+        checksums[p] = 0;
+
+        const capu::uint64_t start = capu::Time::GetMilliseconds();
+        for (capu::uint32_t i = 0; i < workers * 4; ++i)
+        {
+            pool.add(new CacheSweep(checksums[p]));
+        }
+        pool.close();
+        const capu::uint64_t time = capu::Time::GetMilliseconds() - start;
+
+        printf("%u workers on %u cpus, %s: %u ms\n", workers, cpus.count(),
+            pinnings[p] == capu::TPP_PER_CPU ? "pinned" : "not pinned", static_cast<capu::uint32_t>(time));
+    }
+    EXPECT_EQ(checksums[0], checksums[1]);
+}
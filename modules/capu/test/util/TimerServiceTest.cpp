@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2012 BMW Car IT GmbH
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include "capu/util/TimerService.h"
+#include "capu/util/CountDownLatch.h"
+#include "capu/os/AtomicOperation.h"
+#include "capu/os/Time.h"
+#include <stdio.h>
+
+namespace capu
+{
+    namespace
+    {
+        class CountingRunnable : public Runnable
+        {
+        public:
+            CountingRunnable(CountDownLatch* latch = 0)
+                : mRuns(0)
+                , mLastRunMillis(0)
+                , mLatch(latch)
+            {
+            }
+
+            void run()
+            {
+                mLastRunMillis = Time::GetMilliseconds();
+                AtomicOperation::AtomicInc32(mRuns);
+                if (mLatch)
+                {
+                    mLatch->countDown();
+                }
+            }
+
+            volatile uint32_t mRuns;
+            volatile uint64_t mLastRunMillis;
+
+        private:
+            CountDownLatch* mLatch;
+        };
+
+        class OrderRunnable : public Runnable
+        {
+        public:
+            OrderRunnable(uint32_t& position, const uint32_t expected, CountDownLatch& latch)
+                : mPosition(position)
+                , mExpected(expected)
+                , mInOrder(false)
+                , mLatch(latch)
+            {
+            }
+
+            void run()
+            {
+                mInOrder = mPosition == mExpected;
+                ++mPosition;
+                mLatch.countDown();
+            }
+
+            uint32_t& mPosition;
+            const uint32_t mExpected;
+            bool_t mInOrder;
+
+        private:
+            CountDownLatch& mLatch;
+        };
+
+        class ReschedulingRunnable : public Runnable
+        {
+        public:
+            ReschedulingRunnable(TimerService& service, CountDownLatch& latch)
+                : mService(service)
+                , mLatch(latch)
+                , mRemaining(3)
+            {
+            }
+
+            void run()
+            {
+                mLatch.countDown();
+                if (--mRemaining > 0)
+                {
+                    mService.schedule(new ReschedulingRunnable(*this), 2);
+                }
+            }
+
+        private:
+            TimerService& mService;
+            CountDownLatch& mLatch;
+            uint32_t mRemaining;
+        };
+    }
+
+    TEST(TimerService, scheduleRunsOnceAfterDelay)
+    {
+        TimerService service;
+        CountDownLatch latch(1);
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable(&latch);
+
+        const uint64_t start = Time::GetMilliseconds();
+        TimerService::TimerId id = TimerService::InvalidTimerId;
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 30, &id));
+        EXPECT_NE(TimerService::InvalidTimerId, id);
+        EXPECT_EQ(1u, service.count());
+
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+        EXPECT_GE(runnable->mLastRunMillis - start, 30u);
+        Thread::Sleep(50);
+        EXPECT_EQ(1u, runnable->mRuns);
+        EXPECT_EQ(0u, service.count());
+
+        // already expired
+        EXPECT_EQ(CAPU_ERANGE, service.cancel(id));
+    }
+
+    TEST(TimerService, expiresInOrderOfDelay)
+    {
+        TimerService service;
+        CountDownLatch latch(5);
+        uint32_t position = 0;
+        const uint32_t delays[] = {90, 10, 70, 30, 200};
+        const uint32_t expected[] = {3, 0, 2, 1, 4};
+        SmartPointer<OrderRunnable> runnables[5];
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            runnables[i] = new OrderRunnable(position, expected[i], latch);
+            EXPECT_EQ(CAPU_OK, service.schedule(runnables[i], delays[i]));
+        }
+
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            EXPECT_TRUE(runnables[i]->mInOrder);
+        }
+    }
+
+    TEST(TimerService, cancel)
+    {
+        TimerService service;
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable();
+
+        TimerService::TimerId id = TimerService::InvalidTimerId;
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 20, &id));
+        EXPECT_EQ(CAPU_OK, service.cancel(id));
+        EXPECT_EQ(CAPU_ERANGE, service.cancel(id));
+        EXPECT_EQ(CAPU_ERANGE, service.cancel(TimerService::InvalidTimerId));
+        EXPECT_EQ(CAPU_ERANGE, service.cancel(12345));
+        EXPECT_EQ(0u, service.count());
+
+        // the slot is reused with a new id
+        TimerService::TimerId otherId = TimerService::InvalidTimerId;
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 10000, &otherId));
+        EXPECT_NE(id, otherId);
+        EXPECT_EQ(CAPU_ERANGE, service.cancel(id));
+
+        Thread::Sleep(60);
+        EXPECT_EQ(0u, runnable->mRuns);
+        EXPECT_EQ(CAPU_OK, service.cancel(otherId));
+    }
+
+    TEST(TimerService, periodic)
+    {
+        TimerService service;
+        CountDownLatch latch(5);
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable(&latch);
+
+        const uint64_t start = Time::GetMilliseconds();
+        TimerService::TimerId id = TimerService::InvalidTimerId;
+        EXPECT_EQ(CAPU_OK, service.schedulePeriodic(runnable, 5, 10, &id));
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+        EXPECT_GE(Time::GetMilliseconds() - start, 45u);
+        EXPECT_EQ(1u, service.count());
+
+        EXPECT_EQ(CAPU_OK, service.cancel(id));
+        const uint32_t runs = runnable->mRuns;
+        Thread::Sleep(50);
+        EXPECT_EQ(runs, runnable->mRuns);
+    }
+
+    TEST(TimerService, delaysBeyondTheLowestLevel)
+    {
+        // 130 ticks need a cascade from the second level
+        TimerService service;
+        CountDownLatch latch(1);
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable(&latch);
+
+        const uint64_t start = Time::GetMilliseconds();
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 130));
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+        EXPECT_GE(runnable->mLastRunMillis - start, 130u);
+    }
+
+    TEST(TimerService, farFutureTimersStayPending)
+    {
+        TimerService service(10);
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable();
+
+        // one hour, one week and the maximum delay
+        TimerService::TimerId ids[3];
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 3600000, &ids[0]));
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 604800000, &ids[1]));
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 0xFFFFFFFFu, &ids[2]));
+        Thread::Sleep(30);
+        EXPECT_EQ(3u, service.count());
+        EXPECT_EQ(0u, runnable->mRuns);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(CAPU_OK, service.cancel(ids[i]));
+        }
+    }
+
+    TEST(TimerService, scheduleFromRunnable)
+    {
+        TimerService service;
+        CountDownLatch latch(3);
+        EXPECT_EQ(CAPU_OK, service.schedule(new ReschedulingRunnable(service, latch), 2));
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+    }
+
+    TEST(TimerService, runsOnThreadPool)
+    {
+        ThreadPool pool(2);
+        TimerService service(1, &pool);
+        CountDownLatch latch(10);
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable(&latch);
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            EXPECT_EQ(CAPU_OK, service.schedule(runnable, i * 3));
+        }
+        EXPECT_EQ(CAPU_OK, latch.await(5000));
+    }
+
+    TEST(TimerService, close)
+    {
+        TimerService service;
+        SmartPointer<CountingRunnable> runnable = new CountingRunnable();
+        EXPECT_EQ(CAPU_OK, service.schedule(runnable, 20));
+        EXPECT_EQ(CAPU_EINVAL, service.schedule(SmartPointer<Runnable>(), 20));
+
+        EXPECT_FALSE(service.isClosed());
+        EXPECT_EQ(CAPU_OK, service.close());
+        EXPECT_TRUE(service.isClosed());
+        EXPECT_EQ(0u, service.count());
+        EXPECT_EQ(CAPU_ERROR, service.schedule(runnable, 20));
+
+        Thread::Sleep(40);
+        EXPECT_EQ(0u, runnable->mRuns);
+        EXPECT_EQ(CAPU_OK, service.close());
+    }
+
+    TEST(TimerService, performanceScheduleAndCancel)
+    {
+        const uint32_t count = 1000000;
+        TimerService service;
+        SmartPointer<Runnable> runnable = new CountingRunnable();
+        TimerService::TimerId* ids = new TimerService::TimerId[count];
+
+        // timeouts between one second and one hour, like connection timeouts
+        uint32_t random = 1;
+        uint64_t start = Time::GetMilliseconds();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            service.schedule(runnable, 1000 + random % 3599000, &ids[i]);
+        }
+        const uint64_t scheduleTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(count, service.count());
+
+        start = Time::GetMilliseconds();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            service.cancel(ids[i]);
+        }
+        const uint64_t cancelTime = Time::GetMilliseconds() - start;
+        EXPECT_EQ(0u, service.count());
+
+        // the second round reuses the nodes
+        start = Time::GetMilliseconds();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            service.schedule(runnable, 1000 + i % 3599000, &ids[i]);
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            service.cancel(ids[i]);
+        }
+        const uint64_t reuseTime = Time::GetMilliseconds() - start;
+        delete[] ids;
+
+        printf("%u timers: schedule %u ms, cancel %u ms, schedule and cancel again %u ms\n",
+            count, static_cast<uint32_t>(scheduleTime), static_cast<uint32_t>(cancelTime), static_cast<uint32_t>(reuseTime));
+    }
+}
@@ -270,4 +270,35 @@ namespace capu
         EXPECT_FLOAT_EQ(Math::LN2_f, floatResult);
         EXPECT_EQ(true, boolResult);
     }
+
+    TEST_F(UdpSocketInputStreamTest, ReceiveStringView)
+    {
+        UdpSocket serverSocket;
+        serverSocket.bind(0, 0);
+
+        TestUdpMultipleSender sender(serverSocket.getSocketAddrInfo().port, 5, "Hello World", Math::LN2_f, true);
+        Thread thread;
+        thread.start(sender);
+
+        UdpSocketInputStream<1450> inStream(serverSocket);
+
+        int32_t intResult;
+        StringView stringResult;
+        float_t floatResult;
+        bool_t  boolResult;
+
+        inStream >> intResult;
+        inStream >> stringResult;
+        inStream >> floatResult >> boolResult;
+
+        thread.join();
+
+        serverSocket.close();
+
+        EXPECT_EQ(CAPU_OK, inStream.getState());
+        EXPECT_EQ(5, intResult);
+        EXPECT_TRUE(StringView("Hello World") == stringResult);
+        EXPECT_FLOAT_EQ(Math::LN2_f, floatResult);
+        EXPECT_EQ(true, boolResult);
+    }
 }